@@ -0,0 +1,182 @@
+//---------------------------------------------------------------------------
+// lexc.cpp
+//
+// A command-line tool for compiling a word list into a lexicon bundle.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "LexiconBundle.h"
+#include "WordEngine.h"
+#include "Defs.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QStringList>
+#include <iostream>
+
+using namespace std;
+using namespace Defs;
+
+//---------------------------------------------------------------------------
+//  usage
+//
+//! Print a usage message.
+//---------------------------------------------------------------------------
+void
+usage()
+{
+    cerr << "Usage: lexc [options] <word-file> <bundle-file>" << endl
+         << endl
+         << "Compile a word list into a single-file lexicon bundle.  The"
+         << endl
+         << "word file contains one word per line, optionally followed by"
+         << endl
+         << "its definition." << endl
+         << endl
+         << "Options:" << endl
+         << "  -d              include definitions from the word file" << endl
+         << "  -p <file>       read playability values from <file>" << endl
+         << "  -s <file>       read stems from <file> (may be repeated)"
+         << endl;
+}
+
+//---------------------------------------------------------------------------
+//  readLines
+//
+//! Read the non-empty, non-comment lines of a text file.
+//
+//! @param filename the name of the file
+//! @param lines return the simplified lines
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+readLines(const QString& filename, QStringList& lines)
+{
+    QFile file (filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        cerr << "Can't open file '" << filename.toLocal8Bit().constData()
+             << "': " << file.errorString().toLocal8Bit().constData()
+             << endl;
+        return false;
+    }
+
+    char* buffer = new char[MAX_INPUT_LINE_LEN];
+    while (file.readLine(buffer, MAX_INPUT_LINE_LEN) > 0) {
+        QString line = QString::fromUtf8(buffer).simplified();
+        if (!line.length() || (line.at(0) == '#'))
+            continue;
+        lines.append(line);
+    }
+    delete[] buffer;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  main
+//
+//! Compile a lexicon bundle.
+//---------------------------------------------------------------------------
+int
+main(int argc, char** argv)
+{
+    QCoreApplication app (argc, argv);
+
+    bool loadDefinitions = false;
+    QString playabilityFile;
+    QStringList stemFiles;
+    QStringList files;
+
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.count(); ++i) {
+        const QString& arg = args[i];
+        if (arg == "-d")
+            loadDefinitions = true;
+        else if ((arg == "-p") && (i + 1 < args.count()))
+            playabilityFile = args[++i];
+        else if ((arg == "-s") && (i + 1 < args.count()))
+            stemFiles.append(args[++i]);
+        else if (arg.startsWith("-")) {
+            usage();
+            return 1;
+        }
+        else
+            files.append(arg);
+    }
+
+    if (files.count() != 2) {
+        usage();
+        return 1;
+    }
+
+    QStringList lines;
+    if (!readLines(files[0], lines))
+        return 1;
+
+    QStringList words;
+    QMap<QString, QString> definitions;
+    foreach (const QString& line, lines) {
+        QString word = line.section(' ', 0, 0).toUpper();
+        words.append(word);
+        if (!loadDefinitions)
+            continue;
+
+        QString definition = line.section(' ', 1);
+        if (definition.isEmpty())
+            continue;
+        if (definitions.contains(word))
+            definitions[word] += WordEngine::DEF_ORIG_SEP + definition;
+        else
+            definitions[word] = definition;
+    }
+
+    QMap<QString, qint64> playability;
+    if (!playabilityFile.isEmpty()) {
+        QStringList playLines;
+        if (!readLines(playabilityFile, playLines))
+            return 1;
+        foreach (const QString& line, playLines) {
+            bool ok = false;
+            qint64 value = line.section(' ', 0, 0).toLongLong(&ok);
+            QString word = line.section(' ', 1, 1).toUpper();
+            if (ok && !word.isEmpty())
+                playability[word] = value;
+        }
+    }
+
+    QMap<int, QStringList> stems;
+    foreach (const QString& stemFile, stemFiles) {
+        QStringList stemLines;
+        if (!readLines(stemFile, stemLines))
+            return 1;
+        foreach (const QString& line, stemLines) {
+            QString stem = line.section(' ', 0, 0).toUpper();
+            stems[stem.length()].append(stem);
+        }
+    }
+
+    QString errString;
+    if (!LexiconBundle::write(files[1], words, definitions, playability,
+                              stems, &errString))
+    {
+        cerr << errString.toLocal8Bit().constData() << endl;
+        return 1;
+    }
+
+    return 0;
+}
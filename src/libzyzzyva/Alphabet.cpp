@@ -0,0 +1,278 @@
+//---------------------------------------------------------------------------
+// Alphabet.cpp
+//
+// A dense coding of the letters of a lexicon, with letter property tables.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+
+#include "Alphabet.h"
+#include "MainSettings.h"
+#include "Auxil.h"
+#include <QList>
+#include <QStringList>
+#include <QtAlgorithms>
+#include <cstring>
+
+// FIXME: point values should be part of the letter distribution
+const QString DEFAULT_POINT_VALUES = "A:1 B:3 C:3 D:2 E:1 F:4 G:2 H:4 I:1 "
+    "J:8 K:5 L:1 M:3 N:1 O:1 P:3 Q:10 R:1 S:1 T:1 U:1 V:4 W:4 X:8 Y:4 Z:10 "
+    "_:0";
+
+//---------------------------------------------------------------------------
+//  parseLetterCounts
+//
+//! Parse a string of letters and counts in the form used by letter
+//! distributions, for example "A:9 B:2".
+//
+//! @param str the string
+//! @return a map of letters to counts
+//---------------------------------------------------------------------------
+static QMap<QChar, int>
+parseLetterCounts(const QString& str)
+{
+    QMap<QChar, int> counts;
+    foreach (const QString& item, str.split(" ", QString::SkipEmptyParts)) {
+        QString letter = item.section(":", 0, 0);
+        if (!letter.isEmpty())
+            counts.insert(letter.at(0), item.section(":", 1, 1).toInt());
+    }
+    return counts;
+}
+
+//---------------------------------------------------------------------------
+//  Alphabet
+//
+//! Constructor.  The alphabet holds the letters A-Z and the letters of the
+//! distribution.  If no letter distribution is specified, the default
+//! distribution is used.
+//
+//! @param distribution the letter distribution
+//---------------------------------------------------------------------------
+Alphabet::Alphabet(const QString& distribution)
+{
+    QString dist (distribution);
+    if (dist.isEmpty())
+        dist = MainSettings::getLetterDistribution();
+
+    QMap<QChar, int> letterFrequencies = parseLetterCounts(dist);
+    QString allLetters = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    QMapIterator<QChar, int> it (letterFrequencies);
+    while (it.hasNext())
+        allLetters += it.next().key();
+
+    assignCodes(allLetters, letterFrequencies,
+                parseLetterCounts(DEFAULT_POINT_VALUES));
+}
+
+//---------------------------------------------------------------------------
+//  addLetters
+//
+//! Add letters to the alphabet.  Letters already in the alphabet, and
+//! characters outside Latin-1, are ignored.  New letters have no point
+//! value and do not occur in the distribution.  Adding letters may change
+//! the codes of other letters.
+//
+//! @param newLetters the letters to add
+//---------------------------------------------------------------------------
+void
+Alphabet::addLetters(const QString& newLetters)
+{
+    bool added = false;
+    foreach (const QChar& c, newLetters) {
+        if ((c.unicode() <= 0xff) && (getCode(c) == NO_CODE)) {
+            added = true;
+            break;
+        }
+    }
+    if (!added)
+        return;
+
+    QMap<QChar, int> letterFrequencies;
+    QMap<QChar, int> letterValues;
+    for (int code = 0; code < letters.length(); ++code) {
+        letterFrequencies.insert(letters.at(code), frequencies[code]);
+        letterValues.insert(letters.at(code), pointValues[code]);
+    }
+    assignCodes(letters + newLetters, letterFrequencies, letterValues);
+}
+
+//---------------------------------------------------------------------------
+//  setPointValue
+//
+//! Set the point value of a letter in the alphabet.
+//
+//! @param letter the letter
+//! @param value the point value
+//---------------------------------------------------------------------------
+void
+Alphabet::setPointValue(const QChar& letter, int value)
+{
+    int code = getCode(letter);
+    if (code != NO_CODE)
+        pointValues[code] = value;
+}
+
+//---------------------------------------------------------------------------
+//  encode
+//
+//! Translate a word into letter codes.
+//
+//! @param word the word
+//! @param wordCodes return the codes, with room for the length of the word
+//! @return true if every letter of the word is in the alphabet, false
+//! otherwise
+//---------------------------------------------------------------------------
+bool
+Alphabet::encode(const QString& word, quint8* wordCodes) const
+{
+    int length = word.length();
+    for (int i = 0; i < length; ++i) {
+        int code = getCode(word.at(i));
+        if (code == NO_CODE)
+            return false;
+        wordCodes[i] = quint8(code);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  getNumVowels
+//
+//! Determine the number of vowels in a coded word.
+//
+//! @param wordCodes the letter codes of the word
+//! @param length the length of the word
+//! @return the number of vowels
+//---------------------------------------------------------------------------
+int
+Alphabet::getNumVowels(const quint8* wordCodes, int length) const
+{
+    int numVowels = 0;
+    for (int i = 0; i < length; ++i)
+        numVowels += vowels[wordCodes[i]];
+    return numVowels;
+}
+
+//---------------------------------------------------------------------------
+//  getNumUniqueLetters
+//
+//! Determine the number of unique letters in a coded word.
+//
+//! @param wordCodes the letter codes of the word
+//! @param length the length of the word
+//! @return the number of unique letters
+//---------------------------------------------------------------------------
+int
+Alphabet::getNumUniqueLetters(const quint8* wordCodes, int length) const
+{
+    quint32 seen[8];
+    memset(seen, 0, sizeof(seen));
+    int numUniqueLetters = 0;
+    for (int i = 0; i < length; ++i) {
+        quint8 code = wordCodes[i];
+        quint32 bit = 1U << (code & 31);
+        if (!(seen[code >> 5] & bit)) {
+            seen[code >> 5] |= bit;
+            ++numUniqueLetters;
+        }
+    }
+    return numUniqueLetters;
+}
+
+//---------------------------------------------------------------------------
+//  getPointValue
+//
+//! Determine the total point value of the letters of a coded word.
+//
+//! @param wordCodes the letter codes of the word
+//! @param length the length of the word
+//! @return the point value
+//---------------------------------------------------------------------------
+int
+Alphabet::getPointValue(const quint8* wordCodes, int length) const
+{
+    int pointValue = 0;
+    for (int i = 0; i < length; ++i)
+        pointValue += pointValues[wordCodes[i]];
+    return pointValue;
+}
+
+//---------------------------------------------------------------------------
+//  getLetterCounts
+//
+//! Count the occurrences of each letter in a coded word.
+//
+//! @param wordCodes the letter codes of the word
+//! @param length the length of the word
+//! @param counts return the count of each letter, with room for every
+//! letter of the alphabet
+//---------------------------------------------------------------------------
+void
+Alphabet::getLetterCounts(const quint8* wordCodes, int length, int* counts)
+    const
+{
+    memset(counts, 0, letters.length() * sizeof(int));
+    for (int i = 0; i < length; ++i)
+        ++counts[wordCodes[i]];
+}
+
+//---------------------------------------------------------------------------
+//  assignCodes
+//
+//! Number the letters in character order and fill in the property tables.
+//
+//! @param allLetters the letters, in any order and possibly repeated
+//! @param letterFrequencies the number of tiles of each letter
+//! @param letterValues the point value of each letter
+//---------------------------------------------------------------------------
+void
+Alphabet::assignCodes(const QString& allLetters, const QMap<QChar, int>&
+                      letterFrequencies, const QMap<QChar, int>& letterValues)
+{
+    QList<QChar> sorted;
+    foreach (const QChar& c, allLetters) {
+        if ((c.unicode() <= 0xff) && !sorted.contains(c))
+            sorted.append(c);
+    }
+    qSort(sorted);
+    if (sorted.size() > NO_CODE)
+        sorted = sorted.mid(0, NO_CODE);
+
+    int numLetters = sorted.size();
+    letters.clear();
+    memset(codes, NO_CODE, sizeof(codes));
+    vowels.resize(numLetters);
+    pointValues.resize(numLetters);
+    frequencies.resize(numLetters);
+    collationRanks.resize(numLetters);
+    for (int code = 0; code < numLetters; ++code) {
+        QChar c = sorted[code];
+        letters += c;
+        codes[c.unicode()] = quint8(code);
+        vowels[code] = Auxil::isVowel(c);
+        pointValues[code] = letterValues.value(c);
+        frequencies[code] = letterFrequencies.value(c);
+    }
+
+    qSort(sorted.begin(), sorted.end(), Auxil::localeAwareLessThanQChar);
+    for (int rank = 0; rank < numLetters; ++rank)
+        collationRanks[getCode(sorted[rank])] = rank;
+}
@@ -0,0 +1,85 @@
+//---------------------------------------------------------------------------
+// Alphabet.h
+//
+// A dense coding of the letters of a lexicon, with letter property tables.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+
+#ifndef ZYZZYVA_ALPHABET_H
+#define ZYZZYVA_ALPHABET_H
+
+#include <QChar>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// Letters are numbered from zero in character order, so the properties of a
+// letter can be looked up in flat tables and a word can be handled as an
+// array of small codes.  Only Latin-1 characters can be coded, and the
+// coding is case-sensitive.
+class Alphabet
+{
+    public:
+    static const quint8 NO_CODE = 0xff;
+
+    public:
+    Alphabet(const QString& distribution = QString());
+    ~Alphabet() { }
+
+    void addLetters(const QString& newLetters);
+    void setPointValue(const QChar& letter, int value);
+
+    int getNumLetters() const { return letters.length(); }
+    QString getLetters() const { return letters; }
+    QChar getLetter(int code) const { return letters.at(code); }
+    int getCode(const QChar& letter) const {
+        ushort u = letter.unicode();
+        return (u <= 0xff) ? codes[u] : NO_CODE;
+    }
+
+    bool isVowel(int code) const { return vowels[code]; }
+    int getPointValue(int code) const { return pointValues[code]; }
+    int getFrequency(int code) const { return frequencies[code]; }
+    int getCollationRank(int code) const { return collationRanks[code]; }
+
+    bool encode(const QString& word, quint8* wordCodes) const;
+    int getNumVowels(const quint8* wordCodes, int length) const;
+    int getNumUniqueLetters(const quint8* wordCodes, int length) const;
+    int getPointValue(const quint8* wordCodes, int length) const;
+    void getLetterCounts(const quint8* wordCodes, int length, int* counts)
+        const;
+
+    private:
+    void assignCodes(const QString& allLetters, const QMap<QChar, int>&
+                     letterFrequencies, const QMap<QChar, int>&
+                     letterValues);
+
+    private:
+    QString letters;
+    quint8 codes[256];
+    QVector<bool> vowels;
+    QVector<int> pointValues;
+    QVector<int> frequencies;
+    QVector<int> collationRanks;
+};
+
+#endif // ZYZZYVA_ALPHABET_H
@@ -26,8 +26,10 @@
 #include "MainSettings.h"
 #include "Defs.h"
 #include <QApplication>
+#include <QCryptographicHash>
 #include <QDir>
 #include <QFile>
+#include <cstring>
 #include <unistd.h>
 
 const QString SET_UNKNOWN_STRING = "Unknown";
@@ -72,6 +74,7 @@ const QString SEARCH_TYPE_LIMIT_BY_PLAYABILITY_ORDER =
               "Limit by Playability Order";
 const QString SEARCH_TYPE_PART_OF_SPEECH = "Part of Speech";
 const QString SEARCH_TYPE_DEFINITION = "Definition";
+const QString SEARCH_TYPE_DRAW_PROBABILITY = "Draw Probability";
 
 // Obsolete search condition strings
 const QString SEARCH_TYPE_OLD_EXACT_LENGTH = "Exact Length";
@@ -474,6 +477,51 @@ Auxil::getDatabaseFilename(const QString& lexicon)
     return (dbPath + "/" + lexicon + ".db");
 }
 
+//---------------------------------------------------------------------------
+//  getCompiledLexiconFilename
+//
+//! Return the filename of the compiled bundle cached for a lexicon text
+//! file with certain contents.  Also create the lexicon directory if it
+//! doesn't already exist.
+//
+//! @param lexicon the lexicon name
+//! @param hash the content hash of the lexicon text file
+//! @return the compiled bundle filename
+//---------------------------------------------------------------------------
+QString
+Auxil::getCompiledLexiconFilename(const QString& lexicon, const QString& hash)
+{
+    QString path = getUserDir() + "/lexicons";
+    QDir dir;
+    dir.mkpath(path);
+    return (path + "/" + lexicon + "-" + hash + ".zlx");
+}
+
+//---------------------------------------------------------------------------
+//  getFileContentHash
+//
+//! Return a hash of the contents of a file, as a string of hex digits.
+//
+//! @param filename the name of the file
+//! @return the hash, or empty string if the file cannot be read
+//---------------------------------------------------------------------------
+QString
+Auxil::getFileContentHash(const QString& filename)
+{
+    QFile file (filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+
+    QCryptographicHash hash (QCryptographicHash::Sha1);
+    while (!file.atEnd()) {
+        QByteArray bytes = file.read(65536);
+        if (bytes.isEmpty())
+            return QString();
+        hash.addData(bytes);
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
 //---------------------------------------------------------------------------
 //  dialogWordWrap
 //
@@ -627,11 +675,30 @@ Auxil::getCanonicalSearchString(const QString& str)
 int
 Auxil::getNumUniqueLetters(const QString& word)
 {
+    // Mark Latin-1 letters in a flat table, and fall back to comparing the
+    // letters of the alphagram for anything else
+    bool seen[256];
+    memset(seen, 0, sizeof(seen));
     int numUniqueLetters = 0;
+    int length = word.length();
+    int i = 0;
+    for (; i < length; ++i) {
+        ushort u = word.at(i).unicode();
+        if (u > 0xff)
+            break;
+        if (!seen[u]) {
+            seen[u] = true;
+            ++numUniqueLetters;
+        }
+    }
+    if (i == length)
+        return numUniqueLetters;
+
+    numUniqueLetters = 0;
     QString alphagram = getAlphagram(word);
     QChar c;
-    for (int i = 0; i < alphagram.length(); ++i) {
-        QChar d = alphagram.at(i);
+    for (int j = 0; j < alphagram.length(); ++j) {
+        QChar d = alphagram.at(j);
         if (d != c)
             ++numUniqueLetters;
         c = d;
@@ -788,6 +855,8 @@ Auxil::stringToSearchType(const QString& string)
         return SearchCondition::PartOfSpeech;
     else if (string == SEARCH_TYPE_DEFINITION)
         return SearchCondition::Definition;
+    else if (string == SEARCH_TYPE_DRAW_PROBABILITY)
+        return SearchCondition::DrawProbability;
 
     // Obsolete search condition strings
     else if (string == SEARCH_TYPE_OLD_EXACT_LENGTH)
@@ -900,6 +969,9 @@ Auxil::searchTypeToString(SearchCondition::SearchType type)
         case SearchCondition::Definition:
         return SEARCH_TYPE_DEFINITION;
 
+        case SearchCondition::DrawProbability:
+        return SEARCH_TYPE_DRAW_PROBABILITY;
+
         default: return QString();
     }
 }
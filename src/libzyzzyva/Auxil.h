@@ -51,6 +51,9 @@ namespace Auxil {
     QString getUserConfigDir();
     QString getLexiconPrefix(const QString& lexicon);
     QString getDatabaseFilename(const QString& lexicon);
+    QString getCompiledLexiconFilename(const QString& lexicon,
+                                       const QString& hash);
+    QString getFileContentHash(const QString& filename);
     QString dialogWordWrap(const QString& str);
     QString wordWrap(const QString& str, int wrapLength);
     bool isVowel(QChar c);
@@ -0,0 +1,194 @@
+//---------------------------------------------------------------------------
+// CompletionIndex.cpp
+//
+// An index for finding the best-scoring completions of a prefix.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+
+#include "CompletionIndex.h"
+#include <QPair>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include <vector>
+
+//---------------------------------------------------------------------------
+//  build
+//
+//! Build the index from a list of words and their scores.  Words that
+//! cannot be held as fixed words are left out, as are repeated words.
+//
+//! @param wordList the words
+//! @param wordScores the score of each word, higher scores ranking first
+//---------------------------------------------------------------------------
+void
+CompletionIndex::build(const QStringList& wordList, const QVector<double>&
+                       wordScores)
+{
+    clear();
+
+    QVector<QPair<FixedWord, double> > entries;
+    entries.reserve(wordList.size());
+    int numWords = wordList.size();
+    for (int i = 0; i < numWords; ++i) {
+        const QString& word = wordList[i];
+        if (!FixedWord::canHold(word))
+            continue;
+        entries.append(qMakePair(FixedWord(word).toUpper(),
+                                 wordScores.value(i)));
+    }
+    qSort(entries);
+
+    words.reserve(entries.size());
+    scores.reserve(entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        if (!words.isEmpty() && (words.last() == entries[i].first)) {
+            scores.last() = qMax(scores.last(), entries[i].second);
+            continue;
+        }
+        words.append(entries[i].first);
+        scores.append(entries[i].second);
+    }
+
+    // Each node holds the index of the best word below it, or -1 for the
+    // padding beyond the last word
+    numLeaves = 1;
+    while (numLeaves < words.size())
+        numLeaves <<= 1;
+    best.fill(-1, 2 * numLeaves);
+    for (int i = 0; i < words.size(); ++i)
+        best[numLeaves + i] = i;
+    for (int node = numLeaves - 1; node > 0; --node) {
+        qint32 left = best[2 * node];
+        qint32 right = best[2 * node + 1];
+        best[node] = isBetter(right, left) ? right : left;
+    }
+}
+
+//---------------------------------------------------------------------------
+//  clear
+//
+//! Remove all words from the index.
+//---------------------------------------------------------------------------
+void
+CompletionIndex::clear()
+{
+    words.clear();
+    scores.clear();
+    best.clear();
+    numLeaves = 0;
+}
+
+//---------------------------------------------------------------------------
+//  complete
+//
+//! Find the best-scoring words beginning with a prefix.  Words with equal
+//! scores are returned in alphabetical order.  The time taken depends on
+//! the number of completions requested and the logarithm of the number of
+//! words, not on the number of words beginning with the prefix.
+//
+//! @param prefix the prefix
+//! @param maxCompletions the maximum number of words to return
+//! @return the words in order of decreasing score, in upper case
+//---------------------------------------------------------------------------
+QStringList
+CompletionIndex::complete(const QString& prefix, int maxCompletions) const
+{
+    QStringList completions;
+    if ((maxCompletions <= 0) || words.isEmpty() ||
+        !FixedWord::canHold(prefix))
+    {
+        return completions;
+    }
+
+    // The prefix padded with zeros sorts before every word beginning with it
+    FixedWord key = FixedWord(prefix).toUpper();
+    int keyLen = key.length();
+    qint32 lo = std::lower_bound(words.begin(), words.end(), key) -
+        words.begin();
+    qint32 hi = words.size();
+    for (qint32 first = lo; first < hi; ) {
+        qint32 mid = first + (hi - first) / 2;
+        bool match = true;
+        for (int i = 0; match && (i < keyLen); ++i)
+            match = (words[mid].at(i) == key.at(i));
+        if (match)
+            first = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo >= hi)
+        return completions;
+
+    // Each heap entry is a node keyed by the score and position of its best
+    // word, so the top of the heap always holds the next best completion
+    typedef std::pair<std::pair<double, qint32>, qint32> Entry;
+    std::priority_queue<Entry> heap;
+    for (qint32 l = lo + numLeaves, r = hi + numLeaves; l < r;
+         l >>= 1, r >>= 1)
+    {
+        if (l & 1) {
+            heap.push(Entry(std::make_pair(scores[best[l]], -best[l]), l));
+            ++l;
+        }
+        if (r & 1) {
+            --r;
+            heap.push(Entry(std::make_pair(scores[best[r]], -best[r]), r));
+        }
+    }
+
+    while (!heap.empty() && (completions.size() < maxCompletions)) {
+        qint32 node = heap.top().second;
+        heap.pop();
+        if (node >= numLeaves) {
+            completions.append(words[node - numLeaves].toString());
+            continue;
+        }
+        for (qint32 child = 2 * node; child <= 2 * node + 1; ++child) {
+            qint32 word = best[child];
+            if (word >= 0)
+                heap.push(Entry(std::make_pair(scores[word], -word), child));
+        }
+    }
+    return completions;
+}
+
+//---------------------------------------------------------------------------
+//  isBetter
+//
+//! Determine whether one word ranks before another.
+//
+//! @param a the index of the first word, or -1 for none
+//! @param b the index of the second word, or -1 for none
+//! @return true if the first word ranks before the second, false otherwise
+//---------------------------------------------------------------------------
+bool
+CompletionIndex::isBetter(qint32 a, qint32 b) const
+{
+    if (a < 0)
+        return false;
+    if (b < 0)
+        return true;
+    if (scores[a] != scores[b])
+        return scores[a] > scores[b];
+    return a < b;
+}
@@ -0,0 +1,59 @@
+//---------------------------------------------------------------------------
+// CompletionIndex.h
+//
+// An index for finding the best-scoring completions of a prefix.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#ifndef ZYZZYVA_COMPLETION_INDEX_H
+#define ZYZZYVA_COMPLETION_INDEX_H
+
+#include "FixedWord.h"
+#include <QStringList>
+#include <QVector>
+
+// The words of a lexicon in sorted order, so the completions of any prefix
+// form a contiguous range, over a tree holding the best-scoring word of each
+// power-of-two block of the range.  The best completions are found by a
+// best-first walk of that tree, which visits only the blocks that can hold
+// one of them.
+class CompletionIndex
+{
+    public:
+    CompletionIndex() : numLeaves(0) { }
+    ~CompletionIndex() { }
+
+    void build(const QStringList& words, const QVector<double>& scores);
+    void clear();
+    bool isEmpty() const { return words.isEmpty(); }
+    int getNumWords() const { return words.size(); }
+    QStringList complete(const QString& prefix, int maxCompletions) const;
+
+    private:
+    bool isBetter(qint32 a, qint32 b) const;
+
+    private:
+    QVector<FixedWord> words;
+    QVector<double> scores;
+    QVector<qint32> best;
+    qint32 numLeaves;
+};
+
+#endif // ZYZZYVA_COMPLETION_INDEX_H
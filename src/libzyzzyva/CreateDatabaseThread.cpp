@@ -30,9 +30,7 @@
 #include "Defs.h"
 #include <QtSql>
 
-const int MAX_DEFINITION_LINKS = 3;
 const int PROGRESS_STEP = 1000;
-const QString DB_CONNECTION_NAME = "CreateDatabaseThread";
 
 using namespace Defs;
 
@@ -59,8 +57,10 @@ CreateDatabaseThread::runPrivate()
 
     {
         // Create empty database
+        // Each thread uses its own connection, so databases for several
+        // lexicons can be created at the same time
         QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE",
-                                                    DB_CONNECTION_NAME);
+                                                    dbConnectionName);
         db.setDatabaseName(dbFilename);
         if (!db.open()) {
             error = QString("Unable to open database file '%1':\n%2").arg(
@@ -126,6 +126,8 @@ CreateDatabaseThread::createTables(QSqlDatabase& db)
         "is_back_hook integer, lexicon_symbols text, "
         "definition text)");
 
+    query.exec("CREATE TABLE definition_links (word text, link text)");
+
     query.exec("CREATE TABLE db_version (version integer)");
     query.exec("INSERT into db_version (version) VALUES (" +
                QString::number(CURRENT_DATABASE_VERSION) + ")");
@@ -139,6 +141,11 @@ CreateDatabaseThread::createTables(QSqlDatabase& db)
     query.prepare("INSERT into lexicon_file (file) VALUES (?)");
     query.bindValue(0, wordEngine->getLexiconFile(lexiconName));
     query.exec();
+
+    query.exec("CREATE TABLE lexicon_hash (hash text)");
+    query.prepare("INSERT into lexicon_hash (hash) VALUES (?)");
+    query.bindValue(0, wordEngine->getLexiconHash(lexiconName));
+    query.exec();
 }
 
 //---------------------------------------------------------------------------
@@ -203,8 +210,9 @@ CreateDatabaseThread::createIndexes(QSqlDatabase& db)
     if (cancelled)
         return;
 
-    query.exec("CREATE INDEX definition_index on words "
-               "(definition)");
+    // Index on definition links table
+    query.exec("CREATE INDEX definition_link_index on definition_links "
+               "(link)");
     if (cancelled)
         return;
 }
@@ -221,6 +229,7 @@ void
 CreateDatabaseThread::insertWords(QSqlDatabase& db, int& stepNum)
 {
     LetterBag letterBag;
+    Alphabet alphabet = wordEngine->getAlphabet(lexiconName);
     QStringList letters;
     letters << "A" << "B" << "C" << "D" << "E" << "F" << "G" << "H" <<
         "I" << "J" << "K" << "L" << "M" << "N" << "O" << "P" << "Q" <<
@@ -273,12 +282,17 @@ CreateDatabaseThread::insertWords(QSqlDatabase& db, int& stepNum)
             double combinations0 = letterBag.getNumCombinations(word, 0);
             double combinations1 = letterBag.getNumCombinations(word, 1);
             double combinations2 = letterBag.getNumCombinations(word, 2);
-            int numUniqueLetters = Auxil::getNumUniqueLetters(word);
-            int numVowels = Auxil::getNumVowels(word);
 
+            // The alphabet holds every letter of the lexicon, so the word
+            // can always be coded
+            quint8 codes[MAX_WORD_LEN];
+            int numUniqueLetters = 0;
+            int numVowels = 0;
             int pointValue = 0;
-            for (int i = 0; i < word.length(); ++i) {
-                pointValue += letterBag.getLetterValue(word.at(i));
+            if (alphabet.encode(word, codes)) {
+                numUniqueLetters = alphabet.getNumUniqueLetters(codes, length);
+                numVowels = alphabet.getNumVowels(codes, length);
+                pointValue = alphabet.getPointValue(codes, length);
             }
 
             QString alphagram = Auxil::getAlphagram(word);
@@ -303,49 +317,24 @@ CreateDatabaseThread::insertWords(QSqlDatabase& db, int& stepNum)
             // Populate words and hooks with symbols
             QString symbolStr;
             if (!lexStyles.isEmpty()) {
-                QListIterator<LexiconStyle> it (lexStyles);
-                while (it.hasNext()) {
-                    const LexiconStyle& style = it.next();
-                    bool acceptable =
-                        wordEngine->isAcceptable(style.compareLexicon, word);
-                    if (!(acceptable ^ style.inCompareLexicon))
-                        symbolStr += style.symbol;
-                }
+                symbolStr = getLexiconSymbols(lexStyles, word);
 
                 // Populate front hooks with symbols
                 for (int i = 0; i < front.length(); ++i) {
                     QChar c = front[i];
-                    QString hookWord = c.toUpper() + word;
-
-                    it.toFront();
-                    while (it.hasNext()) {
-                        const LexiconStyle& style = it.next();
-                        bool acceptable = wordEngine->isAcceptable(
-                            style.compareLexicon, hookWord);
-
-                        if (!(acceptable ^ style.inCompareLexicon)) {
-                            front.insert(i + 1, style.symbol);
-                            i += style.symbol.length();
-                        }
-                    }
+                    QString hookSymbols =
+                        getLexiconSymbols(lexStyles, c.toUpper() + word);
+                    front.insert(i + 1, hookSymbols);
+                    i += hookSymbols.length();
                 }
 
                 // Populate back hooks with symbols
                 for (int i = 0; i < back.length(); ++i) {
                     QChar c = back[i];
-                    QString hookWord = word + c.toUpper();
-
-                    it.toFront();
-                    while (it.hasNext()) {
-                        const LexiconStyle& style = it.next();
-                        bool acceptable = wordEngine->isAcceptable(
-                            style.compareLexicon, hookWord);
-
-                        if (!(acceptable ^ style.inCompareLexicon)) {
-                            back.insert(i + 1, style.symbol);
-                            i += style.symbol.length();
-                        }
-                    }
+                    QString hookSymbols =
+                        getLexiconSymbols(lexStyles, word + c.toUpper());
+                    back.insert(i + 1, hookSymbols);
+                    i += hookSymbols.length();
                 }
             }
 
@@ -582,13 +571,16 @@ CreateDatabaseThread::cancel()
 void
 CreateDatabaseThread::cleanup()
 {
-    QSqlDatabase::removeDatabase(DB_CONNECTION_NAME);
+    QSqlDatabase::removeDatabase(dbConnectionName);
 }
 
 //---------------------------------------------------------------------------
 //  updateDefinitionLinks
 //
-//! Update links within definitions of words in the database.
+//! Record links within definitions of words in the database.  Definitions
+//! are stored with their links intact, and the links are replaced by
+//! WordEngine only when a definition is displayed.  The recorded links allow
+//! Definition searches to match text found in linked definitions.
 //
 //! @param db the database
 //! @param stepNum the current step number
@@ -601,35 +593,31 @@ CreateDatabaseThread::updateDefinitionLinks(QSqlDatabase& db, int& stepNum)
     if (cancelled)
         return;
 
-    QSqlQuery updateQuery (db);
-    updateQuery.prepare("UPDATE words SET definition=? WHERE word=?");
+    QSqlQuery insertQuery (db);
+    insertQuery.prepare("INSERT INTO definition_links (word, link) "
+                        "VALUES (?, ?)");
 
     QSqlQuery transactionQuery ("BEGIN TRANSACTION", db);
 
-    QSet<QString> alreadyReplaced;
+    QRegExp linkRegex (QString("[{<](\\w+)=\\w+[}>]"));
     QMapIterator<QString, QString> it (definitions);
     while (it.hasNext()) {
         it.next();
         QString word = it.key();
         QString definition = it.value();
 
-        QStringList defs = definition.split(WordEngine::DEF_ORIG_SEP);
-        QString newDefinition;
-        foreach (const QString& def, defs) {
-            if (!newDefinition.isEmpty())
-                newDefinition += WordEngine::DEF_DISPLAY_SEP;
-
-            alreadyReplaced.clear();
-            alreadyReplaced.insert(word.toUpper());
-
-            newDefinition += replaceDefinitionLinks(def, MAX_DEFINITION_LINKS,
-                &alreadyReplaced);
+        QSet<QString> links;
+        int index = 0;
+        while ((index = linkRegex.indexIn(definition, index)) >= 0) {
+            links.insert(linkRegex.cap(1).toUpper());
+            index += linkRegex.matchedLength();
         }
+        links.remove(word);
 
-        if (definition != newDefinition) {
-            updateQuery.bindValue(0, newDefinition);
-            updateQuery.bindValue(1, word);
-            updateQuery.exec();
+        foreach (const QString& link, links) {
+            insertQuery.bindValue(0, word);
+            insertQuery.bindValue(1, link);
+            insertQuery.exec();
         }
 
         ++stepNum;
@@ -683,121 +671,34 @@ CreateDatabaseThread::getDefinitions(QSqlDatabase& db, int& stepNum)
 }
 
 //---------------------------------------------------------------------------
-//  replaceDefinitionLinks
-//
-//! Replace links in a definition with the definitions of the words they are
-//! linked to.  A string is assumed to have a maximum of one link.  Links may
-//! be followed recursively to the maximum depth specified.
+//  getLexiconSymbols
 //
-//! @param definition the definition with links to be replaced
-//! @param maxDepth the maximum number of recursive links to replace
-//! @param useFollow true if the "follow" replacement should be used
-//
-//! @return a string with links replaced
-//---------------------------------------------------------------------------
-QString
-CreateDatabaseThread::replaceDefinitionLinks(const QString& definition,
-    int maxDepth, QSet<QString>* alreadyReplaced, bool useFollow) const
-{
-    QRegExp followRegex (QString("\\{(\\w+)=(\\w+)\\}"));
-    QRegExp replaceRegex (QString("\\<(\\w+)=(\\w+)\\>"));
-
-    bool createdSet = false;
-    if (!alreadyReplaced) {
-        alreadyReplaced = new QSet<QString>;
-        createdSet = true;
-    }
-
-    // Try to match the follow regex and the replace regex.  If a follow regex
-    // is ever matched, then the "follow" replacements should always be used,
-    // even if the "replace" regex is matched in a later iteration.
-    QRegExp* matchedRegex = 0;
-    int index = followRegex.indexIn(definition, 0);
-    if (index >= 0) {
-        matchedRegex = &followRegex;
-        useFollow = true;
-    }
-    else {
-        index = replaceRegex.indexIn(definition, 0);
-        matchedRegex = &replaceRegex;
-    }
-
-    if (index < 0)
-        return definition;
-
-    QString modified (definition);
-    QString word = matchedRegex->cap(1);
-    QString pos = matchedRegex->cap(2);
-
-    QString replacement;
-    QString upper = word.toUpper();
-    QString failReplacement = useFollow ? word : upper;
-    bool cutRecursion = !maxDepth || alreadyReplaced->contains(upper);
-    if (cutRecursion) {
-        replacement = failReplacement;
-    }
-    else {
-        QString subdef = getSubDefinition(upper, pos);
-        if (subdef.isEmpty()) {
-            replacement = failReplacement;
-            cutRecursion = true;
-        }
-        else if (useFollow) {
-            replacement = (matchedRegex == &followRegex) ?
-                word + " (" + subdef + ")" : subdef;
-        }
-        else {
-            replacement = upper + ", " + subdef;
-        }
-        alreadyReplaced->insert(upper);
-    }
-
-    modified.replace(index, matchedRegex->matchedLength(), replacement);
-    int lowerMaxDepth = useFollow ? maxDepth - 1 : maxDepth;
-    QString newDefinition = cutRecursion ? modified
-        : replaceDefinitionLinks(modified, lowerMaxDepth, alreadyReplaced,
-            useFollow);
-
-    if (createdSet) {
-        delete alreadyReplaced;
-    }
-
-    return newDefinition;
-}
-
-//---------------------------------------------------------------------------
-//  getSubDefinition
-//
-//! Return the definition associated with a word and a part of speech.  If
-//! more than one definition is given for a part of speech, pick the first
-//! one.
+//! Return the symbols to display with a word.  If the lexicon shares its
+//! word graph with the compared lexicons, membership in all of them is found
+//! with a single traversal.
 //
+//! @param styles the lexicon styles that apply to this lexicon
 //! @param word the word
-//! @param pos the part of speech
-//
-//! @return the definition substring
+//! @return the symbols of the styles matching the word
 //---------------------------------------------------------------------------
 QString
-CreateDatabaseThread::getSubDefinition(const QString& word, const QString&
-                                       pos) const
+CreateDatabaseThread::getLexiconSymbols(const QList<LexiconStyle>& styles,
+                                        const QString& word) const
 {
-    if (!definitions.contains(word))
-        return QString();
-
-    QString definition = definitions[word];
-    QRegExp posRegex (QString("\\[(\\w+)"));
-    QStringList defs = definition.split(WordEngine::DEF_ORIG_SEP);
-    foreach (const QString& def, defs) {
-        if ((posRegex.indexIn(def, 0) > 0) &&
-            (posRegex.cap(1) == pos))
-        {
-            QString str = def.left(def.indexOf("[")).simplified();
-            if (!str.isEmpty())
-                return str;
-        }
-    }
+    QMap<QString, bool> membership =
+        wordEngine->getSharedMembership(lexiconName, word);
 
-    return QString();
+    QString symbols;
+    QListIterator<LexiconStyle> it (styles);
+    while (it.hasNext()) {
+        const LexiconStyle& style = it.next();
+        bool acceptable = membership.contains(style.compareLexicon) ?
+            membership.value(style.compareLexicon) :
+            wordEngine->isAcceptable(style.compareLexicon, word);
+        if (!(acceptable ^ style.inCompareLexicon))
+            symbols += style.symbol;
+    }
+    return symbols;
 }
 
 //---------------------------------------------------------------------------
@@ -25,6 +25,8 @@
 #ifndef ZYZZYVA_CREATE_DATABASE_THREAD_H
 #define ZYZZYVA_CREATE_DATABASE_THREAD_H
 
+#include "LexiconStyle.h"
+#include <QList>
 #include <QMap>
 #include <QString>
 #include <QSqlDatabase>
@@ -39,7 +41,9 @@ class CreateDatabaseThread : public QThread
     CreateDatabaseThread(WordEngine* e, const QString& lex, const QString& db,
                          const QString& def, QObject* parent = 0)
         : QThread(parent), wordEngine(e), lexiconName(lex),
-          dbFilename(db), definitionFilename(def), cancelled(false) { }
+          dbFilename(db), definitionFilename(def),
+          dbConnectionName("CreateDatabaseThread_" + lex),
+          cancelled(false) { }
     ~CreateDatabaseThread() { }
 
     bool getCancelled() { return cancelled; }
@@ -69,9 +73,8 @@ class CreateDatabaseThread : public QThread
     void updateDefinitionLinks(QSqlDatabase& db, int& stepNum);
 
     void getDefinitions(QSqlDatabase& db, int& stepNum);
-    QString replaceDefinitionLinks(const QString& definition, int maxDepth,
-        QSet<QString>* alreadyReplaced = 0, bool useFollow = false) const;
-    QString getSubDefinition(const QString& word, const QString& pos) const;
+    QString getLexiconSymbols(const QList<LexiconStyle>& styles, const
+                              QString& word) const;
     int importPlayability(const QString& filename, QMap<QString, qint64>&
                           playabilityMap) const;
 
@@ -79,6 +82,7 @@ class CreateDatabaseThread : public QThread
     QString lexiconName;
     QString dbFilename;
     QString definitionFilename;
+    QString dbConnectionName;
     bool cancelled;
     QString error;
     QMap<QString, QString> definitions;
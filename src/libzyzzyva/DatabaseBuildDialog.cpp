@@ -0,0 +1,262 @@
+//---------------------------------------------------------------------------
+// DatabaseBuildDialog.cpp
+//
+// A dialog for showing the progress of lexicon database builds.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+
+#include "DatabaseBuildDialog.h"
+#include "DatabaseBuildScheduler.h"
+#include "Auxil.h"
+#include "Defs.h"
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+const QString DIALOG_CAPTION = "Creating Lexicon Databases";
+
+using namespace Defs;
+
+//---------------------------------------------------------------------------
+//  DatabaseBuildDialog
+//
+//! Constructor.
+//
+//! @param s the scheduler running the builds
+//! @param parent the parent widget
+//! @param f widget flags
+//---------------------------------------------------------------------------
+DatabaseBuildDialog::DatabaseBuildDialog(DatabaseBuildScheduler* s, QWidget*
+                                         parent, Qt::WFlags f)
+    : QDialog(parent, f), scheduler(s)
+{
+    QVBoxLayout* mainVlay = new QVBoxLayout(this);
+    mainVlay->setMargin(MARGIN);
+    mainVlay->setSpacing(SPACING);
+
+    QLabel* instructionLabel = new QLabel;
+    QString message = "Creating lexicon databases.  "
+        "This may take several minutes.";
+    message = Auxil::dialogWordWrap(message);
+    instructionLabel->setText(message);
+    mainVlay->addWidget(instructionLabel);
+
+    QGridLayout* buildGlay = new QGridLayout;
+    buildGlay->setSpacing(SPACING);
+    mainVlay->addLayout(buildGlay);
+
+    int row = 0;
+    foreach (const QString& lexicon, scheduler->getLexicons()) {
+        QLabel* lexiconLabel = new QLabel(lexicon);
+        buildGlay->addWidget(lexiconLabel, row, 0);
+
+        QProgressBar* progressBar = new QProgressBar;
+        progressBar->setRange(0, 100);
+        progressBar->setValue(0);
+        buildGlay->addWidget(progressBar, row, 1);
+        progressBars.insert(lexicon, progressBar);
+
+        QLabel* stateLabel = new QLabel(getWaitingText(lexicon));
+        buildGlay->addWidget(stateLabel, row, 2);
+        stateLabels.insert(lexicon, stateLabel);
+        ++row;
+    }
+
+    QHBoxLayout* totalHlay = new QHBoxLayout;
+    totalHlay->setSpacing(SPACING);
+    mainVlay->addLayout(totalHlay);
+
+    QLabel* totalLabel = new QLabel("Total:");
+    totalHlay->addWidget(totalLabel);
+
+    totalBar = new QProgressBar;
+    totalBar->setRange(0, 100);
+    totalBar->setValue(0);
+    totalHlay->addWidget(totalBar);
+
+    QHBoxLayout* buttonHlay = new QHBoxLayout;
+    buttonHlay->setSpacing(SPACING);
+    mainVlay->addLayout(buttonHlay);
+
+    buttonHlay->addStretch(1);
+
+    cancelButton = new QPushButton("&Cancel");
+    connect(cancelButton, SIGNAL(clicked()), SLOT(cancelClicked()));
+    buttonHlay->addWidget(cancelButton);
+
+    connect(scheduler, SIGNAL(buildStateChanged(const QString&, int)),
+            SLOT(buildStateChanged(const QString&, int)));
+    connect(scheduler, SIGNAL(buildProgress(const QString&, int, int)),
+            SLOT(buildProgress(const QString&, int, int)));
+    connect(scheduler, SIGNAL(totalProgress(int)),
+            SLOT(totalProgress(int)));
+    connect(scheduler, SIGNAL(finished()), SLOT(buildsFinished()));
+
+    setWindowTitle(DIALOG_CAPTION);
+}
+
+//---------------------------------------------------------------------------
+//  ~DatabaseBuildDialog
+//
+//! Destructor.
+//---------------------------------------------------------------------------
+DatabaseBuildDialog::~DatabaseBuildDialog()
+{
+}
+
+//---------------------------------------------------------------------------
+//  buildStateChanged
+//
+//! Called when the state of a build changes.
+//
+//! @param lexicon the lexicon name
+//! @param state the new build state
+//---------------------------------------------------------------------------
+void
+DatabaseBuildDialog::buildStateChanged(const QString& lexicon, int state)
+{
+    QLabel* stateLabel = stateLabels.value(lexicon);
+    if (!stateLabel)
+        return;
+
+    QString text;
+    switch (state) {
+        case DatabaseBuildScheduler::BuildRunning:
+        text = "Creating";
+        break;
+
+        case DatabaseBuildScheduler::BuildSucceeded:
+        text = "Done";
+        progressBars[lexicon]->setValue(progressBars[lexicon]->maximum());
+        break;
+
+        case DatabaseBuildScheduler::BuildFailed:
+        text = "Failed";
+        break;
+
+        case DatabaseBuildScheduler::BuildCancelled:
+        text = "Cancelled";
+        break;
+
+        default:
+        text = getWaitingText(lexicon);
+        break;
+    }
+
+    stateLabel->setText(text);
+}
+
+//---------------------------------------------------------------------------
+//  buildProgress
+//
+//! Called when a build makes progress.
+//
+//! @param lexicon the lexicon name
+//! @param value the number of steps completed
+//! @param steps the total number of steps
+//---------------------------------------------------------------------------
+void
+DatabaseBuildDialog::buildProgress(const QString& lexicon, int value, int
+                                   steps)
+{
+    QProgressBar* progressBar = progressBars.value(lexicon);
+    if (!progressBar || (steps <= 0))
+        return;
+
+    progressBar->setMaximum(steps);
+    progressBar->setValue(qMin(value, steps));
+}
+
+//---------------------------------------------------------------------------
+//  totalProgress
+//
+//! Called when the combined progress of all builds changes.
+//
+//! @param percent the percentage of work completed
+//---------------------------------------------------------------------------
+void
+DatabaseBuildDialog::totalProgress(int percent)
+{
+    totalBar->setValue(percent);
+}
+
+//---------------------------------------------------------------------------
+//  buildsFinished
+//
+//! Called when all builds have finished.  Close the dialog.
+//---------------------------------------------------------------------------
+void
+DatabaseBuildDialog::buildsFinished()
+{
+    accept();
+}
+
+//---------------------------------------------------------------------------
+//  getWaitingText
+//
+//! Return the state text for a lexicon whose build has not yet started,
+//! naming the lexicons it is waiting for.
+//
+//! @param lexicon the lexicon name
+//! @return the state text
+//---------------------------------------------------------------------------
+QString
+DatabaseBuildDialog::getWaitingText(const QString& lexicon) const
+{
+    QStringList dependencies = scheduler->getDependencies(lexicon);
+    if (dependencies.isEmpty())
+        return "Waiting";
+    return "Waiting for " + dependencies.join(", ");
+}
+
+//---------------------------------------------------------------------------
+//  cancelClicked
+//
+//! Called when the Cancel button is clicked.  Cancel all builds, and close
+//! the dialog once running builds have stopped.
+//---------------------------------------------------------------------------
+void
+DatabaseBuildDialog::cancelClicked()
+{
+    cancelButton->setEnabled(false);
+    scheduler->cancel();
+}
+
+//---------------------------------------------------------------------------
+//  reject
+//
+//! Called when the dialog is dismissed with the Escape key or the window
+//! close button.  Treat it as a request to cancel, since the dialog must stay
+//! open until running builds have stopped.
+//---------------------------------------------------------------------------
+void
+DatabaseBuildDialog::reject()
+{
+    if (scheduler->isFinished()) {
+        QDialog::reject();
+        return;
+    }
+
+    cancelClicked();
+}
@@ -0,0 +1,64 @@
+//---------------------------------------------------------------------------
+// DatabaseBuildDialog.h
+//
+// A dialog for showing the progress of lexicon database builds.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+
+#ifndef ZYZZYVA_DATABASE_BUILD_DIALOG_H
+#define ZYZZYVA_DATABASE_BUILD_DIALOG_H
+
+#include <QDialog>
+#include <QMap>
+
+class DatabaseBuildScheduler;
+class QLabel;
+class QProgressBar;
+class QPushButton;
+
+class DatabaseBuildDialog : public QDialog
+{
+    Q_OBJECT
+    public:
+    DatabaseBuildDialog(DatabaseBuildScheduler* s, QWidget* parent = 0,
+                        Qt::WFlags f = 0);
+    ~DatabaseBuildDialog();
+
+    public slots:
+    void buildStateChanged(const QString& lexicon, int state);
+    void buildProgress(const QString& lexicon, int value, int steps);
+    void totalProgress(int percent);
+    void buildsFinished();
+    void cancelClicked();
+    void reject();
+
+    private:
+    QString getWaitingText(const QString& lexicon) const;
+
+    private:
+    DatabaseBuildScheduler* scheduler;
+    QMap<QString, QLabel*> stateLabels;
+    QMap<QString, QProgressBar*> progressBars;
+    QProgressBar* totalBar;
+    QPushButton* cancelButton;
+};
+
+#endif // ZYZZYVA_DATABASE_BUILD_DIALOG_H
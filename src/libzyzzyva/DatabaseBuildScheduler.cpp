@@ -0,0 +1,455 @@
+//---------------------------------------------------------------------------
+// DatabaseBuildScheduler.cpp
+//
+// A class for building several lexicon databases at the same time.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+
+#include "DatabaseBuildScheduler.h"
+#include "CreateDatabaseThread.h"
+#include "LexiconStyle.h"
+#include "MainSettings.h"
+#include "WordEngine.h"
+#include <QThread>
+
+// Builds also compete for disk bandwidth, so run no more than this many at
+// once no matter how many cores are available
+const int MAX_CONCURRENT_BUILDS = 4;
+
+//---------------------------------------------------------------------------
+//  DatabaseBuildScheduler
+//
+//! Constructor.
+//
+//! @param e the word engine
+//! @param parent the parent object
+//---------------------------------------------------------------------------
+DatabaseBuildScheduler::DatabaseBuildScheduler(WordEngine* e, QObject*
+                                               parent)
+    : QObject(parent), wordEngine(e), maxRunning(getDefaultMaxRunning()),
+      cancelled(false), lastPercent(-1)
+{
+}
+
+//---------------------------------------------------------------------------
+//  ~DatabaseBuildScheduler
+//
+//! Destructor.  Cancel and wait for any builds still running.
+//---------------------------------------------------------------------------
+DatabaseBuildScheduler::~DatabaseBuildScheduler()
+{
+    QMutableMapIterator<QString, Build> it (builds);
+    while (it.hasNext()) {
+        it.next();
+        CreateDatabaseThread* thread = it.value().thread;
+        if (!thread)
+            continue;
+        thread->cancel();
+        thread->wait();
+        delete thread;
+    }
+}
+
+//---------------------------------------------------------------------------
+//  getDefaultMaxRunning
+//
+//! Determine how many builds to run at once by default.
+//
+//! @return the number of builds
+//---------------------------------------------------------------------------
+int
+DatabaseBuildScheduler::getDefaultMaxRunning()
+{
+    int cores = QThread::idealThreadCount();
+    return qMax(1, qMin(cores, MAX_CONCURRENT_BUILDS));
+}
+
+//---------------------------------------------------------------------------
+//  addBuild
+//
+//! Add a lexicon database to be built.  Must be called before start.
+//
+//! @param lexicon the lexicon name
+//! @param dbFilename the database file to create
+//! @param definitionFilename the file containing definitions
+//---------------------------------------------------------------------------
+void
+DatabaseBuildScheduler::addBuild(const QString& lexicon, const QString&
+                                 dbFilename, const QString&
+                                 definitionFilename)
+{
+    if (builds.contains(lexicon))
+        return;
+
+    Build build;
+    build.dbFilename = dbFilename;
+    build.definitionFilename = definitionFilename;
+    build.weight = qMax(1, wordEngine->getNumWords(lexicon));
+    builds.insert(lexicon, build);
+    lexicons.append(lexicon);
+}
+
+//---------------------------------------------------------------------------
+//  getDependencies
+//
+//! Return the lexicons whose builds must finish before a lexicon's build
+//! starts.  A lexicon depends on the compare lexicons of its lexicon styles,
+//! since its lexicon symbols are computed against them.
+//
+//! @param lexicon the lexicon name
+//! @return the lexicons it depends on
+//---------------------------------------------------------------------------
+QStringList
+DatabaseBuildScheduler::getDependencies(const QString& lexicon) const
+{
+    QStringList dependencies;
+    if (!builds.contains(lexicon))
+        return dependencies;
+
+    QList<LexiconStyle> lexStyles = MainSettings::getWordListLexiconStyles();
+    foreach (const LexiconStyle& style, lexStyles) {
+        if (!style.isValid() || (style.lexicon != lexicon) ||
+            !builds.contains(style.compareLexicon) ||
+            dependencies.contains(style.compareLexicon))
+        {
+            continue;
+        }
+        dependencies.append(style.compareLexicon);
+    }
+    return dependencies;
+}
+
+//---------------------------------------------------------------------------
+//  getState
+//
+//! Return the state of a lexicon's build.
+//
+//! @param lexicon the lexicon name
+//! @return the build state
+//---------------------------------------------------------------------------
+DatabaseBuildScheduler::BuildState
+DatabaseBuildScheduler::getState(const QString& lexicon) const
+{
+    return builds.value(lexicon).state;
+}
+
+//---------------------------------------------------------------------------
+//  getError
+//
+//! Return the error encountered by a lexicon's build.
+//
+//! @param lexicon the lexicon name
+//! @return the error, or an empty string if there was none
+//---------------------------------------------------------------------------
+QString
+DatabaseBuildScheduler::getError(const QString& lexicon) const
+{
+    return builds.value(lexicon).error;
+}
+
+//---------------------------------------------------------------------------
+//  isFinished
+//
+//! Determine whether all builds have finished.
+//
+//! @return true if no builds are pending or running, false otherwise
+//---------------------------------------------------------------------------
+bool
+DatabaseBuildScheduler::isFinished() const
+{
+    QMapIterator<QString, Build> it (builds);
+    while (it.hasNext()) {
+        it.next();
+        BuildState state = it.value().state;
+        if ((state == BuildPending) || (state == BuildRunning))
+            return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  start
+//
+//! Work out the order of the builds and start as many as allowed.
+//---------------------------------------------------------------------------
+void
+DatabaseBuildScheduler::start()
+{
+    foreach (const QString& lexicon, lexicons)
+        builds[lexicon].dependencies = getDependencies(lexicon);
+
+    updateTotalProgress();
+    startReadyBuilds();
+
+    if (isFinished())
+        emit finished();
+}
+
+//---------------------------------------------------------------------------
+//  cancel
+//
+//! Cancel all running builds, and do not start any pending ones.
+//---------------------------------------------------------------------------
+void
+DatabaseBuildScheduler::cancel()
+{
+    cancelled = true;
+    foreach (const QString& lexicon, lexicons) {
+        Build& build = builds[lexicon];
+        if (build.state == BuildPending)
+            setState(lexicon, BuildCancelled);
+        else if ((build.state == BuildRunning) && build.thread)
+            build.thread->cancel();
+    }
+
+    if (isFinished())
+        emit finished();
+}
+
+//---------------------------------------------------------------------------
+//  threadSteps
+//
+//! Called when a build thread reports its total number of steps.
+//
+//! @param steps the number of steps
+//---------------------------------------------------------------------------
+void
+DatabaseBuildScheduler::threadSteps(int steps)
+{
+    QString lexicon = getThreadLexicon();
+    if (lexicon.isEmpty())
+        return;
+
+    Build& build = builds[lexicon];
+    build.steps = steps;
+    emit buildProgress(lexicon, build.value, build.steps);
+    updateTotalProgress();
+}
+
+//---------------------------------------------------------------------------
+//  threadProgress
+//
+//! Called when a build thread reports progress.
+//
+//! @param value the number of steps completed
+//---------------------------------------------------------------------------
+void
+DatabaseBuildScheduler::threadProgress(int value)
+{
+    QString lexicon = getThreadLexicon();
+    if (lexicon.isEmpty())
+        return;
+
+    Build& build = builds[lexicon];
+    build.value = value;
+    emit buildProgress(lexicon, build.value, build.steps);
+    updateTotalProgress();
+}
+
+//---------------------------------------------------------------------------
+//  threadFinished
+//
+//! Called when a build thread finishes.  Record the result and start any
+//! builds that were waiting for it.
+//---------------------------------------------------------------------------
+void
+DatabaseBuildScheduler::threadFinished()
+{
+    QString lexicon = getThreadLexicon();
+    if (lexicon.isEmpty())
+        return;
+
+    Build& build = builds[lexicon];
+    CreateDatabaseThread* thread = build.thread;
+    build.thread = 0;
+    build.error = thread->getError();
+
+    BuildState state = BuildSucceeded;
+    if (!build.error.isEmpty())
+        state = BuildFailed;
+    else if (thread->getCancelled())
+        state = BuildCancelled;
+    thread->deleteLater();
+
+    if (state == BuildSucceeded)
+        build.value = build.steps;
+    setState(lexicon, state);
+    updateTotalProgress();
+
+    if (!cancelled)
+        startReadyBuilds();
+
+    if (isFinished())
+        emit finished();
+}
+
+//---------------------------------------------------------------------------
+//  startReadyBuilds
+//
+//! Start pending builds whose dependencies have all finished, up to the
+//! maximum number of running builds.
+//---------------------------------------------------------------------------
+void
+DatabaseBuildScheduler::startReadyBuilds()
+{
+    int numRunning = getNumRunning();
+    QString firstPending;
+    foreach (const QString& lexicon, lexicons) {
+        if (numRunning >= maxRunning)
+            return;
+
+        const Build& build = builds[lexicon];
+        if (build.state != BuildPending)
+            continue;
+        if (firstPending.isEmpty())
+            firstPending = lexicon;
+
+        bool ready = true;
+        foreach (const QString& dependency, build.dependencies) {
+            BuildState depState = builds[dependency].state;
+            if ((depState == BuildPending) || (depState == BuildRunning)) {
+                ready = false;
+                break;
+            }
+        }
+
+        if (ready) {
+            startBuild(lexicon);
+            ++numRunning;
+        }
+    }
+
+    // Lexicons that compare against each other can never become ready, so
+    // break the cycle by starting one of them
+    if (!numRunning && !firstPending.isEmpty())
+        startBuild(firstPending);
+}
+
+//---------------------------------------------------------------------------
+//  startBuild
+//
+//! Start building a lexicon database.
+//
+//! @param lexicon the lexicon name
+//---------------------------------------------------------------------------
+void
+DatabaseBuildScheduler::startBuild(const QString& lexicon)
+{
+    Build& build = builds[lexicon];
+    build.thread = new CreateDatabaseThread(wordEngine, lexicon,
+        build.dbFilename, build.definitionFilename);
+    connect(build.thread, SIGNAL(steps(int)), SLOT(threadSteps(int)));
+    connect(build.thread, SIGNAL(progress(int)), SLOT(threadProgress(int)));
+    connect(build.thread, SIGNAL(finished()), SLOT(threadFinished()));
+
+    setState(lexicon, BuildRunning);
+    build.thread->start(QThread::LowPriority);
+}
+
+//---------------------------------------------------------------------------
+//  setState
+//
+//! Set the state of a lexicon's build.
+//
+//! @param lexicon the lexicon name
+//! @param state the new state
+//---------------------------------------------------------------------------
+void
+DatabaseBuildScheduler::setState(const QString& lexicon, BuildState state)
+{
+    builds[lexicon].state = state;
+    emit buildStateChanged(lexicon, state);
+}
+
+//---------------------------------------------------------------------------
+//  updateTotalProgress
+//
+//! Compute the combined progress of all builds, weighting each build by the
+//! number of words in its lexicon, and report it if it has changed.
+//---------------------------------------------------------------------------
+void
+DatabaseBuildScheduler::updateTotalProgress()
+{
+    double total = 0;
+    double done = 0;
+    QMapIterator<QString, Build> it (builds);
+    while (it.hasNext()) {
+        it.next();
+        const Build& build = it.value();
+        total += build.weight;
+        if (build.state == BuildPending)
+            continue;
+        else if (build.state != BuildRunning)
+            done += build.weight;
+        else if (build.steps > 0)
+            done += build.weight * qMin(1.0, double(build.value) / build.steps);
+    }
+
+    int percent = (total > 0) ? int(100 * done / total) : 100;
+    if (percent == lastPercent)
+        return;
+
+    lastPercent = percent;
+    emit totalProgress(percent);
+}
+
+//---------------------------------------------------------------------------
+//  getNumRunning
+//
+//! Return the number of builds currently running.
+//
+//! @return the number of running builds
+//---------------------------------------------------------------------------
+int
+DatabaseBuildScheduler::getNumRunning() const
+{
+    int numRunning = 0;
+    QMapIterator<QString, Build> it (builds);
+    while (it.hasNext()) {
+        it.next();
+        if (it.value().state == BuildRunning)
+            ++numRunning;
+    }
+    return numRunning;
+}
+
+//---------------------------------------------------------------------------
+//  getThreadLexicon
+//
+//! Return the lexicon built by the thread that sent the current signal.
+//
+//! @return the lexicon name, or an empty string if not found
+//---------------------------------------------------------------------------
+QString
+DatabaseBuildScheduler::getThreadLexicon() const
+{
+    const QObject* thread = sender();
+    if (!thread)
+        return QString();
+
+    QMapIterator<QString, Build> it (builds);
+    while (it.hasNext()) {
+        it.next();
+        if (it.value().thread == thread)
+            return it.key();
+    }
+    return QString();
+}
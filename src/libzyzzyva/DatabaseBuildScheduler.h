@@ -0,0 +1,112 @@
+//---------------------------------------------------------------------------
+// DatabaseBuildScheduler.h
+//
+// A class for building several lexicon databases at the same time.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+
+#ifndef ZYZZYVA_DATABASE_BUILD_SCHEDULER_H
+#define ZYZZYVA_DATABASE_BUILD_SCHEDULER_H
+
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class CreateDatabaseThread;
+class WordEngine;
+
+class DatabaseBuildScheduler : public QObject
+{
+    Q_OBJECT
+    public:
+    enum BuildState {
+        BuildPending,
+        BuildRunning,
+        BuildSucceeded,
+        BuildFailed,
+        BuildCancelled
+    };
+
+    public:
+    DatabaseBuildScheduler(WordEngine* e, QObject* parent = 0);
+    ~DatabaseBuildScheduler();
+
+    static int getDefaultMaxRunning();
+
+    void addBuild(const QString& lexicon, const QString& dbFilename,
+                  const QString& definitionFilename);
+    void setMaxRunning(int max) { maxRunning = qMax(1, max); }
+    QStringList getLexicons() const { return lexicons; }
+    QStringList getDependencies(const QString& lexicon) const;
+    BuildState getState(const QString& lexicon) const;
+    QString getError(const QString& lexicon) const;
+    bool isFinished() const;
+
+    public slots:
+    void start();
+    void cancel();
+
+    signals:
+    void buildStateChanged(const QString& lexicon, int state);
+    void buildProgress(const QString& lexicon, int value, int steps);
+    void totalProgress(int percent);
+    void finished();
+
+    private slots:
+    void threadSteps(int steps);
+    void threadProgress(int value);
+    void threadFinished();
+
+    private:
+    class Build {
+        public:
+        Build() : thread(0), state(BuildPending), weight(1), steps(0),
+                  value(0) { }
+        QString dbFilename;
+        QString definitionFilename;
+        QStringList dependencies;
+        CreateDatabaseThread* thread;
+        BuildState state;
+        int weight;
+        int steps;
+        int value;
+        QString error;
+    };
+
+    private:
+    void startReadyBuilds();
+    void startBuild(const QString& lexicon);
+    void setState(const QString& lexicon, BuildState state);
+    void updateTotalProgress();
+    int getNumRunning() const;
+    QString getThreadLexicon() const;
+
+    private:
+    WordEngine* wordEngine;
+    QStringList lexicons;
+    QMap<QString, Build> builds;
+    int maxRunning;
+    bool cancelled;
+    int lastPercent;
+};
+
+#endif // ZYZZYVA_DATABASE_BUILD_SCHEDULER_H
@@ -0,0 +1,297 @@
+//---------------------------------------------------------------------------
+// DawgBuilder.cpp
+//
+// A class for building Directed Acyclic Word Graphs.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "DawgBuilder.h"
+
+const qint32 TERMINAL_NODE = 0;
+const qint32 ROOT_NODE = 1;
+
+const qint32 V_END_OF_WORD = 23;
+const qint32 M_END_OF_WORD = (1L << V_END_OF_WORD);
+const qint32 V_END_OF_NODE = 22;
+const qint32 M_END_OF_NODE = (1L << V_END_OF_NODE);
+
+const qint32 V_LETTER       = 24;
+const qint32 M_LETTER       = 0xFF;
+const qint32 M_NODE_POINTER = 0x1FFFFFL;
+
+//---------------------------------------------------------------------------
+//  build
+//
+//! Build a minimal DAWG from a list of words.  The resulting edge array uses
+//! the same layout as the DAWG files generated by dawgutils and read by
+//! WordGraph: the first element is an unused terminal entry, and the edges of
+//! the root node begin at index 1.
+//
+//! @param words the list of words
+//! @param reverse whether to build the graph from reversed words
+//! @param edges return the edge array
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+DawgBuilder::build(const QStringList& words, bool reverse, QVector<qint32>*
+                   edges, QString* errString)
+{
+    if (!edges)
+        return false;
+
+    QMap<QByteArray, quint8> wordMasks;
+    foreach (const QString& word, words) {
+        if (!word.isEmpty())
+            wordMasks.insert(getWordBytes(word, reverse), 1);
+    }
+
+    return buildGraph(wordMasks, edges, 0, errString);
+}
+
+//---------------------------------------------------------------------------
+//  buildShared
+//
+//! Build a single minimal DAWG holding the words of several lexicons, along
+//! with a mask for each edge telling which lexicons it belongs to.  The low
+//! byte of each mask has a bit set for each lexicon with words continuing
+//! past the edge, and the high byte has a bit set for each lexicon in which
+//! the word ending at the edge is valid.  Bit N stands for the Nth list of
+//! words.  Nodes are only merged if their masks agree, so each mask is the
+//! same for every path through the edge.
+//
+//! @param lexiconWords the list of words for each lexicon, at most eight
+//! @param reverse whether to build the graph from reversed words
+//! @param edges return the edge array
+//! @param masks return the edge masks, indexed like the edge array
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+DawgBuilder::buildShared(const QList<QStringList>& lexiconWords, bool
+                         reverse, QVector<qint32>* edges, QVector<quint16>*
+                         masks, QString* errString)
+{
+    if (!edges || !masks)
+        return false;
+
+    if (lexiconWords.count() > 8) {
+        if (errString)
+            *errString = "Too many lexicons to share a word graph.";
+        return false;
+    }
+
+    QMap<QByteArray, quint8> wordMasks;
+    for (int i = 0; i < lexiconWords.count(); ++i) {
+        foreach (const QString& word, lexiconWords[i]) {
+            if (!word.isEmpty())
+                wordMasks[getWordBytes(word, reverse)] |= (1 << i);
+        }
+    }
+
+    return buildGraph(wordMasks, edges, masks, errString);
+}
+
+//---------------------------------------------------------------------------
+//  getWordBytes
+//
+//! Convert a word to the uppercase Latin-1 bytes stored in the graph.
+//
+//! @param word the word
+//! @param reverse whether to reverse the word
+//! @return the bytes
+//---------------------------------------------------------------------------
+QByteArray
+DawgBuilder::getWordBytes(const QString& word, bool reverse)
+{
+    QByteArray bytes = word.toUpper().toLatin1();
+    if (reverse) {
+        int len = bytes.length();
+        for (int i = 0; i < len / 2; ++i) {
+            char c = bytes[i];
+            bytes[i] = bytes[len - i - 1];
+            bytes[len - i - 1] = c;
+        }
+    }
+    return bytes;
+}
+
+//---------------------------------------------------------------------------
+//  buildGraph
+//
+//! Build a minimal DAWG from a sorted map of words to lexicon masks.
+//
+//! @param words the words and their lexicon masks
+//! @param edges return the edge array
+//! @param masks return the edge masks, if not null
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+DawgBuilder::buildGraph(const QMap<QByteArray, quint8>& words,
+                        QVector<qint32>* edges, QVector<quint16>* masks,
+                        QString* errString)
+{
+    if (words.isEmpty()) {
+        if (errString)
+            *errString = "No words to build a word graph from.";
+        return false;
+    }
+
+    nodes.clear();
+    uniqueNodes.clear();
+    registry.clear();
+    nodes.append(TrieNode());
+    QMapIterator<QByteArray, quint8> wit (words);
+    while (wit.hasNext()) {
+        wit.next();
+        addWord(wit.key(), wit.value());
+    }
+
+    int root = minimize(0);
+    nodes.clear();
+    registry.clear();
+
+    // Lay out the root node first, followed by all other nodes
+    QVector<qint32> offsets (uniqueNodes.count());
+    qint32 offset = ROOT_NODE;
+    offsets[root] = offset;
+    offset += uniqueNodes[root].edges.count();
+    for (int i = 0; i < uniqueNodes.count(); ++i) {
+        if (i == root)
+            continue;
+        offsets[i] = offset;
+        offset += uniqueNodes[i].edges.count();
+    }
+
+    if (offset - 1 > M_NODE_POINTER) {
+        if (errString)
+            *errString = "Too many edges in word graph.";
+        uniqueNodes.clear();
+        return false;
+    }
+
+    edges->fill(0, offset);
+    (*edges)[0] = TERMINAL_NODE;
+    if (masks)
+        masks->fill(0, offset);
+    for (int i = 0; i < uniqueNodes.count(); ++i) {
+        const QList<TrieEdge>& nodeEdges = uniqueNodes[i].edges;
+        qint32 pos = offsets[i];
+        for (int j = 0; j < nodeEdges.count(); ++j) {
+            const TrieEdge& edge = nodeEdges[j];
+            qint32 value = (qint32(uchar(edge.letter)) & M_LETTER) << V_LETTER;
+            if (edge.eowMask)
+                value |= M_END_OF_WORD;
+            if (j == nodeEdges.count() - 1)
+                value |= M_END_OF_NODE;
+            if (edge.child >= 0)
+                value |= (offsets[edge.child] & M_NODE_POINTER);
+            (*edges)[pos + j] = value;
+            if (masks)
+                (*masks)[pos + j] = (quint16(edge.eowMask) << 8) |
+                    edge.childMask;
+        }
+    }
+
+    uniqueNodes.clear();
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  addWord
+//
+//! Add a word to the trie.  Words must be added in sorted order.
+//
+//! @param word the word to add
+//! @param mask the lexicons the word belongs to
+//---------------------------------------------------------------------------
+void
+DawgBuilder::addWord(const QByteArray& word, quint8 mask)
+{
+    int node = 0;
+    for (int i = 0; i < word.length(); ++i) {
+        char letter = word.at(i);
+        bool last = (i == word.length() - 1);
+
+        // Words are sorted, so a matching edge can only be the last one
+        QList<TrieEdge>& edges = nodes[node].edges;
+        if (edges.isEmpty() || (edges.last().letter != letter))
+            edges.append(TrieEdge(letter));
+
+        if (last) {
+            nodes[node].edges.last().eowMask |= mask;
+            break;
+        }
+
+        nodes[node].edges.last().childMask |= mask;
+
+        int child = nodes[node].edges.last().child;
+        if (child < 0) {
+            child = nodes.count();
+            nodes.append(TrieNode());
+            nodes[node].edges.last().child = child;
+        }
+        node = child;
+    }
+}
+
+//---------------------------------------------------------------------------
+//  minimize
+//
+//! Replace a trie node and all nodes below it with their unique
+//! equivalents, merging nodes with identical outgoing edges.
+//
+//! @param node the trie node index
+//! @return the index of the unique node, or -1 if the node has no edges
+//---------------------------------------------------------------------------
+int
+DawgBuilder::minimize(int node)
+{
+    if (node < 0)
+        return -1;
+
+    TrieNode unique;
+    QByteArray signature;
+    int numEdges = nodes[node].edges.count();
+    for (int i = 0; i < numEdges; ++i) {
+        TrieEdge edge = nodes[node].edges[i];
+        edge.child = minimize(edge.child);
+        unique.edges.append(edge);
+
+        signature.append(edge.letter);
+        signature.append(char(edge.eowMask));
+        signature.append(char(edge.childMask));
+        signature.append(QByteArray::number(edge.child));
+        signature.append(',');
+    }
+
+    if (unique.edges.isEmpty())
+        return -1;
+
+    QHash<QByteArray, int>::const_iterator it = registry.find(signature);
+    if (it != registry.end())
+        return it.value();
+
+    int index = uniqueNodes.count();
+    uniqueNodes.append(unique);
+    registry.insert(signature, index);
+    return index;
+}
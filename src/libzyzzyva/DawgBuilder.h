@@ -0,0 +1,79 @@
+//---------------------------------------------------------------------------
+// DawgBuilder.h
+//
+// A class for building Directed Acyclic Word Graphs.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#ifndef ZYZZYVA_DAWG_BUILDER_H
+#define ZYZZYVA_DAWG_BUILDER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class DawgBuilder
+{
+    public:
+    DawgBuilder() { }
+    ~DawgBuilder() { }
+
+    bool build(const QStringList& words, bool reverse, QVector<qint32>*
+               edges, QString* errString = 0);
+    bool buildShared(const QList<QStringList>& lexiconWords, bool reverse,
+                     QVector<qint32>* edges, QVector<quint16>* masks,
+                     QString* errString = 0);
+
+    private:
+    // The masks hold one bit per lexicon.  eowMask marks the lexicons in
+    // which the word ending at the edge is valid, and childMask marks the
+    // lexicons with valid words continuing past the edge.
+    class TrieEdge {
+        public:
+        TrieEdge(char l = 0, int c = -1)
+            : letter(l), eowMask(0), childMask(0), child(c) { }
+        char letter;
+        quint8 eowMask;
+        quint8 childMask;
+        int child;
+    };
+
+    class TrieNode {
+        public:
+        QList<TrieEdge> edges;
+    };
+
+    private:
+    static QByteArray getWordBytes(const QString& word, bool reverse);
+    bool buildGraph(const QMap<QByteArray, quint8>& words, QVector<qint32>*
+                    edges, QVector<quint16>* masks, QString* errString);
+    void addWord(const QByteArray& word, quint8 mask);
+    int minimize(int node);
+
+    QVector<TrieNode> nodes;
+    QVector<TrieNode> uniqueNodes;
+    QHash<QByteArray, int> registry;
+};
+
+#endif // ZYZZYVA_DAWG_BUILDER_H
@@ -40,6 +40,24 @@ using namespace Defs;
 const QString TITLE_PREFIX = "Definition";
 const QString NONE_STR = "(none)";
 
+//---------------------------------------------------------------------------
+//  appendSymbols
+//
+//! Append lexicon symbols from a word profile to each word in a list.
+//
+//! @param words the list of words
+//! @param profile the word profile containing lexicon symbols
+//---------------------------------------------------------------------------
+void
+appendSymbols(QStringList& words, const WordEngine::WordProfile& profile)
+{
+    QMutableListIterator<QString> it (words);
+    while (it.hasNext()) {
+        QString& str = it.next();
+        str.append(profile.lexiconSymbols.value(str));
+    }
+}
+
 //---------------------------------------------------------------------------
 //  DefineForm
 //
@@ -77,6 +95,7 @@ DefineForm::DefineForm(WordEngine* e, QWidget* parent, Qt::WFlags f)
 
     wordLine = new WordLineEdit;
     wordLine->setValidator(new WordValidator(wordLine));
+    wordLine->setWordCompletion(true);
     connect(wordLine, SIGNAL(textChanged(const QString&)),
             SLOT(wordChanged(const QString&)));
     connect(wordLine, SIGNAL(returnPressed()), SLOT(displayDefinition()));
@@ -187,6 +206,7 @@ DefineForm::lexiconActivated(const QString& lexicon)
 {
     detailsString = Auxil::lexiconToDetails(lexicon);
     emit detailsChanged(detailsString);
+    wordLine->setWordHints(engine, lexicon);
 }
 
 //---------------------------------------------------------------------------
@@ -245,49 +265,34 @@ DefineForm::displayInfo(bool allInfo)
     QString lexicon = lexiconWidget->getCurrentLexicon();
     bool showSymbols = MainSettings::getWordListUseLexiconStyles();
 
-    bool acceptable = engine->isAcceptable(lexicon, word);
-    QString resultStr = acceptable ?
+    WordEngine::WordProfile profile =
+        engine->getWordProfile(lexicon, word, allInfo);
+    QString resultStr = profile.acceptable ?
                         QString("<font color=\"blue\">Acceptable</font>") :
                         QString("<font color=\"red\">Unacceptable</font>");
 
-    // FIXME: if the word is acceptable, get as much information as possible
-    // from WordEngine::getWordInfo, not getDefinition, etc. separately
-
     // Get definition
-    QString definition;
-    if (acceptable) {
+    if (profile.acceptable) {
         resultStr += "<br>";
         if (allInfo)
             resultStr += "<b>Definition:</b> ";
-        definition = engine->getDefinition(lexicon, word);
+        QString definition = profile.definition;
         if (definition.isEmpty())
             definition = EMPTY_DEFINITION;
         resultStr += definition;
     }
 
     if (allInfo) {
-        SearchSpec spec;
-        SearchCondition condition;
-
         // Get anagrams
-        condition.type = SearchCondition::AnagramMatch;
-        condition.stringValue = word;
-        spec.conditions.append(condition);
-        QStringList anagrams = engine->search(lexicon, spec, true);
-        anagrams.removeAll(word);
-        if (showSymbols) {
-            QMutableListIterator<QString> it (anagrams);
-            while (it.hasNext()) {
-                QString& anagram = it.next();
-                anagram.append(engine->getLexiconSymbols(lexicon, anagram));
-            }
-        }
+        QStringList anagrams = profile.anagrams;
+        if (showSymbols)
+            appendSymbols(anagrams, profile);
         QString anagramsStr = anagrams.isEmpty() ? NONE_STR :
             QString("(%1): ").arg(anagrams.count()) + anagrams.join(", ");
         resultStr += "<br><b>Anagrams:</b> " + anagramsStr;
 
         // Get front hooks
-        QString fHooks = engine->getFrontHookLetters(lexicon, word).toUpper();
+        QString fHooks = profile.frontHooks.toUpper();
         if (!showSymbols)
             fHooks.replace(QRegExp("[\\W_\\d]+"), QString());
         QString fHookStr = fHooks.isEmpty() ? NONE_STR :
@@ -295,7 +300,7 @@ DefineForm::displayInfo(bool allInfo)
         resultStr += "<br><b>Front Hooks:</b> " + fHookStr;
 
         // Get back hooks
-        QString bHooks = engine->getBackHookLetters(lexicon, word).toUpper();
+        QString bHooks = profile.backHooks.toUpper();
         if (!showSymbols)
             bHooks.replace(QRegExp("[\\W_\\d]+"), QString());
         QString bHookStr = bHooks.isEmpty() ? NONE_STR :
@@ -303,18 +308,9 @@ DefineForm::displayInfo(bool allInfo)
         resultStr += "<br><b>Back Hooks:</b> " + bHookStr;
 
         // Get front extensions
-        spec.conditions.clear();
-        condition.type = SearchCondition::PatternMatch;
-        condition.stringValue = "*?" + word;
-        spec.conditions.append(condition);
-        QStringList fExts = engine->search(lexicon, spec, true);
-        if (showSymbols) {
-            QMutableListIterator<QString> it (fExts);
-            while (it.hasNext()) {
-                QString& fExt = it.next();
-                fExt.append(engine->getLexiconSymbols(lexicon, fExt));
-            }
-        }
+        QStringList fExts = profile.frontExtensions;
+        if (showSymbols)
+            appendSymbols(fExts, profile);
         QString fExtStr = fExts.isEmpty() ? NONE_STR :
             QString("(%1): ").arg(fExts.count()) +
             fExts.replaceInStrings(
@@ -322,36 +318,18 @@ DefineForm::displayInfo(bool allInfo)
         resultStr += "<br><b>Front Extensions:</b> " + fExtStr;
 
         // Get back extensions
-        spec.conditions.clear();
-        condition.type = SearchCondition::PatternMatch;
-        condition.stringValue = word + "?*";
-        spec.conditions.append(condition);
-        QStringList bExts = engine->search(lexicon, spec, true);
-        if (showSymbols) {
-            QMutableListIterator<QString> it (bExts);
-            while (it.hasNext()) {
-                QString& bExt = it.next();
-                bExt.append(engine->getLexiconSymbols(lexicon, bExt));
-            }
-        }
+        QStringList bExts = profile.backExtensions;
+        if (showSymbols)
+            appendSymbols(bExts, profile);
         QString bExtStr = bExts.isEmpty() ? NONE_STR :
             QString("(%1): ").arg(bExts.count()) +
             bExts.replaceInStrings(QRegExp("^" + word), "-").join(", ");
         resultStr += "<br><b>Back Extensions:</b> " + bExtStr;
 
         // Get double extensions
-        spec.conditions.clear();
-        condition.type = SearchCondition::PatternMatch;
-        condition.stringValue = "*?" + word + "?*";
-        spec.conditions.append(condition);
-        QStringList dExts = engine->search(lexicon, spec, true);
-        if (showSymbols) {
-            QMutableListIterator<QString> it (dExts);
-            while (it.hasNext()) {
-                QString& dExt = it.next();
-                dExt.append(engine->getLexiconSymbols(lexicon, dExt));
-            }
-        }
+        QStringList dExts = profile.doubleExtensions;
+        if (showSymbols)
+            appendSymbols(dExts, profile);
         QString dExtStr = dExts.isEmpty() ? NONE_STR :
             QString("(%1): ").arg(dExts.count()) +
             dExts.replaceInStrings(QRegExp(word), "-").join(", ");
@@ -361,7 +339,7 @@ DefineForm::displayInfo(bool allInfo)
     resultBox->setText(resultStr);
 
     if (showSymbols)
-        word += engine->getLexiconSymbols(lexicon, word);
+        word += profile.lexiconSymbols.value(word);
 
     resultBox->setTitle(word);
     resultBox->show();
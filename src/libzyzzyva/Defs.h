@@ -30,12 +30,13 @@
 
 namespace Defs {
     const QString ZYZZYVA_VERSION = "2.3.0";
-    const int CURRENT_DATABASE_VERSION = 4;
+    const int CURRENT_DATABASE_VERSION = 5;
     const QString IMPORT_CHOOSER_TITLE = "Choose a Word List";
     const QString EMPTY_DEFINITION = "(no definition)";
     const int DEFINITION_WRAP_LENGTH = 80;
     const int MAX_WORD_LEN = 15;
     const int MAX_BLANKS = 2;
+    const int DRAW_PROBABILITY_SCALE = 1000000000;
     const int MAX_INPUT_LINE_LEN = 640;
     const int SPACING = 4;
     const int MARGIN = 4;
@@ -0,0 +1,166 @@
+//---------------------------------------------------------------------------
+// FixedWord.cpp
+//
+// A fixed-capacity word value stored inline in sixteen bytes.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "FixedWord.h"
+#include <QChar>
+
+//---------------------------------------------------------------------------
+//  FixedWord
+//
+//! Constructor.  Characters beyond the capacity, or outside Latin-1, are not
+//! representable; callers should check canHold first when the string may
+//! come from user input.
+//
+//! @param str the string
+//---------------------------------------------------------------------------
+FixedWord::FixedWord(const QString& str)
+{
+    clear();
+    int len = qMin(str.length(), int(CAPACITY));
+    for (int i = 0; i < len; ++i)
+        bytes[i] = str.at(i).toLatin1();
+    bytes[CAPACITY] = char(len);
+}
+
+//---------------------------------------------------------------------------
+//  canHold
+//
+//! Determine whether a string can be represented exactly.
+//
+//! @param str the string
+//! @return true if the string fits, false otherwise
+//---------------------------------------------------------------------------
+bool
+FixedWord::canHold(const QString& str)
+{
+    int len = str.length();
+    if (len > CAPACITY)
+        return false;
+    for (int i = 0; i < len; ++i) {
+        ushort u = str.at(i).unicode();
+        if (!u || (u > 0xff))
+            return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  toUpper
+//
+//! Return an uppercase copy of the word.
+//
+//! @return the uppercase word
+//---------------------------------------------------------------------------
+FixedWord
+FixedWord::toUpper() const
+{
+    FixedWord upper (*this);
+    int len = length();
+    for (int i = 0; i < len; ++i) {
+        uchar c = bytes[i];
+        if ((c >= 'a') && (c <= 'z')) {
+            upper.bytes[i] = c - ('a' - 'A');
+        }
+        else if (c > 0x7f) {
+            QChar u = QChar(ushort(c)).toUpper();
+            if (u.unicode() <= 0xff)
+                upper.bytes[i] = char(u.unicode());
+        }
+    }
+    return upper;
+}
+
+//---------------------------------------------------------------------------
+//  reversed
+//
+//! Return a copy of the word with its letters in reverse order.
+//
+//! @return the reversed word
+//---------------------------------------------------------------------------
+FixedWord
+FixedWord::reversed() const
+{
+    FixedWord reverse (*this);
+    int len = length();
+    for (int i = 0; i < len; ++i)
+        reverse.bytes[i] = bytes[len - i - 1];
+    return reverse;
+}
+
+//---------------------------------------------------------------------------
+//  alphagram
+//
+//! Return the letters of the word sorted in byte order.  For unaccented
+//! letters this is the same order as Auxil::getAlphagram.
+//
+//! @return the alphagram
+//---------------------------------------------------------------------------
+FixedWord
+FixedWord::alphagram() const
+{
+    FixedWord sorted (*this);
+    int len = length();
+    for (int i = 1; i < len; ++i) {
+        uchar c = sorted.bytes[i];
+        int j = i - 1;
+        for (; (j >= 0) && (uchar(sorted.bytes[j]) > c); --j)
+            sorted.bytes[j + 1] = sorted.bytes[j];
+        sorted.bytes[j + 1] = c;
+    }
+    return sorted;
+}
+
+//---------------------------------------------------------------------------
+//  toString
+//
+//! Convert the word to a string.
+//
+//! @return the string
+//---------------------------------------------------------------------------
+QString
+FixedWord::toString() const
+{
+    return QString::fromLatin1(bytes, length());
+}
+
+//---------------------------------------------------------------------------
+//  hash
+//
+//! Return a hash value for the word, computed over all sixteen bytes.
+//
+//! @return the hash value
+//---------------------------------------------------------------------------
+uint
+FixedWord::hash() const
+{
+    quint32 words[(CAPACITY + 1) / 4];
+    memcpy(words, bytes, sizeof(words));
+    uint h = 2166136261U;
+    for (int i = 0; i < (CAPACITY + 1) / 4; ++i) {
+        h ^= words[i];
+        h *= 16777619U;
+        h ^= h >> 15;
+    }
+    return h;
+}
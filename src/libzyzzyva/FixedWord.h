@@ -0,0 +1,80 @@
+//---------------------------------------------------------------------------
+// FixedWord.h
+//
+// A fixed-capacity word value stored inline in sixteen bytes.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#ifndef ZYZZYVA_FIXED_WORD_H
+#define ZYZZYVA_FIXED_WORD_H
+
+#include <QString>
+#include <QtGlobal>
+#include <cstring>
+
+// Letters are stored one byte each in Latin-1 and padded with zeros, and the
+// length is kept in the last byte, so the whole value can be compared and
+// hashed as sixteen raw bytes.
+class FixedWord
+{
+    public:
+    static const int CAPACITY = 15;
+
+    public:
+    FixedWord() { clear(); }
+    explicit FixedWord(const QString& str);
+    ~FixedWord() { }
+
+    static bool canHold(const QString& str);
+
+    int length() const { return uchar(bytes[CAPACITY]); }
+    bool isEmpty() const { return !bytes[CAPACITY]; }
+    char at(int i) const { return bytes[i]; }
+    void clear() { memset(bytes, 0, sizeof(bytes)); }
+    void append(char c) { bytes[uchar(bytes[CAPACITY])++] = c; }
+
+    FixedWord& operator+=(char c) { append(c); return *this; }
+    FixedWord operator+(char c) const {
+        FixedWord w (*this); w.append(c); return w;
+    }
+
+    FixedWord toUpper() const;
+    FixedWord reversed() const;
+    FixedWord alphagram() const;
+    QString toString() const;
+    uint hash() const;
+
+    bool operator==(const FixedWord& rhs) const {
+        return !memcmp(bytes, rhs.bytes, sizeof(bytes));
+    }
+    bool operator!=(const FixedWord& rhs) const { return !(*this == rhs); }
+    bool operator<(const FixedWord& rhs) const {
+        return memcmp(bytes, rhs.bytes, sizeof(bytes)) < 0;
+    }
+
+    private:
+    char bytes[CAPACITY + 1];
+};
+
+inline uint qHash(const FixedWord& word) { return word.hash(); }
+
+Q_DECLARE_TYPEINFO(FixedWord, Q_MOVABLE_TYPE);
+
+#endif // ZYZZYVA_FIXED_WORD_H
@@ -27,6 +27,7 @@
 #include "Auxil.h"
 
 const int KEEP_ALIVE_INTERVAL = 31000;
+const QString DEFAULT_SERVER_HOST = "66.98.172.34";
 
 //---------------------------------------------------------------------------
 //  ~IscConnectionThread
@@ -49,6 +50,22 @@ IscConnectionThread::run()
     exec();
 }
 
+//---------------------------------------------------------------------------
+//  setServer
+//
+//! Set the server to connect to instead of the ISC server, for example a
+//! local server replaying a recorded session.
+//
+//! @param host the host name or address
+//! @param port the port
+//---------------------------------------------------------------------------
+void
+IscConnectionThread::setServer(const QString& host, quint16 port)
+{
+    serverHost = host;
+    serverPort = port;
+}
+
 //---------------------------------------------------------------------------
 //  connectToServer
 //
@@ -63,6 +80,7 @@ IscConnectionThread::connectToServer(const QString& creds,
                                      QAbstractSocket::SocketError* err)
 {
     credentials = creds;
+    codec.clear();
     socket = new QTcpSocket(this);
     connect(socket, SIGNAL(error(QAbstractSocket::SocketError)),
             SIGNAL(socketError(QAbstractSocket::SocketError)));
@@ -70,11 +88,15 @@ IscConnectionThread::connectToServer(const QString& creds,
             SLOT(socketStateChanged(QAbstractSocket::SocketState)));
     connect(socket, SIGNAL(readyRead()), SLOT(socketReadyRead()));
 
-    // Connect to a random port between 1321 and 1330
-    Rand rng (Rand::MarsagliaMwc, QDateTime::currentDateTime().toTime_t(),
-              Auxil::getPid());
-    int port = 1321 + rng.rand(9);
-    socket->connectToHost("66.98.172.34", port);
+    if (serverHost.isEmpty()) {
+        // Connect to a random port between 1321 and 1330
+        Rand rng (Rand::MarsagliaMwc, QDateTime::currentDateTime().toTime_t(),
+                  Auxil::getPid());
+        int port = 1321 + rng.rand(9);
+        socket->connectToHost(DEFAULT_SERVER_HOST, port);
+    }
+    else
+        socket->connectToHost(serverHost, serverPort);
 
     if (socketHadError) {
         if (err)
@@ -133,7 +155,7 @@ IscConnectionThread::sendMessage(const QString& message)
         }
     }
 
-    socket->write(encodeMessage(command + " " + args));
+    socket->write(IscFrameCodec::encode(command + " " + args));
 }
 
 //---------------------------------------------------------------------------
@@ -220,16 +242,23 @@ IscConnectionThread::socketStateChanged(QAbstractSocket::SocketState state)
 //---------------------------------------------------------------------------
 //  socketReadyRead
 //
-//! Called when the socket has data ready to read.
+//! Called when the socket has data ready to read.  Data is read directly into
+//! the receive buffer, and every complete message in it is handled.  Partial
+//! messages stay buffered until the rest of their bytes arrive.
 //---------------------------------------------------------------------------
 void
 IscConnectionThread::socketReadyRead()
 {
-    QByteArray bytes = socket->readAll();
-    QStringList messages = decodeMessage(bytes);
-    foreach (const QString& message, messages) {
-        receiveMessage(message);
+    qint64 available = socket->bytesAvailable();
+    if (available > 0) {
+        int size = int(available);
+        qint64 bytesRead = socket->read(codec.reserve(size), size);
+        codec.commit(int(bytesRead));
     }
+
+    QString message;
+    while (codec.nextMessage(&message))
+        receiveMessage(message);
 }
 
 //---------------------------------------------------------------------------
@@ -242,54 +271,3 @@ IscConnectionThread::keepAliveTimeout()
 {
     sendMessage("ALIVE");
 }
-
-//---------------------------------------------------------------------------
-//  encodeMessage
-//
-//! Encode a message for the server by prepending two bytes indicating message
-//! length, followed by "0 " and the message.
-//
-//! @param message the message to encode
-//! @return an array of bytes to be sent to the server
-//---------------------------------------------------------------------------
-QByteArray
-IscConnectionThread::encodeMessage(const QString& message)
-{
-    int length = message.length() + 2;
-    unsigned char high = (length & 0xff00) >> 8;
-    unsigned char low  = (length & 0x00ff);
-
-    QByteArray bytes;
-    bytes.append(high);
-    bytes.append(low);
-    bytes.append(QString("0 "));
-    bytes.append(message);
-    return bytes;
-}
-
-//---------------------------------------------------------------------------
-//  decodeMessage
-//
-//! Decode a message from the server by interpreting the first two bytes as
-//! message length, followed by the message itself.  More than one message may
-//! be present in the data stream, so return a list of all messages found.
-//
-//! @param bytes the bytes to decode
-//! @return the decoded messages
-//---------------------------------------------------------------------------
-QStringList
-IscConnectionThread::decodeMessage(const QByteArray& bytes)
-{
-    int index = 0;
-    QStringList messages;
-
-    while (index < bytes.size()) {
-        unsigned char high = bytes[index];
-        unsigned char low  = bytes[index + 1];
-        int length = (high << 8) + low - 2;
-        messages.append(QString(bytes.mid(index + 4, length)));
-        index += length + 4;
-    }
-
-    return messages;
-}
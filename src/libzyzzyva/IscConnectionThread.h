@@ -25,6 +25,7 @@
 #ifndef ZYZZYVA_ISC_CONNECTION_THREAD_H
 #define ZYZZYVA_ISC_CONNECTION_THREAD_H
 
+#include "IscFrameCodec.h"
 #include <QStringList>
 #include <QTcpSocket>
 #include <QThread>
@@ -35,9 +36,11 @@ class IscConnectionThread : public QThread
     Q_OBJECT
     public:
     IscConnectionThread(QObject* parent = 0)
-        : QThread(parent), socket(0) { }
+        : QThread(parent), socket(0), serverPort(0),
+          socketHadError(false) { }
     ~IscConnectionThread();
 
+    void setServer(const QString& host, quint16 port);
     bool connectToServer(const QString& creds,
                          QAbstractSocket::SocketError* err = 0);
     void disconnectFromServer();
@@ -55,8 +58,6 @@ class IscConnectionThread : public QThread
     void socketStateChanged(QAbstractSocket::SocketState state);
     void socketReadyRead();
     void keepAliveTimeout();
-    QByteArray encodeMessage(const QString& message);
-    QStringList decodeMessage(const QByteArray& bytes);
 
     protected:
     void run();
@@ -64,6 +65,9 @@ class IscConnectionThread : public QThread
     private:
     QTcpSocket* socket;
     QTimer keepAliveTimer;
+    IscFrameCodec codec;
+    QString serverHost;
+    quint16 serverPort;
     QString credentials;
     bool socketHadError;
 };
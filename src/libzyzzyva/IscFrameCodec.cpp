@@ -0,0 +1,168 @@
+//---------------------------------------------------------------------------
+// IscFrameCodec.cpp
+//
+// A class for encoding and incrementally decoding ISC message frames.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "IscFrameCodec.h"
+#include <cstring>
+
+// Each frame starts with two bytes of big-endian length, followed by a
+// two-byte tag ("0 ") and the message.  The length counts the tag.
+const int IscFrameCodec::HEADER_SIZE = 4;
+const int LENGTH_SIZE = 2;
+const int MIN_BUFFER_SIZE = 4096;
+
+//---------------------------------------------------------------------------
+//  encode
+//
+//! Encode a message for the server by prepending two bytes indicating message
+//! length, followed by "0 " and the message.
+//
+//! @param message the message to encode
+//! @return an array of bytes to be sent to the server
+//---------------------------------------------------------------------------
+QByteArray
+IscFrameCodec::encode(const QString& message)
+{
+    QByteArray messageBytes = message.toAscii();
+    int length = messageBytes.length() + HEADER_SIZE - LENGTH_SIZE;
+
+    QByteArray bytes;
+    bytes.reserve(messageBytes.length() + HEADER_SIZE);
+    bytes.append(char((length & 0xff00) >> 8));
+    bytes.append(char(length & 0x00ff));
+    bytes.append("0 ");
+    bytes.append(messageBytes);
+    return bytes;
+}
+
+//---------------------------------------------------------------------------
+//  reserve
+//
+//! Make room at the end of the receive buffer for incoming data, so it can be
+//! read directly into place.  Consumed data at the front of the buffer is
+//! discarded first.  Must be followed by a call to commit.
+//
+//! @param size the number of bytes to make room for
+//! @return a pointer to the free space
+//---------------------------------------------------------------------------
+char*
+IscFrameCodec::reserve(int size)
+{
+    if (readPos && (writePos + size > buffer.size())) {
+        int pending = writePos - readPos;
+        if (pending)
+            memmove(buffer.data(), buffer.constData() + readPos, pending);
+        readPos = 0;
+        writePos = pending;
+    }
+
+    if (writePos + size > buffer.size())
+        buffer.resize(qMax(writePos + size, qMax(2 * buffer.size(),
+                                                 MIN_BUFFER_SIZE)));
+
+    return buffer.data() + writePos;
+}
+
+//---------------------------------------------------------------------------
+//  commit
+//
+//! Mark bytes written into space returned by reserve as received.
+//
+//! @param size the number of bytes actually written
+//---------------------------------------------------------------------------
+void
+IscFrameCodec::commit(int size)
+{
+    if (size > 0)
+        writePos = qMin(writePos + size, buffer.size());
+}
+
+//---------------------------------------------------------------------------
+//  append
+//
+//! Append received bytes to the receive buffer.
+//
+//! @param data the bytes
+//! @param size the number of bytes
+//---------------------------------------------------------------------------
+void
+IscFrameCodec::append(const char* data, int size)
+{
+    if (size <= 0)
+        return;
+
+    memcpy(reserve(size), data, size);
+    commit(size);
+}
+
+//---------------------------------------------------------------------------
+//  nextMessage
+//
+//! Decode the next complete message in the receive buffer.  Incomplete
+//! frames are left in the buffer until the rest of their bytes arrive.
+//
+//! @param message return the decoded message
+//! @return true if a complete message was decoded, false otherwise
+//---------------------------------------------------------------------------
+bool
+IscFrameCodec::nextMessage(QString* message)
+{
+    int available = writePos - readPos;
+    if (available < LENGTH_SIZE)
+        return false;
+
+    const uchar* data =
+        reinterpret_cast<const uchar*>(buffer.constData()) + readPos;
+    int length = (int(data[0]) << 8) + int(data[1]);
+    if (available < LENGTH_SIZE + length)
+        return false;
+
+    // Frames too short to carry the tag hold no message
+    int messageLength = length - (HEADER_SIZE - LENGTH_SIZE);
+    if (message) {
+        if (messageLength > 0) {
+            *message = QString::fromAscii(
+                reinterpret_cast<const char*>(data) + HEADER_SIZE,
+                messageLength);
+        }
+        else
+            *message = QString();
+    }
+
+    readPos += LENGTH_SIZE + length;
+    if (readPos == writePos)
+        readPos = writePos = 0;
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  clear
+//
+//! Discard all buffered data.
+//---------------------------------------------------------------------------
+void
+IscFrameCodec::clear()
+{
+    readPos = writePos = 0;
+}
@@ -0,0 +1,55 @@
+//---------------------------------------------------------------------------
+// IscFrameCodec.h
+//
+// A class for encoding and incrementally decoding ISC message frames.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#ifndef ZYZZYVA_ISC_FRAME_CODEC_H
+#define ZYZZYVA_ISC_FRAME_CODEC_H
+
+#include <QByteArray>
+#include <QString>
+
+class IscFrameCodec
+{
+    public:
+    static const int HEADER_SIZE;
+
+    public:
+    IscFrameCodec() : readPos(0), writePos(0) { }
+    ~IscFrameCodec() { }
+
+    static QByteArray encode(const QString& message);
+
+    char* reserve(int size);
+    void commit(int size);
+    void append(const char* data, int size);
+    bool nextMessage(QString* message);
+    int bufferedBytes() const { return writePos - readPos; }
+    void clear();
+
+    private:
+    QByteArray buffer;
+    int readPos;
+    int writePos;
+};
+
+#endif // ZYZZYVA_ISC_FRAME_CODEC_H
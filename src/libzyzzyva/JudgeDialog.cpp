@@ -387,6 +387,8 @@ JudgeDialog::textChanged()
     inputArea->setTextCursor(cursor);
     inputArea->blockSignals(false);
 
+    resolveCurrentWord(text);
+
     bool doJudge = (tabIndex >= 0) && (numWords == count);
     if (!text.isEmpty()) {
         if (doJudge)
@@ -396,6 +398,48 @@ JudgeDialog::textChanged()
     }
 }
 
+//---------------------------------------------------------------------------
+//  resolveCurrentWord
+//
+//! Advance the input cursor to the word currently being typed, and remember
+//! whether it is acceptable so the word is already resolved when the play
+//! is judged.
+//
+//! @param text the contents of the input area
+//---------------------------------------------------------------------------
+void
+JudgeDialog::resolveCurrentWord(const QString& text)
+{
+    updateInputCursor();
+    if (text.isEmpty()) {
+        resolvedWords.clear();
+        inputCursor.reset();
+        return;
+    }
+
+    QString word = text.section('\n', -1);
+    inputCursor.setPrefix(word);
+    if (!word.isEmpty())
+        resolvedWords[word] = inputCursor.isWord();
+}
+
+//---------------------------------------------------------------------------
+//  updateInputCursor
+//
+//! Replace the input cursor if the word graph of the lexicon has changed
+//! since it was created, and forget the words resolved with the old graph.
+//---------------------------------------------------------------------------
+void
+JudgeDialog::updateInputCursor()
+{
+    WordGraph::Cursor cursor = engine->getWordCursor(lexicon);
+    if (cursor.getGeneration() == inputCursor.getGeneration())
+        return;
+
+    inputCursor = cursor;
+    resolvedWords.clear();
+}
+
 //---------------------------------------------------------------------------
 //  currentChanged
 //
@@ -451,8 +495,10 @@ JudgeDialog::judgeWord()
     QStringList unacceptableWords;
     QStringList::iterator it;
     QString wordStr;
+    updateInputCursor();
     for (it = words.begin(); it != words.end(); ++it) {
-        bool wordAcceptable = engine->isAcceptable(lexicon, *it);
+        bool wordAcceptable = resolvedWords.contains(*it) ?
+            resolvedWords.value(*it) : engine->isAcceptable(lexicon, *it);
 
         if (wordAcceptable)
             acceptableWords.append(*it);
@@ -26,10 +26,12 @@
 #ifndef ZYZZYVA_JUDGE_DIALOG_H
 #define ZYZZYVA_JUDGE_DIALOG_H
 
+#include "WordGraph.h"
 #include <QDialog>
 #include <QFrame>
 #include <QLabel>
 #include <QLineEdit>
+#include <QMap>
 #include <QStackedWidget>
 #include <QTimer>
 #include <QWidget>
@@ -70,6 +72,8 @@ class JudgeDialog : public QDialog
     private:
     QString getInstructionMessage();
     QWidget* createTitleWidget();
+    void resolveCurrentWord(const QString& text);
+    void updateInputCursor();
 
     private:
     WordEngine*     engine;
@@ -100,6 +104,8 @@ class JudgeDialog : public QDialog
     QTimer*         resultTimer;
     QTimer*         exitTimer;
     int             clearResultsHold;
+    WordGraph::Cursor inputCursor;
+    QMap<QString, bool> resolvedWords;
 
     int fontMultiplier;
 };
@@ -23,9 +23,11 @@
 //---------------------------------------------------------------------------
 
 #include "LetterBag.h"
-#include "MainSettings.h"
 #include "Auxil.h"
 #include "Defs.h"
+#include <QDateTime>
+#include <QVarLengthArray>
+#include <QVector>
 
 using namespace Defs;
 
@@ -35,43 +37,14 @@ const QChar LetterBag::BLANK_CHAR = '_';
 //  LetterBag
 //
 //! Constructor.  Precalculate the M choose N probabilities for all
-//! combinations up to MAX_WORD_LEN.
+//! combinations up to MAX_WORD_LEN.  Letter values are taken from the
+//! alphabet of the distribution.
 //
 //! @param distribution the letter distribution to use
 //---------------------------------------------------------------------------
 LetterBag::LetterBag(const QString& distribution)
     : totalLetters(0)
 {
-    // Set letter values
-    // FIXME: this should be able to be passed in as a parameter
-    letterValues[QChar(BLANK_CHAR)] = 0;
-    letterValues[QChar('A')] = 1;
-    letterValues[QChar('B')] = 3;
-    letterValues[QChar('C')] = 3;
-    letterValues[QChar('D')] = 2;
-    letterValues[QChar('E')] = 1;
-    letterValues[QChar('F')] = 4;
-    letterValues[QChar('G')] = 2;
-    letterValues[QChar('H')] = 4;
-    letterValues[QChar('I')] = 1;
-    letterValues[QChar('J')] = 8;
-    letterValues[QChar('K')] = 5;
-    letterValues[QChar('L')] = 1;
-    letterValues[QChar('M')] = 3;
-    letterValues[QChar('N')] = 1;
-    letterValues[QChar('O')] = 1;
-    letterValues[QChar('P')] = 3;
-    letterValues[QChar('Q')] = 10;
-    letterValues[QChar('R')] = 1;
-    letterValues[QChar('S')] = 1;
-    letterValues[QChar('T')] = 1;
-    letterValues[QChar('U')] = 1;
-    letterValues[QChar('V')] = 4;
-    letterValues[QChar('W')] = 4;
-    letterValues[QChar('X')] = 8;
-    letterValues[QChar('Y')] = 4;
-    letterValues[QChar('Z')] = 10;
-
     rng.srand(QDateTime::currentDateTime().toTime_t(), Auxil::getPid());
     resetContents(distribution);
 }
@@ -113,17 +86,23 @@ LetterBag::getNumCombinations(const QString& word, int numBlanks) const
     else if (numBlanks > 2)
         numBlanks = 2;
 
-    // Build parallel arrays of letters with their counts, and the
+    // Build parallel arrays of letter codes with their counts, and the
     // precalculated combinations based on the letter frequency
-    QList<QChar> letters;
-    QList<int> counts;
-    QList<const QList<double>*> combos;
-    for (int i = 0; i < word.length(); ++i) {
+    int wordLen = word.length();
+    QVarLengthArray<int, MAX_WORD_LEN> letters;
+    QVarLengthArray<int, MAX_WORD_LEN> counts;
+    QVarLengthArray<const QList<double>*, MAX_WORD_LEN> combos;
+    for (int i = 0; i < wordLen; ++i) {
+        // Letters outside the alphabet are kept apart by their character
         QChar c = word.at(i);
+        int code = alphabet.getCode(c);
+        bool inAlphabet = (code != Alphabet::NO_CODE);
+        if (!inAlphabet)
+            code = Alphabet::NO_CODE + 1 + c.unicode();
 
         bool foundLetter = false;
         for (int j = 0; j < letters.size(); ++j) {
-            if (letters[j] == c) {
+            if (letters[j] == code) {
                 ++counts[j];
                 foundLetter = true;
                 break;
@@ -131,12 +110,15 @@ LetterBag::getNumCombinations(const QString& word, int numBlanks) const
         }
 
         if (!foundLetter) {
-            letters.append(c);
+            int frequency = inAlphabet ? letterFrequencies[code] : 0;
+            letters.append(code);
             counts.append(1);
-            combos.append(&subChooseCombos[ letterFrequencies[c] ]);
+            combos.append(&subChooseCombos[frequency]);
         }
     }
 
+    int blankFrequency = getFrequency(BLANK_CHAR);
+
     // XXX: Generalize the following code to handle arbitrary number of blanks
     double totalCombos = 0.0;
     int numLetters = letters.size();
@@ -154,7 +136,7 @@ LetterBag::getNumCombinations(const QString& word, int numBlanks) const
     // Calculate the combinations with one blank
     for (int i = 0; i < numLetters; ++i) {
         --counts[i];
-        thisCombo = subChooseCombos[ letterFrequencies[BLANK_CHAR] ][1];
+        thisCombo = subChooseCombos[blankFrequency][1];
         for (int j = 0; j < numLetters; ++j) {
             thisCombo *= (*combos[j])[ counts[j] ];
         }
@@ -172,7 +154,7 @@ LetterBag::getNumCombinations(const QString& word, int numBlanks) const
             if (!counts[j])
                 continue;
             --counts[j];
-            thisCombo = subChooseCombos[ letterFrequencies[BLANK_CHAR] ][2];
+            thisCombo = subChooseCombos[blankFrequency][2];
 
             for (int k = 0; k < numLetters; ++k) {
                 thisCombo *= (*combos[k])[ counts[k] ];
@@ -189,6 +171,109 @@ LetterBag::getNumCombinations(const QString& word, int numBlanks) const
     return totalCombos;
 }
 
+//---------------------------------------------------------------------------
+//  getDrawProbability
+//
+//! Return the probability of drawing a word from the current contents of
+//! the bag when drawing the number of letters in the word.  Unlike
+//! getProbability, this does not assume a full bag, and any number of blanks
+//! in the bag may stand in for letters of the word.
+//
+//! @param word the word
+//! @return the probability of drawing letters to form the word, between 0
+//! and 1
+//---------------------------------------------------------------------------
+double
+LetterBag::getDrawProbability(const QString& word) const
+{
+    int wordLen = word.length();
+    if (!wordLen || (wordLen > totalLetters))
+        return 0.0;
+
+    QString upperWord = word.toUpper();
+    QList<QChar> letters;
+    QVector<int> wordCounts;
+    QVector<int> poolCounts;
+    for (int i = 0; i < wordLen; ++i) {
+        QChar c = upperWord.at(i);
+        int index = letters.indexOf(c);
+        if (index < 0) {
+            letters.append(c);
+            wordCounts.append(1);
+            poolCounts.append(getFrequency(c));
+        }
+        else
+            ++wordCounts[index];
+    }
+
+    double combos = getNumDrawCombinations(letters.size(),
+        wordCounts.constData(), poolCounts.constData(),
+        getFrequency(BLANK_CHAR));
+
+    // Divide by the number of ways to draw that many tiles, one factor at a
+    // time to keep the intermediate values small
+    for (int i = 0; i < wordLen; ++i)
+        combos *= double(i + 1) / double(totalLetters - i);
+    return combos;
+}
+
+//---------------------------------------------------------------------------
+//  getNumDrawCombinations
+//
+//! Return the unique ways of drawing tiles that form a set of letters from a
+//! pool of tiles, when drawing as many tiles as there are letters.  Blanks
+//! in the pool may stand in for any letter.
+//
+//! @param numLetters the number of distinct letters
+//! @param wordCounts the number of times each distinct letter is needed
+//! @param poolCounts the number of tiles of each distinct letter in the pool
+//! @param poolBlanks the number of blanks in the pool
+//! @return the number of ways of drawing tiles to form the letters
+//---------------------------------------------------------------------------
+double
+LetterBag::getNumDrawCombinations(int numLetters, const int* wordCounts,
+                                  const int* poolCounts, int poolBlanks)
+{
+    // ways[b] holds the number of ways to draw the letters seen so far
+    // using exactly b blanks in place of letters
+    QVector<double> ways (poolBlanks + 1, 0.0);
+    ways[0] = 1.0;
+    int maxBlanks = 0;
+    for (int i = 0; i < numLetters; ++i) {
+        int need = wordCounts[i];
+        int have = poolCounts[i];
+        QVector<double> next (poolBlanks + 1, 0.0);
+        for (int b = 0; b <= maxBlanks; ++b) {
+            if (ways[b] == 0.0)
+                continue;
+            for (int used = 0; (used <= need) && (b + used <= poolBlanks);
+                 ++used)
+            {
+                int drawn = need - used;
+                if (drawn > have)
+                    continue;
+
+                // Multiply by (have choose drawn)
+                double choose = 1.0;
+                for (int k = 0; k < drawn; ++k)
+                    choose = choose * (have - k) / (k + 1);
+                next[b + used] += ways[b] * choose;
+            }
+        }
+        maxBlanks = qMin(maxBlanks + need, poolBlanks);
+        ways = next;
+    }
+
+    // Multiply by (poolBlanks choose b) for the blanks that were used
+    double total = 0.0;
+    double chooseBlanks = 1.0;
+    for (int b = 0; b <= poolBlanks; ++b) {
+        total += ways[b] * chooseBlanks;
+        chooseBlanks = chooseBlanks * (poolBlanks - b) / (b + 1);
+    }
+    return total;
+}
+
 //---------------------------------------------------------------------------
 //  getLetterValue
 //
@@ -200,7 +285,8 @@ LetterBag::getNumCombinations(const QString& word, int numBlanks) const
 int
 LetterBag::getLetterValue(const QChar& letter) const
 {
-    return letterValues.value(letter.toUpper(), 0);
+    int code = alphabet.getCode(letter.toUpper());
+    return (code == Alphabet::NO_CODE) ? 0 : alphabet.getPointValue(code);
 }
 
 //---------------------------------------------------------------------------
@@ -214,7 +300,8 @@ LetterBag::getLetterValue(const QChar& letter) const
 void
 LetterBag::setLetterValue(const QChar& letter, int value)
 {
-    letterValues[letter] = value;
+    getLetterCode(letter);
+    alphabet.setPointValue(letter, value);
 }
 
 //---------------------------------------------------------------------------
@@ -228,25 +315,24 @@ LetterBag::setLetterValue(const QChar& letter, int value)
 void
 LetterBag::resetContents(const QString& distribution)
 {
-    QString dist (distribution);
-    if (dist.isEmpty())
-        dist = MainSettings::getLetterDistribution();
-    QStringList strList = dist.split(" ");
+    alphabet = Alphabet(distribution);
 
     int maxFrequency = MAX_WORD_LEN;
 
+    int numLetters = alphabet.getNumLetters();
     totalLetters = 0;
-    letterFrequencies.clear();
-
-    foreach (const QString& str, strList) {
-        QChar letter = str.section(":", 0, 0)[0];
-        int frequency = str.section(":", 1, 1).toInt();
-        letterFrequencies.insert(letter, frequency);
+    letterFrequencies.resize(numLetters);
+    for (int code = 0; code < numLetters; ++code) {
+        int frequency = alphabet.getFrequency(code);
+        letterFrequencies[code] = frequency;
         totalLetters += frequency;
         if (frequency > maxFrequency)
             maxFrequency = frequency;
     }
 
+    fullChooseCombos.clear();
+    subChooseCombos.clear();
+
     // Precalculate M choose N combinations - use doubles because the numbers
     // get very large
     double a = 1;
@@ -273,6 +359,28 @@ LetterBag::resetContents(const QString& distribution)
     }
 }
 
+//---------------------------------------------------------------------------
+//  setLetters
+//
+//! Set the contents of the bag to a specific set of tiles, such as the
+//! tiles unseen at some point in a game.  Blanks may be given as either ?
+//! or the blank character.
+//
+//! @param letters the tiles in the bag
+//---------------------------------------------------------------------------
+void
+LetterBag::setLetters(const QString& letters)
+{
+    totalLetters = 0;
+    letterFrequencies.fill(0);
+    foreach (const QChar& letter, letters) {
+        if ((letter == '?') || (letter == BLANK_CHAR))
+            insertLetter(BLANK_CHAR);
+        else if (letter.isLetter())
+            insertLetter(letter);
+    }
+}
+
 //---------------------------------------------------------------------------
 //  insertLetter
 //
@@ -283,11 +391,10 @@ LetterBag::resetContents(const QString& distribution)
 void
 LetterBag::insertLetter(const QChar& letter)
 {
-    QChar c = letter.toUpper();
-    if (letterFrequencies.contains(c))
-        ++letterFrequencies[c];
-    else
-        letterFrequencies[c] = 1;
+    int code = getLetterCode(letter.toUpper());
+    if (code == Alphabet::NO_CODE)
+        return;
+    ++letterFrequencies[code];
     ++totalLetters;
 }
 
@@ -307,8 +414,10 @@ LetterBag::insertLetter(const QChar& letter)
 bool
 LetterBag::drawLetter(const QChar& letter)
 {
-    QChar c = letter.toUpper();
-    --letterFrequencies[c];
+    int code = getLetterCode(letter.toUpper());
+    if (code == Alphabet::NO_CODE)
+        return false;
+    --letterFrequencies[code];
     --totalLetters;
     return true;
 }
@@ -330,16 +439,15 @@ LetterBag::lookRandomLetters(int num)
     unsigned int choose = num;
     unsigned int chooseFrom = totalLetters;
 
-    QMapIterator<QChar, int> it (letterFrequencies);
-    while (it.hasNext()) {
-        it.next();
-        int frequency = it.value();
+    int numLetters = letterFrequencies.size();
+    for (int code = 0; code < numLetters; ++code) {
+        int frequency = letterFrequencies[code];
         for (int i = 0; i < frequency; ++i, --chooseFrom) {
             unsigned int r = chooseFrom > 1 ? rng.rand(chooseFrom - 1) : 0;
             if (r >= choose)
                 continue;
 
-            QChar letter = it.key();
+            QChar letter = alphabet.getLetter(code);
             letters += letter;
             --choose;
             if (!choose)
@@ -378,11 +486,10 @@ QString
 LetterBag::getLetters() const
 {
     QString string;
-    QMapIterator <QChar, int> it (letterFrequencies);
-    while (it.hasNext()) {
-        it.next();
-        QChar letter = it.key();
-        int frequency = it.value();
+    int numLetters = letterFrequencies.size();
+    for (int code = 0; code < numLetters; ++code) {
+        QChar letter = alphabet.getLetter(code);
+        int frequency = letterFrequencies[code];
         for (int i = 0; i < frequency; ++i) {
             string += letter;
         }
@@ -402,3 +509,48 @@ LetterBag::getNumLetters() const
 {
     return totalLetters;
 }
+
+//---------------------------------------------------------------------------
+//  getLetterCode
+//
+//! Return the code of a letter, adding the letter to the alphabet of the
+//! bag if necessary.
+//
+//! @param letter the letter
+//! @return the letter code, or Alphabet::NO_CODE if the letter cannot be
+//! coded
+//---------------------------------------------------------------------------
+int
+LetterBag::getLetterCode(const QChar& letter)
+{
+    int code = alphabet.getCode(letter);
+    if (code != Alphabet::NO_CODE)
+        return code;
+
+    // Adding a letter renumbers the letters after it
+    QString oldLetters = alphabet.getLetters();
+    QVector<int> oldFrequencies = letterFrequencies;
+    alphabet.addLetters(letter);
+    if (alphabet.getNumLetters() == oldLetters.length())
+        return Alphabet::NO_CODE;
+    letterFrequencies.fill(0, alphabet.getNumLetters());
+    for (int i = 0; i < oldLetters.length(); ++i)
+        letterFrequencies[alphabet.getCode(oldLetters.at(i))] =
+            oldFrequencies[i];
+    return alphabet.getCode(letter);
+}
+
+//---------------------------------------------------------------------------
+//  getFrequency
+//
+//! Return the number of tiles of a letter in the bag.
+//
+//! @param letter the letter
+//! @return the number of tiles
+//---------------------------------------------------------------------------
+int
+LetterBag::getFrequency(const QChar& letter) const
+{
+    int code = alphabet.getCode(letter);
+    return (code == Alphabet::NO_CODE) ? 0 : letterFrequencies[code];
+}
@@ -25,11 +25,12 @@
 #ifndef ZYZZYVA_LETTER_BAG_H
 #define ZYZZYVA_LETTER_BAG_H
 
+#include "Alphabet.h"
 #include "Rand.h"
 #include <QChar>
-#include <QMap>
 #include <QList>
 #include <QString>
+#include <QVector>
 
 class LetterBag
 {
@@ -39,11 +40,16 @@ class LetterBag
 
     double getProbability(const QString& word, int numBlanks) const;
     double getNumCombinations(const QString& word, int numBlanks) const;
+    double getDrawProbability(const QString& word) const;
+    static double getNumDrawCombinations(int numLetters, const int*
+                                         wordCounts, const int* poolCounts,
+                                         int poolBlanks);
 
     int getLetterValue(const QChar& letter) const;
     void setLetterValue(const QChar& letter, int value);
 
     void resetContents(const QString& distribution = QString());
+    void setLetters(const QString& letters);
     void insertLetter(const QChar& letter);
     bool drawLetter(const QChar& letter);
     QString lookRandomLetters(int num);
@@ -52,10 +58,14 @@ class LetterBag
     QString getLetters() const;
     int getNumLetters() const;
 
+    private:
+    int getLetterCode(const QChar& letter);
+    int getFrequency(const QChar& letter) const;
+
     private:
     int totalLetters;
-    QMap<QChar, int> letterFrequencies;
-    QMap<QChar, int> letterValues;
+    Alphabet alphabet;
+    QVector<int> letterFrequencies;
 
     QList<double> fullChooseCombos;
     QList<QList<double> > subChooseCombos;
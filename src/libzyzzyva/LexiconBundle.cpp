@@ -0,0 +1,583 @@
+//---------------------------------------------------------------------------
+// LexiconBundle.cpp
+//
+// A class for reading and writing single-file compiled lexicons.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "LexiconBundle.h"
+#include "DawgBuilder.h"
+#include "Auxil.h"
+#include "Defs.h"
+#include <QByteArray>
+#include <QSet>
+#include <QVector>
+#include <QtAlgorithms>
+#include <QtEndian>
+#include <cstring>
+
+const char* LexiconBundle::MAGIC = "ZLXB";
+const quint32 LexiconBundle::VERSION = 1;
+const int LexiconBundle::WORD_SLOT_SIZE = 16;
+
+const int HEADER_SIZE = 16;
+const int SECTION_ENTRY_SIZE = 16;
+const int SECTION_ALIGNMENT = 8;
+
+using namespace Defs;
+
+//---------------------------------------------------------------------------
+//  appendUInt32
+//
+//! Append a 32-bit value to a byte array in little-endian order.
+//
+//! @param bytes the byte array
+//! @param value the value to append
+//---------------------------------------------------------------------------
+static void
+appendUInt32(QByteArray& bytes, quint32 value)
+{
+    uchar buf[4];
+    qToLittleEndian<quint32>(value, buf);
+    bytes.append((const char*) buf, 4);
+}
+
+//---------------------------------------------------------------------------
+//  appendInt64
+//
+//! Append a 64-bit value to a byte array in little-endian order.
+//
+//! @param bytes the byte array
+//! @param value the value to append
+//---------------------------------------------------------------------------
+static void
+appendInt64(QByteArray& bytes, qint64 value)
+{
+    uchar buf[8];
+    qToLittleEndian<qint64>(value, buf);
+    bytes.append((const char*) buf, 8);
+}
+
+//---------------------------------------------------------------------------
+//  LexiconBundle
+//
+//! Constructor.
+//---------------------------------------------------------------------------
+LexiconBundle::LexiconBundle()
+    : data(0), dataSize(0), mapped(false), numWords(0)
+{
+}
+
+//---------------------------------------------------------------------------
+//  ~LexiconBundle
+//
+//! Destructor.
+//---------------------------------------------------------------------------
+LexiconBundle::~LexiconBundle()
+{
+    close();
+}
+
+//---------------------------------------------------------------------------
+//  write
+//
+//! Compile a lexicon into a single bundle file.  The bundle holds the
+//! forward and reverse word graphs, a sorted table of fixed-size word slots,
+//! per-word attribute arrays, optional definitions, and stems.  Every section
+//! is stored little-endian at an aligned offset, so the file can be mapped
+//! into memory and used directly.
+//
+//! @param filename the name of the bundle file to write
+//! @param words the list of words in the lexicon
+//! @param definitions definitions keyed by word, possibly empty
+//! @param playability playability values keyed by word, possibly empty
+//! @param stems lists of stems keyed by stem length, possibly empty
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+LexiconBundle::write(const QString& filename, const QStringList& words,
+                     const QMap<QString, QString>& definitions,
+                     const QMap<QString, qint64>& playability,
+                     const QMap<int, QStringList>& stems, QString* errString)
+{
+    QSet<QString> wordSet;
+    foreach (const QString& word, words) {
+        QString upper = word.toUpper();
+        if (upper.isEmpty())
+            continue;
+        if (upper.length() > MAX_WORD_LEN) {
+            if (errString)
+                *errString = "Word too long: '" + upper + "'.";
+            return false;
+        }
+        wordSet.insert(upper);
+    }
+
+    QStringList sortedWords = wordSet.toList();
+    qSort(sortedWords);
+
+    QMap<int, QByteArray> sectionData;
+
+    DawgBuilder builder;
+    for (int i = 0; i < 2; ++i) {
+        bool reverse = (i == 1);
+        QVector<qint32> edges;
+        if (!builder.build(sortedWords, reverse, &edges, errString))
+            return false;
+
+        QByteArray bytes;
+        bytes.reserve(edges.count() * 4);
+        foreach (qint32 edge, edges)
+            appendUInt32(bytes, quint32(edge));
+        sectionData[reverse ? SectionReverseDawg : SectionForwardDawg] =
+            bytes;
+    }
+
+    QMap<QString, int> numAnagramsMap;
+    foreach (const QString& word, sortedWords)
+        ++numAnagramsMap[Auxil::getAlphagram(word)];
+
+    QByteArray wordBytes;
+    QByteArray anagramBytes;
+    QByteArray playabilityBytes;
+    QByteArray defIndexBytes;
+    QByteArray defTextBytes;
+    foreach (const QString& word, sortedWords) {
+        QByteArray slot = word.toLatin1();
+        slot.append(QByteArray(WORD_SLOT_SIZE - slot.length(), '\0'));
+        wordBytes.append(slot);
+
+        appendUInt32(anagramBytes,
+                     numAnagramsMap.value(Auxil::getAlphagram(word)));
+        appendInt64(playabilityBytes, playability.value(word));
+
+        if (!definitions.isEmpty()) {
+            appendUInt32(defIndexBytes, defTextBytes.length());
+            defTextBytes.append(definitions.value(word).toUtf8());
+        }
+    }
+
+    sectionData[SectionWords] = wordBytes;
+    sectionData[SectionNumAnagrams] = anagramBytes;
+    sectionData[SectionPlayability] = playabilityBytes;
+    if (!definitions.isEmpty()) {
+        appendUInt32(defIndexBytes, defTextBytes.length());
+        sectionData[SectionDefinitionIndex] = defIndexBytes;
+        sectionData[SectionDefinitionText] = defTextBytes;
+    }
+
+    if (!stems.isEmpty()) {
+        QByteArray stemBytes;
+        QMapIterator<int, QStringList> it (stems);
+        while (it.hasNext()) {
+            it.next();
+            int length = it.key();
+            QByteArray stemData;
+            int count = 0;
+            foreach (const QString& stem, it.value()) {
+                if (stem.length() != length)
+                    continue;
+                stemData.append(stem.toUpper().toLatin1());
+                ++count;
+            }
+            appendUInt32(stemBytes, length);
+            appendUInt32(stemBytes, count);
+            stemBytes.append(stemData);
+            while (stemBytes.length() % 4)
+                stemBytes.append('\0');
+        }
+        sectionData[SectionStems] = stemBytes;
+    }
+
+    // Lay out the header, the section table, and the aligned sections
+    QByteArray header;
+    header.append(MAGIC, 4);
+    appendUInt32(header, VERSION);
+    appendUInt32(header, sectionData.count());
+    appendUInt32(header, sortedWords.count());
+
+    quint32 offset = HEADER_SIZE + sectionData.count() * SECTION_ENTRY_SIZE;
+    QByteArray body;
+    QMapIterator<int, QByteArray> sit (sectionData);
+    while (sit.hasNext()) {
+        sit.next();
+        while (offset % SECTION_ALIGNMENT) {
+            body.append('\0');
+            ++offset;
+        }
+        const QByteArray& bytes = sit.value();
+        appendUInt32(header, sit.key());
+        appendUInt32(header, qChecksum(bytes.constData(), bytes.length()));
+        appendUInt32(header, offset);
+        appendUInt32(header, bytes.length());
+        body.append(bytes);
+        offset += bytes.length();
+    }
+
+    QFile outFile (filename);
+    if (!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (errString) {
+            *errString = "Can't open file '" + filename + "': " +
+                outFile.errorString();
+        }
+        return false;
+    }
+
+    if ((outFile.write(header) != header.length()) ||
+        (outFile.write(body) != body.length()))
+    {
+        if (errString) {
+            *errString = "Can't write file '" + filename + "': " +
+                outFile.errorString();
+        }
+        return false;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  open
+//
+//! Open a bundle file and map it into memory.  The header, the section
+//! table and the checksum of every section are verified.
+//
+//! @param filename the name of the bundle file
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+LexiconBundle::open(const QString& filename, QString* errString)
+{
+    close();
+
+    file.setFileName(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errString) {
+            *errString = "Can't open file '" + filename + "': " +
+                file.errorString();
+        }
+        return false;
+    }
+
+    dataSize = file.size();
+    data = file.map(0, dataSize);
+    mapped = (data != 0);
+    if (!mapped) {
+        QByteArray bytes = file.readAll();
+        dataSize = bytes.size();
+        data = new uchar[dataSize];
+        memcpy(data, bytes.constData(), dataSize);
+    }
+
+    QString error;
+    quint32 numSections = 0;
+    if ((dataSize < HEADER_SIZE) || (memcmp(data, MAGIC, 4) != 0)) {
+        error = "The file is not a lexicon bundle.";
+    }
+    else if (qFromLittleEndian<quint32>(data + 4) != VERSION) {
+        error = "The lexicon bundle version is not supported.";
+    }
+    else {
+        numSections = qFromLittleEndian<quint32>(data + 8);
+        numWords = qFromLittleEndian<quint32>(data + 12);
+        if (dataSize < HEADER_SIZE + qint64(numSections) * SECTION_ENTRY_SIZE)
+            error = "The lexicon bundle is truncated.";
+    }
+
+    for (quint32 i = 0; error.isEmpty() && (i < numSections); ++i) {
+        const uchar* entry = data + HEADER_SIZE + i * SECTION_ENTRY_SIZE;
+        quint32 type = qFromLittleEndian<quint32>(entry);
+        quint32 checksum = qFromLittleEndian<quint32>(entry + 4);
+        Section section;
+        section.offset = qFromLittleEndian<quint32>(entry + 8);
+        section.length = qFromLittleEndian<quint32>(entry + 12);
+
+        if ((section.offset % SECTION_ALIGNMENT) ||
+            (qint64(section.offset) + section.length > dataSize))
+        {
+            error = "The lexicon bundle is truncated.";
+        }
+        else if (qChecksum((const char*) data + section.offset,
+                           section.length) != checksum)
+        {
+            error = "The lexicon checksum does not match the expected "
+                "checksum.  It is possible the lexicon has been corrupted.";
+        }
+        else
+            sections.insert(type, section);
+    }
+
+    if (error.isEmpty() &&
+        (!sections.contains(SectionForwardDawg) ||
+         !sections.contains(SectionReverseDawg) ||
+         !sections.contains(SectionWords) ||
+         (sections.value(SectionWords).length !=
+          quint32(numWords * WORD_SLOT_SIZE))))
+    {
+        error = "The lexicon bundle is missing required data.";
+    }
+
+    if (!error.isEmpty()) {
+        if (errString)
+            *errString = "Can't load lexicon bundle '" + filename + "': " +
+                error;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  close
+//
+//! Close the bundle file and release its memory.
+//---------------------------------------------------------------------------
+void
+LexiconBundle::close()
+{
+    if (data) {
+        if (mapped)
+            file.unmap(data);
+        else
+            delete[] data;
+    }
+    if (file.isOpen())
+        file.close();
+
+    data = 0;
+    dataSize = 0;
+    mapped = false;
+    numWords = 0;
+    sections.clear();
+}
+
+//---------------------------------------------------------------------------
+//  getDawg
+//
+//! Return the edge array of the forward or reverse word graph.  The array is
+//! stored in little-endian order.
+//
+//! @param reverse whether to return the reverse graph
+//! @param numEdges return the number of edges, not counting the initial
+//! terminal entry
+//! @return the edge array, or 0 if not available
+//---------------------------------------------------------------------------
+const qint32*
+LexiconBundle::getDawg(bool reverse, qint32* numEdges) const
+{
+    quint32 length = 0;
+    const uchar* p = getSection(reverse ? SectionReverseDawg
+                                        : SectionForwardDawg, &length);
+    if (!p || (length < 4))
+        return 0;
+
+    if (numEdges)
+        *numEdges = length / 4 - 1;
+    return (const qint32*) p;
+}
+
+//---------------------------------------------------------------------------
+//  findWord
+//
+//! Find the index of a word in the sorted word table.
+//
+//! @param word the word, assumed to be upper case
+//! @return the index of the word, or -1 if not found
+//---------------------------------------------------------------------------
+int
+LexiconBundle::findWord(const QString& word) const
+{
+    const uchar* words = getSection(SectionWords);
+    if (!words || word.isEmpty() || (word.length() >= WORD_SLOT_SIZE))
+        return -1;
+
+    QByteArray key = word.toLatin1();
+    int low = 0;
+    int high = numWords - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        const char* slot = (const char*) words + mid * WORD_SLOT_SIZE;
+        int cmp = qstrncmp(slot, key.constData(), WORD_SLOT_SIZE);
+        if (cmp == 0)
+            return mid;
+        else if (cmp < 0)
+            low = mid + 1;
+        else
+            high = mid - 1;
+    }
+    return -1;
+}
+
+//---------------------------------------------------------------------------
+//  getWord
+//
+//! Return the word at an index in the sorted word table.
+//
+//! @param index the word index
+//! @return the word, or an empty string if the index is invalid
+//---------------------------------------------------------------------------
+QString
+LexiconBundle::getWord(int index) const
+{
+    const uchar* words = getSection(SectionWords);
+    if (!words || (index < 0) || (index >= numWords))
+        return QString();
+
+    const char* slot = (const char*) words + index * WORD_SLOT_SIZE;
+    return QString::fromLatin1(slot, qstrnlen(slot, WORD_SLOT_SIZE));
+}
+
+//---------------------------------------------------------------------------
+//  getNumAnagrams
+//
+//! Return the number of anagrams of a word, including the word itself.
+//
+//! @param index the word index
+//! @return the number of anagrams
+//---------------------------------------------------------------------------
+int
+LexiconBundle::getNumAnagrams(int index) const
+{
+    const uchar* p = getSection(SectionNumAnagrams);
+    if (!p || (index < 0) || (index >= numWords))
+        return 0;
+    return qFromLittleEndian<quint32>(p + index * 4);
+}
+
+//---------------------------------------------------------------------------
+//  getPlayability
+//
+//! Return the playability value of a word.
+//
+//! @param index the word index
+//! @return the playability value
+//---------------------------------------------------------------------------
+qint64
+LexiconBundle::getPlayability(int index) const
+{
+    const uchar* p = getSection(SectionPlayability);
+    if (!p || (index < 0) || (index >= numWords))
+        return 0;
+    return qFromLittleEndian<qint64>(p + index * 8);
+}
+
+//---------------------------------------------------------------------------
+//  hasDefinitions
+//
+//! Determine whether the bundle contains definitions.
+//
+//! @return true if definitions are present, false otherwise
+//---------------------------------------------------------------------------
+bool
+LexiconBundle::hasDefinitions() const
+{
+    return sections.contains(SectionDefinitionIndex) &&
+        sections.contains(SectionDefinitionText);
+}
+
+//---------------------------------------------------------------------------
+//  getDefinition
+//
+//! Return the definition of a word.
+//
+//! @param index the word index
+//! @return the definition, or an empty string if none
+//---------------------------------------------------------------------------
+QString
+LexiconBundle::getDefinition(int index) const
+{
+    quint32 indexLength = 0;
+    quint32 textLength = 0;
+    const uchar* indexData = getSection(SectionDefinitionIndex, &indexLength);
+    const uchar* text = getSection(SectionDefinitionText, &textLength);
+    if (!indexData || !text || (index < 0) ||
+        (quint32(index + 1) * 4 >= indexLength))
+    {
+        return QString();
+    }
+
+    quint32 start = qFromLittleEndian<quint32>(indexData + index * 4);
+    quint32 end = qFromLittleEndian<quint32>(indexData + (index + 1) * 4);
+    if ((start > end) || (end > textLength))
+        return QString();
+
+    return QString::fromUtf8((const char*) text + start, end - start);
+}
+
+//---------------------------------------------------------------------------
+//  getStems
+//
+//! Return the stems stored in the bundle.
+//
+//! @return lists of stems keyed by stem length
+//---------------------------------------------------------------------------
+QMap<int, QStringList>
+LexiconBundle::getStems() const
+{
+    QMap<int, QStringList> stems;
+    quint32 length = 0;
+    const uchar* p = getSection(SectionStems, &length);
+    if (!p)
+        return stems;
+
+    quint32 pos = 0;
+    while (pos + 8 <= length) {
+        quint32 stemLength = qFromLittleEndian<quint32>(p + pos);
+        quint32 count = qFromLittleEndian<quint32>(p + pos + 4);
+        pos += 8;
+        if (!stemLength || (pos + stemLength * count > length))
+            break;
+
+        QStringList& list = stems[stemLength];
+        for (quint32 i = 0; i < count; ++i) {
+            list.append(QString::fromLatin1((const char*) p + pos,
+                                            stemLength));
+            pos += stemLength;
+        }
+        while (pos % 4)
+            ++pos;
+    }
+
+    return stems;
+}
+
+//---------------------------------------------------------------------------
+//  getSection
+//
+//! Return a pointer to the data of a section.
+//
+//! @param type the section type
+//! @param length return the length of the section in bytes
+//! @return the section data, or 0 if the section is not present
+//---------------------------------------------------------------------------
+const uchar*
+LexiconBundle::getSection(SectionType type, quint32* length) const
+{
+    if (!data || !sections.contains(type))
+        return 0;
+
+    Section section = sections.value(type);
+    if (length)
+        *length = section.length;
+    return data + section.offset;
+}
@@ -0,0 +1,95 @@
+//---------------------------------------------------------------------------
+// LexiconBundle.h
+//
+// A class for reading and writing single-file compiled lexicons.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#ifndef ZYZZYVA_LEXICON_BUNDLE_H
+#define ZYZZYVA_LEXICON_BUNDLE_H
+
+#include <QFile>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+class LexiconBundle
+{
+    public:
+    static const char* MAGIC;
+    static const quint32 VERSION;
+    static const int WORD_SLOT_SIZE;
+
+    enum SectionType {
+        SectionForwardDawg = 1,
+        SectionReverseDawg = 2,
+        SectionWords = 3,
+        SectionNumAnagrams = 4,
+        SectionPlayability = 5,
+        SectionDefinitionIndex = 6,
+        SectionDefinitionText = 7,
+        SectionStems = 8
+    };
+
+    public:
+    LexiconBundle();
+    ~LexiconBundle();
+
+    static bool write(const QString& filename, const QStringList& words,
+                      const QMap<QString, QString>& definitions,
+                      const QMap<QString, qint64>& playability,
+                      const QMap<int, QStringList>& stems,
+                      QString* errString = 0);
+
+    bool open(const QString& filename, QString* errString = 0);
+    void close();
+    bool isOpen() const { return data != 0; }
+    QString getFilename() const { return file.fileName(); }
+
+    const qint32* getDawg(bool reverse, qint32* numEdges) const;
+    int getNumWords() const { return numWords; }
+    int findWord(const QString& word) const;
+    QString getWord(int index) const;
+    int getNumAnagrams(int index) const;
+    qint64 getPlayability(int index) const;
+    bool hasDefinitions() const;
+    QString getDefinition(int index) const;
+    QMap<int, QStringList> getStems() const;
+
+    private:
+    class Section {
+        public:
+        Section() : offset(0), length(0) { }
+        quint32 offset;
+        quint32 length;
+    };
+
+    private:
+    const uchar* getSection(SectionType type, quint32* length = 0) const;
+
+    QFile file;
+    uchar* data;
+    qint64 dataSize;
+    bool mapped;
+    int numWords;
+    QMap<int, Section> sections;
+};
+
+#endif // ZYZZYVA_LEXICON_BUNDLE_H
@@ -51,6 +51,7 @@ const QString SETTINGS_IMPORT_LEXICON = "autoimport_lexicon";
 const QString SETTINGS_IMPORT_LEXICONS = "autoimport_lexicons";
 const QString SETTINGS_DEFAULT_LEXICON = "default_lexicon";
 const QString SETTINGS_IMPORT_FILE = "autoimport_file";
+const QString SETTINGS_SHARE_LEXICON_GRAPHS = "share_lexicon_graphs";
 const QString SETTINGS_DISPLAY_WELCOME = "display_welcome";
 const QString SETTINGS_USER_DATA_DIR = "user_data_dir";
 const QString SETTINGS_FONT_MAIN = "font";
@@ -95,6 +96,7 @@ const QString SETTINGS_QUIZ_TIMEOUT_DISABLE_INPUT = "quiz_timeout_disable_input"
 const QString SETTINGS_QUIZ_TIMEOUT_DISABLE_INPUT_MSECS
     = "quiz_timeout_disable_input_msecs";
 const QString SETTINGS_QUIZ_RECORD_STATS = "quiz_record_stats";
+const QString SETTINGS_QUIZ_RECORD_SESSIONS = "quiz_record_sessions";
 const QString SETTINGS_PROBABILITY_NUM_BLANKS = "probability_num_blanks";
 const QString SETTINGS_CARDBOX_SCHEDULES = "cardbox_schedules";
 const QString SETTINGS_CARDBOX_WINDOWS = "cardbox_windows";
@@ -103,6 +105,7 @@ const QString SETTINGS_JUDGE_SAVE_LOG = "judge_save_log";
 
 const bool    DEFAULT_AUTO_IMPORT = true;
 const QString DEFAULT_DEFAULT_LEXICON = Defs::LEXICON_OWL2;
+const bool    DEFAULT_SHARE_LEXICON_GRAPHS = false;
 const bool    DEFAULT_DISPLAY_WELCOME = true;
 const QString DEFAULT_USER_DATA_DIR = Auxil::getHomeDir() + "/Zyzzyva";
 const bool    DEFAULT_USE_TILE_THEME = true;
@@ -123,6 +126,7 @@ const bool    DEFAULT_QUIZ_CYCLE_ANSWERS = true;
 const bool    DEFAULT_QUIZ_TIMEOUT_DISABLE_INPUT = true;
 const int     DEFAULT_QUIZ_TIMEOUT_DISABLE_INPUT_MSECS = 750;
 const bool    DEFAULT_QUIZ_RECORD_STATS = true;
+const bool    DEFAULT_QUIZ_RECORD_SESSIONS = false;
 const int     DEFAULT_PROBABILITY_NUM_BLANKS = 2;
 const QString DEFAULT_CARDBOX_SCHEDULES = "1 4 7 12 20 30 60 90 150 270 480";
 const QString DEFAULT_CARDBOX_WINDOWS = "0 1 2 3 5 7 10 15 20 30 50";
@@ -229,6 +233,10 @@ MainSettings::readSettings()
     instance->autoImportFile
         = settings.value(SETTINGS_IMPORT_FILE).toString();
 
+    instance->shareLexiconGraphs
+        = settings.value(SETTINGS_SHARE_LEXICON_GRAPHS,
+                         DEFAULT_SHARE_LEXICON_GRAPHS).toBool();
+
     instance->displayWelcome
         = settings.value(SETTINGS_DISPLAY_WELCOME,
                          DEFAULT_DISPLAY_WELCOME).toBool();
@@ -295,6 +303,9 @@ MainSettings::readSettings()
     instance->quizRecordStats
         = settings.value(SETTINGS_QUIZ_RECORD_STATS,
                          DEFAULT_QUIZ_RECORD_STATS).toBool();
+    instance->quizRecordSessions
+        = settings.value(SETTINGS_QUIZ_RECORD_SESSIONS,
+                         DEFAULT_QUIZ_RECORD_SESSIONS).toBool();
 
     instance->probabilityNumBlanks
         = settings.value(SETTINGS_PROBABILITY_NUM_BLANKS,
@@ -382,6 +393,8 @@ MainSettings::writeSettings()
     settings.setValue(SETTINGS_IMPORT_LEXICONS, instance->autoImportLexicons);
     settings.setValue(SETTINGS_DEFAULT_LEXICON, instance->defaultLexicon);
     settings.setValue(SETTINGS_IMPORT_FILE, instance->autoImportFile);
+    settings.setValue(SETTINGS_SHARE_LEXICON_GRAPHS,
+                      instance->shareLexiconGraphs);
     settings.setValue(SETTINGS_DISPLAY_WELCOME, instance->displayWelcome);
     settings.setValue(SETTINGS_USER_DATA_DIR, instance->userDataDir);
     settings.setValue(SETTINGS_USE_TILE_THEME, instance->useTileTheme);
@@ -417,6 +430,8 @@ MainSettings::writeSettings()
                       instance->quizTimeoutDisableInputMillisecs);
     settings.setValue(SETTINGS_QUIZ_RECORD_STATS,
                       instance->quizRecordStats);
+    settings.setValue(SETTINGS_QUIZ_RECORD_SESSIONS,
+                      instance->quizRecordSessions);
 
     settings.setValue(SETTINGS_PROBABILITY_NUM_BLANKS,
                       instance->probabilityNumBlanks);
@@ -495,6 +510,7 @@ MainSettings::restoreDefaults(const QString& group)
         instance->defaultLexicon = DEFAULT_DEFAULT_LEXICON;
         instance->autoImportLexicons = QStringList(DEFAULT_DEFAULT_LEXICON);
         instance->autoImportFile = QString();
+        instance->shareLexiconGraphs = DEFAULT_SHARE_LEXICON_GRAPHS;
         instance->displayWelcome = DEFAULT_DISPLAY_WELCOME;
         instance->userDataDir = DEFAULT_USER_DATA_DIR;
     }
@@ -527,6 +543,7 @@ MainSettings::restoreDefaults(const QString& group)
         instance->quizTimeoutDisableInputMillisecs =
             DEFAULT_QUIZ_TIMEOUT_DISABLE_INPUT_MSECS;
         instance->quizRecordStats = DEFAULT_QUIZ_RECORD_STATS;
+        instance->quizRecordSessions = DEFAULT_QUIZ_RECORD_SESSIONS;
     }
 
     if (group.isEmpty() || (group == PROBABILITY_PREFS_GROUP)) {
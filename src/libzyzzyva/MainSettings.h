@@ -67,6 +67,10 @@ class MainSettings
         return instance->autoImportFile; }
     static void setAutoImportFile(const QString& str) {
         instance->autoImportFile = str; }
+    static bool getShareLexiconGraphs() {
+        return instance->shareLexiconGraphs; }
+    static void setShareLexiconGraphs(bool b) {
+        instance->shareLexiconGraphs = b; }
     static QString getDefaultLexicon() {
         return instance->defaultLexicon; }
     static void setDefaultLexicon(const QString& s) {
@@ -139,6 +143,10 @@ class MainSettings
         return instance->quizRecordStats; }
     static void setQuizRecordStats(bool b) {
         instance->quizRecordStats = b; }
+    static bool getQuizRecordSessions() {
+        return instance->quizRecordSessions; }
+    static void setQuizRecordSessions(bool b) {
+        instance->quizRecordSessions = b; }
     static int getProbabilityNumBlanks() {
         return instance->probabilityNumBlanks; }
     static void setProbabilityNumBlanks(int i) {
@@ -229,7 +237,8 @@ class MainSettings
     static void setJudgeSaveLog(bool b) { instance->judgeSaveLog = b; }
 
     private:
-    MainSettings() : useAutoImport(false), useTileTheme(false),
+    MainSettings() : useAutoImport(false), shareLexiconGraphs(false),
+                     useTileTheme(false),
                      wordListSortByLength(false),
                      wordListSortByReverseLength(false),
                      wordListSortByProbabilityOrder(false),
@@ -257,6 +266,7 @@ class MainSettings
     bool useAutoImport;
     QStringList autoImportLexicons;
     QString autoImportFile;
+    bool shareLexiconGraphs;
     QString defaultLexicon;
     bool displayWelcome;
     QString userDataDir;
@@ -278,6 +288,7 @@ class MainSettings
     bool quizTimeoutDisableInput;
     int quizTimeoutDisableInputMillisecs;
     bool quizRecordStats;
+    bool quizRecordSessions;
     int probabilityNumBlanks;
     QList<int> cardboxScheduleList;
     QList<int> cardboxWindowList;
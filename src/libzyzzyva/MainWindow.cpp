@@ -26,7 +26,8 @@
 #include "AboutDialog.h"
 #include "CardboxForm.h"
 #include "CardboxRescheduleDialog.h"
-#include "CreateDatabaseThread.h"
+#include "DatabaseBuildDialog.h"
+#include "DatabaseBuildScheduler.h"
 #include "DatabaseRebuildDialog.h"
 #include "DefinitionDialog.h"
 #include "DefineForm.h"
@@ -53,12 +54,12 @@
 #include <QLabel>
 #include <QMenuBar>
 #include <QMessageBox>
-#include <QProgressDialog>
 #include <QSignalMapper>
 #include <QStatusBar>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QTextStream>
+#include <QTimer>
 #include <QToolBar>
 
 #include "LetterBag.h"
@@ -91,11 +92,15 @@ using namespace Defs;
 //---------------------------------------------------------------------------
 MainWindow::MainWindow(QWidget* parent, QSplashScreen* splash, Qt::WFlags f)
     : QMainWindow(parent, f), splashScreen(splash),
-      wordEngine(new WordEngine()), settingsDialog(new SettingsDialog(this)),
-      aboutDialog(new AboutDialog(this))
+      wordEngine(new WordEngine()), settingsDialog(0), aboutDialog(0)
 {
+    startupClock.start();
     setSplashMessage("Creating interface...");
 
+    connect(wordEngine, SIGNAL(lexiconUnloaded(const QString&,
+                                               const QString&)),
+            SLOT(lexiconUnloaded(const QString&, const QString&)));
+
     // File Menu
     QMenu* fileMenu = menuBar()->addMenu("&File");
 
@@ -175,7 +180,7 @@ MainWindow::MainWindow(QWidget* parent, QSplashScreen* splash, Qt::WFlags f)
     QMenu* editMenu = menuBar()->addMenu("&Edit");
 
     // Preferences
-    QAction* editPrefsAction = new QAction("&Preferences", this);
+    editPrefsAction = new QAction("&Preferences", this);
     editPrefsAction->setIcon(QIcon(":/preferences-icon"));
     connect(editPrefsAction, SIGNAL(triggered()), SLOT(editSettings()));
     editMenu->addAction(editPrefsAction);
@@ -251,7 +256,7 @@ MainWindow::MainWindow(QWidget* parent, QSplashScreen* splash, Qt::WFlags f)
     // Tools Menu
     QMenu* toolsMenu = menuBar()->addMenu("&Tools");
 
-    QAction* rebuildDatabaseAction = new QAction("Rebuild &Database...", this);
+    rebuildDatabaseAction = new QAction("Rebuild &Database...", this);
     connect(rebuildDatabaseAction, SIGNAL(triggered()),
             SLOT(rebuildDatabaseRequested()));
     toolsMenu->addAction(rebuildDatabaseAction);
@@ -276,6 +281,12 @@ MainWindow::MainWindow(QWidget* parent, QSplashScreen* splash, Qt::WFlags f)
     connect(aboutAction, SIGNAL(triggered()), SLOT(displayAbout()));
     helpMenu->addAction(aboutAction);
 
+    // Startup Report
+    QAction* startupReportAction = new QAction("&Startup Report", this);
+    connect(startupReportAction, SIGNAL(triggered()),
+            SLOT(displayStartupReport()));
+    helpMenu->addAction(startupReportAction);
+
     // Tool Bar
     QToolBar* toolbar = new QToolBar;
     toolbar->setIconSize(QSize(22, 22));
@@ -336,7 +347,8 @@ MainWindow::MainWindow(QWidget* parent, QSplashScreen* splash, Qt::WFlags f)
         newIntroForm();
 
     splashScreen = 0;
-    QTimer::singleShot(0, this, SLOT(displayLexiconError()));
+    startupTimes.append(qMakePair(QString("Create interface"),
+                                  startupClock.restart()));
 }
 
 //---------------------------------------------------------------------------
@@ -396,19 +408,16 @@ MainWindow::tryUpdateUserDataDir()
 }
 
 //---------------------------------------------------------------------------
-//  tryAutoImport
+//  chooseAutoImportLexicons
 //
-//! Try automatically importing a lexicon, if the user has enabled it in
-//! preferences.
+//! Determine which lexicons to import automatically.  If none have been
+//! chosen yet, prompt the user with a lexicon selection dialog.
+//
+//! @return the list of lexicons to import
 //---------------------------------------------------------------------------
-void
-MainWindow::tryAutoImport()
+QStringList
+MainWindow::chooseAutoImportLexicons()
 {
-    if (!MainSettings::getUseAutoImport())
-        return;
-
-    setSplashMessage("Loading lexicons...");
-
     // If no auto import lexicons are set, prompt the user with a lexicon
     // selection dialog
     QStringList lexicons = MainSettings::getAutoImportLexicons();
@@ -427,19 +436,13 @@ MainWindow::tryAutoImport()
             MainSettings::setAutoImportLexicons(lexicons);
             MainSettings::setDefaultLexicon(dialog->getDefaultLexicon());
             writeSettings();
-            settingsDialog->readSettings();
+            if (settingsDialog)
+                settingsDialog->readSettings();
         }
 
         delete dialog;
     }
-
-    // FIXME: This should not be part of the MainWindow class.  Lexicons (and
-    // mapping lexicons to actual files) should be handled by someone else.
-    QStringListIterator it (lexicons);
-    while (it.hasNext()) {
-        const QString& lexicon = it.next();
-        importLexicon(lexicon);
-    }
+    return lexicons;
 }
 
 //---------------------------------------------------------------------------
@@ -512,14 +515,136 @@ MainWindow::processDatabaseErrors()
     rebuildDatabases(dbErrors.keys());
 }
 
+//---------------------------------------------------------------------------
+//  runStartupSteps
+//
+//! Begin the startup steps that follow the display of the main window:
+//! loading lexicons, connecting to databases, and opening files.  Each step
+//! runs from the event loop, so the window is painted and can respond
+//! between steps, and the time taken by each step is recorded.  Actions
+//! that load lexicons or rebuild databases are disabled until the last step
+//! has run.
+//
+//! @param files files to open once everything else is loaded
+//---------------------------------------------------------------------------
+void
+MainWindow::runStartupSteps(const QStringList& files)
+{
+    startupTimes.append(qMakePair(QString("Show main window"),
+                                  startupClock.restart()));
+
+    startupFiles = files;
+    startupLexicons.clear();
+    startupSteps.clear();
+    startupSteps << UpdateUserDataDirStep << ChooseLexiconsStep
+                 << ShareLexiconGraphsStep << DisplayLexiconErrorStep
+                 << ConnectToDatabasesStep << ProcessDatabaseErrorsStep
+                 << OpenFilesStep;
+
+    editPrefsAction->setEnabled(false);
+    rebuildDatabaseAction->setEnabled(false);
+    QTimer::singleShot(0, this, SLOT(runNextStartupStep()));
+}
+
+//---------------------------------------------------------------------------
+//  runNextStartupStep
+//
+//! Run the next pending startup step and record how long it took.  Steps
+//! that prompt the user include the time spent waiting for a response.
+//---------------------------------------------------------------------------
+void
+MainWindow::runNextStartupStep()
+{
+    if (startupSteps.isEmpty())
+        return;
+
+    startupClock.restart();
+    StartupStep step = startupSteps.takeFirst();
+    QString stepName;
+    switch (step) {
+        case UpdateUserDataDirStep:
+        stepName = "Update user data directory";
+        tryUpdateUserDataDir();
+        break;
+
+        case ChooseLexiconsStep:
+        stepName = "Choose lexicons";
+        if (MainSettings::getUseAutoImport()) {
+            setSplashMessage("Loading lexicons...");
+            startupLexicons = chooseAutoImportLexicons();
+            for (int i = 0; i < startupLexicons.count(); ++i)
+                startupSteps.prepend(ImportLexiconStep);
+        }
+        break;
+
+        case ImportLexiconStep:
+        stepName = "Load " + startupLexicons.first();
+        importLexicon(startupLexicons.takeFirst());
+        break;
+
+        case ShareLexiconGraphsStep:
+        stepName = "Share word graphs";
+        shareLexiconGraphs();
+        break;
+
+        case DisplayLexiconErrorStep:
+        stepName = "Display lexicon errors";
+        displayLexiconError();
+        break;
+
+        case ConnectToDatabasesStep:
+        stepName = "Connect to databases";
+        tryConnectToDatabases();
+        break;
+
+        case ProcessDatabaseErrorsStep:
+        stepName = "Process database errors";
+        processDatabaseErrors();
+        break;
+
+        case OpenFilesStep:
+        stepName = "Open files";
+        processArguments(startupFiles);
+        startupFiles.clear();
+        break;
+
+        default: break;
+    }
+    startupTimes.append(qMakePair(stepName, startupClock.elapsed()));
+
+    if (startupSteps.isEmpty()) {
+        editPrefsAction->setEnabled(true);
+        rebuildDatabaseAction->setEnabled(true);
+        currentTabChanged(tabStack->currentIndex());
+    }
+    else {
+        QTimer::singleShot(0, this, SLOT(runNextStartupStep()));
+    }
+}
+
+//---------------------------------------------------------------------------
+//  displayStartupReport
+//
+//! Display the time taken by each startup step.
+//---------------------------------------------------------------------------
+void
+MainWindow::displayStartupReport()
+{
+    QMessageBox::information(this, "Startup Report", getStartupReport());
+}
+
 //---------------------------------------------------------------------------
 //  importInteractive
 //
-//! Allow the user to import a word list from a file.
+//! Allow the user to import a word list from a file.  Nothing is done while
+//! startup steps are pending, since they may still be loading lexicons.
 //---------------------------------------------------------------------------
 void
 MainWindow::importInteractive()
 {
+    if (!startupSteps.isEmpty())
+        return;
+
     QString file = QFileDialog::getOpenFileName(this, IMPORT_CHOOSER_TITLE,
         QDir::current().path(), "All Files (*.*)");
 
@@ -709,12 +834,14 @@ MainWindow::editSettings()
 {
     bool settingsChanged = false;
     bool oldAutoImport = false;
+    bool oldShareGraphs = false;
     QSet<QString> oldLexicons;
     QList<LexiconStyle> oldStyles;
     QString oldCustomFile;
-    if (settingsDialog->exec() == QDialog::Accepted) {
+    if (getSettingsDialog()->exec() == QDialog::Accepted) {
         settingsChanged = true;
         oldAutoImport = MainSettings::getUseAutoImport();
+        oldShareGraphs = MainSettings::getShareLexiconGraphs();
         oldLexicons = MainSettings::getAutoImportLexicons().toSet();
         oldCustomFile = MainSettings::getAutoImportFile();
         oldStyles = MainSettings::getWordListLexiconStyles();
@@ -778,6 +905,13 @@ MainWindow::editSettings()
         tryConnectToDatabases();
     }
 
+    // Reloaded lexicons no longer share their word graphs
+    if (!addedLexicons.isEmpty() ||
+        (MainSettings::getShareLexiconGraphs() && !oldShareGraphs))
+    {
+        shareLexiconGraphs();
+    }
+
     // Add DB errors for database whose symbols need to be updated
     if (!symbolLexicons.isEmpty()) {
         processNeeded = true;
@@ -803,7 +937,7 @@ MainWindow::editSettings()
 void
 MainWindow::viewDefinition()
 {
-    WordEntryDialog* entryDialog = new WordEntryDialog(this);
+    WordEntryDialog* entryDialog = new WordEntryDialog(wordEngine, this);
     entryDialog->setWindowTitle("Word Definition");
     entryDialog->resize(entryDialog->minimumSizeHint().width() * 2,
                         entryDialog->minimumSizeHint().height());
@@ -842,7 +976,7 @@ MainWindow::viewVariation(int variation)
         default: break;
     }
 
-    WordEntryDialog* entryDialog = new WordEntryDialog(this);
+    WordEntryDialog* entryDialog = new WordEntryDialog(wordEngine, this);
     entryDialog->setWindowTitle(caption);
     entryDialog->resize(entryDialog->minimumSizeHint().width() * 2,
                         entryDialog->minimumSizeHint().height());
@@ -939,7 +1073,7 @@ MainWindow::rescheduleCardboxRequested()
 void
 MainWindow::displayAbout()
 {
-    aboutDialog->exec();
+    getAboutDialog()->exec();
 }
 
 //---------------------------------------------------------------------------
@@ -990,6 +1124,22 @@ MainWindow::helpDialogError(const QString& message)
     //QMessageBox::warning(this, caption, Auxil::dialogWordWrap(message));
 }
 
+//---------------------------------------------------------------------------
+//  lexiconUnloaded
+//
+//! Called when the word engine unloads a lexicon that can no longer be
+//! used.  Tell the user why.
+//
+//! @param lexicon the name of the lexicon
+//! @param reason the reason the lexicon was unloaded
+//---------------------------------------------------------------------------
+void
+MainWindow::lexiconUnloaded(const QString& lexicon, const QString& reason)
+{
+    QString caption = "Lexicon " + lexicon + " Unloaded";
+    QMessageBox::warning(this, caption, Auxil::dialogWordWrap(reason));
+}
+
 //---------------------------------------------------------------------------
 //  closeCurrentTab
 //
@@ -1183,8 +1333,8 @@ MainWindow::tryConnectToDatabase(const QString& lexicon)
                 break;
             }
 
-            // For custom lexicon, check to see if lexicon file has changed -
-            // if it has, the database is out of date
+            // For custom lexicon, check to see if lexicon file or its
+            // contents have changed - if so, the database is out of date
             if (lexicon == LEXICON_CUSTOM) {
                 QString qstr = "SELECT file FROM lexicon_file";
                 QSqlQuery query (qstr, db);
@@ -1196,6 +1346,17 @@ MainWindow::tryConnectToDatabase(const QString& lexicon)
                     dbError = DbOutOfDate;
                     break;
                 }
+
+                qstr = "SELECT hash FROM lexicon_hash";
+                QSqlQuery hashQuery (qstr, db);
+                QString lexiconHash;
+                if (hashQuery.next())
+                    lexiconHash = hashQuery.value(0).toString();
+
+                if (lexiconHash != wordEngine->getLexiconHash(lexicon)) {
+                    dbError = DbOutOfDate;
+                    break;
+                }
             }
         } while (false);
 
@@ -1245,8 +1406,8 @@ MainWindow::connectToDatabase(const QString& lexicon)
 //---------------------------------------------------------------------------
 //  rebuildDatabases
 //
-//! Rebuild the databases for a list of lexicons.  Also display a progress
-//! dialog.
+//! Rebuild the databases for a list of lexicons.  Several databases are built
+//! at the same time, and a dialog displays their combined progress.
 //
 //! @param lexicons the list of lexicons
 //---------------------------------------------------------------------------
@@ -1255,19 +1416,53 @@ MainWindow::rebuildDatabases(const QStringList& lexicons)
 {
     QStringList successes;
     QStringList failures;
+    QStringList errors;
+
+    DatabaseBuildScheduler scheduler (wordEngine);
     foreach (const QString& lexicon, lexicons) {
-        bool ok = rebuildDatabase(lexicon);
-        // FIXME: do something if DB creation fails!
-        if (!ok) {
+        if (!backupDatabase(lexicon)) {
             failures.append(lexicon);
             continue;
         }
 
-        ok = connectToDatabase(lexicon);
-        if (ok)
-            successes.append(lexicon);
-        else
-            failures.append(lexicon);
+        QString definitionFilename;
+        if (lexicon == LEXICON_CUSTOM) {
+            definitionFilename = MainSettings::getAutoImportFile();
+        }
+        else {
+            definitionFilename = Auxil::getWordsDir() +
+                Auxil::getLexiconPrefix(lexicon) + ".txt";
+        }
+
+        scheduler.addBuild(lexicon, Auxil::getDatabaseFilename(lexicon),
+                           definitionFilename);
+    }
+
+    if (!scheduler.getLexicons().isEmpty()) {
+        DatabaseBuildDialog* dialog = new DatabaseBuildDialog(&scheduler,
+                                                              this);
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        scheduler.start();
+        if (!scheduler.isFinished())
+            dialog->exec();
+        QApplication::restoreOverrideCursor();
+        delete dialog;
+    }
+
+    foreach (const QString& lexicon, scheduler.getLexicons()) {
+        DatabaseBuildScheduler::BuildState state = scheduler.getState(lexicon);
+        if (state == DatabaseBuildScheduler::BuildSucceeded) {
+            if (connectToDatabase(lexicon))
+                successes.append(lexicon);
+            else
+                failures.append(lexicon);
+            continue;
+        }
+
+        if (state == DatabaseBuildScheduler::BuildFailed)
+            errors.append(lexicon + ": " + scheduler.getError(lexicon));
+        restoreDatabase(lexicon);
+        failures.append(lexicon);
     }
 
     QString resultMessage;
@@ -1279,31 +1474,25 @@ MainWindow::rebuildDatabases(const QStringList& lexicons)
         resultMessage += "These databases encountered errors: " +
             failures.join(", ") + ".";
     }
+    if (!errors.isEmpty())
+        resultMessage += "\n\n" + errors.join("\n");
 
     QMessageBox::information(this, "Database Creation Result", resultMessage);
 }
 
 //---------------------------------------------------------------------------
-//  rebuildDatabase
+//  backupDatabase
 //
-//! Rebuild the database for a lexicon.  Also display a progress dialog.
+//! Move the database for a lexicon out of the way before rebuilding it, so
+//! it can be restored if the rebuild fails.
 //
 //! @param lexicon the lexicon name
 //! @return true if successful, false otherwise
 //---------------------------------------------------------------------------
 bool
-MainWindow::rebuildDatabase(const QString& lexicon)
+MainWindow::backupDatabase(const QString& lexicon)
 {
     QString dbFilename = Auxil::getDatabaseFilename(lexicon);
-    QString definitionFilename;
-    if (lexicon == LEXICON_CUSTOM) {
-        definitionFilename = MainSettings::getAutoImportFile();
-    }
-    else {
-        definitionFilename = Auxil::getWordsDir() +
-            Auxil::getLexiconPrefix(lexicon) + ".txt";
-    }
-
     QFileInfo fileInfo (dbFilename);
     QString file = fileInfo.fileName();
     QString path = fileInfo.path();
@@ -1336,52 +1525,30 @@ MainWindow::rebuildDatabase(const QString& lexicon)
         return false;
     }
 
-    QProgressDialog* dialog = new QProgressDialog(this);
-
-    QLabel* dialogLabel = new QLabel("Creating " + lexicon + " database...");
-    dialog->setWindowTitle("Creating " + lexicon + " Database");
-    dialog->setLabel(dialogLabel);
-
-    CreateDatabaseThread* thread = new CreateDatabaseThread(wordEngine,
-        lexicon, dbFilename, definitionFilename, this);
-    connect(thread, SIGNAL(steps(int)),
-            dialog, SLOT(setMaximum(int)));
-    connect(thread, SIGNAL(progress(int)),
-            dialog, SLOT(setValue(int)));
-    connect(dialog, SIGNAL(canceled()), thread, SLOT(cancel()));
-
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-
-    thread->start();
-    dialog->exec();
-    thread->quit();
-    thread->wait();
-
-    QApplication::restoreOverrideCursor();
-
-    bool success = true;
-    if (!thread->getError().isEmpty()) {
-        QMessageBox::information(this, "Unable to Create Database",
-            thread->getError());
-        success = false;
-    }
-
-    else if (thread->getCancelled()) {
-        QMessageBox::information(this, "Database Not Created",
-            "Database creation cancelled.");
-        success = false;
-    }
+    return true;
+}
 
-    if (!success) {
-        if (dbFile.exists())
-            dbFile.remove();
-        if (tmpDbFile.exists())
-            tmpDbFile.rename(dbFilename);
-    }
+//---------------------------------------------------------------------------
+//  restoreDatabase
+//
+//! Remove a partially built database for a lexicon and restore the database
+//! saved by backupDatabase.
+//
+//! @param lexicon the lexicon name
+//---------------------------------------------------------------------------
+void
+MainWindow::restoreDatabase(const QString& lexicon)
+{
+    QString dbFilename = Auxil::getDatabaseFilename(lexicon);
+    QFileInfo fileInfo (dbFilename);
+    QString tmpDbFilename = fileInfo.path() + "/orig-" + fileInfo.fileName();
 
-    delete thread;
-    delete dialog;
-    return success;
+    QFile dbFile (dbFilename);
+    QFile tmpDbFile (tmpDbFilename);
+    if (dbFile.exists())
+        dbFile.remove();
+    if (tmpDbFile.exists())
+        tmpDbFile.rename(dbFilename);
 }
 
 //---------------------------------------------------------------------------
@@ -1446,6 +1613,31 @@ MainWindow::rescheduleCardbox(const QStringList& words,
     }
 }
 
+//---------------------------------------------------------------------------
+//  getStartupReport
+//
+//! Return a report of the time taken by each startup step, one step per
+//! line, followed by the total.
+//
+//! @return the startup report
+//---------------------------------------------------------------------------
+QString
+MainWindow::getStartupReport() const
+{
+    QString report;
+    int total = 0;
+    QListIterator<QPair<QString, int> > it (startupTimes);
+    while (it.hasNext()) {
+        const QPair<QString, int>& time = it.next();
+        report += QString("%1: %2 ms\n").arg(time.first).arg(time.second);
+        total += time.second;
+    }
+    report += QString("Total: %1 ms").arg(total);
+    if (!startupSteps.isEmpty())
+        report += "\n\nStartup is still in progress.";
+    return report;
+}
+
 //---------------------------------------------------------------------------
 //  closeEvent
 //
@@ -1692,6 +1884,34 @@ MainWindow::newQuizFromWordFile(const QString& filename)
     newQuizForm(quizSpec);
 }
 
+//---------------------------------------------------------------------------
+//  importOverlay
+//
+//! Import a lexicon as a list of changes to another lexicon.
+//
+//! @param lexicon the name of the lexicon
+//! @param baseLexicon the name of the base lexicon
+//! @param file the overlay file to import
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+MainWindow::importOverlay(const QString& lexicon, const QString& baseLexicon,
+                          const QString& file)
+{
+    QString errString;
+    bool ok = wordEngine->importOverlayFile(lexicon, baseLexicon, file,
+                                            &errString);
+
+    if (!ok) {
+        QString message = "Unable to load the " + lexicon + " lexicon.  "
+            "The following errors occurred:\n" + errString;
+        message = Auxil::dialogWordWrap(message);
+        QMessageBox::warning(this, "Unable to load lexicon", message);
+    }
+
+    return ok;
+}
+
 //---------------------------------------------------------------------------
 //  importDawg
 //
@@ -1761,6 +1981,33 @@ MainWindow::importChecksums(const QString& filename)
     return checksums;
 }
 
+//---------------------------------------------------------------------------
+//  importBundle
+//
+//! Import a lexicon from a single-file bundle compiled by lexc.
+//
+//! @param lexicon the name of the lexicon
+//! @param file the bundle file
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+MainWindow::importBundle(const QString& lexicon, const QString& file)
+{
+    QString errString;
+    QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+    bool ok = wordEngine->importLexiconBundle(lexicon, file, &errString);
+    QApplication::restoreOverrideCursor();
+
+    if (!ok) {
+        QString message = "Unable to load the " + lexicon + " lexicon.  "
+            "The following errors occurred:\n" + errString;
+        message = Auxil::dialogWordWrap(message);
+        QMessageBox::warning(this, "Unable to load lexicon", message);
+    }
+
+    return ok;
+}
+
 //---------------------------------------------------------------------------
 //  setSplashMessage
 //
@@ -1780,6 +2027,36 @@ MainWindow::setSplashMessage(const QString& message)
     qApp->processEvents();
 }
 
+//---------------------------------------------------------------------------
+//  getSettingsDialog
+//
+//! Return the settings dialog, creating it the first time it is needed.
+//
+//! @return the settings dialog
+//---------------------------------------------------------------------------
+SettingsDialog*
+MainWindow::getSettingsDialog()
+{
+    if (!settingsDialog)
+        settingsDialog = new SettingsDialog(this);
+    return settingsDialog;
+}
+
+//---------------------------------------------------------------------------
+//  getAboutDialog
+//
+//! Return the About dialog, creating it the first time it is needed.
+//
+//! @return the About dialog
+//---------------------------------------------------------------------------
+AboutDialog*
+MainWindow::getAboutDialog()
+{
+    if (!aboutDialog)
+        aboutDialog = new AboutDialog(this);
+    return aboutDialog;
+}
+
 //---------------------------------------------------------------------------
 //  fixTrolltechConfig
 //
@@ -1874,7 +2151,8 @@ MainWindow::updateSettings()
 
         if (added) {
             MainSettings::setWordListLexiconStyles(styles);
-            settingsDialog->refreshSettings();
+            if (settingsDialog)
+                settingsDialog->refreshSettings();
         }
     }
 }
@@ -1984,7 +2262,41 @@ MainWindow::renameLexicon(const QString& oldName, const QString& newName)
     }
     if (changed) {
         MainSettings::setWordListLexiconStyles(lexiconStyles);
-        settingsDialog->refreshSettings();
+        if (settingsDialog)
+            settingsDialog->refreshSettings();
+    }
+}
+
+//---------------------------------------------------------------------------
+//  shareLexiconGraphs
+//
+//! Let loaded lexicons of the same family share a single word graph, if the
+//! user has enabled it in preferences.  Lexicons that cannot share a graph
+//! keep their own.
+//---------------------------------------------------------------------------
+void
+MainWindow::shareLexiconGraphs()
+{
+    if (!MainSettings::getShareLexiconGraphs())
+        return;
+
+    QList<QStringList> families;
+    families << (QStringList() << LEXICON_OWL << LEXICON_OWL2 << LEXICON_OSPD4)
+             << (QStringList() << LEXICON_CSW07 << LEXICON_CSW12)
+             << (QStringList() << LEXICON_ODS4 << LEXICON_ODS5);
+
+    foreach (const QStringList& family, families) {
+        QStringList lexicons;
+        foreach (const QString& lexicon, family) {
+            if (wordEngine->lexiconIsLoaded(lexicon))
+                lexicons.append(lexicon);
+        }
+        if (lexicons.count() < 2)
+            continue;
+
+        setSplashMessage("Sharing " + lexicons.join(", ") +
+                         " word graphs...");
+        wordEngine->shareLexiconGraphs(lexicons);
     }
 }
 
@@ -2003,6 +2315,7 @@ MainWindow::importLexicon(const QString& lexicon)
     QString reverseImportFile;
     QString checksumFile;
     QString playabilityFile;
+    QString bundleFile;
     bool ok = true;
     bool dawg = true;
     if (lexicon == LEXICON_CUSTOM) {
@@ -2011,8 +2324,12 @@ MainWindow::importLexicon(const QString& lexicon)
 
         if (wordEngine->lexiconIsLoaded(lexicon)) {
             QString lexiconFile = wordEngine->getLexiconFile(lexicon);
-            if (lexiconFile == importFile)
+            QString lexiconHash = wordEngine->getLexiconHash(lexicon);
+            if ((lexiconFile == importFile) &&
+                (lexiconHash == Auxil::getFileContentHash(importFile)))
+            {
                 return true;
+            }
         }
     }
     else {
@@ -2040,9 +2357,16 @@ MainWindow::importLexicon(const QString& lexicon)
             reverseImportFile = prefix + "-R.dwg";
             checksumFile =      prefix + "-Checksums.txt";
             playabilityFile =   prefix + "-Playability.txt";
+            bundleFile =        prefix + ".zlx";
         }
     }
 
+    // A compiled bundle holds the graphs, checksums and stems in one file
+    if (!bundleFile.isEmpty() && QFile::exists(bundleFile)) {
+        setSplashMessage("Loading " + lexicon + " lexicon...");
+        return importBundle(lexicon, bundleFile);
+    }
+
     if (importFile.isEmpty())
         return false;
 
@@ -2077,8 +2401,17 @@ MainWindow::importLexicon(const QString& lexicon)
         ok = ok && importDawg(lexicon, reverseImportFile, true, &lexiconError,
                               &expectedReverseChecksum);
     }
-    else
-        ok = importText(lexicon, importFile);
+    else {
+        // A custom lexicon may be given as changes to another lexicon
+        QString baseLexicon = WordEngine::readOverlayBase(importFile);
+        if (!baseLexicon.isEmpty() && (baseLexicon != lexicon) &&
+            importLexicon(baseLexicon))
+        {
+            ok = importOverlay(lexicon, baseLexicon, importFile);
+        }
+        else
+            ok = importCompiledText(lexicon, importFile);
+    }
 
     importStems(lexicon);
 
@@ -2103,6 +2436,34 @@ MainWindow::importText(const QString& lexicon, const QString& file)
     return imported;
 }
 
+//---------------------------------------------------------------------------
+//  importCompiledText
+//
+//! Import words from a text file, using a compiled bundle cached for the
+//! current contents of the file when possible.
+//
+//! @param lexicon the name of the lexicon
+//! @param file the file to import words from
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+MainWindow::importCompiledText(const QString& lexicon, const QString& file)
+{
+    QString errString;
+    QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+    bool ok = wordEngine->importCompiledTextFile(lexicon, file, &errString);
+    QApplication::restoreOverrideCursor();
+
+    if (!ok) {
+        QString message = "Unable to load the " + lexicon + " lexicon.  "
+            "The following errors occurred:\n" + errString;
+        message = Auxil::dialogWordWrap(message);
+        QMessageBox::warning(this, "Unable to load lexicon", message);
+    }
+
+    return ok;
+}
+
 //---------------------------------------------------------------------------
 //  importStems
 //
@@ -30,9 +30,11 @@
 #include <QIcon>
 #include <QLabel>
 #include <QMainWindow>
+#include <QPair>
 #include <QSettings>
 #include <QSplashScreen>
 #include <QTabWidget>
+#include <QTime>
 #include <QToolButton>
 
 class AboutDialog;
@@ -57,9 +59,11 @@ class MainWindow : public QMainWindow
     void fileOpenRequested(const QString& filename);
     void processArguments(const QStringList& args);
     void tryUpdateUserDataDir();
-    void tryAutoImport();
     void tryConnectToDatabases();
     void processDatabaseErrors();
+    void runStartupSteps(const QStringList& files = QStringList());
+    void runNextStartupStep();
+    void displayStartupReport();
     void importInteractive();
     void newQuizFormInteractive();
     void newQuizFormInteractive(const QuizSpec& quizSpec);
@@ -80,6 +84,7 @@ class MainWindow : public QMainWindow
     void displayHelp();
     void displayLexiconError();
     void helpDialogError(const QString& message);
+    void lexiconUnloaded(const QString& lexicon, const QString& reason);
     void closeCurrentTab();
     void currentTabChanged(int index);
     void tabTitleChanged(const QString& title);
@@ -98,26 +103,36 @@ class MainWindow : public QMainWindow
     // separate class for manipulating quiz databases.  Hm, how about the
     // QuizStatsDatabase class?
     void rebuildDatabases(const QStringList& lexicons);
-    bool rebuildDatabase(const QString& lexicon);
+    bool backupDatabase(const QString& lexicon);
+    void restoreDatabase(const QString& lexicon);
     int rescheduleCardbox(const QStringList& words, const QString& lexicon,
         const QString& quizType, CardboxRescheduleType rescheduleType,
         int rescheduleValue = 0) const;
+    QString getStartupReport() const;
 
     protected:
     virtual void closeEvent(QCloseEvent* event);
 
     private:
     void setSplashMessage(const QString& message);
+    SettingsDialog* getSettingsDialog();
+    AboutDialog* getAboutDialog();
+    QStringList chooseAutoImportLexicons();
     void fixTrolltechConfig();
     void updateSettings();
     void makeUserDirs();
     void renameLexicon(const QString& oldName, const QString& newName);
     bool importLexicon(const QString& lexicon);
+    void shareLexiconGraphs();
     int importText(const QString& lexicon, const QString& file);
+    bool importCompiledText(const QString& lexicon, const QString& file);
+    bool importOverlay(const QString& lexicon, const QString& baseLexicon,
+                       const QString& file);
     bool importDawg(const QString& lexicon, const QString& file,
                     bool reverse = false, QString* errString = 0,
                     quint16* expectedChecksum = 0);
     QList<quint16> importChecksums(const QString& file);
+    bool importBundle(const QString& lexicon, const QString& file);
     int importStems(const QString& lexicon);
     void readSettings(bool useGeometry);
     void writeSettings();
@@ -135,6 +150,17 @@ class MainWindow : public QMainWindow
         DbSymbolsOutOfDate
     };
 
+    enum StartupStep {
+        UpdateUserDataDirStep,
+        ChooseLexiconsStep,
+        ImportLexiconStep,
+        ShareLexiconGraphsStep,
+        DisplayLexiconErrorStep,
+        ConnectToDatabasesStep,
+        ProcessDatabaseErrorsStep,
+        OpenFilesStep
+    };
+
     private:
     QSplashScreen* splashScreen;
     WordEngine*  wordEngine;
@@ -145,6 +171,8 @@ class MainWindow : public QMainWindow
 
     QAction*     saveAction;
     QAction*     saveAsAction;
+    QAction*     editPrefsAction;
+    QAction*     rebuildDatabaseAction;
 
     SettingsDialog* settingsDialog;
     AboutDialog*    aboutDialog;
@@ -153,6 +181,12 @@ class MainWindow : public QMainWindow
     QString lexiconError;
     QMap<QString, int> dbErrors;
 
+    QList<StartupStep> startupSteps;
+    QStringList startupLexicons;
+    QStringList startupFiles;
+    QList<QPair<QString, int> > startupTimes;
+    QTime startupClock;
+
     static MainWindow*  instance;
 };
 
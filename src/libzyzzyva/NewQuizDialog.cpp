@@ -183,6 +183,38 @@ NewQuizDialog::NewQuizDialog(QWidget* parent, Qt::WFlags f)
     connect(searchSpecForm, SIGNAL(returnPressed()), SLOT(accept()));
     specHlay->addWidget(searchSpecForm);
 
+    QHBoxLayout* sampleHlay = new QHBoxLayout;
+    searchVlay->addLayout(sampleHlay);
+
+    sampleCbox = new QCheckBox("Sa&mple at most");
+    connect(sampleCbox, SIGNAL(toggled(bool)), SLOT(sampleToggled(bool)));
+    sampleHlay->addWidget(sampleCbox);
+
+    sampleWidget = new QWidget;
+    sampleWidget->setEnabled(false);
+    sampleHlay->addWidget(sampleWidget);
+
+    QHBoxLayout* sampleWidgetHlay = new QHBoxLayout(sampleWidget);
+    sampleWidgetHlay->setMargin(0);
+
+    sampleSbox = new QSpinBox;
+    sampleSbox->setMinimum(1);
+    sampleSbox->setMaximum(999999);
+    sampleSbox->setValue(200);
+    sampleWidgetHlay->addWidget(sampleSbox);
+
+    QLabel* sampleLabel = new QLabel("questions, weighted by");
+    sampleWidgetHlay->addWidget(sampleLabel);
+
+    // Items are in the order of SampleWeight values
+    sampleWeightCombo = new QComboBox;
+    sampleWeightCombo->addItem("Nothing");
+    sampleWeightCombo->addItem("Probability");
+    sampleWeightCombo->addItem("Playability");
+    sampleWidgetHlay->addWidget(sampleWeightCombo);
+
+    sampleHlay->addStretch(1);
+
     QHBoxLayout* progressHlay = new QHBoxLayout;
     mainVlay->addLayout(progressHlay);
 
@@ -291,6 +323,11 @@ NewQuizDialog::getQuizSpec()
         quizSpec.setSearchSpec(searchSpecForm->getSearchSpec());
     }
 
+    bool sample = sampleCbox->isChecked() &&
+        (quizSpec.getQuizSourceType() == QuizSpec::SearchSource);
+    quizSpec.setSampleSize(sample ? sampleSbox->value() : 0);
+    quizSpec.setSampleWeight(sample ? sampleWeightCombo->currentIndex() : 0);
+
     QWidget* widget = sourceStack->currentWidget();
     if (widget == buildWidget) {
         quizSpec.setResponseMinLength(responseMinSbox->value());
@@ -354,6 +391,13 @@ NewQuizDialog::setQuizSpec(const QuizSpec& spec)
         searchSpecForm->setSearchSpec(SearchSpec());
     }
 
+    int sampleSize = spec.getSampleSize();
+    sampleCbox->setChecked(sampleSize);
+    if (sampleSize) {
+        sampleSbox->setValue(sampleSize);
+        sampleWeightCombo->setCurrentIndex(spec.getSampleWeight());
+    }
+
     int responseMin = spec.getResponseMinLength();
     if (responseMin)
         responseMinSbox->setValue(responseMin);
@@ -473,6 +517,20 @@ NewQuizDialog::timerToggled(bool on)
     timerWidget->setEnabled(on);
 }
 
+//---------------------------------------------------------------------------
+//  sampleToggled
+//
+//! Called when the Sample checkbox is toggled.  Disable the sample
+//! configuration unless the Sample checkbox is checked.
+//
+//! @param on whether the checkbox is checked
+//---------------------------------------------------------------------------
+void
+NewQuizDialog::sampleToggled(bool on)
+{
+    sampleWidget->setEnabled(on);
+}
+
 //---------------------------------------------------------------------------
 //  searchContentsChanged
 //
@@ -54,6 +54,7 @@ class NewQuizDialog : public QDialog
 
     public slots:
     void timerToggled(bool on);
+    void sampleToggled(bool on);
     void typeActivated(const QString& text);
     void methodActivated(const QString& text);
     void useSearchButtonToggled(bool on);
@@ -87,6 +88,10 @@ class NewQuizDialog : public QDialog
     QRadioButton*   useSearchButton;
     QGroupBox*      searchSpecGbox;
     SearchSpecForm* searchSpecForm;
+    QCheckBox*      sampleCbox;
+    QWidget*        sampleWidget;
+    QSpinBox*       sampleSbox;
+    QComboBox*      sampleWeightCombo;
     ZPushButton*    saveQuizButton;
     ZPushButton*    okButton;
     QWidget*        timerWidget;
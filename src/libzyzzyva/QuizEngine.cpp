@@ -31,6 +31,8 @@
 #include "Auxil.h"
 #include <cstdlib>
 
+const int MAX_SIGNATURE_BIT = 63;
+
 //---------------------------------------------------------------------------
 //  probabilityCmp
 //
@@ -105,24 +107,55 @@ QuizEngine::newQuiz(const QuizSpec& spec)
         quizSpec = spec;
     }
 
+    // Cardbox quizzes limited by a search spec can often be selected with a
+    // single query against the stats and lexicon databases
+    else if (getReadyMatchingQuestions(spec, &questions)) {
+        if (questions.isEmpty())
+            return false;
+        quizSpec = spec;
+        quizQuestions = questions;
+    }
+
     else {
         // Anagram Quiz: The search spec is used to select the list of words.
         // Their alphagrams are used as quiz questions, and their anagrams are
         // used as quiz answers.
         QStringList questionWords;
         QuizSpec::QuizType quizType = spec.getType();
-        if ((quizType == QuizSpec::QuizAnagrams) ||
-            (quizType == QuizSpec::QuizAnagramsWithHooks))
-        {
-            questionWords =
-                wordEngine->search(lexicon, spec.getSearchSpec(), true);
-            questions = wordEngine->alphagrams(questionWords);
+        int sampleSize = spec.getSampleSize();
+
+        // Seed the random number generator before searching, because a
+        // sample of the questions is drawn from it as well as shuffled by it
+        bool seeded = (sampleSize ||
+                       (spec.getQuestionOrder() == QuizSpec::RandomOrder));
+        unsigned int seed = 0;
+        unsigned int seed2 = 0;
+        if (seeded) {
+            seed = spec.getRandomSeed();
+            if (!seed)
+                seed = QDateTime::currentDateTime().toTime_t();
+            seed2 = spec.getRandomSeed2();
+            if (!seed2)
+                seed2 = Auxil::getPid();
+            rng.setAlgorithm(spec.getRandomAlgorithm());
+            rng.srand(seed, seed2);
         }
 
-        else if (quizType == QuizSpec::QuizHooks) {
-            questionWords =
-                wordEngine->search(lexicon, spec.getSearchSpec(), true);
-            questions = questionWords;
+        bool alphagramQuiz = ((quizType == QuizSpec::QuizAnagrams) ||
+                              (quizType == QuizSpec::QuizAnagramsWithHooks));
+        if (alphagramQuiz || (quizType == QuizSpec::QuizHooks)) {
+            if (sampleSize) {
+                questionWords = wordEngine->sampleSearch(lexicon,
+                    spec.getSearchSpec(), sampleSize,
+                    SampleWeight(spec.getSampleWeight()),
+                    spec.getProbabilityNumBlanks(), alphagramQuiz, &rng);
+            }
+            else {
+                questionWords =
+                    wordEngine->search(lexicon, spec.getSearchSpec(), true);
+            }
+            questions = alphagramQuiz ? wordEngine->alphagrams(questionWords)
+                                      : questionWords;
         }
 
         else if (quizType == QuizSpec::QuizWordListRecall) {
@@ -134,6 +167,10 @@ QuizEngine::newQuiz(const QuizSpec& spec)
 
         quizSpec = spec;
         quizQuestions = questions;
+        if (seeded) {
+            quizSpec.setRandomSeed(seed);
+            quizSpec.setRandomSeed2(seed2);
+        }
 
         switch (quizSpec.getQuestionOrder()) {
             case QuizSpec::AlphabeticalOrder:
@@ -141,17 +178,6 @@ QuizEngine::newQuiz(const QuizSpec& spec)
             break;
 
             case QuizSpec::RandomOrder: {
-                unsigned int seed = spec.getRandomSeed();
-                if (!seed)
-                    seed = QDateTime::currentDateTime().toTime_t();
-                unsigned int seed2 = spec.getRandomSeed2();
-                if (!seed2)
-                    seed2 = Auxil::getPid();
-                rng.setAlgorithm(spec.getRandomAlgorithm());
-                rng.srand(seed, seed2);
-                quizSpec.setRandomSeed(seed);
-                quizSpec.setRandomSeed2(seed2);
-
                 // XXX: We need a Shuffle class to handle shuffling using various
                 // algorithms!
                 QString tmp;
@@ -275,8 +301,9 @@ QuizEngine::newQuiz(const QuizSpec& spec)
     // number of quiz answers by subtracting that number of responses.  This
     // is necessary because we used the quizCorrect total (including these
     // correct responses) as a base for the quizTotal calculation earlier.
-    correctUserResponses = progress.getQuestionCorrect();
-    if (!correctUserResponses.empty())
+    foreach (const QString& word, progress.getQuestionCorrect())
+        correctUserResponses.insert(word);
+    if (!correctUserResponses.isEmpty())
         quizTotal -= correctUserResponses.size();
 
     return true;
@@ -355,7 +382,8 @@ QuizEngine::respond(const QString& response, bool lexiconSymbols)
     QString word (response);
     bool ok = true;
 
-    // Check hooks (including lexicon symbols) for Anagrms With Hooks quiz
+    // Check hooks (including lexicon symbols) for Anagrams With Hooks quiz
+    // against the signatures computed when the question was prepared
     if (quizSpec.getType() == QuizSpec::QuizAnagramsWithHooks) {
         QStringList sections = response.split(":");
         if (sections.size() != 3) {
@@ -363,36 +391,35 @@ QuizEngine::respond(const QString& response, bool lexiconSymbols)
             return Incorrect;
         }
 
-        QString frontHooks = sections.at(0);
+        HookSignature signature;
         word = sections.at(1);
-        QString baseWord = word;
-        baseWord.replace(QRegExp("[\\W_\\d]+"), QString());
-        QString backHooks = sections.at(2);
-
-        QString lexicon = quizSpec.getLexicon();
-        QString frontAnswers =
-            wordEngine->getFrontHookLetters(lexicon, baseWord).toUpper();
-        QString backAnswers =
-            wordEngine->getBackHookLetters(lexicon, baseWord).toUpper();
-
         if (lexiconSymbols) {
-            QMap<QChar, QString> frontAnsMap = parseHookSymbols(frontAnswers);
-            QMap<QChar, QString> backAnsMap = parseHookSymbols(backAnswers);
-            QMap<QChar, QString> frontMap = parseHookSymbols(frontHooks);
-            QMap<QChar, QString> backMap = parseHookSymbols(backHooks);
-            ok = ((frontMap == frontAnsMap) && (backMap == backAnsMap));
+            QString letters;
+            QString symbols;
+            foreach (const QChar& c, word) {
+                if (c.isLetter())
+                    letters += c;
+                else
+                    symbols += c;
+            }
+            word = letters;
+            ok = parseSymbols(symbols, false, &signature.wordSymbols);
         }
-        else {
-            frontHooks = Auxil::getAlphagram(frontHooks);
-            backHooks = Auxil::getAlphagram(backHooks);
-            frontAnswers.replace(QRegExp("[\\W_\\d]+"), QString());
-            backAnswers.replace(QRegExp("[\\W_\\d]+"), QString());
-            ok = ((frontHooks == frontAnswers) && (backHooks == backAnswers));
+
+        ok = ok && parseHooks(sections.at(0), false, lexiconSymbols,
+                              &signature.frontHooks, &signature.frontSymbols)
+                && parseHooks(sections.at(2), false, lexiconSymbols,
+                              &signature.backHooks, &signature.backSymbols);
+
+        if (ok) {
+            HookSignature answerSignature;
+            ok = getHookSignature(word, &answerSignature) &&
+                signature.matches(answerSignature, lexiconSymbols);
         }
     }
 
     // Check lexicon symbols
-    if (ok && lexiconSymbols) {
+    else if (lexiconSymbols) {
         QRegExp re ("(?:([^\\W_\\d]+)([\\W_\\d]*))");
         QString symbols;
         if (re.indexIn(word) >= 0) {
@@ -459,7 +486,7 @@ void
 QuizEngine::markQuestionAsMissed()
 {
     // Remove any correct answers the user may have already had
-    int numCorrect = correctUserResponses.count();
+    int numCorrect = correctUserResponses.size();
     quizCorrect -= numCorrect;
 
     correctUserResponses.clear();
@@ -495,15 +522,59 @@ QStringList
 QuizEngine::getMissed() const
 {
     QStringList missedWords;
-    QSetIterator<QString> it (correctResponses);
-    while (it.hasNext()) {
-        QString word = it.next();
+    foreach (const QString& word, correctResponses.toStringList()) {
         if (!correctUserResponses.contains(word))
             missedWords.append(word);
     }
     return missedWords;
 }
 
+//---------------------------------------------------------------------------
+//  getAnswerResponse
+//
+//! Get the response that correctly answers the current question with a
+//! word, including its hooks in an Anagrams With Hooks quiz.
+//
+//! @param word the word
+//! @param lexiconSymbols whether to include lexicon symbols
+//! @return the response
+//---------------------------------------------------------------------------
+QString
+QuizEngine::getAnswerResponse(const QString& word, bool lexiconSymbols) const
+{
+    if (quizSpec.getType() != QuizSpec::QuizAnagramsWithHooks) {
+        if (!lexiconSymbols)
+            return word;
+        return word + wordEngine->getLexiconSymbols(quizSpec.getLexicon(),
+                                                    word);
+    }
+
+    HookSignature signature;
+    getHookSignature(word, &signature);
+
+    QString response = hooksToString(signature.frontHooks,
+                                     signature.frontSymbols, lexiconSymbols);
+    response += ":" + word;
+    if (lexiconSymbols)
+        response += symbolsToString(signature.wordSymbols);
+    response += ":" + hooksToString(signature.backHooks,
+                                    signature.backSymbols, lexiconSymbols);
+    return response;
+}
+
+//---------------------------------------------------------------------------
+//  getQuestionCorrectResponses
+//
+//! Get the correct responses the user has given for the current question.
+//
+//! @return the correct user responses
+//---------------------------------------------------------------------------
+QSet<QString>
+QuizEngine::getQuestionCorrectResponses() const
+{
+    return correctUserResponses.toStringList().toSet();
+}
+
 //---------------------------------------------------------------------------
 //  onLastQuestion
 //
@@ -528,6 +599,10 @@ QuizEngine::clearQuestion()
     correctResponses.clear();
     correctUserResponses.clear();
     incorrectUserResponses.clear();
+    hookSignatures.clear();
+    otherHookSignatures.clear();
+    signatureLetters.clear();
+    signatureSymbols.clear();
 }
 
 //---------------------------------------------------------------------------
@@ -604,8 +679,87 @@ QuizEngine::prepareQuestion()
         answers += wordEngine->search(lexicon, spec, true);
     }
 
-    correctResponses += answers.toSet();
-    quizTotal += correctResponses.count();
+    foreach (const QString& answer, answers)
+        correctResponses.insert(answer);
+    quizTotal += correctResponses.size();
+
+    // Compute the hooks and symbols of each answer once, so responses can be
+    // checked without looking them up again
+    if (type == QuizSpec::QuizAnagramsWithHooks) {
+        foreach (const QString& answer, answers) {
+            HookSignature signature;
+            parseHooks(wordEngine->getFrontHookLetters(lexicon,
+                                                       answer).toUpper(),
+                       true, true, &signature.frontHooks,
+                       &signature.frontSymbols);
+            parseHooks(wordEngine->getBackHookLetters(lexicon,
+                                                      answer).toUpper(),
+                       true, true, &signature.backHooks,
+                       &signature.backSymbols);
+            parseSymbols(wordEngine->getLexiconSymbols(lexicon, answer), true,
+                         &signature.wordSymbols);
+            if (FixedWord::canHold(answer))
+                hookSignatures.insert(FixedWord(answer), signature);
+            else
+                otherHookSignatures.insert(answer, signature);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+//  getReadyMatchingQuestions
+//
+//! Select the ready questions of a scheduled quiz whose words match the
+//! quiz search spec, by joining the cardbox stats with the lexicon database
+//! in one query.  Only possible if the lexicon database can evaluate every
+//! condition of the search spec, and the quiz does not draw a sample of the
+//! matching words, which must be drawn before the ready questions are
+//! selected.
+//
+//! @param spec the quiz spec
+//! @param questions return the ready questions, in scheduled order
+//! @return true if the questions were selected, false if the quiz must be
+//! built from a word search instead
+//---------------------------------------------------------------------------
+bool
+QuizEngine::getReadyMatchingQuestions(const QuizSpec& spec, QStringList*
+                                      questions)
+{
+    QuizSpec::QuestionOrder order = spec.getQuestionOrder();
+    if ((order != QuizSpec::ScheduleOrder) &&
+        (order != QuizSpec::ScheduleZeroFirstOrder))
+    {
+        return false;
+    }
+
+    if (spec.getSampleSize())
+        return false;
+
+    QuizSpec::QuizType quizType = spec.getType();
+    bool alphagrams = ((quizType == QuizSpec::QuizAnagrams) ||
+                       (quizType == QuizSpec::QuizAnagramsWithHooks));
+    if (!alphagrams && (quizType != QuizSpec::QuizHooks))
+        return false;
+
+    QString lexicon = spec.getLexicon();
+    QString condition;
+    if (!wordEngine->getDatabaseCondition(lexicon, spec.getSearchSpec(),
+                                          &condition))
+    {
+        return false;
+    }
+
+    QuizStatsDatabase db (lexicon, Auxil::quizTypeToString(quizType));
+    if (!db.isValid() ||
+        !db.attachLexiconDatabase(wordEngine->getDatabaseFilename(lexicon)))
+    {
+        return false;
+    }
+
+    bool zeroFirst = (order == QuizSpec::ScheduleZeroFirstOrder);
+    *questions = db.getReadyMatchingQuestions(condition, alphagrams,
+                                              zeroFirst);
+    return true;
 }
 
 //---------------------------------------------------------------------------
@@ -644,25 +798,186 @@ QuizEngine::addQuestionIncorrect(const QString& response)
 }
 
 //---------------------------------------------------------------------------
-//  parseHookSymbols
+//  getSignatureBit
+//
+//! Get the signature bit of a hook letter or lexicon symbol.  Bits beyond
+//! the last are shared, which no lexicon comes close to needing.
+//
+//! @param chars the letters or symbols of the current question
+//! @param c the letter or symbol
+//! @param add whether to add the character if it is not yet known
+//! @return the bit, or -1 if the character is not known
+//---------------------------------------------------------------------------
+int
+QuizEngine::getSignatureBit(QString* chars, const QChar& c, bool add)
+{
+    int index = chars->indexOf(c);
+    if (index < 0) {
+        if (!add)
+            return -1;
+        index = chars->length();
+        chars->append(c);
+    }
+    return qMin(index, MAX_SIGNATURE_BIT);
+}
+
+//---------------------------------------------------------------------------
+//  parseHooks
 //
-//! Parse a string to create a map of hook letters to lexicon symbols.  The
-//! individual symbol characters are placed in sorted order.
+//! Parse a string of hook letters, each followed by any lexicon symbols of
+//! the hook, into a mask of hook letters and the symbol mask of each hook
+//! letter.  A response is rejected if it repeats a letter or symbol, or
+//! uses one that no answer has.
 //
 //! @param str the string to parse
-//! @return a map from hook characters to lexicon symbols
+//! @param add whether the string is from an answer, so that new letters and
+//! symbols are added to the tables of the current question
+//! @param allowSymbols whether lexicon symbols are allowed
+//! @param hooks return the hook letter mask
+//! @param symbols return the symbol masks, in order of letter bit
+//! @return true if successful, false otherwise
 //---------------------------------------------------------------------------
-QMap<QChar, QString>
-QuizEngine::parseHookSymbols(const QString& str)
+bool
+QuizEngine::parseHooks(const QString& str, bool add, bool allowSymbols,
+                       quint64* hooks, QVector<quint64>* symbols)
 {
-    QRegExp re ("(?:([^\\W_\\d])([\\W_\\d]*))");
-    QMap<QChar, QString> hookSymbols;
-    for (int index = 0; ((index = re.indexIn(str, index)) >= 0);
-         index += re.cap(0).length())
-    {
-        QChar letter = re.cap(1).at(0);
-        QString symbols = Auxil::getAlphagram(re.cap(2));
-        hookSymbols.insert(letter, symbols);
+    quint64 letterSymbols[MAX_SIGNATURE_BIT + 1];
+    int letterBit = -1;
+    *hooks = 0;
+    symbols->clear();
+
+    foreach (const QChar& c, str) {
+        if (c.isLetter()) {
+            letterBit = getSignatureBit(&signatureLetters, c, add);
+            if (letterBit < 0)
+                return false;
+            quint64 mask = Q_UINT64_C(1) << letterBit;
+            if (!add && (*hooks & mask))
+                return false;
+            *hooks |= mask;
+            letterSymbols[letterBit] = 0;
+        }
+        else {
+            if (!allowSymbols || (letterBit < 0))
+                return false;
+            int symbolBit = getSignatureBit(&signatureSymbols, c, add);
+            if (symbolBit < 0)
+                return false;
+            quint64 mask = Q_UINT64_C(1) << symbolBit;
+            if (!add && (letterSymbols[letterBit] & mask))
+                return false;
+            letterSymbols[letterBit] |= mask;
+        }
+    }
+
+    for (int bit = 0; (bit <= MAX_SIGNATURE_BIT) && (*hooks >> bit); ++bit) {
+        if (*hooks & (Q_UINT64_C(1) << bit))
+            symbols->append(letterSymbols[bit]);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  parseSymbols
+//
+//! Parse a string of lexicon symbols into a symbol mask.  A response is
+//! rejected if it repeats a symbol or uses one that no answer has.
+//
+//! @param str the string to parse
+//! @param add whether the string is from an answer, so that new symbols are
+//! added to the table of the current question
+//! @param symbols return the symbol mask
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+QuizEngine::parseSymbols(const QString& str, bool add, quint64* symbols)
+{
+    *symbols = 0;
+    foreach (const QChar& c, str) {
+        int bit = getSignatureBit(&signatureSymbols, c, add);
+        if (bit < 0)
+            return false;
+        quint64 mask = Q_UINT64_C(1) << bit;
+        if (!add && (*symbols & mask))
+            return false;
+        *symbols |= mask;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  getHookSignature
+//
+//! Look up the hook signature computed for an answer to the current
+//! question.
+//
+//! @param word the answer
+//! @param signature return the signature
+//! @return true if the word is an answer with a signature, false otherwise
+//---------------------------------------------------------------------------
+bool
+QuizEngine::getHookSignature(const QString& word, HookSignature* signature)
+    const
+{
+    if (FixedWord::canHold(word)) {
+        QHash<FixedWord, HookSignature>::const_iterator it =
+            hookSignatures.constFind(FixedWord(word));
+        if (it == hookSignatures.constEnd())
+            return false;
+        *signature = it.value();
+        return true;
+    }
+
+    QHash<QString, HookSignature>::const_iterator it =
+        otherHookSignatures.constFind(word);
+    if (it == otherHookSignatures.constEnd())
+        return false;
+    *signature = it.value();
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  hooksToString
+//
+//! Convert a hook letter mask and its symbol masks back to a string.
+//
+//! @param hooks the hook letter mask
+//! @param symbols the symbol masks, in order of letter bit
+//! @param lexiconSymbols whether to include lexicon symbols
+//! @return the string
+//---------------------------------------------------------------------------
+QString
+QuizEngine::hooksToString(quint64 hooks, const QVector<quint64>& symbols,
+                          bool lexiconSymbols) const
+{
+    QString str;
+    int index = 0;
+    for (int bit = 0; (bit <= MAX_SIGNATURE_BIT) && (hooks >> bit); ++bit) {
+        if (!(hooks & (Q_UINT64_C(1) << bit)))
+            continue;
+        str += signatureLetters.at(bit);
+        if (lexiconSymbols)
+            str += symbolsToString(symbols.at(index));
+        ++index;
+    }
+    return str;
+}
+
+//---------------------------------------------------------------------------
+//  symbolsToString
+//
+//! Convert a symbol mask back to a string.
+//
+//! @param symbols the symbol mask
+//! @return the string
+//---------------------------------------------------------------------------
+QString
+QuizEngine::symbolsToString(quint64 symbols) const
+{
+    QString str;
+    for (int bit = 0; (bit <= MAX_SIGNATURE_BIT) && (symbols >> bit); ++bit) {
+        if (symbols & (Q_UINT64_C(1) << bit))
+            str += signatureSymbols.at(bit);
     }
-    return hookSymbols;
+    return str;
 }
@@ -26,11 +26,14 @@
 #ifndef ZYZZYVA_QUIZ_ENGINE_H
 #define ZYZZYVA_QUIZ_ENGINE_H
 
+#include "FixedWord.h"
 #include "QuizSpec.h"
 #include "Rand.h"
+#include <QHash>
 #include <QSet>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 class WordEngine;
 
@@ -57,6 +60,8 @@ class QuizEngine
     void markQuestionAsMissed();
     QString getQuestion() const;
     QStringList getMissed() const;
+    QString getAnswerResponse(const QString& word, bool lexiconSymbols =
+                              false) const;
     QuizSpec getQuizSpec() const { return quizSpec; }
     int getQuestionIndex() const { return questionIndex; }
     int numQuestions() const { return quizQuestions.size(); }
@@ -66,8 +71,7 @@ class QuizEngine
     int getQuizTotal() const { return quizTotal; }
     int getQuizCorrect() const { return quizCorrect; }
     int getQuizIncorrect() const { return quizIncorrect; }
-    QSet<QString> getQuestionCorrectResponses() const {
-        return correctUserResponses; }
+    QSet<QString> getQuestionCorrectResponses() const;
     QStringList getQuestionIncorrectResponses() const {
         return incorrectUserResponses; }
 
@@ -78,18 +82,87 @@ class QuizEngine
         quizSpec.setFilename(filename);
     }
 
+    private:
+    // The hooks and lexicon symbols of an answer.  Hook letters and symbols
+    // are kept as bits numbered by their position in the letter and symbol
+    // tables of the current question, and the symbols of each hook letter
+    // are listed in order of letter bit.
+    class HookSignature {
+        public:
+        HookSignature() : frontHooks(0), backHooks(0), wordSymbols(0) { }
+
+        bool matches(const HookSignature& other, bool lexiconSymbols) const {
+            return (frontHooks == other.frontHooks) &&
+                (backHooks == other.backHooks) &&
+                (!lexiconSymbols || ((wordSymbols == other.wordSymbols) &&
+                                     (frontSymbols == other.frontSymbols) &&
+                                     (backSymbols == other.backSymbols)));
+        }
+
+        public:
+        quint64 frontHooks;
+        quint64 backHooks;
+        quint64 wordSymbols;
+        QVector<quint64> frontSymbols;
+        QVector<quint64> backSymbols;
+    };
+
+    // A set of words.  Words that fit in a FixedWord are kept as FixedWords,
+    // and any others are kept as strings, so every word can be held.
+    class ResponseSet {
+        public:
+        void insert(const QString& word) {
+            if (FixedWord::canHold(word))
+                fixedWords.insert(FixedWord(word));
+            else
+                otherWords.insert(word);
+        }
+        bool contains(const QString& word) const {
+            return FixedWord::canHold(word) ?
+                fixedWords.contains(FixedWord(word)) :
+                otherWords.contains(word);
+        }
+        int size() const { return fixedWords.size() + otherWords.size(); }
+        bool isEmpty() const { return !size(); }
+        void clear() { fixedWords.clear(); otherWords.clear(); }
+        QStringList toStringList() const {
+            QStringList words = otherWords.toList();
+            foreach (const FixedWord& word, fixedWords)
+                words.append(word.toString());
+            return words;
+        }
+
+        private:
+        QSet<FixedWord> fixedWords;
+        QSet<QString> otherWords;
+    };
+
     private:
     void clearQuestion();
     void prepareQuestion();
+    bool getReadyMatchingQuestions(const QuizSpec& spec, QStringList*
+                                   questions);
     void addQuestionCorrect(const QString& response);
     void addQuestionIncorrect(const QString& response);
-    QMap<QChar, QString> parseHookSymbols(const QString& str);
+    int getSignatureBit(QString* chars, const QChar& c, bool add);
+    bool parseHooks(const QString& str, bool add, bool allowSymbols,
+                    quint64* hooks, QVector<quint64>* symbols);
+    bool parseSymbols(const QString& str, bool add, quint64* symbols);
+    bool getHookSignature(const QString& word, HookSignature* signature)
+        const;
+    QString hooksToString(quint64 hooks, const QVector<quint64>& symbols,
+                          bool lexiconSymbols) const;
+    QString symbolsToString(quint64 symbols) const;
 
     private:
     WordEngine*   wordEngine;
-    QSet<QString> correctResponses;
-    QSet<QString> correctUserResponses;
+    ResponseSet   correctResponses;
+    ResponseSet   correctUserResponses;
     QStringList   incorrectUserResponses;
+    QHash<FixedWord, HookSignature> hookSignatures;
+    QHash<QString, HookSignature> otherHookSignatures;
+    QString signatureLetters;
+    QString signatureSymbols;
 
     int quizTotal;
     int quizCorrect;
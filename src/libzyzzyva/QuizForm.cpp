@@ -43,6 +43,8 @@
 #include "Defs.h"
 #include <QApplication>
 #include <QColor>
+#include <QDateTime>
+#include <QDir>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QTimerEvent>
@@ -460,8 +462,10 @@ QuizForm::responseEntered()
         return;
     }
 
+    bool lexiconSymbols = (lexiconSymbolCbox->checkState() == Qt::Checked);
+    sessionRecorder.recordResponse(response, lexiconSymbols);
     QuizEngine::ResponseStatus status = quizEngine->respond(response,
-        (lexiconSymbolCbox->checkState() == Qt::Checked));
+                                                            lexiconSymbols);
     QString displayResponse = response;
     QString statusStr;
 
@@ -587,6 +591,8 @@ QuizForm::newQuiz(const QuizSpec& spec)
     // Restore incorrect and missed words from quiz progress
     analyzeDialog->newQuiz(spec);
 
+    startSessionRecording(spec);
+
     // Connect to database before starting the first question
     QString lexicon = spec.getLexicon();
     QString quizType = Auxil::quizTypeToString(spec.getType());
@@ -825,12 +831,14 @@ QuizForm::unpauseTimer()
 void
 QuizForm::markMissed()
 {
+    sessionRecorder.recordMarkMissed();
     quizEngine->markQuestionAsMissed();
     responseModel->clear();
     markMissedButton->setText(MARK_CORRECT_BUTTON);
     bool old = checkBringsJudgment;
     checkBringsJudgment = true;
     questionMarkedStatus = QuestionMarkedMissed;
+    sessionRecorder.recordUndoResponse();
     quizStatsDatabase->undoLastResponse(quizEngine->getQuestion());
     checkResponseClicked();
     checkBringsJudgment = old;
@@ -858,9 +866,11 @@ QuizForm::markCorrect()
     bool old = checkBringsJudgment;
     checkBringsJudgment = false;
     questionMarkedStatus = QuestionMarkedCorrect;
+    sessionRecorder.recordUndoResponse();
     quizStatsDatabase->undoLastResponse(quizEngine->getQuestion());
     checkResponseClicked();
     checkBringsJudgment = old;
+    sessionRecorder.recordMarkCorrect();
     quizEngine->markQuestionAsCorrect();
     analyzeDialog->updateStats();
 }
@@ -878,6 +888,7 @@ QuizForm::moveToCardbox(int cardbox)
     if (quizEngine->getQuestionCorrect() != quizEngine->getQuestionTotal())
         markCorrect();
 
+    sessionRecorder.recordCardbox(cardbox);
     quizStatsDatabase->setCardbox(quizEngine->getQuestion(), cardbox);
     updateQuestionStatus();
 }
@@ -890,6 +901,7 @@ QuizForm::moveToCardbox(int cardbox)
 void
 QuizForm::nextQuestionClicked()
 {
+    sessionRecorder.recordNext();
     if (!quizEngine->nextQuestion()) {
         QString caption = "Error getting next question";
         QString message = "Error getting next question.";
@@ -934,27 +946,12 @@ QuizForm::checkResponseClicked()
         QStringListIterator it (unanswered);
         while (it.hasNext()) {
             QString word = it.next();
-            QString response = word;
-            QString lexicon = quizSpec.getLexicon();
             bool lexiconSymbols =
                 (lexiconSymbolCbox->checkState() == Qt::Checked);
+            QString response =
+                quizEngine->getAnswerResponse(word, lexiconSymbols);
 
-            if (lexiconSymbols) {
-                response += wordEngine->getLexiconSymbols(lexicon, word);
-            }
-
-            if (quizType == QuizSpec::QuizAnagramsWithHooks) {
-                QString frontHooks =
-                    wordEngine->getFrontHookLetters(lexicon, word).toUpper();
-                QString backHooks =
-                    wordEngine->getBackHookLetters(lexicon, word).toUpper();
-                if (!lexiconSymbols) {
-                    frontHooks.replace(QRegExp("[\\W_\\d]+"), QString());
-                    backHooks.replace(QRegExp("[\\W_\\d]+"), QString());
-                }
-                response = frontHooks + ":" + response + ":" + backHooks;
-            }
-
+            sessionRecorder.recordResponse(response, lexiconSymbols);
             quizEngine->respond(response, lexiconSymbols);
 
             // FIXME: Probably not the right way to get alphabetical sorting
@@ -1033,15 +1030,20 @@ QuizForm::checkResponseClicked()
         startDisplayingCorrectAnswers();
     }
 
-    if (MainSettings::getQuizRecordStats() && !recordStatsBlocked)
+    bool databaseValid = quizStatsDatabase && quizStatsDatabase->isValid();
+    bool recordStats = MainSettings::getQuizRecordStats() &&
+        !recordStatsBlocked;
+    if (recordStats)
         recordQuestionStats(questionCorrect);
 
-    if (quizStatsDatabase && quizStatsDatabase->isValid() &&
+    bool updateStatus = databaseValid &&
         (MainSettings::getQuizShowQuestionStats() ||
-        (quizEngine->getQuizSpec().getMethod() == QuizSpec::CardboxQuizMethod)))
-    {
+        (quizEngine->getQuizSpec().getMethod() == QuizSpec::CardboxQuizMethod));
+    if (updateStatus)
         updateQuestionStatus();
-    }
+
+    sessionRecorder.recordCheck(questionCorrect, recordStats && databaseValid,
+                                updateStatus);
 
     QApplication::restoreOverrideCursor();
 }
@@ -1963,6 +1965,40 @@ QuizForm::recordQuestionStats(bool correct)
         updateCardbox);
 }
 
+//---------------------------------------------------------------------------
+//  startSessionRecording
+//
+//! Begin recording a new quiz session if the Quiz Record Sessions
+//! preference is set.  Sessions are written to the quiz sessions directory
+//! and can be replayed by the quizreplay tool.
+//
+//! @param spec the quiz spec
+//---------------------------------------------------------------------------
+void
+QuizForm::startSessionRecording(const QuizSpec& spec)
+{
+    sessionRecorder.stop();
+    if (!MainSettings::getQuizRecordSessions())
+        return;
+
+    QString dirName = Auxil::getQuizDir() + "/sessions";
+    QDir dir (dirName);
+    if (!dir.exists() && !dir.mkpath(dirName)) {
+        qWarning("Cannot create quiz sessions directory\n");
+        return;
+    }
+
+    QString filename = dirName + "/" +
+        QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz") +
+        QuizSessionRecorder::FILE_SUFFIX;
+    QString errString;
+    if (!sessionRecorder.start(filename, &errString)) {
+        qWarning("%s", errString.toLocal8Bit().constData());
+        return;
+    }
+    sessionRecorder.recordQuizSpec(spec);
+}
+
 //---------------------------------------------------------------------------
 //  customLetterOrderAllowed
 //
@@ -27,6 +27,7 @@
 
 #include "ActionForm.h"
 #include "QuizTimerSpec.h"
+#include "QuizSessionRecorder.h"
 #include "QuizStatsDatabase.h"
 #include "QuizSpec.h"
 #include <QCheckBox>
@@ -129,6 +130,7 @@ class QuizForm : public ActionForm
     void connectToDatabase(const QString& lexicon, const QString& quizType);
     void disconnectDatabase();
     void recordQuestionStats(bool correct);
+    void startSessionRecording(const QuizSpec& spec);
     bool customLetterOrderAllowed(QuizSpec::QuizType quizType) const;
     void updateValidatorOptions();
 
@@ -182,6 +184,7 @@ class QuizForm : public ActionForm
 
     QuizStatsDatabase* quizStatsDatabase;
     QuizStatsDatabase::QuestionData origQuestionData;
+    QuizSessionRecorder sessionRecorder;
 
     QTimer* displayAnswerTimer;
     int currentDisplayAnswer;
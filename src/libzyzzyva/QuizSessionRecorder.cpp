@@ -0,0 +1,342 @@
+//---------------------------------------------------------------------------
+// QuizSessionRecorder.cpp
+//
+// A class for recording quiz sessions as timestamped events.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "QuizSessionRecorder.h"
+#include "QuizSpec.h"
+#include <QDomDocument>
+#include <QTextStream>
+
+const QString QuizSessionRecorder::FILE_SUFFIX = ".zqs";
+
+const QString EVENT_QUIZ_SPEC = "spec";
+const QString EVENT_RESPOND = "respond";
+const QString EVENT_CHECK = "check";
+const QString EVENT_NEXT = "next";
+const QString EVENT_MARK_MISSED = "missed";
+const QString EVENT_MARK_CORRECT = "correct";
+const QString EVENT_UNDO_RESPONSE = "undo";
+const QString EVENT_CARDBOX = "cardbox";
+
+//---------------------------------------------------------------------------
+//  start
+//
+//! Begin recording a session to a file.  Each event is written as a line
+//! holding the time in milliseconds since recording began, the event name,
+//! and an optional argument, separated by spaces.
+//
+//! @param filename the name of the file
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+QuizSessionRecorder::start(const QString& filename, QString* errString)
+{
+    stop();
+    file.setFileName(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (errString) {
+            *errString = "Cannot open session file '" + filename + "': " +
+                file.errorString();
+        }
+        return false;
+    }
+    clock.start();
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  stop
+//
+//! Stop recording and close the session file.
+//---------------------------------------------------------------------------
+void
+QuizSessionRecorder::stop()
+{
+    if (file.isOpen())
+        file.close();
+}
+
+//---------------------------------------------------------------------------
+//  recordQuizSpec
+//
+//! Record the start of a new quiz.  The spec, including its progress, is
+//! written as XML on a single line.
+//
+//! @param spec the quiz spec
+//---------------------------------------------------------------------------
+void
+QuizSessionRecorder::recordQuizSpec(const QuizSpec& spec)
+{
+    QDomDocument document;
+    document.appendChild(spec.asDomElement());
+    QString xml = document.toString(0);
+    xml.replace("\n", " ");
+    record(QuizSpecEvent, xml.trimmed());
+}
+
+//---------------------------------------------------------------------------
+//  recordResponse
+//
+//! Record a response given to the quiz engine.
+//
+//! @param response the response
+//! @param lexiconSymbols whether lexicon symbols were required
+//---------------------------------------------------------------------------
+void
+QuizSessionRecorder::recordResponse(const QString& response,
+                                    bool lexiconSymbols)
+{
+    record(RespondEvent, QString(lexiconSymbols ? "1 " : "0 ") + response);
+}
+
+//---------------------------------------------------------------------------
+//  recordCheck
+//
+//! Record the completion of a question.
+//
+//! @param correct whether the question was judged correct
+//! @param recordStats whether a response was recorded in the stats database
+//! @param updateStatus whether the question data was read back afterward
+//---------------------------------------------------------------------------
+void
+QuizSessionRecorder::recordCheck(bool correct, bool recordStats,
+                                 bool updateStatus)
+{
+    record(CheckEvent, QString("%1 %2 %3").arg(correct ? 1 : 0)
+           .arg(recordStats ? 1 : 0).arg(updateStatus ? 1 : 0));
+}
+
+//---------------------------------------------------------------------------
+//  recordNext
+//
+//! Record a move to the next question.
+//---------------------------------------------------------------------------
+void
+QuizSessionRecorder::recordNext()
+{
+    record(NextEvent);
+}
+
+//---------------------------------------------------------------------------
+//  recordMarkMissed
+//
+//! Record the current question being marked as missed.
+//---------------------------------------------------------------------------
+void
+QuizSessionRecorder::recordMarkMissed()
+{
+    record(MarkMissedEvent);
+}
+
+//---------------------------------------------------------------------------
+//  recordMarkCorrect
+//
+//! Record the current question being marked as correct.
+//---------------------------------------------------------------------------
+void
+QuizSessionRecorder::recordMarkCorrect()
+{
+    record(MarkCorrectEvent);
+}
+
+//---------------------------------------------------------------------------
+//  recordUndoResponse
+//
+//! Record the last stats database response for the current question being
+//! undone.
+//---------------------------------------------------------------------------
+void
+QuizSessionRecorder::recordUndoResponse()
+{
+    record(UndoResponseEvent);
+}
+
+//---------------------------------------------------------------------------
+//  recordCardbox
+//
+//! Record the current question being moved to a cardbox.
+//
+//! @param cardbox the cardbox
+//---------------------------------------------------------------------------
+void
+QuizSessionRecorder::recordCardbox(int cardbox)
+{
+    record(CardboxEvent, QString::number(cardbox));
+}
+
+//---------------------------------------------------------------------------
+//  record
+//
+//! Write an event to the session file.
+//
+//! @param type the event type
+//! @param argument the event argument
+//---------------------------------------------------------------------------
+void
+QuizSessionRecorder::record(EventType type, const QString& argument)
+{
+    if (!file.isOpen())
+        return;
+
+    QString line = QString::number(clock.elapsed()) + " " +
+        eventTypeToString(type);
+    if (!argument.isEmpty())
+        line += " " + argument;
+    line += "\n";
+    file.write(line.toUtf8());
+    file.flush();
+}
+
+//---------------------------------------------------------------------------
+//  readSession
+//
+//! Read the events of a recorded session.
+//
+//! @param filename the name of the session file
+//! @param events return the events
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+QuizSessionRecorder::readSession(const QString& filename,
+                                 QList<Event>* events, QString* errString)
+{
+    if (!events)
+        return false;
+
+    QFile in (filename);
+    if (!in.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errString) {
+            *errString = "Cannot open session file '" + filename + "': " +
+                in.errorString();
+        }
+        return false;
+    }
+
+    QTextStream stream (&in);
+    stream.setCodec("UTF-8");
+    int lineNum = 0;
+    QString line;
+    while (!(line = stream.readLine()).isNull()) {
+        ++lineNum;
+        if (line.trimmed().isEmpty())
+            continue;
+
+        bool ok = false;
+        Event event;
+        event.time = line.section(' ', 0, 0).toLongLong(&ok);
+        event.type = stringToEventType(line.section(' ', 1, 1));
+        event.argument = line.section(' ', 2);
+        if (!ok || (event.type == UnknownEvent)) {
+            if (errString) {
+                *errString = "Invalid event in session file '" + filename +
+                    "', line " + QString::number(lineNum) + ".";
+            }
+            return false;
+        }
+        events->append(event);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  parseQuizSpec
+//
+//! Reconstruct a quiz spec from the argument of a quiz spec event.
+//
+//! @param argument the event argument
+//! @param spec return the quiz spec
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+QuizSessionRecorder::parseQuizSpec(const QString& argument, QuizSpec* spec,
+                                   QString* errString)
+{
+    if (!spec)
+        return false;
+
+    QString errorMsg;
+    QDomDocument document;
+    if (!document.setContent(argument, false, &errorMsg)) {
+        if (errString)
+            *errString = "Invalid quiz spec in session: " + errorMsg;
+        return false;
+    }
+    return spec->fromDomElement(document.documentElement(), errString);
+}
+
+//---------------------------------------------------------------------------
+//  eventTypeToString
+//
+//! Return the name of an event type as written in session files.
+//
+//! @param type the event type
+//! @return the event name
+//---------------------------------------------------------------------------
+QString
+QuizSessionRecorder::eventTypeToString(EventType type)
+{
+    switch (type) {
+        case QuizSpecEvent: return EVENT_QUIZ_SPEC;
+        case RespondEvent: return EVENT_RESPOND;
+        case CheckEvent: return EVENT_CHECK;
+        case NextEvent: return EVENT_NEXT;
+        case MarkMissedEvent: return EVENT_MARK_MISSED;
+        case MarkCorrectEvent: return EVENT_MARK_CORRECT;
+        case UndoResponseEvent: return EVENT_UNDO_RESPONSE;
+        case CardboxEvent: return EVENT_CARDBOX;
+        default: return QString();
+    }
+}
+
+//---------------------------------------------------------------------------
+//  stringToEventType
+//
+//! Return the event type named in a session file.
+//
+//! @param str the event name
+//! @return the event type
+//---------------------------------------------------------------------------
+QuizSessionRecorder::EventType
+QuizSessionRecorder::stringToEventType(const QString& str)
+{
+    if (str == EVENT_QUIZ_SPEC)
+        return QuizSpecEvent;
+    else if (str == EVENT_RESPOND)
+        return RespondEvent;
+    else if (str == EVENT_CHECK)
+        return CheckEvent;
+    else if (str == EVENT_NEXT)
+        return NextEvent;
+    else if (str == EVENT_MARK_MISSED)
+        return MarkMissedEvent;
+    else if (str == EVENT_MARK_CORRECT)
+        return MarkCorrectEvent;
+    else if (str == EVENT_UNDO_RESPONSE)
+        return UndoResponseEvent;
+    else if (str == EVENT_CARDBOX)
+        return CardboxEvent;
+    return UnknownEvent;
+}
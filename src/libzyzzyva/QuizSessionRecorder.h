@@ -0,0 +1,92 @@
+//---------------------------------------------------------------------------
+// QuizSessionRecorder.h
+//
+// A class for recording quiz sessions as timestamped events.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#ifndef ZYZZYVA_QUIZ_SESSION_RECORDER_H
+#define ZYZZYVA_QUIZ_SESSION_RECORDER_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QString>
+
+class QuizSpec;
+
+class QuizSessionRecorder
+{
+    public:
+    static const QString FILE_SUFFIX;
+
+    enum EventType {
+        UnknownEvent = 0,
+        QuizSpecEvent,
+        RespondEvent,
+        CheckEvent,
+        NextEvent,
+        MarkMissedEvent,
+        MarkCorrectEvent,
+        UndoResponseEvent,
+        CardboxEvent
+    };
+
+    class Event {
+        public:
+        Event() : time(0), type(UnknownEvent) { }
+        qint64 time;
+        EventType type;
+        QString argument;
+    };
+
+    public:
+    QuizSessionRecorder() { }
+    ~QuizSessionRecorder() { stop(); }
+
+    bool start(const QString& filename, QString* errString = 0);
+    void stop();
+    bool isRecording() const { return file.isOpen(); }
+    QString getFilename() const { return file.fileName(); }
+
+    void recordQuizSpec(const QuizSpec& spec);
+    void recordResponse(const QString& response, bool lexiconSymbols);
+    void recordCheck(bool correct, bool recordStats, bool updateStatus);
+    void recordNext();
+    void recordMarkMissed();
+    void recordMarkCorrect();
+    void recordUndoResponse();
+    void recordCardbox(int cardbox);
+
+    static bool readSession(const QString& filename, QList<Event>* events,
+                            QString* errString = 0);
+    static bool parseQuizSpec(const QString& argument, QuizSpec* spec,
+                              QString* errString = 0);
+    static QString eventTypeToString(EventType type);
+    static EventType stringToEventType(const QString& str);
+
+    private:
+    void record(EventType type, const QString& argument = QString());
+
+    QFile file;
+    QElapsedTimer clock;
+};
+
+#endif // ZYZZYVA_QUIZ_SESSION_RECORDER_H
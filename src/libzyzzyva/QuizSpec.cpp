@@ -25,6 +25,7 @@
 #include "QuizSpec.h"
 #include "Auxil.h"
 #include "Defs.h"
+#include "SampleWeight.h"
 
 using namespace Defs;
 
@@ -39,6 +40,8 @@ const QString XML_TOP_LEXICON_ATTR = "lexicon";
 const QString XML_QUESTION_SOURCE_ELEMENT = "question-source";
 const QString XML_QUESTION_SOURCE_TYPE_ATTR = "type";
 const QString XML_QUESTION_SOURCE_SINGLE_QUESTION_ATTR = "single-question";
+const QString XML_QUESTION_SOURCE_SAMPLE_SIZE_ATTR = "sample-size";
+const QString XML_QUESTION_SOURCE_SAMPLE_WEIGHT_ATTR = "sample-weight";
 const QString XML_SEARCH_ELEMENT = "zyzzyva-search";
 const QString XML_RANDOMIZER_ELEMENT = "randomizer";
 const QString XML_RANDOMIZER_SEED_ATTR = "seed";
@@ -51,6 +54,9 @@ const QString XML_TIMER_ELEMENT = "timer";
 const QString XML_TIMER_TIMEOUT_ATTR = "timeout";
 const QString XML_TIMER_PERIOD_ATTR = "period";
 const QString XML_PROGRESS_ELEMENT = "progress";
+const QString SAMPLE_WEIGHT_UNIFORM = "uniform";
+const QString SAMPLE_WEIGHT_PROBABILITY = "probability";
+const QString SAMPLE_WEIGHT_PLAYABILITY = "playability";
 
 //---------------------------------------------------------------------------
 //  asString
@@ -106,8 +112,11 @@ QuizSpec::asDomElement() const
                             Auxil::quizMethodToString(method));
     topElement.setAttribute(XML_TOP_QUESTION_ORDER_ATTR,
                             Auxil::quizQuestionOrderToString(questionOrder));
-    if (questionOrder == ProbabilityOrder)
+    if ((questionOrder == ProbabilityOrder) ||
+        (sampleSize && (sampleWeight == ProbabilityWeight)))
+    {
         topElement.setAttribute(XML_TOP_PROB_NUM_BLANKS_ATTR, probNumBlanks);
+    }
 
     topElement.setAttribute(XML_TOP_LEXICON_ATTR, lexicon);
 
@@ -116,10 +125,18 @@ QuizSpec::asDomElement() const
                                Auxil::quizSourceTypeToString(sourceType));
     topElement.appendChild(sourceElement);
 
-    if (sourceType == SearchSource)
+    if (sourceType == SearchSource) {
+        if (sampleSize) {
+            sourceElement.setAttribute(XML_QUESTION_SOURCE_SAMPLE_SIZE_ATTR,
+                                       sampleSize);
+            sourceElement.setAttribute(XML_QUESTION_SOURCE_SAMPLE_WEIGHT_ATTR,
+                                       sampleWeightToString(sampleWeight));
+        }
         sourceElement.appendChild(searchSpec.asDomElement());
+    }
 
-    if (questionOrder == RandomOrder) {
+    // Sampled questions need the random seeds to be chosen again
+    if ((questionOrder == RandomOrder) || sampleSize) {
         QDomElement randomElement = doc.createElement(XML_RANDOMIZER_ELEMENT);
         randomElement.setAttribute(XML_RANDOMIZER_SEED_ATTR, randomSeed);
         randomElement.setAttribute(XML_RANDOMIZER_SEED2_ATTR, randomSeed2);
@@ -204,6 +221,14 @@ QuizSpec::fromDomElement(const QDomElement& element, QString*)
             }
             tmpSpec.setProbabilityNumBlanks(numBlanks);
         }
+        else if (element.hasAttribute(XML_TOP_PROB_NUM_BLANKS_ATTR)) {
+            bool ok = false;
+            int numBlanks = element.attribute(
+                XML_TOP_PROB_NUM_BLANKS_ATTR).toInt(&ok);
+            if (!ok)
+                return false;
+            tmpSpec.setProbabilityNumBlanks(numBlanks);
+        }
     }
 
     if (element.hasAttribute(XML_TOP_LEXICON_ATTR)) {
@@ -239,6 +264,20 @@ QuizSpec::fromDomElement(const QDomElement& element, QString*)
             }
 
             if (source == QuizSpec::SearchSource) {
+                if (elem.hasAttribute(XML_QUESTION_SOURCE_SAMPLE_SIZE_ATTR)) {
+                    bool ok = false;
+                    int size = elem.attribute(
+                        XML_QUESTION_SOURCE_SAMPLE_SIZE_ATTR).toInt(&ok);
+                    if (!ok || (size < 0))
+                        return false;
+                    int weight = stringToSampleWeight(elem.attribute(
+                        XML_QUESTION_SOURCE_SAMPLE_WEIGHT_ATTR));
+                    if (weight < 0)
+                        return false;
+                    tmpSpec.setSampleSize(size);
+                    tmpSpec.setSampleWeight(weight);
+                }
+
                 QDomElement searchElem = elem.firstChild().toElement();
                 if (searchElem.tagName() != XML_SEARCH_ELEMENT)
                     return false;
@@ -278,8 +317,11 @@ QuizSpec::fromDomElement(const QDomElement& element, QString*)
         }
 
         else if (tag == XML_RANDOMIZER_ELEMENT) {
-            if (tmpSpec.getQuestionOrder() != QuizSpec::RandomOrder)
+            if ((tmpSpec.getQuestionOrder() != QuizSpec::RandomOrder) &&
+                !tmpSpec.getSampleSize())
+            {
                 return false;
+            }
 
             if (!elem.hasAttribute(XML_RANDOMIZER_SEED_ATTR) ||
                 !elem.hasAttribute(XML_RANDOMIZER_ALGORITHM_ATTR))
@@ -356,3 +398,42 @@ QuizSpec::fromXmlFile(QFile& file, QString* errStr)
     filename = file.fileName();
     return true;
 }
+
+//---------------------------------------------------------------------------
+//  sampleWeightToString
+//
+//! Return the string representation of a sample weight.
+//
+//! @param weight the sample weight
+//! @return the string representation
+//---------------------------------------------------------------------------
+QString
+QuizSpec::sampleWeightToString(int weight)
+{
+    switch (weight) {
+        case ProbabilityWeight: return SAMPLE_WEIGHT_PROBABILITY;
+        case PlayabilityWeight: return SAMPLE_WEIGHT_PLAYABILITY;
+        default: return SAMPLE_WEIGHT_UNIFORM;
+    }
+}
+
+//---------------------------------------------------------------------------
+//  stringToSampleWeight
+//
+//! Return the sample weight represented by a string.  An empty string
+//! represents uniform sampling.
+//
+//! @param string the string representation
+//! @return the sample weight, or -1 if the string is not recognized
+//---------------------------------------------------------------------------
+int
+QuizSpec::stringToSampleWeight(const QString& string)
+{
+    if (string.isEmpty() || (string == SAMPLE_WEIGHT_UNIFORM))
+        return UniformWeight;
+    else if (string == SAMPLE_WEIGHT_PROBABILITY)
+        return ProbabilityWeight;
+    else if (string == SAMPLE_WEIGHT_PLAYABILITY)
+        return PlayabilityWeight;
+    return -1;
+}
@@ -78,7 +78,8 @@ class QuizSpec
                  sourceType(SearchSource), questionOrder(RandomOrder),
                  probNumBlanks(0), randomSeed(0), randomSeed2(0),
                  randomAlgorithm(Rand::MarsagliaMwc),
-                 responseMinLength(0), responseMaxLength(0) { }
+                 responseMinLength(0), responseMaxLength(0), sampleSize(0),
+                 sampleWeight(0) { }
     ~QuizSpec() { }
 
     QString asString() const;
@@ -86,6 +87,8 @@ class QuizSpec
     QDomElement asDomElement() const;
     bool fromDomElement(const QDomElement& element, QString* errStr = 0);
     bool fromXmlFile(QFile& file, QString* errStr = 0);
+    static QString sampleWeightToString(int weight);
+    static int stringToSampleWeight(const QString& string);
 
     void setLexicon(const QString& lex) { lexicon = lex; }
     void setType(QuizType t) { type = t; }
@@ -101,6 +104,8 @@ class QuizSpec
     void setRandomAlgorithm(int i) { randomAlgorithm = i; }
     void setResponseMinLength(int i) { responseMinLength = i; }
     void setResponseMaxLength(int i) { responseMaxLength = i; }
+    void setSampleSize(int i) { sampleSize = i; }
+    void setSampleWeight(int i) { sampleWeight = i; }
     void setFilename(const QString& fname) { filename = fname; }
 
     void addIncorrect(const QString& word) { progress.addIncorrect(word); }
@@ -120,6 +125,8 @@ class QuizSpec
     int getRandomAlgorithm() const { return randomAlgorithm; }
     int getResponseMinLength() const { return responseMinLength; }
     int getResponseMaxLength() const { return responseMaxLength; }
+    int getSampleSize() const { return sampleSize; }
+    int getSampleWeight() const { return sampleWeight; }
     QString getFilename() const { return filename; }
 
     private:
@@ -137,6 +144,8 @@ class QuizSpec
     int randomAlgorithm;
     int responseMinLength;
     int responseMaxLength;
+    int sampleSize;
+    int sampleWeight;
     QString filename;
 };
 
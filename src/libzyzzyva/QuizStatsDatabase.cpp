@@ -54,7 +54,7 @@ const QString SQL_CREATE_QUESTIONS_TABLE_CURRENT =
 //---------------------------------------------------------------------------
 QuizStatsDatabase::QuizStatsDatabase(const QString& lexicon,
     const QString& quizType)
-    : db(0)
+    : db(0), lexiconAttached(false)
 {
     QString dirName = Auxil::getQuizDir() + "/data/" + lexicon;
     QDir dir (dirName);
@@ -86,8 +86,10 @@ QuizStatsDatabase::QuizStatsDatabase(const QString& lexicon,
 QuizStatsDatabase::~QuizStatsDatabase()
 {
     if (db) {
-        if (db->isOpen())
+        if (db->isOpen()) {
+            detachLexiconDatabase();
             db->close();
+        }
         delete db;
         db = 0;
         QSqlDatabase::removeDatabase(dbConnectionName);
@@ -547,37 +549,77 @@ QStringList
 QuizStatsDatabase::getReadyQuestions(const QStringList& questions,
     bool zeroFirst)
 {
-    unsigned int now = QDateTime::currentDateTime().toTime_t();
-
-    bool selectAll = questions.isEmpty();
     QSet<QString> questionSet = questions.toSet();
+    return selectReadyQuestions(QString(), zeroFirst,
+                                questions.isEmpty() ? 0 : &questionSet);
+}
 
-    QString zQueryStr = zeroFirst ? QString(" OR cardbox = 0") : QString();
-    QString queryStr = "SELECT question, cardbox FROM questions WHERE "
-        "next_scheduled <= " + QString::number(now) + zQueryStr +
-        " ORDER BY next_scheduled";
+//---------------------------------------------------------------------------
+//  attachLexiconDatabase
+//
+//! Attach a lexicon database to the stats database, so questions can be
+//! selected by the attributes of their words in a single query.
+//
+//! @param filename the lexicon database file
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+QuizStatsDatabase::attachLexiconDatabase(const QString& filename)
+{
+    if (!db || !db->isOpen() || filename.isEmpty())
+        return false;
+
+    if (lexiconAttached)
+        detachLexiconDatabase();
 
     QSqlQuery query (*db);
-    query.prepare(queryStr);
-    query.exec();
+    query.prepare("ATTACH DATABASE ? AS lexicon");
+    query.bindValue(0, filename);
+    lexiconAttached = query.exec();
+    return lexiconAttached;
+}
 
-    QStringList zeroQuestions;
-    QStringList readyQuestions;
-    while (query.next()) {
-        const QString& question = query.value(0).toString();
+//---------------------------------------------------------------------------
+//  detachLexiconDatabase
+//
+//! Detach a lexicon database attached with attachLexiconDatabase.
+//---------------------------------------------------------------------------
+void
+QuizStatsDatabase::detachLexiconDatabase()
+{
+    if (!lexiconAttached)
+        return;
 
-        // Skip questions that weren't in the parameter question list
-        if (!selectAll && !questionSet.contains(question))
-            continue;
+    QSqlQuery query (*db);
+    query.exec("DETACH DATABASE lexicon");
+    lexiconAttached = false;
+}
 
-        int cardbox = query.value(1).toInt();
-        if (zeroFirst && (cardbox == 0))
-            zeroQuestions.append(question);
-        else
-            readyQuestions.append(question);
-    }
+//---------------------------------------------------------------------------
+//  getReadyMatchingQuestions
+//
+//! Get a list of questions that are ready for review and whose words match
+//! a condition on the attached lexicon database.  The lexicon is joined in
+//! the same query, so no word list needs to be built first.  The questions
+//! are returned in their scheduled order.
+//
+//! @param wordCondition an SQL condition on the lexicon words table, which
+//! is referred to as "words"
+//! @param alphagrams whether questions are alphagrams rather than words
+//! @param zeroFirst whether to put cardbox 0 questions before all others
+//! @return the list of ready questions, in scheduled order
+//---------------------------------------------------------------------------
+QStringList
+QuizStatsDatabase::getReadyMatchingQuestions(const QString& wordCondition,
+    bool alphagrams, bool zeroFirst)
+{
+    if (!lexiconAttached)
+        return QStringList();
 
-    return zeroFirst ? zeroQuestions + readyQuestions : readyQuestions;
+    QString column = alphagrams ? "words.alphagram" : "words.word";
+    QString matchStr = "question IN (SELECT " + column + " FROM "
+        "lexicon.words AS words WHERE" + wordCondition + ")";
+    return selectReadyQuestions(matchStr, zeroFirst, 0);
 }
 
 //---------------------------------------------------------------------------
@@ -759,6 +801,54 @@ QuizStatsDatabase::getDatabase() const
     return db;
 }
 
+//---------------------------------------------------------------------------
+//  selectReadyQuestions
+//
+//! Select questions that are ready for review, in their scheduled order.
+//
+//! @param matchStr an additional SQL condition questions must match, or
+//! empty if none
+//! @param zeroFirst whether to put cardbox 0 questions before all others
+//! @param questionSet the set of possible questions, or 0 if all questions
+//! should be retrieved
+//! @return the list of ready questions, in scheduled order
+//---------------------------------------------------------------------------
+QStringList
+QuizStatsDatabase::selectReadyQuestions(const QString& matchStr,
+    bool zeroFirst, const QSet<QString>* questionSet)
+{
+    unsigned int now = QDateTime::currentDateTime().toTime_t();
+
+    QString zQueryStr = zeroFirst ? QString(" OR cardbox = 0") : QString();
+    QString queryStr = "SELECT question, cardbox FROM questions WHERE "
+        "(next_scheduled <= " + QString::number(now) + zQueryStr + ")";
+    if (!matchStr.isEmpty())
+        queryStr += " AND " + matchStr;
+    queryStr += " ORDER BY next_scheduled";
+
+    QSqlQuery query (*db);
+    query.prepare(queryStr);
+    query.exec();
+
+    QStringList zeroQuestions;
+    QStringList readyQuestions;
+    while (query.next()) {
+        const QString& question = query.value(0).toString();
+
+        // Skip questions that weren't in the parameter question list
+        if (questionSet && !questionSet->contains(question))
+            continue;
+
+        int cardbox = query.value(1).toInt();
+        if (zeroFirst && (cardbox == 0))
+            zeroQuestions.append(question);
+        else
+            readyQuestions.append(question);
+    }
+
+    return zeroFirst ? zeroQuestions + readyQuestions : readyQuestions;
+}
+
 //---------------------------------------------------------------------------
 //  calculateNextScheduled
 //
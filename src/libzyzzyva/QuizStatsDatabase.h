@@ -27,6 +27,7 @@
 
 #include "Rand.h"
 #include <QMap>
+#include <QSet>
 #include <QSqlDatabase>
 #include <QSqlQueryModel>
 #include <QString>
@@ -68,6 +69,10 @@ class QuizStatsDatabase
     int shiftCardboxByBacklog(const QStringList& questions, int desiredBacklog);
     int shiftCardboxByDays(const QStringList& questions, int numDays);
     QStringList getReadyQuestions(const QStringList& questions, bool zeroFirst);
+    bool attachLexiconDatabase(const QString& filename);
+    void detachLexiconDatabase();
+    QStringList getReadyMatchingQuestions(const QString& wordCondition,
+                                          bool alphagrams, bool zeroFirst);
     QuestionData getQuestionData(const QString& question);
     QMap<int, int> getCardboxCounts();
     QMap<int, int> getCardboxDueCounts();
@@ -77,12 +82,15 @@ class QuizStatsDatabase
 
     private:
     int calculateNextScheduled(int cardbox);
+    QStringList selectReadyQuestions(const QString& matchStr, bool zeroFirst,
+                                     const QSet<QString>* questionSet);
     void setQuestionData(const QString& question, const QuestionData& data,
                          bool updateCardbox);
 
     private:
     QString dbConnectionName;
     QSqlDatabase* db;
+    bool lexiconAttached;
     Rand rng;
 
     QString undoQuestion;
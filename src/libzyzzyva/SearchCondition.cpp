@@ -108,6 +108,13 @@ SearchCondition::asString() const
             + QString::number(maxValue * 1) + "% " + stringValue;
         break;
 
+        case DrawProbability:
+        str += "Min " + QString::number(minValue * 100.0 /
+                                        DRAW_PROBABILITY_SCALE) + "%, Max "
+            + QString::number(maxValue * 100.0 / DRAW_PROBABILITY_SCALE)
+            + "% from " + stringValue;
+        break;
+
         default: break;
     }
 
@@ -182,6 +189,7 @@ SearchCondition::asDomElement() const
         break;
 
         case ConsistOf:
+        case DrawProbability:
         topElement.setAttribute(XML_MIN_ATTR, minValue);
         topElement.setAttribute(XML_MAX_ATTR, maxValue);
         topElement.setAttribute(XML_STRING_ATTR, stringValue);
@@ -383,6 +391,22 @@ SearchCondition::fromDomElement(const QDomElement& element)
         }
         break;
 
+        case DrawProbability:
+        if (!element.hasAttribute(XML_STRING_ATTR) ||
+            !element.hasAttribute(XML_MIN_ATTR) ||
+            !element.hasAttribute(XML_MAX_ATTR))
+            return false;
+        tmpCondition.minValue =
+            element.attribute(XML_MIN_ATTR).toInt(&ok);
+        if (!ok)
+            return false;
+        tmpCondition.maxValue =
+            element.attribute(XML_MAX_ATTR).toInt(&ok);
+        if (!ok)
+            return false;
+        tmpCondition.stringValue = element.attribute(XML_STRING_ATTR);
+        break;
+
         // Obsolete condition types
         case OldDoesNotTakePrefix:
         case OldDoesNotTakeSuffix:
@@ -55,6 +55,7 @@ class SearchCondition
         LimitByPlayabilityOrder,
         PartOfSpeech,
         Definition,
+        DrawProbability,
 
         // Obsolete search condition types
         OldExactLength,
@@ -76,6 +77,16 @@ class SearchCondition
     QString asString() const;
     QDomElement asDomElement() const;
     bool fromDomElement(const QDomElement& element);
+    bool operator==(const SearchCondition& other) const {
+        return ((type == other.type) &&
+                (stringValue == other.stringValue) &&
+                (minValue == other.minValue) &&
+                (maxValue == other.maxValue) &&
+                (intValue == other.intValue) &&
+                (negated == other.negated) &&
+                (boolValue == other.boolValue) &&
+                (legacy == other.legacy));
+    }
 
     SearchType type;
     QString stringValue;
@@ -37,6 +37,7 @@ QMap<QString, QString> SearchConditionForm::posToNicePosMap;
 QMap<QString, QString> SearchConditionForm::nicePosToPosMap;
 
 const int MAX_MAX_INT_VALUE = 999999;
+const int DRAW_PERCENT_DECIMALS = 7;
 
 const QString POS_ADJECTIVE = "adj";
 const QString POS_ADVERB = "adv";
@@ -77,11 +78,13 @@ using namespace Defs;
 SearchConditionForm::SearchConditionForm(QWidget* parent, Qt::WFlags f)
     : QWidget(parent, f),
     letterValidator(new WordValidator(this)),
-    patternValidator(new WordValidator(this)), legacy(false)
+    patternValidator(new WordValidator(this)),
+    poolValidator(new WordValidator(this)), legacy(false)
 {
     patternValidator->setOptions(WordValidator::AllowQuestionMarks |
                                  WordValidator::AllowAsterisks |
                                  WordValidator::AllowCharacterClasses);
+    poolValidator->setOptions(WordValidator::AllowQuestionMarks);
 
     QHBoxLayout* mainHlay = new QHBoxLayout(this);
     mainHlay->setMargin(0);
@@ -124,6 +127,7 @@ SearchConditionForm::SearchConditionForm(QWidget* parent, Qt::WFlags f)
           << Auxil::searchTypeToString(SearchCondition::PartOfSpeech)
           << Auxil::searchTypeToString(SearchCondition::Definition)
           << Auxil::searchTypeToString(SearchCondition::ConsistOf)
+          << Auxil::searchTypeToString(SearchCondition::DrawProbability)
           << Auxil::searchTypeToString(SearchCondition::NumAnagrams);
 
     typeCbox = new QComboBox;
@@ -253,6 +257,49 @@ SearchConditionForm::SearchConditionForm(QWidget* parent, Qt::WFlags f)
 
     paramStack->addWidget(paramConsistWidget);
 
+    // Frame containing percent spin boxes and input line
+    paramDrawWidget = new QWidget;
+    QHBoxLayout* paramDrawHlay = new QHBoxLayout(paramDrawWidget);
+    paramDrawHlay->setMargin(0);
+    paramDrawHlay->setSpacing(SPACING);
+
+    QLabel* paramDrawMinLabel = new QLabel("Min:");
+    paramDrawHlay->addWidget(paramDrawMinLabel);
+
+    paramDrawMinSbox = new QDoubleSpinBox;
+    paramDrawMinSbox->setDecimals(DRAW_PERCENT_DECIMALS);
+    paramDrawMinSbox->setMinimum(0);
+    paramDrawMinSbox->setMaximum(100);
+    connect(paramDrawMinSbox, SIGNAL(valueChanged(double)),
+            SIGNAL(contentsChanged()));
+    paramDrawHlay->addWidget(paramDrawMinSbox);
+
+    QLabel* drawMinPctLabel = new QLabel("%");
+    paramDrawHlay->addWidget(drawMinPctLabel);
+
+    QLabel* paramDrawMaxLabel = new QLabel("Max:");
+    paramDrawHlay->addWidget(paramDrawMaxLabel);
+
+    paramDrawMaxSbox = new QDoubleSpinBox;
+    paramDrawMaxSbox->setDecimals(DRAW_PERCENT_DECIMALS);
+    paramDrawMaxSbox->setMinimum(0);
+    paramDrawMaxSbox->setMaximum(100);
+    connect(paramDrawMaxSbox, SIGNAL(valueChanged(double)),
+            SIGNAL(contentsChanged()));
+    paramDrawHlay->addWidget(paramDrawMaxSbox);
+
+    QLabel* drawMaxPctLabel = new QLabel("%");
+    paramDrawHlay->addWidget(drawMaxPctLabel);
+
+    paramDrawLine = new WordLineEdit;
+    paramDrawLine->setValidator(poolValidator);
+    connect(paramDrawLine, SIGNAL(returnPressed()), SIGNAL(returnPressed()));
+    connect(paramDrawLine, SIGNAL(textChanged(const QString&)),
+            SIGNAL(contentsChanged()));
+    paramDrawHlay->addWidget(paramDrawLine);
+
+    paramStack->addWidget(paramDrawWidget);
+
     // Frame containing disabled input line and push button for getting word
     // lists
     paramWordListWidget = new QWidget;
@@ -336,6 +383,14 @@ SearchConditionForm::getSearchCondition() const
         condition.maxValue = paramConsistMaxSbox->value();
         break;
 
+        case SearchCondition::DrawProbability:
+        condition.stringValue = paramDrawLine->text();
+        condition.minValue = qRound(paramDrawMinSbox->value() *
+                                    DRAW_PROBABILITY_SCALE / 100);
+        condition.maxValue = qRound(paramDrawMaxSbox->value() *
+                                    DRAW_PROBABILITY_SCALE / 100);
+        break;
+
         case SearchCondition::BelongToGroup:
         case SearchCondition::InLexicon:
         condition.stringValue = paramCbox->currentText();
@@ -422,6 +477,14 @@ SearchConditionForm::setSearchCondition(const SearchCondition& condition)
         paramConsistLine->setText(condition.stringValue);
         break;
 
+        case SearchCondition::DrawProbability:
+        paramDrawMinSbox->setValue(condition.minValue * 100.0 /
+                                   DRAW_PROBABILITY_SCALE);
+        paramDrawMaxSbox->setValue(condition.maxValue * 100.0 /
+                                   DRAW_PROBABILITY_SCALE);
+        paramDrawLine->setText(condition.stringValue);
+        break;
+
         case SearchCondition::BelongToGroup:
         case SearchCondition::InLexicon:
         paramCbox->setCurrentIndex(paramCbox->findText(condition.stringValue));
@@ -496,6 +559,10 @@ SearchConditionForm::isValid() const
         return (paramConsistMinSbox->value() <= paramConsistMaxSbox->value())
             && !paramConsistLine->text().isEmpty();
 
+        case SearchCondition::DrawProbability:
+        return (paramDrawMinSbox->value() <= paramDrawMaxSbox->value())
+            && !paramDrawLine->text().isEmpty();
+
         case SearchCondition::InWordList:
         return !paramWordListString.isEmpty();
 
@@ -672,6 +739,14 @@ SearchConditionForm::typeChanged(const QString& string)
         paramStack->setCurrentWidget(paramConsistWidget);
         break;
 
+        case SearchCondition::DrawProbability:
+        negationCbox->setCheckState(Qt::Unchecked);
+        negationCbox->setEnabled(false);
+        paramDrawMinSbox->setValue(0);
+        paramDrawMaxSbox->setValue(100);
+        paramStack->setCurrentWidget(paramDrawWidget);
+        break;
+
         case SearchCondition::InWordList:
         negationCbox->setEnabled(true);
         setWordListString(QString());
@@ -722,6 +797,9 @@ SearchConditionForm::reset()
     paramConsistMinSbox->setValue(0);
     paramConsistMaxSbox->setValue(100);
     paramConsistLine->setText(QString());
+    paramDrawMinSbox->setValue(0);
+    paramDrawMaxSbox->setValue(100);
+    paramDrawLine->setText(QString());
     typeCbox->setCurrentIndex(0);
     typeChanged(typeCbox->currentText());
 }
@@ -754,6 +832,12 @@ SearchConditionForm::selectInputArea()
                 paramConsistLine->text().length());
         }
     }
+    else if (currentWidget == paramDrawWidget) {
+        paramDrawLine->setFocus();
+        if (MainSettings::getSearchSelectInput()) {
+            paramDrawLine->setSelection(0, paramDrawLine->text().length());
+        }
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -28,6 +28,7 @@
 #include "SearchCondition.h"
 #include <QCheckBox>
 #include <QComboBox>
+#include <QDoubleSpinBox>
 #include <QLabel>
 #include <QPushButton>
 #include <QSpinBox>
@@ -87,11 +88,16 @@ class SearchConditionForm : public QWidget
     QSpinBox*       paramConsistMinSbox;
     QSpinBox*       paramConsistMaxSbox;
     WordLineEdit*   paramConsistLine;
+    QWidget*        paramDrawWidget;
+    QDoubleSpinBox* paramDrawMinSbox;
+    QDoubleSpinBox* paramDrawMaxSbox;
+    WordLineEdit*   paramDrawLine;
     QWidget*        paramWordListWidget;
     QLineEdit*      paramWordListLine;
     QString         paramWordListString;
     WordValidator*  letterValidator;
     WordValidator*  patternValidator;
+    WordValidator*  poolValidator;
     QPushButton*    addButton;
     QPushButton*    deleteButton;
 
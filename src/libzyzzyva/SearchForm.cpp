@@ -23,6 +23,7 @@
 //---------------------------------------------------------------------------
 
 #include "SearchForm.h"
+#include "LetterBag.h"
 #include "LexiconSelectWidget.h"
 #include "MainSettings.h"
 #include "SearchSpecForm.h"
@@ -43,6 +44,37 @@
 using namespace Defs;
 
 const QString TITLE_PREFIX = "Search";
+const int DEFAULT_SUMMARY_BAND_SIZE = 500;
+const int MAX_SUMMARY_BAND_SIZE = 100000;
+
+//---------------------------------------------------------------------------
+//  addAttributeItems
+//
+//! Fill a combo box with the word attributes that search results can be
+//! summarized by.
+//
+//! @param combo the combo box
+//! @param allowNone whether to offer no attribute as the first choice
+//---------------------------------------------------------------------------
+static void
+addAttributeItems(QComboBox* combo, bool allowNone)
+{
+    if (allowNone)
+        combo->addItem("(None)", int(WordEngine::NoAttribute));
+    combo->addItem("Length", int(WordEngine::LengthAttribute));
+    combo->addItem("Number of Vowels", int(WordEngine::NumVowelsAttribute));
+    combo->addItem("Number of Unique Letters",
+                   int(WordEngine::NumUniqueLettersAttribute));
+    combo->addItem("Point Value", int(WordEngine::PointValueAttribute));
+    combo->addItem("Number of Anagrams",
+                   int(WordEngine::NumAnagramsAttribute));
+    combo->addItem("First Letter", int(WordEngine::FirstLetterAttribute));
+    combo->addItem("Last Letter", int(WordEngine::LastLetterAttribute));
+    combo->addItem("Probability Order",
+                   int(WordEngine::ProbabilityOrderAttribute));
+    combo->addItem("Playability Order",
+                   int(WordEngine::PlayabilityOrderAttribute));
+}
 
 //---------------------------------------------------------------------------
 //  SearchForm
@@ -91,6 +123,9 @@ SearchForm::SearchForm(WordEngine* e, QWidget* parent, Qt::WFlags f)
     connect(searchButton, SIGNAL(clicked()), SLOT(search()));
     buttonHlay->addWidget(searchButton);
 
+    refineCbox = new QCheckBox("Search &within previous results");
+    buttonHlay->addWidget(refineCbox);
+
     resultView = new WordTableView(wordEngine);
     specVlay->addWidget(resultView, 1);
 
@@ -99,6 +134,52 @@ SearchForm::SearchForm(WordEngine* e, QWidget* parent, Qt::WFlags f)
             resultView, SLOT(resizeItemsToContents()));
     resultView->setModel(resultModel);
 
+    QHBoxLayout* summaryHlay = new QHBoxLayout;
+    summaryHlay->setSpacing(SPACING);
+    specVlay->addLayout(summaryHlay);
+
+    QLabel* summaryFirstLabel = new QLabel("Summarize by:");
+    summaryHlay->addWidget(summaryFirstLabel);
+
+    summaryFirstCombo = new QComboBox;
+    addAttributeItems(summaryFirstCombo, false);
+    summaryHlay->addWidget(summaryFirstCombo);
+
+    QLabel* summarySecondLabel = new QLabel("and:");
+    summaryHlay->addWidget(summarySecondLabel);
+
+    summarySecondCombo = new QComboBox;
+    addAttributeItems(summarySecondCombo, true);
+    summaryHlay->addWidget(summarySecondCombo);
+
+    QLabel* summaryValueLabel = new QLabel("Range of:");
+    summaryHlay->addWidget(summaryValueLabel);
+
+    summaryValueCombo = new QComboBox;
+    addAttributeItems(summaryValueCombo, true);
+    summaryHlay->addWidget(summaryValueCombo);
+
+    QLabel* summaryBandLabel = new QLabel("Order bands of:");
+    summaryHlay->addWidget(summaryBandLabel);
+
+    summaryBandSbox = new QSpinBox;
+    summaryBandSbox->setMinimum(1);
+    summaryBandSbox->setMaximum(MAX_SUMMARY_BAND_SIZE);
+    summaryBandSbox->setValue(DEFAULT_SUMMARY_BAND_SIZE);
+    summaryHlay->addWidget(summaryBandSbox);
+
+    summarizeButton = new ZPushButton("S&ummarize");
+    summarizeButton->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+    connect(summarizeButton, SIGNAL(clicked()), SLOT(summarize()));
+    summaryHlay->addWidget(summarizeButton);
+
+    summaryHlay->addStretch(1);
+
+    summaryTree = new QTreeWidget;
+    summaryTree->setRootIsDecorated(false);
+    summaryTree->hide();
+    specVlay->addWidget(summaryTree);
+
     lexiconActivated(lexiconWidget->getCurrentLexicon());
 
     specChanged();
@@ -219,8 +300,18 @@ SearchForm::search()
 
     QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-    QStringList wordList =
-        wordEngine->search(lexicon, specForm->getSearchSpec(), false);
+    // Only evaluate added conditions if refining the previous search
+    QStringList wordList;
+    if (refineCbox->isChecked() && (lexicon == lastLexicon)) {
+        wordList = wordEngine->refineSearch(lexicon, lastSpec, lastResults,
+                                            spec, false);
+    }
+    else
+        wordList = wordEngine->search(lexicon, spec, false);
+
+    lastSpec = spec;
+    lastLexicon = lexicon;
+    lastResults = wordList;
 
     if (!wordList.empty()) {
 
@@ -230,6 +321,8 @@ SearchForm::search()
         bool hasSubanagramCondition = false;
         bool hasProbabilityCondition = false;
         bool hasPlayabilityCondition = false;
+        bool hasDrawCondition = false;
+        LetterBag drawBag;
         int probNumBlanks = MainSettings::getProbabilityNumBlanks();
         QListIterator<SearchCondition> it (spec.conditions);
         while (it.hasNext()) {
@@ -260,6 +353,15 @@ SearchForm::search()
             {
                 hasPlayabilityCondition = true;
             }
+
+            // Show draw probabilities from the pool of the first Draw
+            // Probability condition
+            else if ((type == SearchCondition::DrawProbability) &&
+                     !hasDrawCondition)
+            {
+                drawBag.setLetters(condition.stringValue);
+                hasDrawCondition = true;
+            }
         }
 
         // Create a list of WordItem objects from the words
@@ -292,6 +394,11 @@ SearchForm::search()
             WordTableModel::WordItem wordItem
                 (displayWord, WordTableModel::WordNormal, wildcard);
 
+            if (hasDrawCondition) {
+                wordItem.setDrawProbability(
+                    drawBag.getDrawProbability(wordUpper));
+            }
+
             // Set probability/playability order for correct sorting
             if (hasProbabilityCondition) {
                 int probOrder = wordEngine->getProbabilityOrder(
@@ -322,6 +429,7 @@ SearchForm::search()
         else if (hasPlayabilityCondition)
             MainSettings::setWordListSortByPlayabilityOrder(true);
         resultModel->setProbabilityNumBlanks(probNumBlanks);
+        resultModel->setShowDrawProbability(hasDrawCondition);
         resultModel->addWords(wordItems);
         MainSettings::setWordListSortByPlayabilityOrder(false);
         MainSettings::setWordListSortByProbabilityOrder(false);
@@ -347,6 +455,95 @@ SearchForm::search()
     QApplication::restoreOverrideCursor();
 }
 
+//---------------------------------------------------------------------------
+//  summarize
+//
+//! Summarize the words matching the search spec by the chosen attributes,
+//! and display the groups in the summary pane.  The words themselves are
+//! not displayed.
+//---------------------------------------------------------------------------
+void
+SearchForm::summarize()
+{
+    SearchSpec spec = specForm->getSearchSpec();
+    if (spec.conditions.empty())
+        return;
+
+    QString lexicon = lexiconWidget->getCurrentLexicon();
+
+    WordEngine::AggregateSpec aggregate;
+    aggregate.firstGroup = WordEngine::AggregateAttribute(
+        summaryFirstCombo->itemData(
+            summaryFirstCombo->currentIndex()).toInt());
+    aggregate.secondGroup = WordEngine::AggregateAttribute(
+        summarySecondCombo->itemData(
+            summarySecondCombo->currentIndex()).toInt());
+    aggregate.valueAttribute = WordEngine::AggregateAttribute(
+        summaryValueCombo->itemData(
+            summaryValueCombo->currentIndex()).toInt());
+    aggregate.bandSize = summaryBandSbox->value();
+    aggregate.numBlanks = MainSettings::getProbabilityNumBlanks();
+
+    summarizeButton->setEnabled(false);
+    statusString = "Summarizing...";
+    emit statusChanged(statusString);
+    qApp->processEvents();
+
+    QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+    QList<WordEngine::AggregateRow> rows =
+        wordEngine->aggregateSearch(lexicon, spec, aggregate);
+
+    QStringList headers;
+    headers.append(summaryFirstCombo->currentText());
+    if (aggregate.secondGroup != WordEngine::NoAttribute)
+        headers.append(summarySecondCombo->currentText());
+    headers.append("Count");
+    if (aggregate.valueAttribute != WordEngine::NoAttribute) {
+        headers.append("Min " + summaryValueCombo->currentText());
+        headers.append("Max " + summaryValueCombo->currentText());
+    }
+
+    summaryTree->clear();
+    summaryTree->setColumnCount(headers.size());
+    summaryTree->setHeaderLabels(headers);
+
+    int numWords = 0;
+    foreach (const WordEngine::AggregateRow& row, rows) {
+        QStringList strings;
+        strings.append(WordEngine::attributeKeyToString(
+            aggregate.firstGroup, row.firstKey, aggregate.bandSize));
+        if (aggregate.secondGroup != WordEngine::NoAttribute) {
+            strings.append(WordEngine::attributeKeyToString(
+                aggregate.secondGroup, row.secondKey, aggregate.bandSize));
+        }
+        strings.append(QString::number(row.count));
+        if (aggregate.valueAttribute != WordEngine::NoAttribute) {
+            strings.append(WordEngine::attributeKeyToString(
+                aggregate.valueAttribute, row.minValue));
+            strings.append(WordEngine::attributeKeyToString(
+                aggregate.valueAttribute, row.maxValue));
+        }
+        summaryTree->addTopLevelItem(new QTreeWidgetItem(strings));
+        numWords += row.count;
+    }
+    for (int i = 0; i < headers.size(); ++i)
+        summaryTree->resizeColumnToContents(i);
+    summaryTree->show();
+
+    QString wordStr = QString::number(numWords) + " word";
+    if (numWords != 1)
+        wordStr += "s";
+    QString groupStr = QString::number(rows.size()) + " group";
+    if (rows.size() != 1)
+        groupStr += "s";
+    statusString = "Summary found " + wordStr + " in " + groupStr;
+    emit statusChanged(statusString);
+
+    summarizeButton->setEnabled(true);
+    QApplication::restoreOverrideCursor();
+}
+
 //---------------------------------------------------------------------------
 //  specChanged
 //
@@ -357,6 +554,7 @@ void
 SearchForm::specChanged()
 {
     searchButton->setEnabled(specForm->isValid());
+    summarizeButton->setEnabled(specForm->isValid());
 }
 
 //---------------------------------------------------------------------------
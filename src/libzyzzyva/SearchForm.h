@@ -26,9 +26,12 @@
 #define ZYZZYVA_SEARCH_FORM_H
 
 #include "ActionForm.h"
+#include "SearchSpec.h"
 #include <QCheckBox>
 #include <QComboBox>
 #include <QLabel>
+#include <QSpinBox>
+#include <QTreeWidget>
 
 class LexiconSelectWidget;
 class SearchSpecForm;
@@ -56,6 +59,7 @@ class SearchForm : public ActionForm
 
     public slots:
     void search();
+    void summarize();
     void updateResultTotal(int num);
     void lexiconActivated(const QString& lexicon);
     void specChanged();
@@ -67,8 +71,20 @@ class SearchForm : public ActionForm
     WordTableView*  resultView;
     WordTableModel* resultModel;
     ZPushButton*    searchButton;
+    QCheckBox*      refineCbox;
+    QComboBox*      summaryFirstCombo;
+    QComboBox*      summarySecondCombo;
+    QComboBox*      summaryValueCombo;
+    QSpinBox*       summaryBandSbox;
+    ZPushButton*    summarizeButton;
+    QTreeWidget*    summaryTree;
     QString         statusString;
     QString         detailsString;
+
+    // The previous search, kept so it can be refined
+    SearchSpec      lastSpec;
+    QString         lastLexicon;
+    QStringList     lastResults;
 };
 
 #endif // ZYZZYVA_SEARCH_FORM_H
@@ -309,6 +309,21 @@ SearchSpec::optimize(const QString& lexicon)
             }
             break;
 
+            case SearchCondition::DrawProbability:
+            condition.stringValue = stringValue =
+                Auxil::getCanonicalSearchString(stringValue);
+            if ((minValue > maxValue) ||
+                (minValue > DRAW_PROBABILITY_SCALE) ||
+                (stringValue.length() < qMax(minLength, 1)))
+            {
+                conditions.clear();
+                return;
+            }
+            if (stringValue.length() < maxLength)
+                maxLength = stringValue.length();
+            newConditions.append(condition);
+            break;
+
             case SearchCondition::BelongToGroup: {
                 SearchSet ss = Auxil::stringToSearchSet(stringValue);
                 if (ss == UnknownSearchSet)
@@ -513,3 +528,46 @@ SearchSpec::update()
         ++version;
     }
 }
+
+//---------------------------------------------------------------------------
+//  isRefinementOf
+//
+//! Determine whether this search spec only narrows another search spec, so
+//! that its results can be found by filtering the results of the other
+//! search spec.  This is true when both specs are conjunctions, and this
+//! spec contains every condition of the other spec plus zero or more
+//! additional conditions.  Limit By Probability/Playability Order conditions
+//! depend on the entire candidate list, so specs containing them are never
+//! considered refinements.
+//
+//! @param base the search spec that may be refined
+//! @param addedConditions returns the conditions not present in the base
+//! @return true if this spec is a refinement of the base spec
+//---------------------------------------------------------------------------
+bool
+SearchSpec::isRefinementOf(const SearchSpec& base, QList<SearchCondition>*
+                           addedConditions) const
+{
+    if (!conjunction || !base.conjunction || base.conditions.isEmpty())
+        return false;
+
+    QList<SearchCondition> added = conditions;
+    foreach (const SearchCondition& condition, base.conditions) {
+        int index = added.indexOf(condition);
+        if (index < 0)
+            return false;
+        added.removeAt(index);
+    }
+
+    foreach (const SearchCondition& condition, conditions) {
+        if ((condition.type == SearchCondition::LimitByProbabilityOrder) ||
+            (condition.type == SearchCondition::LimitByPlayabilityOrder))
+        {
+            return false;
+        }
+    }
+
+    if (addedConditions)
+        *addedConditions = added;
+    return true;
+}
@@ -43,6 +43,8 @@ class SearchSpec
     bool fromDomElement(const QDomElement& element);
     void optimize(const QString& lexicon);
     void update();
+    bool isRefinementOf(const SearchSpec& base, QList<SearchCondition>*
+                        addedConditions = 0) const;
 
     int version;
     bool conjunction;
@@ -410,6 +410,7 @@ SearchSpecForm::selectInputArea()
             case SearchCondition::Suffix:
             case SearchCondition::IncludeLetters:
             case SearchCondition::ConsistOf:
+            case SearchCondition::DrawProbability:
             form->selectInputArea();
             focusSet = true;
             break;
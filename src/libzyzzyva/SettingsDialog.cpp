@@ -153,6 +153,10 @@ SettingsDialog::SettingsDialog(QWidget* parent, Qt::WFlags f)
     autoImportCustomLine->setReadOnly(true);
     autoImportCustomHlay->addWidget(autoImportCustomLine);
 
+    shareLexiconGraphsCbox =
+        new QCheckBox("Share memory between related lexicons");
+    autoImportVlay->addWidget(shareLexiconGraphsCbox);
+
     QGroupBox* userDataDirGbox = new QGroupBox("Data Directory");
     generalPrefVlay->addWidget(userDataDirGbox);
     generalPrefVlay->setStretchFactor(userDataDirGbox, 1);
@@ -329,6 +333,10 @@ SettingsDialog::SettingsDialog(QWidget* parent, Qt::WFlags f)
         new QCheckBox("Cycle answers after ending a question");
     quizBehaviorVlay->addWidget(quizCycleAnswersCbox);
 
+    quizRecordSessionsCbox =
+        new QCheckBox("Record quiz sessions for replay");
+    quizBehaviorVlay->addWidget(quizRecordSessionsCbox);
+
     QHBoxLayout* timeoutDisableInputHlay = new QHBoxLayout;
     timeoutDisableInputHlay->setMargin(0);
     quizBehaviorVlay->addLayout(timeoutDisableInputHlay);
@@ -745,6 +753,9 @@ SettingsDialog::refreshSettings()
     QString autoImportFile = MainSettings::getAutoImportFile();
     autoImportCustomLine->setText(autoImportFile);
 
+    shareLexiconGraphsCbox->setChecked(
+        MainSettings::getShareLexiconGraphs());
+
     origUserDataDir = MainSettings::getUserDataDir();
     userDataDirLine->setText(origUserDataDir);
 
@@ -801,6 +812,8 @@ SettingsDialog::refreshSettings()
     quizMarkMissedAfterTimerCbox->setChecked(
         MainSettings::getQuizMarkMissedAfterTimerExpires());
     quizCycleAnswersCbox->setChecked(MainSettings::getQuizCycleAnswers());
+    quizRecordSessionsCbox->setChecked(
+        MainSettings::getQuizRecordSessions());
     quizTimeoutDisableInputCbox->setChecked(
         MainSettings::getQuizTimeoutDisableInput());
     quizTimeoutDisableInputSbox->setValue(
@@ -897,6 +910,7 @@ SettingsDialog::writeSettings()
     MainSettings::setAutoImportLexicons(importLexicons);
     MainSettings::setDefaultLexicon(defaultLexicon);
     MainSettings::setAutoImportFile(autoImportCustomLine->text());
+    MainSettings::setShareLexiconGraphs(shareLexiconGraphsCbox->isChecked());
     MainSettings::setDisplayWelcome(displayWelcomeCbox->isChecked());
     MainSettings::setUserDataDir(userDataDirLine->text());
     MainSettings::setUseTileTheme(themeCbox->isChecked());
@@ -921,6 +935,8 @@ SettingsDialog::writeSettings()
     MainSettings::setQuizMarkMissedAfterTimerExpires(
         quizMarkMissedAfterTimerCbox->isChecked());
     MainSettings::setQuizCycleAnswers(quizCycleAnswersCbox->isChecked());
+    MainSettings::setQuizRecordSessions(
+        quizRecordSessionsCbox->isChecked());
     MainSettings::setQuizTimeoutDisableInput(
         quizTimeoutDisableInputCbox->isChecked());
     MainSettings::setQuizTimeoutDisableInputMillisecs(
@@ -1015,6 +1031,7 @@ SettingsDialog::autoImportCboxToggled(bool on)
 {
     autoImportLabel->setEnabled(on);
     autoImportButton->setEnabled(on);
+    shareLexiconGraphsCbox->setEnabled(on);
 
     QStringList lexicons;
     QString defaultLexicon;
@@ -96,6 +96,7 @@ class SettingsDialog : public QDialog
     ZPushButton* autoImportButton;
     QWidget*     autoImportCustomWidget;
     QLineEdit*   autoImportCustomLine;
+    QCheckBox*   shareLexiconGraphsCbox;
     QCheckBox*   displayWelcomeCbox;
     QLineEdit*   userDataDirLine;
     QCheckBox*   userDataDirMoveCbox;
@@ -115,6 +116,7 @@ class SettingsDialog : public QDialog
     QCheckBox*   quizMarkMissedAfterIncorrectCbox;
     QCheckBox*   quizMarkMissedAfterTimerCbox;
     QCheckBox*   quizCycleAnswersCbox;
+    QCheckBox*   quizRecordSessionsCbox;
     QCheckBox*   quizTimeoutDisableInputCbox;
     QSpinBox*    quizTimeoutDisableInputSbox;
     QSpinBox*    probBlanksSbox;
@@ -0,0 +1,148 @@
+//---------------------------------------------------------------------------
+// SharedWordGraph.cpp
+//
+// A word graph shared by several related lexicons.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "SharedWordGraph.h"
+#include "DawgBuilder.h"
+
+const qint32 ROOT_NODE = 1;
+
+const qint32 V_END_OF_NODE = 22;
+const qint32 M_END_OF_NODE = (1L << V_END_OF_NODE);
+
+const qint32 V_LETTER       = 24;
+const qint32 M_LETTER       = 0xFF;
+const qint32 M_NODE_POINTER = 0x1FFFFFL;
+
+//---------------------------------------------------------------------------
+//  build
+//
+//! Build the shared graphs from the words of each lexicon.  Lexicon N is
+//! represented by bit N of the edge masks.
+//
+//! @param lexiconNames the names of the lexicons
+//! @param lexiconWords the words of each lexicon, in the same order
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+SharedWordGraph::build(const QStringList& lexiconNames, const
+                       QList<QStringList>& lexiconWords, QString* errString)
+{
+    if ((lexiconNames.count() != lexiconWords.count()) ||
+        (lexiconNames.count() > MAX_LEXICONS))
+    {
+        if (errString)
+            *errString = "Too many lexicons to share a word graph.";
+        return false;
+    }
+
+    DawgBuilder builder;
+    if (!builder.buildShared(lexiconWords, false, &edges, &masks,
+                             errString) ||
+        !builder.buildShared(lexiconWords, true, &reverseEdges,
+                             &reverseMasks, errString))
+    {
+        edges.clear();
+        masks.clear();
+        reverseEdges.clear();
+        reverseMasks.clear();
+        return false;
+    }
+
+    lexicons = lexiconNames;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  getEdges
+//
+//! Return the edge array of the forward or reverse graph.  The array begins
+//! with the terminal entry, like the arrays used by WordGraph.
+//
+//! @param reverse whether to return the reverse graph
+//! @param numEdges return the number of edges, not counting the terminal
+//! entry
+//! @return the edge array
+//---------------------------------------------------------------------------
+const qint32*
+SharedWordGraph::getEdges(bool reverse, qint32* numEdges) const
+{
+    const QVector<qint32>& array = reverse ? reverseEdges : edges;
+    if (numEdges)
+        *numEdges = array.isEmpty() ? 0 : array.count() - 1;
+    return array.isEmpty() ? 0 : array.constData();
+}
+
+//---------------------------------------------------------------------------
+//  getMasks
+//
+//! Return the edge masks of the forward or reverse graph, as described in
+//! DawgBuilder::buildShared.
+//
+//! @param reverse whether to return the masks of the reverse graph
+//! @return the edge masks
+//---------------------------------------------------------------------------
+const quint16*
+SharedWordGraph::getMasks(bool reverse) const
+{
+    const QVector<quint16>& array = reverse ? reverseMasks : masks;
+    return array.isEmpty() ? 0 : array.constData();
+}
+
+//---------------------------------------------------------------------------
+//  getMembership
+//
+//! Determine which lexicons contain a word with a single traversal of the
+//! graph.
+//
+//! @param word the word, in upper case
+//! @return a mask with bit N set if lexicon N contains the word
+//---------------------------------------------------------------------------
+quint8
+SharedWordGraph::getMembership(const QString& word) const
+{
+    if (word.isEmpty() || edges.isEmpty())
+        return 0;
+
+    qint32 node = ROOT_NODE;
+    quint16 mask = 0;
+    for (int i = 0; i < word.length(); ++i) {
+        if (!node)
+            return 0;
+
+        char c = word.at(i).toLatin1();
+        for (qint32 edge = node; ; ++edge) {
+            qint32 value = edges.at(edge);
+            if (char((value >> V_LETTER) & M_LETTER) == c) {
+                node = value & M_NODE_POINTER;
+                mask = masks.at(edge);
+                break;
+            }
+            if (value & M_END_OF_NODE)
+                return 0;
+        }
+    }
+
+    return quint8(mask >> 8);
+}
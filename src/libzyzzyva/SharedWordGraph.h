@@ -0,0 +1,62 @@
+//---------------------------------------------------------------------------
+// SharedWordGraph.h
+//
+// A word graph shared by several related lexicons.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#ifndef ZYZZYVA_SHARED_WORD_GRAPH_H
+#define ZYZZYVA_SHARED_WORD_GRAPH_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Forward and reverse DAWGs holding the words of up to eight lexicons, with
+// a membership mask for each edge.  Each lexicon reads the graph through a
+// WordGraph that ignores the edges the lexicon does not use.
+class SharedWordGraph
+{
+    public:
+    static const int MAX_LEXICONS = 8;
+
+    public:
+    SharedWordGraph() { }
+    ~SharedWordGraph() { }
+
+    bool build(const QStringList& lexiconNames, const QList<QStringList>&
+               lexiconWords, QString* errString = 0);
+    QStringList getLexicons() const { return lexicons; }
+    int getLexiconIndex(const QString& lexicon) const {
+        return lexicons.indexOf(lexicon); }
+    const qint32* getEdges(bool reverse, qint32* numEdges) const;
+    const quint16* getMasks(bool reverse) const;
+    quint8 getMembership(const QString& word) const;
+
+    private:
+    QStringList lexicons;
+    QVector<qint32> edges;
+    QVector<qint32> reverseEdges;
+    QVector<quint16> masks;
+    QVector<quint16> reverseMasks;
+};
+
+#endif // ZYZZYVA_SHARED_WORD_GRAPH_H
@@ -24,15 +24,27 @@
 
 #include "WordEngine.h"
 #include "LetterBag.h"
+#include "LexiconBundle.h"
+#include "Rand.h"
+#include "SharedWordGraph.h"
 #include "Auxil.h"
 #include "Defs.h"
 #include <QApplication>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QPair>
 #include <QRegExp>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QVarLengthArray>
 #include <QVariant>
 #include <QVector>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
 
 using namespace Defs;
 
@@ -43,6 +55,8 @@ const QString WordEngine::DEF_ORIG_SEP = " / ";
 const QString WordEngine::DEF_DISPLAY_SEP = " / ";
 
 const int LIMIT_RANGE_MAX = 999999;
+const int MAX_DEFINITION_LINKS = 3;
+const int MAX_QUERY_WORDS = 1000;
 
 //---------------------------------------------------------------------------
 //  clearCache
@@ -60,6 +74,46 @@ WordEngine::clearCache(const QString& lexicon) const
     lexiconData[lexicon]->wordCache.clear();
 }
 
+//---------------------------------------------------------------------------
+//  clearCompletionIndexes
+//
+//! Discard the completion indexes for a lexicon, so they will be rebuilt
+//! the next time they are needed.
+//
+//! @param lexicon the name of the lexicon
+//---------------------------------------------------------------------------
+void
+WordEngine::clearCompletionIndexes(const QString& lexicon) const
+{
+    if (!lexiconData.contains(lexicon))
+        return;
+
+    lexiconData[lexicon]->completionIndexes.clear();
+}
+
+//---------------------------------------------------------------------------
+//  buildAlphabet
+//
+//! Build the alphabet of a lexicon from the current letter distribution and
+//! the letters of its word graph.  The alphabet is built whenever the words
+//! of the lexicon are loaded, and is only read afterward, so database
+//! build threads can share it safely.
+//
+//! @param lexicon the name of the lexicon
+//---------------------------------------------------------------------------
+void
+WordEngine::buildAlphabet(const QString& lexicon)
+{
+    if (!lexiconData.contains(lexicon))
+        return;
+
+    LexiconData* data = lexiconData[lexicon];
+    Alphabet alphabet;
+    if (data->graph)
+        alphabet.addLetters(data->graph->getLetters().toUpper());
+    data->alphabet = alphabet;
+}
+
 //---------------------------------------------------------------------------
 //  connectToDatabase
 //
@@ -99,6 +153,7 @@ WordEngine::connectToDatabase(const QString& lexicon, const QString& filename,
     LexiconData* data = lexiconData[lexicon];
     data->db = db;
     data->dbConnectionName = dbConnectionName;
+    clearCompletionIndexes(lexicon);
     return true;
 }
 
@@ -125,6 +180,7 @@ WordEngine::disconnectFromDatabase(const QString& lexicon)
     lexiconData[lexicon]->db = 0;
     QSqlDatabase::removeDatabase(dbConnectionName);
     lexiconData[lexicon]->dbConnectionName.clear();
+    clearCompletionIndexes(lexicon);
     return true;
 }
 
@@ -158,7 +214,18 @@ int
 WordEngine::importTextFile(const QString& lexicon, const QString& filename,
                            bool loadDefinitions, QString* errString)
 {
+    // Read the file before touching the old word graph, so a failed import
+    // leaves the lexicon and any overlays built on it intact
+    QStringList words;
+    QStringList definitions;
+    if (!readWordListFile(filename, &words,
+                          loadDefinitions ? &definitions : 0, errString))
+    {
+        return 0;
+    }
+
     // Delete old word graph if it exists
+    unshareLexiconGraph(lexicon);
     if (lexiconData.contains(lexicon))
         delete lexiconData[lexicon]->graph;
     else
@@ -167,40 +234,71 @@ WordEngine::importTextFile(const QString& lexicon, const QString& filename,
     WordGraph* graph = new WordGraph;
     lexiconData[lexicon]->graph = graph;
     lexiconData[lexicon]->lexiconFile = filename;
+    lexiconData[lexicon]->lexiconHash = Auxil::getFileContentHash(filename);
+    lexiconData[lexicon]->baseLexicon = QString();
+    delete lexiconData[lexicon]->bundle;
+    lexiconData[lexicon]->bundle = 0;
+    graphChanged(lexicon);
+    clearCompletionIndexes(lexicon);
+
+    int imported = 0;
+    for (int i = 0; i < words.count(); ++i) {
+        const QString& word = words[i];
+        if (!graph->containsWord(word)) {
+            QString alpha = Auxil::getAlphagram(word);
+            ++lexiconData[lexicon]->numAnagramsMap[alpha];
+        }
+
+        graph->addWord(word);
+        if (loadDefinitions)
+            addDefinition(lexicon, word, definitions[i]);
+        ++imported;
+    }
+
+    buildAlphabet(lexicon);
+    rebaseOverlays(lexicon);
+    return imported;
+}
 
+//---------------------------------------------------------------------------
+//  readWordListFile
+//
+//! Read the words and definitions from a word list file in plain text
+//! format.  Each line holds a word, optionally followed by its definition.
+//! Blank lines and lines beginning with '#' are ignored.
+//
+//! @param filename the name of the file to read
+//! @param words returns the words, in upper case
+//! @param definitions returns the definition of each word, in the same order
+//! as the words, or null if definitions are not needed
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordEngine::readWordListFile(const QString& filename, QStringList* words,
+                             QStringList* definitions, QString* errString)
+{
     QFile file (filename);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         if (errString) {
             *errString = "Can't open file '" + filename + "': " +
                 file.errorString();
         }
-        return 0;
+        return false;
     }
 
-    int imported = 0;
     char* buffer = new char[MAX_INPUT_LINE_LEN];
     while (file.readLine(buffer, MAX_INPUT_LINE_LEN) > 0) {
         QString line (buffer);
         line = line.simplified();
         if (!line.length() || (line.at(0) == '#'))
             continue;
-        QString word = line.section(' ', 0, 0).toUpper();
-
-        if (!graph->containsWord(word)) {
-            QString alpha = Auxil::getAlphagram(word);
-            ++lexiconData[lexicon]->numAnagramsMap[alpha];
-        }
-
-        graph->addWord(word);
-        if (loadDefinitions) {
-            QString definition = line.section(' ', 1);
-            addDefinition(lexicon, word, definition);
-        }
-        ++imported;
+        words->append(line.section(' ', 0, 0).toUpper());
+        if (definitions)
+            definitions->append(line.section(' ', 1));
     }
-
     delete[] buffer;
-    return imported;
+    return true;
 }
 
 //---------------------------------------------------------------------------
@@ -224,10 +322,16 @@ WordEngine::importDawgFile(const QString& lexicon, const QString& filename,
         lexiconData[lexicon] = new LexiconData;
         lexiconData[lexicon]->graph = new WordGraph;
     }
+    unshareLexiconGraph(lexicon);
 
     WordGraph* graph = lexiconData[lexicon]->graph;
     bool ok = graph->importDawgFile(filename, reverse, errString,
                                     expectedChecksum);
+    lexiconData[lexicon]->baseLexicon = QString();
+    graphChanged(lexicon);
+    clearCompletionIndexes(lexicon);
+    buildAlphabet(lexicon);
+    rebaseOverlays(lexicon);
     return ok;
 }
 
@@ -293,6 +397,463 @@ WordEngine::importStems(const QString& lexicon, const QString& filename,
     return imported;
 }
 
+//---------------------------------------------------------------------------
+//  importLexiconBundle
+//
+//! Import a lexicon from a single-file bundle as compiled by lexc.  The
+//! bundle is opened once and mapped into memory; the word graphs and stems
+//! are taken from it, and per-word attributes and definitions are read from
+//! it on demand when no database is connected.
+//
+//! @param lexicon the name of the lexicon
+//! @param filename the name of the bundle file
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordEngine::importLexiconBundle(const QString& lexicon, const QString&
+                                filename, QString* errString)
+{
+    LexiconBundle* bundle = new LexiconBundle;
+    if (!bundle->open(filename, errString)) {
+        delete bundle;
+        return false;
+    }
+
+    if (!lexiconData.contains(lexicon))
+        lexiconData[lexicon] = new LexiconData;
+
+    unshareLexiconGraph(lexicon);
+    LexiconData* data = lexiconData[lexicon];
+    delete data->graph;
+    delete data->bundle;
+    data->graph = new WordGraph;
+    data->bundle = bundle;
+
+    for (int i = 0; i < 2; ++i) {
+        bool reverse = (i == 1);
+        qint32 numEdges = 0;
+        const qint32* edges = bundle->getDawg(reverse, &numEdges);
+        data->graph->importDawgData(edges, numEdges, reverse);
+    }
+
+    QMap<int, QStringList> stems = bundle->getStems();
+    QMapIterator<int, QStringList> it (stems);
+    while (it.hasNext()) {
+        it.next();
+        int length = it.key();
+        data->stems[length] += it.value();
+        foreach (const QString& stem, it.value())
+            data->stemAlphagrams[length].insert(Auxil::getAlphagram(stem));
+    }
+
+    data->baseLexicon = QString();
+    graphChanged(lexicon);
+    clearCompletionIndexes(lexicon);
+    buildAlphabet(lexicon);
+    rebaseOverlays(lexicon);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  importOverlayFile
+//
+//! Load a lexicon as a loaded base lexicon plus a list of added and deleted
+//! words, without rebuilding a word graph.  The file is in plain text
+//! format with one word per line.  A word preceded by '-' is deleted from
+//! the base lexicon, and any other word, optionally preceded by '+', is
+//! added.  Lines beginning with '#' are ignored.
+//
+//! @param lexicon the name of the lexicon
+//! @param baseLexicon the name of the base lexicon
+//! @param filename the name of the file to import
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordEngine::importOverlayFile(const QString& lexicon, const QString&
+                              baseLexicon, const QString& filename, QString*
+                              errString)
+{
+    if (!lexiconIsLoaded(baseLexicon) || (baseLexicon == lexicon) ||
+        !lexiconData[baseLexicon]->baseLexicon.isEmpty())
+    {
+        if (errString)
+            *errString = "Lexicon " + baseLexicon + " cannot be used as a "
+                "base lexicon.";
+        return false;
+    }
+
+    QStringList words;
+    if (!readWordListFile(filename, &words, 0, errString))
+        return false;
+
+    QStringList additions;
+    QStringList deletions;
+    foreach (const QString& word, words) {
+        if (word.startsWith("-"))
+            deletions.append(word.mid(1));
+        else if (word.startsWith("+"))
+            additions.append(word.mid(1));
+        else
+            additions.append(word);
+    }
+
+    WordGraph* graph = new WordGraph;
+    if (!graph->importBaseGraph(lexiconData[baseLexicon]->graph)) {
+        delete graph;
+        if (errString)
+            *errString = "Lexicon " + baseLexicon + " cannot be used as a "
+                "base lexicon.";
+        return false;
+    }
+    graph->setOverlay(additions, deletions);
+
+    unshareLexiconGraph(lexicon);
+    if (!lexiconData.contains(lexicon))
+        lexiconData[lexicon] = new LexiconData;
+
+    LexiconData* data = lexiconData[lexicon];
+    delete data->graph;
+    delete data->bundle;
+    data->graph = graph;
+    data->bundle = 0;
+    data->baseLexicon = baseLexicon;
+    data->lexiconFile = filename;
+    data->lexiconHash = Auxil::getFileContentHash(filename);
+    graphChanged(lexicon);
+    clearCompletionIndexes(lexicon);
+    buildAlphabet(lexicon);
+    clearCache(lexicon);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  readOverlayBase
+//
+//! Read the name of the base lexicon from an overlay file.  An overlay file
+//! begins with a line of the form "#base LEXICON".
+//
+//! @param filename the name of the file
+//! @return the name of the base lexicon, or an empty string if the file is
+//! not an overlay file
+//---------------------------------------------------------------------------
+QString
+WordEngine::readOverlayBase(const QString& filename)
+{
+    QFile file (filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return QString();
+
+    QString line = QString(file.readLine(MAX_INPUT_LINE_LEN)).simplified();
+    if (!line.startsWith("#base "))
+        return QString();
+    return line.section(' ', 1, 1);
+}
+
+//---------------------------------------------------------------------------
+//  rebaseOverlays
+//
+//! Point the overlay lexicons built on a base lexicon at the current graph
+//! of the base lexicon, after the base lexicon has been reloaded.  An
+//! overlay whose base lexicon can no longer be used as a base is unloaded,
+//! and lexiconUnloaded is emitted for it.
+//
+//! @param baseLexicon the name of the base lexicon
+//---------------------------------------------------------------------------
+void
+WordEngine::rebaseOverlays(const QString& baseLexicon)
+{
+    if (!lexiconData.contains(baseLexicon))
+        return;
+
+    const WordGraph* base = lexiconData[baseLexicon]->graph;
+    QMapIterator<QString, LexiconData*> it (lexiconData);
+    while (it.hasNext()) {
+        it.next();
+        LexiconData* data = it.value();
+        if (data->baseLexicon != baseLexicon)
+            continue;
+        if (!data->graph->importBaseGraph(base)) {
+            unloadLexicon(it.key());
+            emit lexiconUnloaded(it.key(), "Lexicon " + baseLexicon +
+                                 " was reloaded in a form that cannot be "
+                                 "used as a base lexicon, so lexicon " +
+                                 it.key() + " has been unloaded.");
+            continue;
+        }
+        graphChanged(it.key());
+        clearCompletionIndexes(it.key());
+        buildAlphabet(it.key());
+        clearCache(it.key());
+    }
+}
+
+//---------------------------------------------------------------------------
+//  shareLexiconGraphs
+//
+//! Replace the word graphs of several loaded lexicons with views of a single
+//! graph holding the words of all of them.  Related lexicons share most of
+//! their words, so this uses little more memory than the largest of the
+//! graphs alone.  The words of each lexicon are unchanged.
+//
+//! @param lexicons the names of the lexicons, at most eight
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordEngine::shareLexiconGraphs(const QStringList& lexicons, QString*
+                               errString)
+{
+    if (lexicons.count() < 2) {
+        if (errString)
+            *errString = "At least two lexicons are needed to share a word "
+                "graph.";
+        return false;
+    }
+
+    SearchCondition condition;
+    condition.type = SearchCondition::Length;
+    condition.minValue = 1;
+    condition.maxValue = MAX_WORD_LEN;
+    SearchSpec spec;
+    spec.conditions.append(condition);
+
+    QList<QStringList> lexiconWords;
+    foreach (const QString& lexicon, lexicons) {
+        if (!lexiconIsLoaded(lexicon)) {
+            if (errString)
+                *errString = "Lexicon " + lexicon + " is not loaded.";
+            return false;
+        }
+        lexiconWords.append(lexiconData[lexicon]->graph->search(spec));
+    }
+
+    SharedWordGraph* shared = new SharedWordGraph;
+    if (!shared->build(lexicons, lexiconWords, errString)) {
+        delete shared;
+        return false;
+    }
+    lexiconWords.clear();
+
+    foreach (const QString& lexicon, lexicons) {
+        LexiconData* data = lexiconData[lexicon];
+        WordGraph* graph = new WordGraph;
+        graph->importSharedGraph(shared, lexicon);
+        delete data->graph;
+        data->graph = graph;
+        data->baseLexicon = QString();
+        graphChanged(lexicon);
+
+        SharedWordGraph* oldShared = data->sharedGraph;
+        data->sharedGraph = shared;
+        releaseSharedGraph(oldShared);
+    }
+
+    foreach (const QString& lexicon, lexicons)
+        rebaseOverlays(lexicon);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  unshareLexiconGraph
+//
+//! Detach a lexicon from the graph it shares with other lexicons, leaving it
+//! with an empty graph.  The shared graph is deleted once no lexicon uses
+//! it.
+//
+//! @param lexicon the name of the lexicon
+//---------------------------------------------------------------------------
+void
+WordEngine::unshareLexiconGraph(const QString& lexicon)
+{
+    if (!lexiconData.contains(lexicon) || !lexiconData[lexicon]->sharedGraph)
+        return;
+
+    LexiconData* data = lexiconData[lexicon];
+    SharedWordGraph* shared = data->sharedGraph;
+    delete data->graph;
+    data->graph = new WordGraph;
+    data->sharedGraph = 0;
+    graphChanged(lexicon);
+    releaseSharedGraph(shared);
+}
+
+//---------------------------------------------------------------------------
+//  unloadLexicon
+//
+//! Unload a lexicon, disconnecting its database and freeing its word graph.
+//! Overlay lexicons built on it are unloaded too, and lexiconUnloaded is
+//! emitted for each of them.
+//
+//! @param lexicon the name of the lexicon
+//---------------------------------------------------------------------------
+void
+WordEngine::unloadLexicon(const QString& lexicon)
+{
+    if (!lexiconData.contains(lexicon))
+        return;
+
+    disconnectFromDatabase(lexicon);
+    unshareLexiconGraph(lexicon);
+    LexiconData* data = lexiconData.take(lexicon);
+    delete data->graph;
+    delete data->bundle;
+    delete data;
+
+    QStringList overlays;
+    QMapIterator<QString, LexiconData*> it (lexiconData);
+    while (it.hasNext()) {
+        it.next();
+        if (it.value()->baseLexicon == lexicon)
+            overlays.append(it.key());
+    }
+
+    foreach (const QString& overlay, overlays) {
+        unloadLexicon(overlay);
+        emit lexiconUnloaded(overlay, "Lexicon " + lexicon + " was "
+                             "unloaded, so lexicon " + overlay + ", which "
+                             "is built on it, has been unloaded.");
+    }
+}
+
+//---------------------------------------------------------------------------
+//  graphChanged
+//
+//! Give a lexicon a new graph generation after its word graph has been
+//! replaced or reloaded.  Generations are never reused, even across
+//! lexicons, so a stale cursor cannot be mistaken for a current one.
+//
+//! @param lexicon the name of the lexicon
+//---------------------------------------------------------------------------
+void
+WordEngine::graphChanged(const QString& lexicon)
+{
+    if (!lexiconData.contains(lexicon))
+        return;
+
+    lexiconData[lexicon]->graphGeneration = ++lastGraphGeneration;
+}
+
+//---------------------------------------------------------------------------
+//  releaseSharedGraph
+//
+//! Delete a shared graph if no lexicon uses it any longer.
+//
+//! @param shared the shared graph
+//---------------------------------------------------------------------------
+void
+WordEngine::releaseSharedGraph(SharedWordGraph* shared)
+{
+    if (!shared)
+        return;
+
+    foreach (const LexiconData* data, lexiconData) {
+        if (data->sharedGraph == shared)
+            return;
+    }
+    delete shared;
+}
+
+//---------------------------------------------------------------------------
+//  getSharedMembership
+//
+//! Determine which of the lexicons sharing a word graph with a lexicon
+//! contain a word, with a single traversal of the shared graph.
+//
+//! @param lexicon the name of the lexicon
+//! @param word the word
+//! @return a map from the name of each lexicon sharing the graph, including
+//! this one, to whether it contains the word, or an empty map if the
+//! lexicon does not share its graph
+//---------------------------------------------------------------------------
+QMap<QString, bool>
+WordEngine::getSharedMembership(const QString& lexicon, const QString& word)
+    const
+{
+    QMap<QString, bool> membership;
+    if (!lexiconData.contains(lexicon) || !lexiconData[lexicon]->sharedGraph)
+        return membership;
+
+    const SharedWordGraph* shared = lexiconData[lexicon]->sharedGraph;
+    quint8 mask = shared->getMembership(word.toUpper());
+    QStringList lexicons = shared->getLexicons();
+    for (int i = 0; i < lexicons.count(); ++i)
+        membership.insert(lexicons[i], (mask & (1 << i)) != 0);
+    return membership;
+}
+
+//---------------------------------------------------------------------------
+//  importCompiledTextFile
+//
+//! Import words from a text file by way of a compiled bundle cached in the
+//! user data directory.  The bundle is keyed by a hash of the file contents,
+//! so an unchanged file is loaded by mapping the bundle, and an edited file
+//! is compiled again.  If the bundle cannot be written or opened, the text
+//! file is imported directly.
+//
+//! @param lexicon the name of the lexicon
+//! @param filename the name of the text file
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordEngine::importCompiledTextFile(const QString& lexicon, const QString&
+                                   filename, QString* errString)
+{
+    QString hash = Auxil::getFileContentHash(filename);
+    if (hash.isEmpty()) {
+        if (errString)
+            *errString = "Can't read file '" + filename + "'.";
+        return false;
+    }
+
+    QString bundleFilename = Auxil::getCompiledLexiconFilename(lexicon, hash);
+    if (!QFile::exists(bundleFilename)) {
+        QStringList words;
+        QStringList wordDefinitions;
+        if (!readWordListFile(filename, &words, &wordDefinitions, errString))
+            return false;
+
+        QMap<QString, QString> definitions;
+        for (int i = 0; i < words.count(); ++i) {
+            if (!wordDefinitions[i].isEmpty())
+                definitions[words[i]] = wordDefinitions[i];
+        }
+
+        // Remove bundles compiled from earlier contents of the file
+        QFileInfo bundleInfo (bundleFilename);
+        QDir dir (bundleInfo.path());
+        QStringList stale = dir.entryList(QStringList(lexicon + "-*.zlx"),
+                                          QDir::Files);
+        foreach (const QString& staleFile, stale)
+            dir.remove(staleFile);
+
+        // Write to a temporary file first, so an interrupted write never
+        // leaves a truncated bundle under the final name
+        QString tmpFilename = bundleFilename + ".tmp";
+        QFile::remove(tmpFilename);
+        if (!LexiconBundle::write(tmpFilename, words, definitions,
+                                  QMap<QString, qint64>(),
+                                  QMap<int, QStringList>()) ||
+            !QFile::rename(tmpFilename, bundleFilename))
+        {
+            QFile::remove(tmpFilename);
+            return (importTextFile(lexicon, filename, true, errString) > 0);
+        }
+    }
+
+    if (!importLexiconBundle(lexicon, bundleFilename)) {
+        QFile::remove(bundleFilename);
+        return (importTextFile(lexicon, filename, true, errString) > 0);
+    }
+
+    LexiconData* data = lexiconData[lexicon];
+    data->lexiconFile = filename;
+    data->lexiconHash = hash;
+    return true;
+}
+
 //---------------------------------------------------------------------------
 //  databaseSearch
 //
@@ -313,9 +874,353 @@ WordEngine::databaseSearch(const QString& lexicon, const SearchSpec&
         return QStringList();
 
     // Build SQL query string
-    QSet<QString> tables;
+    QString whereStr = getDatabaseConditionString(lexicon, optimizedSpec);
+
+    // Make sure results are in the provided word list
+    QMap<QString, QString> upperToLower;
+    if (wordList) {
+        whereStr += " AND words.word IN (";
+        QStringListIterator it (*wordList);
+        bool firstWord = true;
+        while (it.hasNext()) {
+            QString word = it.next();
+            QString wordUpper = word.toUpper();
+            upperToLower[wordUpper] = word;
+            if (!firstWord)
+                whereStr += ",";
+            firstWord = false;
+            whereStr += "'" + wordUpper + "'";
+        }
+        whereStr += ")";
+    }
+
+    QString queryStr = "SELECT words.word FROM words WHERE" + whereStr;
+
+    //qDebug("Query str: |%s|", queryStr.toUtf8().constData());
+
+    // Query the database
+    QStringList resultList;
+    QSqlDatabase* db = lexiconData[lexicon]->db;
+    QSqlQuery query (queryStr, *db);
+    while (query.next()) {
+        QString word = query.value(0).toString();
+        if (!upperToLower.isEmpty() && upperToLower.contains(word)) {
+            word = upperToLower[word];
+        }
+        resultList.append(word);
+    }
+
+    return resultList;
+}
+
+//---------------------------------------------------------------------------
+//  databaseCount
+//
+//! Count the words in the database matching the conditions in a search spec.
+//
+//! @param lexicon the name of the lexicon
+//! @param optimizedSpec the search spec
+//! @return the number of matching words
+//---------------------------------------------------------------------------
+int
+WordEngine::databaseCount(const QString& lexicon, const SearchSpec&
+                          optimizedSpec) const
+{
+    if (!lexiconData.contains(lexicon) || !lexiconData[lexicon]->db)
+        return 0;
+
+    QString queryStr = "SELECT count(*) FROM words WHERE" +
+        getDatabaseConditionString(lexicon, optimizedSpec);
+
+    QSqlDatabase* db = lexiconData[lexicon]->db;
+    QSqlQuery query (queryStr, *db);
+    if (query.next())
+        return query.value(0).toInt();
+    return 0;
+}
+
+//---------------------------------------------------------------------------
+//  databaseAggregate
+//
+//! Summarize the words in the database matching the conditions in a search
+//! spec, letting the database do the grouping.
+//
+//! @param lexicon the name of the lexicon
+//! @param optimizedSpec the search spec
+//! @param aggregate the attributes to group by and summarize
+//! @return the groups, ordered by their keys
+//---------------------------------------------------------------------------
+QList<WordEngine::AggregateRow>
+WordEngine::databaseAggregate(const QString& lexicon, const SearchSpec&
+                              optimizedSpec, const AggregateSpec& aggregate)
+    const
+{
+    QList<AggregateRow> rows;
+    if (!lexiconData.contains(lexicon) || !lexiconData[lexicon]->db)
+        return rows;
+
+    QList<AggregateAttribute> groupAttributes;
+    groupAttributes.append(aggregate.firstGroup);
+    if (aggregate.secondGroup != NoAttribute)
+        groupAttributes.append(aggregate.secondGroup);
+
+    QStringList groupColumns;
+    foreach (AggregateAttribute attribute, groupAttributes) {
+        QString column = getAttributeColumn(attribute, aggregate.numBlanks);
+        if ((aggregate.bandSize > 1) && isBandedAttribute(attribute)) {
+            QString band = QString::number(aggregate.bandSize);
+            column = "((" + column + " - 1) / " + band + ") * " + band +
+                " + 1";
+        }
+        groupColumns.append(column);
+    }
+
+    QString valueColumn = (aggregate.valueAttribute == NoAttribute) ? "0" :
+        getAttributeColumn(aggregate.valueAttribute, aggregate.numBlanks);
+    QString groupStr = (groupColumns.size() == 1) ? "1" : "1, 2";
+
+    QString queryStr = "SELECT " + groupColumns.join(", ") + ", count(*), "
+        "min(" + valueColumn + "), max(" + valueColumn + ") FROM words "
+        "WHERE" + getDatabaseConditionString(lexicon, optimizedSpec) +
+        " GROUP BY " + groupStr + " ORDER BY " + groupStr;
+
+    // Letters come back as text and are keyed by their code
+    QList<AggregateAttribute> columnAttributes = groupAttributes;
+    columnAttributes << NoAttribute << aggregate.valueAttribute
+                     << aggregate.valueAttribute;
+
+    QSqlDatabase* db = lexiconData[lexicon]->db;
+    QSqlQuery query (queryStr, *db);
+    while (query.next()) {
+        QList<qint64> values;
+        for (int i = 0; i < columnAttributes.size(); ++i) {
+            AggregateAttribute attribute = columnAttributes[i];
+            QVariant value = query.value(i);
+            if ((attribute == FirstLetterAttribute) ||
+                (attribute == LastLetterAttribute))
+            {
+                QString letter = value.toString().toUpper();
+                values.append(letter.isEmpty() ? 0 : letter.at(0).unicode());
+            }
+            else
+                values.append(value.toLongLong());
+        }
+
+        AggregateRow row;
+        int column = 0;
+        row.firstKey = values[column++];
+        if (groupAttributes.size() > 1)
+            row.secondKey = values[column++];
+        row.count = int(values[column++]);
+        row.minValue = values[column++];
+        row.maxValue = values[column++];
+        rows.append(row);
+    }
+    return rows;
+}
+
+//---------------------------------------------------------------------------
+//  getAttributeValue
+//
+//! Get the value of a word attribute for aggregation.  Letters are given by
+//! their character code.
+//
+//! @param lexicon the name of the lexicon
+//! @param word the word, in upper case
+//! @param attribute the attribute
+//! @param numBlanks the number of blanks for probability order
+//! @return the value, or zero if there is no attribute
+//---------------------------------------------------------------------------
+qint64
+WordEngine::getAttributeValue(const QString& lexicon, const QString& word,
+                              AggregateAttribute attribute, int numBlanks)
+    const
+{
+    switch (attribute) {
+        case LengthAttribute:
+        return word.length();
+
+        case NumVowelsAttribute:
+        return getNumVowels(lexicon, word);
+
+        case NumUniqueLettersAttribute:
+        return getNumUniqueLetters(lexicon, word);
+
+        case PointValueAttribute:
+        return getPointValue(lexicon, word);
+
+        case NumAnagramsAttribute:
+        return getNumAnagrams(lexicon, word);
+
+        case FirstLetterAttribute:
+        return word.isEmpty() ? 0 : word.at(0).unicode();
+
+        case LastLetterAttribute:
+        return word.isEmpty() ? 0 : word.at(word.length() - 1).unicode();
+
+        case ProbabilityOrderAttribute:
+        return getProbabilityOrder(lexicon, word, numBlanks);
+
+        case PlayabilityOrderAttribute:
+        return getPlayabilityOrder(lexicon, word);
+
+        default:
+        return 0;
+    }
+}
+
+//---------------------------------------------------------------------------
+//  getAttributeValues
+//
+//! Get the values of a word attribute for a list of words.  Attributes
+//! stored in the lexicon database are looked up in batches, without going
+//! through the word info cache.
+//
+//! @param lexicon the name of the lexicon
+//! @param words the words, in upper case
+//! @param attribute the attribute
+//! @param numBlanks the number of blanks for probability order
+//! @return the values, in the same order as the words
+//---------------------------------------------------------------------------
+QList<qint64>
+WordEngine::getAttributeValues(const QString& lexicon, const QStringList&
+                               words, AggregateAttribute attribute, int
+                               numBlanks) const
+{
+    QList<qint64> values;
+
+    if (((attribute == NumAnagramsAttribute) ||
+         (attribute == ProbabilityOrderAttribute) ||
+         (attribute == PlayabilityOrderAttribute)) &&
+        databaseIsConnected(lexicon))
+    {
+        QHash<QString, qint64> wordValues = getDatabaseValues(lexicon, words,
+            getAttributeColumn(attribute, numBlanks));
+        foreach (const QString& word, words)
+            values.append(wordValues.value(word));
+        return values;
+    }
+
+    foreach (const QString& word, words)
+        values.append(getAttributeValue(lexicon, word, attribute, numBlanks));
+    return values;
+}
+
+//---------------------------------------------------------------------------
+//  getAttributeColumn
+//
+//! Get the SQL expression for a word attribute in the words table of a
+//! lexicon database.
+//
+//! @param attribute the attribute
+//! @param numBlanks the number of blanks for probability order
+//! @return the SQL expression
+//---------------------------------------------------------------------------
+QString
+WordEngine::getAttributeColumn(AggregateAttribute attribute, int numBlanks)
+{
+    switch (attribute) {
+        case LengthAttribute: return "length";
+        case NumVowelsAttribute: return "num_vowels";
+        case NumUniqueLettersAttribute: return "num_unique_letters";
+        case PointValueAttribute: return "point_value";
+        case NumAnagramsAttribute: return "num_anagrams";
+        case FirstLetterAttribute: return "substr(word, 1, 1)";
+        case LastLetterAttribute: return "substr(word, length(word), 1)";
+        case ProbabilityOrderAttribute:
+        return "probability_order" +
+            QString::number(qBound(0, numBlanks, MAX_BLANKS));
+        case PlayabilityOrderAttribute: return "playability_order";
+        default: return "0";
+    }
+}
+
+//---------------------------------------------------------------------------
+//  isBandedAttribute
+//
+//! Determine whether an attribute is grouped into bands of values rather
+//! than by single values.
+//
+//! @param attribute the attribute
+//! @return true if the attribute is banded, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordEngine::isBandedAttribute(AggregateAttribute attribute)
+{
+    return (attribute == ProbabilityOrderAttribute) ||
+           (attribute == PlayabilityOrderAttribute);
+}
+
+//---------------------------------------------------------------------------
+//  getDatabaseCondition
+//
+//! Translate a search spec into an SQL condition on the words table of the
+//! lexicon database, so other databases can attach the lexicon database and
+//! select words in the same query.  This is only possible if every condition
+//! in the spec can be evaluated by the database.
+//
+//! @param lexicon the name of the lexicon
+//! @param spec the search spec
+//! @param condition return the SQL condition, referring to the words table
+//! as "words"
+//! @return true if successful, false if the spec cannot be evaluated by the
+//! database alone
+//---------------------------------------------------------------------------
+bool
+WordEngine::getDatabaseCondition(const QString& lexicon, const SearchSpec&
+                                 spec, QString* condition) const
+{
+    if (!databaseIsConnected(lexicon) || spec.conditions.isEmpty())
+        return false;
+
+    SearchSpec optimizedSpec = spec;
+    optimizedSpec.optimize(lexicon);
+
+    foreach (const SearchCondition& searchCondition, optimizedSpec.conditions) {
+        if (getConditionPhase(searchCondition) != DatabasePhase)
+            return false;
+    }
+
+    if (condition)
+        *condition = getDatabaseConditionString(lexicon, optimizedSpec);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  getDatabaseFilename
+//
+//! Return the file name of the database connected to a lexicon.
+//
+//! @param lexicon the name of the lexicon
+//! @return the database file name, or an empty string if no database is
+//! connected
+//---------------------------------------------------------------------------
+QString
+WordEngine::getDatabaseFilename(const QString& lexicon) const
+{
+    if (!databaseIsConnected(lexicon))
+        return QString();
+
+    return lexiconData[lexicon]->db->databaseName();
+}
+
+//---------------------------------------------------------------------------
+//  getDatabaseConditionString
+//
+//! Build the SQL condition matching the database conditions in a search
+//! spec.
+//
+//! @param lexicon the name of the lexicon
+//! @param optimizedSpec the search spec
+//! @return the SQL condition
+//---------------------------------------------------------------------------
+QString
+WordEngine::getDatabaseConditionString(const QString& lexicon, const
+                                       SearchSpec& optimizedSpec) const
+{
     QString whereStr;
     bool foundCondition = false;
+    int numDefinitionConditions = 0;
     QListIterator<SearchCondition> cit (optimizedSpec.conditions);
     while (cit.hasNext()) {
         SearchCondition condition = cit.next();
@@ -329,7 +1234,6 @@ WordEngine::databaseSearch(const QString& lexicon, const SearchSpec&
 
         switch (condition.type) {
             case SearchCondition::PatternMatch: {
-                tables.insert("words");
                 QString str =
                     condition.stringValue.replace("?", "_").replace("*", "%");
                 whereStr += " words.word";
@@ -339,9 +1243,7 @@ WordEngine::databaseSearch(const QString& lexicon, const SearchSpec&
             }
             break;
 
-            case SearchCondition::PartOfSpeech:
-            case SearchCondition::Definition: {
-                tables.insert("words");
+            case SearchCondition::PartOfSpeech: {
 
                 // Escape % and _ characters when preceded by an even number
                 // of backslashes
@@ -361,23 +1263,28 @@ WordEngine::databaseSearch(const QString& lexicon, const SearchSpec&
                     notStr = " NOT";
                 }
 
-                QString whereSecondStr;
-                if (condition.type == SearchCondition::PartOfSpeech) {
-                    whereSecondStr = conjStr +
-                        " words.definition" + notStr +
-                        " LIKE '\%[" + str + "]\%' ESCAPE '\\'";
-                    str = "[" + str + " ";
-                }
-
                 whereStr +=
                     " words.definition" + notStr +
-                    " LIKE '\%" + str + "\%' ESCAPE '\\'" + whereSecondStr;
+                    " LIKE '\%[" + str + " \%' ESCAPE '\\'" + conjStr +
+                    " words.definition" + notStr +
+                    " LIKE '\%[" + str + "]\%' ESCAPE '\\'";
+            }
+            break;
+
+            // Definitions are stored with links intact, so the words whose
+            // definitions match once links are replaced are found first
+            case SearchCondition::Definition: {
+                QString matchStr = getDefinitionMatchQuery(lexicon,
+                    condition.stringValue, numDefinitionConditions++);
+                whereStr += " words.word";
+                if (condition.negated)
+                    whereStr += " NOT";
+                whereStr += " IN (" + matchStr + ")";
             }
             break;
 
             case SearchCondition::ProbabilityOrder:
             case SearchCondition::PlayabilityOrder: {
-                tables.insert("words");
                 QString col;
                 if (condition.type == SearchCondition::ProbabilityOrder) {
                     col = QString("probability_order%1").arg(
@@ -415,7 +1322,6 @@ WordEngine::databaseSearch(const QString& lexicon, const SearchSpec&
             case SearchCondition::NumUniqueLetters:
             case SearchCondition::PointValue:
             case SearchCondition::NumAnagrams: {
-                tables.insert("words");
                 QString column;
                 if (condition.type == SearchCondition::Length)
                     column = "words.length";
@@ -441,7 +1347,6 @@ WordEngine::databaseSearch(const QString& lexicon, const SearchSpec&
             break;
 
             case SearchCondition::IncludeLetters: {
-                tables.insert("words");
                 QString str = condition.stringValue;
                 QMap<QChar, int> letters;
                 for (int i = 0; i < str.length(); ++i) {
@@ -454,7 +1359,7 @@ WordEngine::databaseSearch(const QString& lexicon, const SearchSpec&
                     QChar c = it.key();
                     if (i)
                         whereStr += " AND";
-                    whereStr += " word";
+                    whereStr += " words.word";
                     if (condition.negated)
                         whereStr += " NOT";
                     whereStr += " LIKE '%";
@@ -468,7 +1373,6 @@ WordEngine::databaseSearch(const QString& lexicon, const SearchSpec&
             break;
 
             case SearchCondition::BelongToGroup: {
-                tables.insert("words");
                 SearchSet searchSet =
                     Auxil::stringToSearchSet(condition.stringValue);
                 int target = condition.negated ? 0 : 1;
@@ -501,7 +1405,6 @@ WordEngine::databaseSearch(const QString& lexicon, const SearchSpec&
             break;
 
             case SearchCondition::InWordList: {
-                tables.insert("words");
                 whereStr += " words.word";
                 if (condition.negated)
                     whereStr += " NOT";
@@ -527,50 +1430,131 @@ WordEngine::databaseSearch(const QString& lexicon, const SearchSpec&
         whereStr += ")";
     }
 
-    // Make sure results are in the provided word list
-    QMap<QString, QString> upperToLower;
-    if (wordList) {
-        tables.insert("words");
-        whereStr += " AND words.word IN (";
-        QStringListIterator it (*wordList);
-        bool firstWord = true;
-        while (it.hasNext()) {
-            QString word = it.next();
-            QString wordUpper = word.toUpper();
-            upperToLower[wordUpper] = word;
-            if (!firstWord)
-                whereStr += ",";
-            firstWord = false;
-            whereStr += "'" + wordUpper + "'";
-        }
-        whereStr += ")";
+    return whereStr;
+}
+
+//---------------------------------------------------------------------------
+//  getDefinitionMatchQuery
+//
+//! Build an SQL query for the words whose definitions contain a string once
+//! their links are replaced, as they would be displayed.  Words whose stored
+//! definitions contain the string match directly.  Words that can only
+//! match through their links are checked with their links replaced, each
+//! part of speech separately and without its part of speech and inflection
+//! markup, and the ones that match are stored in a temporary table.
+//
+//! @param lexicon the name of the lexicon
+//! @param text the string to find
+//! @param tableNum the number of the temporary table to use, distinct for
+//! each definition condition in a query
+//! @return the query, selecting a single word column
+//---------------------------------------------------------------------------
+QString
+WordEngine::getDefinitionMatchQuery(const QString& lexicon, const QString&
+                                    text, int tableNum) const
+{
+    if (!databaseIsConnected(lexicon))
+        return QString();
+
+    QSqlDatabase* db = lexiconData[lexicon]->db;
+
+    QString str = text;
+    str.replace("\\", "\\\\");
+    str.replace("%", "\\%");
+    str.replace("_", "\\_");
+    str.replace("'", "''");
+
+    // Linked definitions can only add text to a definition up to the
+    // maximum link depth
+    QString directStr = "SELECT word FROM words WHERE definition LIKE '%" +
+        str + "%' ESCAPE '\\'";
+    QString linkedStr = directStr;
+    for (int i = 0; i < MAX_DEFINITION_LINKS; ++i) {
+        linkedStr = directStr + " UNION SELECT word FROM definition_links "
+            "WHERE link IN (" + linkedStr + ")";
     }
 
-    QStringList tablesList = tables.toList();
-    QString tableStr = " " + tablesList.join(", ");
-    QString selectColStr = "word";
-    if (tables.contains("words")) {
-        selectColStr = " words.word";
+    QSqlQuery query (*db);
+    query.prepare("SELECT word, definition FROM words WHERE word IN (" +
+                  linkedStr + ") AND word NOT IN (" + directStr + ")");
+    query.exec();
+
+    QMap<QString, QString> candidates;
+    while (query.next()) {
+        candidates.insert(query.value(0).toString(),
+                          query.value(1).toString());
     }
 
-    QString queryStr = "SELECT" + selectColStr + " FROM" + tableStr +
-        " WHERE" + whereStr;
+    // Fetch the definitions of linked words one link level at a time, so
+    // replacing the links of the candidates finds them in the cache
+    QSet<QString> fetched;
+    QStringList linkWords = candidates.keys();
+    for (int depth = 0; (depth < MAX_DEFINITION_LINKS) &&
+             !linkWords.isEmpty(); ++depth)
+    {
+        QStringList targets;
+        for (int start = 0; start < linkWords.size();
+             start += MAX_QUERY_WORDS)
+        {
+            QString qstr = "SELECT link FROM definition_links WHERE "
+                "word IN (";
+            int end = qMin(start + MAX_QUERY_WORDS, linkWords.size());
+            for (int i = start; i < end; ++i) {
+                if (i > start)
+                    qstr += ", ";
+                qstr += "'" + linkWords[i] + "'";
+            }
+            qstr += ")";
+
+            query.prepare(qstr);
+            query.exec();
+            while (query.next()) {
+                QString link = query.value(0).toString();
+                if (!fetched.contains(link)) {
+                    fetched.insert(link);
+                    targets.append(link);
+                }
+            }
+        }
 
-    //qDebug("Query str: |%s|", queryStr.toUtf8().constData());
+        for (int start = 0; start < targets.size(); start += MAX_QUERY_WORDS)
+            addToCache(lexicon, targets.mid(start, MAX_QUERY_WORDS));
+        linkWords = targets;
+    }
 
-    // Query the database
-    QStringList resultList;
-    QSqlDatabase* db = lexiconData[lexicon]->db;
-    QSqlQuery query (queryStr, *db);
-    while (query.next()) {
-        QString word = query.value(0).toString();
-        if (!upperToLower.isEmpty() && upperToLower.contains(word)) {
-            word = upperToLower[word];
+    QStringList words;
+    QSet<QString> alreadyReplaced;
+    QMapIterator<QString, QString> it (candidates);
+    while (it.hasNext()) {
+        it.next();
+        const QString& word = it.key();
+        QStringList defs = it.value().split(DEF_ORIG_SEP);
+        foreach (const QString& def, defs) {
+            QString subdef = def.left(def.indexOf("["));
+            alreadyReplaced.clear();
+            alreadyReplaced.insert(word);
+            subdef = replaceDefinitionLinks(lexicon, subdef,
+                MAX_DEFINITION_LINKS, &alreadyReplaced);
+            if (subdef.contains(text, Qt::CaseInsensitive)) {
+                words.append(word);
+                break;
+            }
         }
-        resultList.append(word);
     }
 
-    return resultList;
+    QString tableName = QString("definition_matches%1").arg(tableNum);
+    query.exec("DROP TABLE IF EXISTS temp." + tableName);
+    query.exec("CREATE TEMP TABLE " + tableName + " (word text)");
+
+    QSqlQuery transactionQuery ("BEGIN TRANSACTION", *db);
+    query.prepare("INSERT INTO temp." + tableName + " (word) VALUES (?)");
+    foreach (const QString& word, words) {
+        query.bindValue(0, word);
+        query.exec();
+    }
+    transactionQuery.exec("END TRANSACTION");
+
+    return directStr + " UNION SELECT word FROM temp." + tableName;
 }
 
 //---------------------------------------------------------------------------
@@ -817,6 +1801,74 @@ WordEngine::isAcceptable(const QString& lexicon, const QString& word) const
     return lexiconData[lexicon]->graph->containsWord(word);
 }
 
+//---------------------------------------------------------------------------
+//  getWordCursor
+//
+//! Return a cursor for walking the word graph of a lexicon one letter at a
+//! time.  The cursor is only valid until the graph of the lexicon changes,
+//! so callers keeping a cursor should compare its generation with that of a
+//! freshly returned cursor before reusing it.
+//
+//! @param lexicon the name of the lexicon
+//! @return the cursor, positioned at the empty prefix
+//---------------------------------------------------------------------------
+WordGraph::Cursor
+WordEngine::getWordCursor(const QString& lexicon) const
+{
+    if (!lexiconData.contains(lexicon))
+        return WordGraph::Cursor();
+
+    const LexiconData* data = lexiconData[lexicon];
+    return WordGraph::Cursor(data->graph, data->graphGeneration);
+}
+
+//---------------------------------------------------------------------------
+//  getAlphabet
+//
+//! Return the alphabet of a lexicon: the letters of the letter distribution
+//! and every letter used in the lexicon, with their properties.  The
+//! alphabet is built when the lexicon is loaded.
+//
+//! @param lexicon the name of the lexicon
+//! @return the alphabet
+//---------------------------------------------------------------------------
+const Alphabet&
+WordEngine::getAlphabet(const QString& lexicon) const
+{
+    static const Alphabet defaultAlphabet;
+    if (!lexiconData.contains(lexicon))
+        return defaultAlphabet;
+
+    return lexiconData[lexicon]->alphabet;
+}
+
+//---------------------------------------------------------------------------
+//  getCompletions
+//
+//! Find the best acceptable words beginning with a prefix, for completing
+//! a word as it is typed.  The completion index for the ranking is built
+//! the first time it is needed, after which each lookup takes time
+//! proportional to the number of completions, not the number of words
+//! beginning with the prefix.
+//
+//! @param lexicon the name of the lexicon
+//! @param prefix the prefix
+//! @param maxCompletions the maximum number of words to return
+//! @param ranking how to rank the words: by playability, by probability,
+//! or alphabetically if uniform
+//! @return the words in order of rank, in upper case
+//---------------------------------------------------------------------------
+QStringList
+WordEngine::getCompletions(const QString& lexicon, const QString& prefix,
+                           int maxCompletions, SampleWeight ranking) const
+{
+    if (!lexiconData.contains(lexicon) || !lexiconData[lexicon]->graph)
+        return QStringList();
+
+    return getCompletionIndex(lexicon, ranking).complete(prefix,
+                                                         maxCompletions);
+}
+
 //---------------------------------------------------------------------------
 //  search
 //
@@ -834,6 +1886,225 @@ WordEngine::search(const QString& lexicon, const SearchSpec& spec, bool
     if (!lexiconData.contains(lexicon))
         return QStringList();
 
+    QStringList resultList = getMatchingWords(lexicon, spec);
+
+    // Convert to all caps if necessary
+    if (allCaps) {
+        QStringList::iterator it;
+        for (it = resultList.begin(); it != resultList.end(); ++it)
+            *it = (*it).toUpper();
+    }
+
+    if (!resultList.isEmpty()) {
+        clearCache(lexicon);
+        addToCache(lexicon, resultList);
+    }
+
+    return resultList;
+}
+
+//---------------------------------------------------------------------------
+//  countSearch
+//
+//! Count the acceptable words matching a search specification without
+//! building the list of words when possible.  Specs that the word graph can
+//! evaluate alone are counted from the graph, and specs that the database
+//! can evaluate alone are counted by the database.  Other specs fall back to
+//! a full search.  Nothing is cached.
+//
+//! @param lexicon the name of the lexicon
+//! @param spec the search specification
+//! @return the number of matching words
+//---------------------------------------------------------------------------
+int
+WordEngine::countSearch(const QString& lexicon, const SearchSpec& spec) const
+{
+    if (!lexiconData.contains(lexicon) || spec.conditions.isEmpty())
+        return 0;
+
+    // The number of anagrams of a set of letters plus a blank, such as the
+    // productivity of a stem, is kept in the anagram hook index
+    if (spec.conditions.count() == 1) {
+        const SearchCondition& condition = spec.conditions.first();
+        if ((condition.type == SearchCondition::AnagramMatch) &&
+            !condition.negated && (condition.stringValue.count('?') == 1))
+        {
+            QString letters = condition.stringValue.toUpper();
+            letters.remove('?');
+            bool indexed = false;
+            int numWords = 0;
+            if (QRegExp("[A-Z]+").exactMatch(letters))
+                numWords = getNumAnagramHooks(lexicon, letters, &indexed);
+            if (indexed)
+                return numWords;
+        }
+    }
+
+    SearchSpec optimizedSpec = spec;
+    optimizedSpec.optimize(lexicon);
+
+    bool graphOnly = true;
+    bool databaseOnly = true;
+    QListIterator<SearchCondition> cit (optimizedSpec.conditions);
+    while (cit.hasNext()) {
+        const SearchCondition& condition = cit.next();
+        ConditionPhase phase = getConditionPhase(condition);
+        if ((phase != WordGraphPhase) &&
+            (condition.type != SearchCondition::Length))
+        {
+            graphOnly = false;
+        }
+        if (phase != DatabasePhase)
+            databaseOnly = false;
+    }
+
+    if (graphOnly && lexiconData[lexicon]->graph)
+        return lexiconData[lexicon]->graph->countWords(optimizedSpec);
+
+    if (databaseOnly && databaseIsConnected(lexicon))
+        return databaseCount(lexicon, optimizedSpec);
+
+    return getMatchingWords(lexicon, spec).count();
+}
+
+//---------------------------------------------------------------------------
+//  aggregateSearch
+//
+//! Summarize the acceptable words matching a search specification by
+//! grouping them on one or two word attributes, and counting the words and
+//! finding the range of another attribute in each group.  Specs that the
+//! database can evaluate alone are summarized by the database without
+//! returning any words; other specs are summarized by scanning the matching
+//! words.
+//
+//! @param lexicon the name of the lexicon
+//! @param spec the search specification
+//! @param aggregate the attributes to group by and summarize
+//! @return the groups, ordered by their keys
+//---------------------------------------------------------------------------
+QList<WordEngine::AggregateRow>
+WordEngine::aggregateSearch(const QString& lexicon, const SearchSpec& spec,
+                            const AggregateSpec& aggregate) const
+{
+    if (!lexiconData.contains(lexicon) || spec.conditions.isEmpty() ||
+        (aggregate.firstGroup == NoAttribute))
+    {
+        return QList<AggregateRow>();
+    }
+
+    SearchSpec optimizedSpec = spec;
+    optimizedSpec.optimize(lexicon);
+
+    bool databaseOnly = true;
+    QListIterator<SearchCondition> cit (optimizedSpec.conditions);
+    while (cit.hasNext()) {
+        if (getConditionPhase(cit.next()) != DatabasePhase)
+            databaseOnly = false;
+    }
+
+    if (databaseOnly && databaseIsConnected(lexicon))
+        return databaseAggregate(lexicon, optimizedSpec, aggregate);
+
+    QStringList words = getMatchingWords(lexicon, spec);
+    for (int i = 0; i < words.size(); ++i)
+        words[i] = words[i].toUpper();
+
+    QList<qint64> firstKeys = getAttributeValues(lexicon, words,
+                                                 aggregate.firstGroup,
+                                                 aggregate.numBlanks);
+    QList<qint64> secondKeys = getAttributeValues(lexicon, words,
+                                                  aggregate.secondGroup,
+                                                  aggregate.numBlanks);
+    QList<qint64> values = getAttributeValues(lexicon, words,
+                                              aggregate.valueAttribute,
+                                              aggregate.numBlanks);
+
+    QMap<QPair<qint64, qint64>, AggregateRow> groups;
+    for (int i = 0; i < words.size(); ++i) {
+        AggregateRow key;
+        key.firstKey = firstKeys[i];
+        key.secondKey = secondKeys[i];
+        if ((aggregate.bandSize > 1) &&
+            isBandedAttribute(aggregate.firstGroup))
+        {
+            key.firstKey = ((key.firstKey - 1) / aggregate.bandSize) *
+                aggregate.bandSize + 1;
+        }
+        if ((aggregate.bandSize > 1) &&
+            isBandedAttribute(aggregate.secondGroup))
+        {
+            key.secondKey = ((key.secondKey - 1) / aggregate.bandSize) *
+                aggregate.bandSize + 1;
+        }
+
+        QPair<qint64, qint64> groupKey (key.firstKey, key.secondKey);
+        QMap<QPair<qint64, qint64>, AggregateRow>::iterator it =
+            groups.find(groupKey);
+        if (it == groups.end())
+            it = groups.insert(groupKey, key);
+
+        AggregateRow& row = it.value();
+        qint64 value = values[i];
+        if (!row.count || (value < row.minValue))
+            row.minValue = value;
+        if (!row.count || (value > row.maxValue))
+            row.maxValue = value;
+        ++row.count;
+    }
+
+    return groups.values();
+}
+
+//---------------------------------------------------------------------------
+//  attributeKeyToString
+//
+//! Format a group key or value returned by aggregateSearch for display.
+//
+//! @param attribute the attribute
+//! @param key the key or value
+//! @param bandSize the band size used for banded attributes, or 1 if the
+//! value is not banded
+//! @return the formatted key
+//---------------------------------------------------------------------------
+QString
+WordEngine::attributeKeyToString(AggregateAttribute attribute, qint64 key,
+                                 int bandSize)
+{
+    switch (attribute) {
+        case NoAttribute:
+        return QString();
+
+        case FirstLetterAttribute:
+        case LastLetterAttribute:
+        return QString(QChar(ushort(key)));
+
+        case ProbabilityOrderAttribute:
+        case PlayabilityOrderAttribute:
+        if (bandSize > 1) {
+            return QString::number(key) + "-" +
+                QString::number(key + bandSize - 1);
+        }
+        return QString::number(key);
+
+        default:
+        return QString::number(key);
+    }
+}
+
+//---------------------------------------------------------------------------
+//  getMatchingWords
+//
+//! Find the words matching a search specification by running each phase of
+//! the search as needed.  The words are not converted or cached.
+//
+//! @param lexicon the name of the lexicon
+//! @param spec the search specification
+//! @return a list of acceptable words
+//---------------------------------------------------------------------------
+QStringList
+WordEngine::getMatchingWords(const QString& lexicon, const SearchSpec& spec)
+    const
+{
     SearchSpec optimizedSpec = spec;
     optimizedSpec.optimize(lexicon);
 
@@ -880,38 +2151,373 @@ WordEngine::search(const QString& lexicon, const SearchSpec& spec, bool
         resultList = applyPostConditions(lexicon, optimizedSpec, resultList);
     }
 
-    // Convert to all caps if necessary
-    if (allCaps) {
-        QStringList::iterator it;
-        for (it = resultList.begin(); it != resultList.end(); ++it)
-            *it = (*it).toUpper();
+    return resultList;
+}
+
+//---------------------------------------------------------------------------
+//  sampleSearch
+//
+//! Search for acceptable words matching a search specification, and return
+//! only a random sample of them.  The sampling unit is either a single word,
+//! or a set of anagrams sharing an alphagram.  Units are drawn uniformly with
+//! reservoir sampling, or weighted by probability or playability with
+//! weighted reservoir sampling, so only the sampled words are ever cached or
+//! handed back.  The sample depends only on the matching words and the state
+//! of the random number generator, so a seeded generator reproduces it.
+//
+//! @param lexicon the name of the lexicon
+//! @param spec the search specification
+//! @param sampleSize the maximum number of units to sample
+//! @param weight how to weight the units
+//! @param numBlanks the number of blanks to use for probability weights
+//! @param groupAnagrams whether to sample sets of anagrams instead of words
+//! @param rng the random number generator
+//! @return an alphabetical list of the words in the sampled units, in all
+//! caps
+//---------------------------------------------------------------------------
+QStringList
+WordEngine::sampleSearch(const QString& lexicon, const SearchSpec& spec,
+                         int sampleSize, SampleWeight weight, int numBlanks,
+                         bool groupAnagrams, Rand* rng) const
+{
+    if (!lexiconData.contains(lexicon) || !rng || (sampleSize <= 0))
+        return QStringList();
+
+    QStringList words = getMatchingWords(lexicon, spec);
+
+    // Gather the units to sample from, keeping them in alphabetical order
+    // of their first words
+    QStringList units;
+    QHash<QString, QStringList> unitWords;
+    QStringList::iterator it;
+    for (it = words.begin(); it != words.end(); ++it) {
+        *it = (*it).toUpper();
+        if (!groupAnagrams)
+            continue;
+        QString alpha = Auxil::getAlphagram(*it);
+        QHash<QString, QStringList>::iterator found = unitWords.find(alpha);
+        if (found == unitWords.end()) {
+            units.append(alpha);
+            unitWords.insert(alpha, QStringList(*it));
+        }
+        else
+            found.value().append(*it);
+    }
+    if (!groupAnagrams)
+        units = words;
+
+    int numUnits = units.count();
+    QList<int> chosen;
+
+    if (numUnits <= sampleSize) {
+        for (int i = 0; i < numUnits; ++i)
+            chosen.append(i);
+    }
+
+    // Uniform sampling: keep a reservoir of the first units, and let each
+    // later unit replace a random member with decreasing probability
+    else if (weight == UniformWeight) {
+        for (int i = 0; i < sampleSize; ++i)
+            chosen.append(i);
+        for (int i = sampleSize; i < numUnits; ++i) {
+            int j = rng->rand(i);
+            if (j < sampleSize)
+                chosen[j] = i;
+        }
+        qSort(chosen);
+    }
+
+    // Weighted sampling: give each unit the key log(u) / weight for a
+    // uniform u, and keep the units with the largest keys.  Weights are
+    // combination counts or playability values, so every positive weight is
+    // at least one and every such key is above ZERO_WEIGHT_KEY; units with
+    // no weight are only chosen when too few others remain.
+    else {
+        const double ZERO_WEIGHT_KEY = -1.0e6;
+        LetterBag letterBag;
+
+        // Fetch playability values without caching them, since only the
+        // sampled words are cached
+        bool playabilityFromDatabase = (weight == PlayabilityWeight) &&
+            databaseIsConnected(lexicon);
+        QHash<QString, qint64> playabilityValues;
+        if (playabilityFromDatabase) {
+            playabilityValues =
+                getDatabaseValues(lexicon, words, "playability");
+        }
+
+        std::priority_queue<std::pair<double, int>,
+                            std::vector<std::pair<double, int> >,
+                            std::greater<std::pair<double, int> > > heap;
+        for (int i = 0; i < numUnits; ++i) {
+            const QString& unit = units[i];
+            double unitWeight = 0;
+            if (weight == ProbabilityWeight) {
+                unitWeight = letterBag.getNumCombinations(unit, numBlanks);
+            }
+            else {
+                QStringList playWords = groupAnagrams
+                    ? unitWords.value(unit) : QStringList(unit);
+                foreach (const QString& word, playWords) {
+                    qint64 value = playabilityFromDatabase
+                        ? playabilityValues.value(word)
+                        : getPlayabilityValue(lexicon, word);
+                    unitWeight = qMax(unitWeight, double(value));
+                }
+            }
+
+            double u = (rng->rand(16777214) + 1) / 16777216.0;
+            double key = (unitWeight > 0) ? (log(u) / unitWeight)
+                                          : (ZERO_WEIGHT_KEY + log(u));
+            if (int(heap.size()) < sampleSize)
+                heap.push(std::make_pair(key, i));
+            else if (key > heap.top().first) {
+                heap.pop();
+                heap.push(std::make_pair(key, i));
+            }
+        }
+
+        while (!heap.empty()) {
+            chosen.append(heap.top().second);
+            heap.pop();
+        }
+        qSort(chosen);
+    }
+
+    QStringList resultList;
+    foreach (int i, chosen) {
+        if (groupAnagrams)
+            resultList += unitWords.value(units[i]);
+        else
+            resultList.append(units[i]);
+    }
+    if (groupAnagrams)
+        resultList.sort();
+
+    if (!resultList.isEmpty()) {
+        clearCache(lexicon);
+        addToCache(lexicon, resultList);
+    }
+
+    return resultList;
+}
+
+//---------------------------------------------------------------------------
+//  refineSearch
+//
+//! Search for acceptable words matching a search specification, reusing the
+//! results of a previous search if the specification only adds conditions
+//! to the previous one.  Only the added conditions are evaluated, as filters
+//! over the previous results.  If the specification is not a refinement of
+//! the previous one, a full search is performed instead.
+//
+//! @param lexicon the name of the lexicon
+//! @param baseSpec the previous search specification
+//! @param baseResults the results of the previous search
+//! @param spec the search specification
+//! @param allCaps whether to ensure the words in the list are all caps
+//! @return a list of acceptable words
+//---------------------------------------------------------------------------
+QStringList
+WordEngine::refineSearch(const QString& lexicon, const SearchSpec& baseSpec,
+                         const QStringList& baseResults, const SearchSpec&
+                         spec, bool allCaps) const
+{
+    if (!lexiconData.contains(lexicon))
+        return QStringList();
+
+    QList<SearchCondition> addedConditions;
+    if (!spec.isRefinementOf(baseSpec, &addedConditions))
+        return search(lexicon, spec, allCaps);
+
+    QStringList resultList = baseResults;
+
+    if (!addedConditions.isEmpty() && !resultList.isEmpty()) {
+        SearchSpec addedSpec;
+        addedSpec.conditions = addedConditions;
+        addedSpec.optimize(lexicon);
+        if (addedSpec.conditions.isEmpty())
+            return QStringList();
+
+        // Filter by database conditions that were actually added, rather
+        // than Length conditions derived by SearchSpec::optimize
+        bool hasDatabaseCondition = false;
+        foreach (const SearchCondition& condition, addedConditions) {
+            if (getConditionPhase(condition) == DatabasePhase) {
+                hasDatabaseCondition = true;
+                break;
+            }
+        }
+        if (hasDatabaseCondition) {
+            if (!databaseIsConnected(lexicon))
+                return search(lexicon, spec, allCaps);
+            resultList = databaseSearch(lexicon, addedSpec, &resultList);
+            if (resultList.isEmpty())
+                return resultList;
+        }
+
+        // Filter by word graph and post conditions
+        QList<SearchCondition> wordConditions;
+        QList<SearchCondition> drawConditions;
+        foreach (const SearchCondition& condition, addedSpec.conditions) {
+            switch (condition.type) {
+                case SearchCondition::PatternMatch:
+                case SearchCondition::AnagramMatch:
+                case SearchCondition::SubanagramMatch:
+                if (getConditionPhase(condition) == WordGraphPhase)
+                    wordConditions.append(condition);
+                break;
+
+                case SearchCondition::DrawProbability:
+                if (getConditionPhase(condition) == WordGraphPhase)
+                    drawConditions.append(condition);
+                break;
+
+                case SearchCondition::ConsistOf:
+                wordConditions.append(condition);
+                break;
+
+                default: break;
+            }
+        }
+
+        // Pattern, Anagram, Subanagram and Consist Of conditions are tested
+        // against each retained word directly
+        QStringList::iterator wit;
+        for (wit = resultList.begin(); wit != resultList.end();) {
+            QString wordUpper = (*wit).toUpper();
+            bool keep = matchesPostConditions(lexicon, wordUpper,
+                                              addedSpec.conditions);
+
+            QListIterator<SearchCondition> cit (wordConditions);
+            while (keep && cit.hasNext()) {
+                const SearchCondition& condition = cit.next();
+                keep = WordGraph::matchesCondition(wordUpper, condition) ^
+                    condition.negated;
+            }
+
+            if (keep)
+                ++wit;
+            else
+                wit = resultList.erase(wit);
+        }
+
+        // Draw Probability conditions are tested by computing the draw
+        // probability of each retained word from the pool.  The graph search
+        // only finds words that can be drawn at all, so neither does this.
+        foreach (const SearchCondition& condition, drawConditions) {
+            if (resultList.isEmpty())
+                return resultList;
+
+            LetterBag bag;
+            bag.setLetters(condition.stringValue);
+            for (wit = resultList.begin(); wit != resultList.end();) {
+                double probability = bag.getDrawProbability(*wit);
+                double value = probability * DRAW_PROBABILITY_SCALE;
+                bool match = (probability > 0) &&
+                    (value >= condition.minValue) &&
+                    (value <= condition.maxValue);
+                if (match ^ condition.negated)
+                    ++wit;
+                else
+                    wit = resultList.erase(wit);
+            }
+        }
+    }
+
+    // Convert to all caps if necessary
+    if (allCaps) {
+        QStringList::iterator it;
+        for (it = resultList.begin(); it != resultList.end(); ++it)
+            *it = (*it).toUpper();
+    }
+
+    if (!resultList.isEmpty()) {
+        clearCache(lexicon);
+        addToCache(lexicon, resultList);
+    }
+
+    return resultList;
+}
+
+//---------------------------------------------------------------------------
+//  wordGraphSearch
+//
+//! Search the word graph for words matching the conditions in a search spec.
+//
+//! @param lexicon the name of the lexicon
+//! @param optimizedSpec the search spec
+//! @return a list of words
+//---------------------------------------------------------------------------
+QStringList
+WordEngine::wordGraphSearch(const QString& lexicon, const SearchSpec&
+                            optimizedSpec) const
+{
+    if (!lexiconData.contains(lexicon))
+        return QStringList();
+
+    // Restrict the blank in single-blank Anagram conditions to the letters
+    // that can fill it, as found in the anagram hook index, instead of
+    // trying every letter while traversing the graph
+    SearchSpec graphSpec = optimizedSpec;
+    QMutableListIterator<SearchCondition> it (graphSpec.conditions);
+    while (it.hasNext()) {
+        SearchCondition& condition = it.next();
+        if ((condition.type != SearchCondition::AnagramMatch) ||
+            condition.negated || (condition.stringValue.count('?') != 1))
+        {
+            continue;
+        }
+
+        QString letters = condition.stringValue;
+        letters.remove('?');
+        if (!QRegExp("[A-Z]+").exactMatch(letters))
+            continue;
+
+        bool indexed = false;
+        QString hookLetters = getAnagramHookLetters(lexicon, letters,
+                                                    &indexed);
+        if (!indexed)
+            continue;
+
+        if (hookLetters.isEmpty()) {
+            if (graphSpec.conjunction)
+                return QStringList();
+            it.remove();
+            continue;
+        }
+
+        condition.stringValue = letters + "[" + hookLetters + "]";
     }
 
-    if (!resultList.isEmpty()) {
-        clearCache(lexicon);
-        addToCache(lexicon, resultList);
-    }
+    if (graphSpec.conditions.isEmpty())
+        return QStringList();
 
-    return resultList;
+    return lexiconData[lexicon]->graph->search(graphSpec);
 }
 
 //---------------------------------------------------------------------------
-//  wordGraphSearch
+//  getDrawProbabilities
 //
-//! Search the word graph for words matching the conditions in a search spec.
+//! Find all acceptable words that can still be drawn from the current
+//! contents of a letter bag, such as the tiles unseen late in a game, along
+//! with the probability of drawing each one.
 //
 //! @param lexicon the name of the lexicon
-//! @param optimizedSpec the search spec
-//! @return a list of words
+//! @param bag the letter bag
+//! @param spec a search spec whose Length, Include Letters and Consist of
+//! conditions are also checked
+//! @return a map of words to their draw probabilities, between 0 and 1
 //---------------------------------------------------------------------------
-QStringList
-WordEngine::wordGraphSearch(const QString& lexicon, const SearchSpec&
-                            optimizedSpec) const
+QMap<QString, double>
+WordEngine::getDrawProbabilities(const QString& lexicon, const LetterBag&
+                                 bag, const SearchSpec& spec) const
 {
     if (!lexiconData.contains(lexicon))
-        return QStringList();
+        return QMap<QString, double>();
 
-    return lexiconData[lexicon]->graph->search(optimizedSpec);
+    return lexiconData[lexicon]->graph->getDrawProbabilities(
+        bag.getLetters(), spec);
 }
 
 //---------------------------------------------------------------------------
@@ -938,6 +2544,61 @@ WordEngine::alphagrams(const QStringList& strList) const
     return alphaList;
 }
 
+//---------------------------------------------------------------------------
+//  getAnagramHookLetters
+//
+//! Determine which single letters can be added to the letters of a word to
+//! form an anagram of an acceptable word.
+//
+//! @param lexicon the name of the lexicon
+//! @param word the word
+//! @param indexed return whether the letters of the word can be looked up
+//! in the anagram hook index - if not, an empty string is returned
+//! @return the anagram hook letters, in alphabetical order
+//---------------------------------------------------------------------------
+QString
+WordEngine::getAnagramHookLetters(const QString& lexicon, const QString&
+                                  word, bool* indexed) const
+{
+    AnagramHooks hooks;
+    bool found = findAnagramHooks(lexicon, word, &hooks);
+    if (indexed)
+        *indexed = found;
+    if (!found)
+        return QString();
+
+    QString letters;
+    for (int i = 0; i < 26; ++i) {
+        if (hooks.letterMask & (1 << i))
+            letters += QChar('A' + i);
+    }
+    return letters;
+}
+
+//---------------------------------------------------------------------------
+//  getNumAnagramHooks
+//
+//! Determine the number of acceptable words formed by adding a single
+//! letter to the letters of a word, i.e. the number of anagrams of the word
+//! plus a blank.  For a stem, this is its productivity.
+//
+//! @param lexicon the name of the lexicon
+//! @param word the word
+//! @param indexed return whether the letters of the word can be looked up
+//! in the anagram hook index - if not, zero is returned
+//! @return the number of words
+//---------------------------------------------------------------------------
+int
+WordEngine::getNumAnagramHooks(const QString& lexicon, const QString& word,
+                               bool* indexed) const
+{
+    AnagramHooks hooks;
+    bool found = findAnagramHooks(lexicon, word, &hooks);
+    if (indexed)
+        *indexed = found;
+    return (found ? hooks.numWords : 0);
+}
+
 //---------------------------------------------------------------------------
 //  getWordInfo
 //
@@ -955,17 +2616,152 @@ WordEngine::getWordInfo(const QString& lexicon, const QString& word) const
     if (word.isEmpty())
         return WordInfo();
 
-    if (!lexiconData.contains(lexicon))
+    // Words too long for the cache key cannot be in the database either
+    if (!lexiconData.contains(lexicon) || !FixedWord::canHold(word))
         return WordInfo();
 
-    if (lexiconData[lexicon]->wordCache.contains(word)) {
+    FixedWord key (word);
+    if (lexiconData[lexicon]->wordCache.contains(key)) {
         //qDebug("Cache HIT: |%s|", word.toUtf8().data());
-        return lexiconData[lexicon]->wordCache[word];
+        return lexiconData[lexicon]->wordCache[key];
     }
     //qDebug("Cache MISS: |%s|", word.toUtf8().data());
 
     addToCache(lexicon, QStringList(word));
-    return lexiconData[lexicon]->wordCache.value(word);
+    return lexiconData[lexicon]->wordCache.value(key);
+}
+
+//---------------------------------------------------------------------------
+//  getWordProfile
+//
+//! Get everything the Define tab displays about a word in a single call.
+//! Anagrams are found with one word graph search, and hooks and extensions
+//! are all derived from a single search for words containing the word.
+//! Information about every related word is then fetched with one bulk cache
+//! fill.  Unlike separate calls to search, this does not clear the word
+//! cache, so no information evicts any other.
+//
+//! @param lexicon the name of the lexicon
+//! @param word the word, assumed to be upper case
+//! @param allInfo whether to find anagrams, hooks and extensions in addition
+//! to the definition
+//! @return the word profile
+//---------------------------------------------------------------------------
+WordEngine::WordProfile
+WordEngine::getWordProfile(const QString& lexicon, const QString& word, bool
+                           allInfo) const
+{
+    WordProfile profile;
+    profile.word = word;
+    if (word.isEmpty() || !lexiconData.contains(lexicon))
+        return profile;
+
+    profile.acceptable = isAcceptable(lexicon, word);
+
+    QStringList relatedWords;
+    if (profile.acceptable)
+        relatedWords.append(word);
+
+    QString frontHookLetters;
+    QString backHookLetters;
+    if (allInfo) {
+        SearchSpec spec;
+        SearchCondition condition;
+
+        condition.type = SearchCondition::AnagramMatch;
+        condition.stringValue = word;
+        spec.conditions.append(condition);
+        spec.optimize(lexicon);
+        QStringList anagrams = wordGraphSearch(lexicon, spec);
+
+        spec.conditions.clear();
+        condition.type = SearchCondition::PatternMatch;
+        condition.stringValue = "*" + word + "*";
+        spec.conditions.append(condition);
+        spec.optimize(lexicon);
+        QStringList containing = wordGraphSearch(lexicon, spec);
+
+        foreach (const QString& anagram, anagrams) {
+            QString upper = anagram.toUpper();
+            if (upper == word)
+                continue;
+            profile.anagrams.append(upper);
+        }
+
+        // Classify words containing the word by where it occurs in them
+        int wordLen = word.length();
+        QList<QChar> frontLetters;
+        QList<QChar> backLetters;
+        foreach (const QString& str, containing) {
+            QString upper = str.toUpper();
+            int len = upper.length();
+            if (len == wordLen)
+                continue;
+
+            if (upper.endsWith(word)) {
+                profile.frontExtensions.append(upper);
+                if (len == wordLen + 1)
+                    frontLetters.append(upper.at(0).toLower());
+            }
+
+            if (upper.startsWith(word)) {
+                profile.backExtensions.append(upper);
+                if (len == wordLen + 1)
+                    backLetters.append(upper.at(len - 1).toLower());
+            }
+
+            // The earliest occurrence after the first letter is the only one
+            // that can leave letters on both sides
+            int index = upper.indexOf(word, 1);
+            if ((index > 0) && (index + wordLen < len))
+                profile.doubleExtensions.append(upper);
+        }
+
+        qSort(profile.anagrams);
+        qSort(profile.frontExtensions);
+        qSort(profile.backExtensions);
+        qSort(profile.doubleExtensions);
+
+        qSort(frontLetters.begin(), frontLetters.end(),
+              Auxil::localeAwareLessThanQChar);
+        qSort(backLetters.begin(), backLetters.end(),
+              Auxil::localeAwareLessThanQChar);
+        foreach (const QChar& c, frontLetters)
+            frontHookLetters += c;
+        foreach (const QChar& c, backLetters)
+            backHookLetters += c;
+
+        relatedWords += profile.anagrams;
+        relatedWords += profile.frontExtensions;
+        relatedWords += profile.backExtensions;
+        relatedWords += profile.doubleExtensions;
+    }
+
+    // Fetch information about all related words at once
+    addToCache(lexicon, relatedWords);
+
+    if (profile.acceptable)
+        profile.definition = getDefinition(lexicon, word);
+
+    foreach (const QString& relatedWord, relatedWords) {
+        if (profile.lexiconSymbols.contains(relatedWord))
+            continue;
+        profile.lexiconSymbols.insert(relatedWord,
+                                      getLexiconSymbols(lexicon, relatedWord));
+    }
+
+    if (allInfo) {
+        // Prefer hooks from the database, which include lexicon symbols
+        WordInfo info = FixedWord::canHold(word)
+            ? lexiconData[lexicon]->wordCache.value(FixedWord(word))
+            : WordInfo();
+        profile.frontHooks = info.isValid() ? info.frontHooks
+                                            : frontHookLetters;
+        profile.backHooks = info.isValid() ? info.backHooks
+                                           : backHookLetters;
+    }
+
+    return profile;
 }
 
 //---------------------------------------------------------------------------
@@ -982,6 +2778,10 @@ WordEngine::getNumWords(const QString& lexicon) const
     if (!lexiconData.contains(lexicon))
         return 0;
 
+    // The word graph keeps its word counts, so prefer it to the database
+    if (lexiconData[lexicon]->graph)
+        return lexiconData[lexicon]->graph->getNumWords();
+
     QSqlDatabase* db = lexiconData[lexicon]->db;
     if (db && db->isOpen()) {
         QString qstr = "SELECT count(*) FROM words";
@@ -989,8 +2789,6 @@ WordEngine::getNumWords(const QString& lexicon) const
         if (query.next())
             return query.value(0).toInt();
     }
-    else
-        return lexiconData[lexicon]->graph->getNumWords();
 
     return 0;
 }
@@ -1013,6 +2811,24 @@ WordEngine::getLexiconFile(const QString& lexicon) const
     return lexiconData[lexicon]->lexiconFile;
 }
 
+//---------------------------------------------------------------------------
+//  getLexiconHash
+//
+//! Get the content hash of the text file associated with a lexicon, if
+//! applicable.
+//
+//! @param lexicon the name of the lexicon
+//! @return the content hash of the lexicon file
+//---------------------------------------------------------------------------
+QString
+WordEngine::getLexiconHash(const QString& lexicon) const
+{
+    if (!lexiconData.contains(lexicon))
+        return QString();
+
+    return lexiconData[lexicon]->lexiconHash;
+}
+
 //---------------------------------------------------------------------------
 //  getDefinition
 //
@@ -1057,22 +2873,32 @@ WordEngine::getDefinition(const QString& lexicon, const QString& word,
 
     QString definition;
     if (info.isValid()) {
-        if (replaceLinks) {
-            QStringList defs = info.definition.split(DEF_ORIG_SEP);
-            definition = QString();
-            foreach (const QString& def, defs) {
-                if (!definition.isEmpty())
-                    definition += DEF_DISPLAY_SEP;
-                definition += def;
-            }
-            return definition;
-        }
-        else {
+        if (!replaceLinks)
             return info.definition;
+
+        if (info.definitionLinksReplaced)
+            return info.replacedDefinition;
+
+        // Replace links only when the definition is first displayed, and
+        // remember the result for as long as the word stays in the cache
+        definition = replaceDefinitionLinks(lexicon, info.word,
+                                            info.definition);
+        QHash<FixedWord, WordInfo>& wordCache =
+            lexiconData[lexicon]->wordCache;
+        FixedWord key (word);
+        if (wordCache.contains(key)) {
+            WordInfo& cachedInfo = wordCache[key];
+            cachedInfo.replacedDefinition = definition;
+            cachedInfo.definitionLinksReplaced = true;
         }
+        return definition;
     }
 
     else {
+        const LexiconBundle* bundle = lexiconData[lexicon]->bundle;
+        if (bundle && bundle->hasDefinitions())
+            return bundle->getDefinition(bundle->findWord(word));
+
         if (!lexiconData[lexicon]->definitions.contains(word))
             return QString();
 
@@ -1214,10 +3040,15 @@ WordEngine::addToCache(const QString& lexicon, const QStringList& words) const
     // Throw out words that are already in the cache
     QStringList needWords;
     foreach (const QString& word, words) {
-        if (lexData->wordCache.contains(word))
+        if (!FixedWord::canHold(word) ||
+            lexData->wordCache.contains(FixedWord(word)))
+        {
             continue;
+        }
         needWords.append(word);
     }
+    if (needWords.isEmpty())
+        return;
 
     // Construct the where clause from the word list
     if (needWords.count() == 1) {
@@ -1268,8 +3099,53 @@ WordEngine::addToCache(const QString& lexicon, const QStringList& words) const
             info.blankProbabilityOrder[numBlanks] = probOrder;
         }
 
-        lexiconData[lexicon]->wordCache[info.word] = info;
+        lexiconData[lexicon]->wordCache[FixedWord(info.word)] = info;
+    }
+}
+
+//---------------------------------------------------------------------------
+//  getDatabaseValues
+//
+//! Look up a numeric column of the lexicon database for a list of words,
+//! without adding the words to the cache.  The words are looked up in
+//! batches, so the list may hold any number of words.
+//
+//! @param lexicon the name of the lexicon
+//! @param words the words to look up, in upper case
+//! @param column the SQL expression to look up in the words table
+//! @return a hash of words to values, missing the words not in the database
+//---------------------------------------------------------------------------
+QHash<QString, qint64>
+WordEngine::getDatabaseValues(const QString& lexicon, const QStringList&
+                              words, const QString& column) const
+{
+    QHash<QString, qint64> values;
+    if (!databaseIsConnected(lexicon))
+        return values;
+
+    QSqlDatabase* db = lexiconData[lexicon]->db;
+    values.reserve(words.size());
+    for (int start = 0; start < words.size(); start += MAX_QUERY_WORDS) {
+        QString qstr = "SELECT word, " + column + " FROM words WHERE "
+            "word IN (";
+        int end = qMin(start + MAX_QUERY_WORDS, words.size());
+        for (int i = start; i < end; ++i) {
+            if (i > start)
+                qstr += ", ";
+            qstr += "'" + words[i] + "'";
+        }
+        qstr += ")";
+
+        QSqlQuery query (*db);
+        query.prepare(qstr);
+        query.exec();
+        while (query.next()) {
+            values.insert(query.value(0).toString(),
+                          query.value(1).toLongLong());
+        }
     }
+
+    return values;
 }
 
 //---------------------------------------------------------------------------
@@ -1336,6 +3212,202 @@ WordEngine::matchesPostConditions(const QString& lexicon, const QString& word,
     return true;
 }
 
+//---------------------------------------------------------------------------
+//  findAnagramHooks
+//
+//! Look up the anagram hook index entry for the letters of a word, building
+//! the index first if the word graph has changed since it was last built.
+//
+//! @param lexicon the name of the lexicon
+//! @param word the word
+//! @param hooks return the index entry, which is empty if no single letter
+//! can be added to the letters of the word to form an acceptable word
+//! @return true if the letters of the word can be looked up in the index
+//---------------------------------------------------------------------------
+bool
+WordEngine::findAnagramHooks(const QString& lexicon, const QString& word,
+                             AnagramHooks* hooks) const
+{
+    if (!lexiconData.contains(lexicon))
+        return false;
+
+    // The index does not hold words too long to be held in a FixedWord, so
+    // it cannot tell the hooks of words that would form them
+    QString upper = word.toUpper();
+    if (upper.length() >= FixedWord::CAPACITY)
+        return false;
+
+    LexiconData* data = lexiconData[lexicon];
+    QMutexLocker locker (&data->anagramHooksMutex);
+    if (!data->anagramHooksBuilt ||
+        (data->anagramHooksGeneration != data->graphGeneration))
+    {
+        buildAnagramHookIndex(lexicon);
+    }
+    if (!data->anagramHooksUsable || !QRegExp("[A-Z]*").exactMatch(upper))
+        return false;
+
+    AnagramHooks key;
+    key.alphagram = FixedWord(upper).alphagram();
+    QVector<AnagramHooks>::const_iterator it =
+        qBinaryFind(data->anagramHooks.constBegin(),
+                    data->anagramHooks.constEnd(), key);
+    *hooks = (it == data->anagramHooks.constEnd()) ? key : *it;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  buildAnagramHookIndex
+//
+//! Build the anagram hook index for a lexicon from its word graph.  The
+//! index is sorted by alphagram, and has an entry for every alphagram that
+//! can be extended by a single letter to form the alphagram of an acceptable
+//! word.  Each entry holds a mask of the letters A-Z that extend it, and the
+//! number of words formed that way.  Lexicons using letters outside A-Z are
+//! not indexed.  The caller must hold the lock on the index.
+//
+//! @param lexicon the name of the lexicon
+//---------------------------------------------------------------------------
+void
+WordEngine::buildAnagramHookIndex(const QString& lexicon) const
+{
+    LexiconData* data = lexiconData[lexicon];
+    data->anagramHooks.clear();
+    data->anagramHooksBuilt = true;
+    data->anagramHooksUsable = false;
+    data->anagramHooksGeneration = data->graphGeneration;
+    if (!data->graph)
+        return;
+
+    SearchCondition condition;
+    condition.type = SearchCondition::PatternMatch;
+    condition.stringValue = "*";
+    SearchSpec spec;
+    spec.conditions.append(condition);
+    QStringList words = data->graph->search(spec);
+
+    QRegExp letterRe ("[A-Z]+");
+    QVector<FixedWord> alphagrams;
+    alphagrams.reserve(words.size());
+    foreach (const QString& word, words) {
+        if (!letterRe.exactMatch(word))
+            return;
+        if (FixedWord::canHold(word))
+            alphagrams.append(FixedWord(word).alphagram());
+    }
+    words.clear();
+    qSort(alphagrams.begin(), alphagrams.end());
+
+    // Each group of anagrams extends every alphagram formed by removing one
+    // of its letters
+    QVector<AnagramHooks> extensions;
+    for (int i = 0; i < alphagrams.size();) {
+        const FixedWord& alphagram = alphagrams.at(i);
+        int numAnagrams = 1;
+        while ((i + numAnagrams < alphagrams.size()) &&
+               (alphagrams.at(i + numAnagrams) == alphagram))
+        {
+            ++numAnagrams;
+        }
+        i += numAnagrams;
+
+        int length = alphagram.length();
+        for (int j = 0; j < length; ++j) {
+            char letter = alphagram.at(j);
+            if (j && (letter == alphagram.at(j - 1)))
+                continue;
+
+            AnagramHooks extension;
+            for (int k = 0; k < length; ++k) {
+                if (k != j)
+                    extension.alphagram.append(alphagram.at(k));
+            }
+            extension.letterMask = 1 << (letter - 'A');
+            extension.numWords = numAnagrams;
+            extensions.append(extension);
+        }
+    }
+    alphagrams.clear();
+    qSort(extensions.begin(), extensions.end());
+
+    QVector<AnagramHooks>& hooks = data->anagramHooks;
+    foreach (const AnagramHooks& extension, extensions) {
+        if (!hooks.isEmpty() &&
+            (hooks.last().alphagram == extension.alphagram))
+        {
+            hooks.last().letterMask |= extension.letterMask;
+            hooks.last().numWords += extension.numWords;
+        }
+        else {
+            hooks.append(extension);
+        }
+    }
+    hooks.squeeze();
+
+    data->anagramHooksUsable = true;
+}
+
+//---------------------------------------------------------------------------
+//  getCompletionIndex
+//
+//! Return the completion index of a lexicon for a ranking, building it
+//! first if necessary.  Playability values come from the lexicon database
+//! if it is connected, or from the lexicon bundle otherwise; words without
+//! a value rank after all others, in alphabetical order.
+//
+//! @param lexicon the name of the lexicon, which must be loaded
+//! @param ranking the ranking
+//! @return the completion index
+//---------------------------------------------------------------------------
+const CompletionIndex&
+WordEngine::getCompletionIndex(const QString& lexicon, SampleWeight ranking)
+    const
+{
+    LexiconData* data = lexiconData[lexicon];
+    QMap<int, CompletionIndex>::const_iterator it =
+        data->completionIndexes.constFind(ranking);
+    if (it != data->completionIndexes.constEnd())
+        return it.value();
+
+    SearchCondition condition;
+    condition.type = SearchCondition::PatternMatch;
+    condition.stringValue = "*";
+    SearchSpec spec;
+    spec.conditions.append(condition);
+    QStringList words = data->graph->search(spec);
+
+    int numWords = words.size();
+    QVector<double> scores (numWords, 0.0);
+    if (ranking == ProbabilityWeight) {
+        LetterBag letterBag;
+        for (int i = 0; i < numWords; ++i)
+            scores[i] = letterBag.getNumCombinations(words[i], 0);
+    }
+    else if ((ranking == PlayabilityWeight) && data->db) {
+        QHash<QString, int> wordIndex;
+        wordIndex.reserve(numWords);
+        for (int i = 0; i < numWords; ++i)
+            wordIndex.insert(words[i].toUpper(), i);
+
+        QSqlQuery query ("SELECT word, playability FROM words", *data->db);
+        while (query.next()) {
+            QHash<QString, int>::const_iterator found =
+                wordIndex.constFind(query.value(0).toString());
+            if (found != wordIndex.constEnd())
+                scores[found.value()] = query.value(1).toLongLong();
+        }
+    }
+    else if ((ranking == PlayabilityWeight) && data->bundle) {
+        const LexiconBundle* bundle = data->bundle;
+        for (int i = 0; i < numWords; ++i)
+            scores[i] = bundle->getPlayability(bundle->findWord(words[i]));
+    }
+
+    CompletionIndex& index = data->completionIndexes[ranking];
+    index.build(words, scores);
+    return index;
+}
+
 //---------------------------------------------------------------------------
 //  isSetMember
 //
@@ -1382,9 +3454,15 @@ WordEngine::isSetMember(const QString& lexicon, const QString& word,
             if (word.length() != 5)
                 return false;
 
+            const Alphabet& alphabet = getAlphabet(lexicon);
+            QString upper = word.toUpper();
+            quint8 codes[5];
+            if (!alphabet.encode(upper, codes))
+                return false;
+
             bool ok = false;
-            for (int i = 0; i < word.length(); ++i) {
-                int value = letterBag.getLetterValue(word[i]);
+            for (int i = 0; i < 5; ++i) {
+                int value = alphabet.getPointValue(codes[i]);
                 if (value > 5)
                     return false;
                 if (((value == 4) || (value == 5)) && ((i == 0) || (i == 4)))
@@ -1546,6 +3624,10 @@ WordEngine::getNumAnagrams(const QString& lexicon, const QString& word) const
         return info.numAnagrams;
     }
     else {
+        const LexiconBundle* bundle = lexiconData[lexicon]->bundle;
+        if (bundle)
+            return bundle->getNumAnagrams(bundle->findWord(word));
+
         QString alpha = Auxil::getAlphagram(word);
         return lexiconData[lexicon]->numAnagramsMap.value(alpha);
     }
@@ -1568,7 +3650,11 @@ WordEngine::getPlayabilityValue(const QString& lexicon, const QString& word)
         return 0;
 
     WordInfo info = getWordInfo(lexicon, word);
-    return info.isValid() ? info.playability : 0;
+    if (info.isValid())
+        return info.playability;
+
+    const LexiconBundle* bundle = lexiconData[lexicon]->bundle;
+    return bundle ? bundle->getPlayability(bundle->findWord(word)) : 0;
 }
 
 //---------------------------------------------------------------------------
@@ -1748,7 +3834,14 @@ WordEngine::getPointValue(const QString& lexicon, const QString& word) const
         return 0;
 
     WordInfo info = getWordInfo(lexicon, word);
-    return info.isValid() ? info.pointValue : 0;
+    if (info.isValid())
+        return info.pointValue;
+
+    const Alphabet& alphabet = getAlphabet(lexicon);
+    QString upper = word.toUpper();
+    QVarLengthArray<quint8, MAX_WORD_LEN> codes (upper.length());
+    return alphabet.encode(upper, codes.data())
+        ? alphabet.getPointValue(codes.data(), upper.length()) : 0;
 }
 
 //---------------------------------------------------------------------------
@@ -2013,6 +4106,153 @@ WordEngine::addDefinition(const QString& lexicon, const QString& word,
     lexiconData[lexicon]->definitions.insert(word, defMap);
 }
 
+//---------------------------------------------------------------------------
+//  replaceDefinitionLinks
+//
+//! Replace links in each part of a definition with the definitions of the
+//! words they are linked to.  Definitions consisting only of parts of speech
+//! are returned unchanged.
+//
+//! @param lexicon the name of the lexicon
+//! @param word the word being defined
+//! @param definition the definition with links to be replaced
+//! @return the definition with links replaced
+//---------------------------------------------------------------------------
+QString
+WordEngine::replaceDefinitionLinks(const QString& lexicon, const QString&
+                                   word, const QString& definition) const
+{
+    QRegExp defRegex (QString("^[^[]|\\s+/\\s+[^[]"));
+    if (defRegex.indexIn(definition, 0) < 0)
+        return definition;
+
+    QSet<QString> alreadyReplaced;
+    QStringList defs = definition.split(DEF_ORIG_SEP);
+    QString newDefinition;
+    foreach (const QString& def, defs) {
+        if (!newDefinition.isEmpty())
+            newDefinition += DEF_DISPLAY_SEP;
+
+        alreadyReplaced.clear();
+        alreadyReplaced.insert(word.toUpper());
+
+        newDefinition += replaceDefinitionLinks(lexicon, def,
+            MAX_DEFINITION_LINKS, &alreadyReplaced);
+    }
+
+    return newDefinition;
+}
+
+//---------------------------------------------------------------------------
+//  replaceDefinitionLinks
+//
+//! Replace links in a definition with the definitions of the words they are
+//! linked to.  A string is assumed to have a maximum of one link.  Links may
+//! be followed recursively to the maximum depth specified.
+//
+//! @param lexicon the name of the lexicon
+//! @param definition the definition with links to be replaced
+//! @param maxDepth the maximum number of recursive links to replace
+//! @param alreadyReplaced the set of words already replaced
+//! @param useFollow true if the "follow" replacement should be used
+//
+//! @return a string with links replaced
+//---------------------------------------------------------------------------
+QString
+WordEngine::replaceDefinitionLinks(const QString& lexicon, const QString&
+                                   definition, int maxDepth, QSet<QString>*
+                                   alreadyReplaced, bool useFollow) const
+{
+    QRegExp followRegex (QString("\\{(\\w+)=(\\w+)\\}"));
+    QRegExp replaceRegex (QString("\\<(\\w+)=(\\w+)\\>"));
+
+    // Try to match the follow regex and the replace regex.  If a follow regex
+    // is ever matched, then the "follow" replacements should always be used,
+    // even if the "replace" regex is matched in a later iteration.
+    QRegExp* matchedRegex = 0;
+    int index = followRegex.indexIn(definition, 0);
+    if (index >= 0) {
+        matchedRegex = &followRegex;
+        useFollow = true;
+    }
+    else {
+        index = replaceRegex.indexIn(definition, 0);
+        matchedRegex = &replaceRegex;
+    }
+
+    if (index < 0)
+        return definition;
+
+    QString modified (definition);
+    QString word = matchedRegex->cap(1);
+    QString pos = matchedRegex->cap(2);
+
+    QString replacement;
+    QString upper = word.toUpper();
+    QString failReplacement = useFollow ? word : upper;
+    bool cutRecursion = !maxDepth || alreadyReplaced->contains(upper);
+    if (cutRecursion) {
+        replacement = failReplacement;
+    }
+    else {
+        QString subdef = getSubDefinition(lexicon, upper, pos);
+        if (subdef.isEmpty()) {
+            replacement = failReplacement;
+            cutRecursion = true;
+        }
+        else if (useFollow) {
+            replacement = (matchedRegex == &followRegex) ?
+                word + " (" + subdef + ")" : subdef;
+        }
+        else {
+            replacement = upper + ", " + subdef;
+        }
+        alreadyReplaced->insert(upper);
+    }
+
+    modified.replace(index, matchedRegex->matchedLength(), replacement);
+    int lowerMaxDepth = useFollow ? maxDepth - 1 : maxDepth;
+    return cutRecursion ? modified
+        : replaceDefinitionLinks(lexicon, modified, lowerMaxDepth,
+                                 alreadyReplaced, useFollow);
+}
+
+//---------------------------------------------------------------------------
+//  getSubDefinition
+//
+//! Return the definition associated with a word and a part of speech.  If
+//! more than one definition is given for a part of speech, pick the first
+//! one.
+//
+//! @param lexicon the name of the lexicon
+//! @param word the word
+//! @param pos the part of speech
+//
+//! @return the definition substring
+//---------------------------------------------------------------------------
+QString
+WordEngine::getSubDefinition(const QString& lexicon, const QString& word,
+                             const QString& pos) const
+{
+    QString definition = getDefinition(lexicon, word, false);
+    if (definition.isEmpty())
+        return QString();
+
+    QRegExp posRegex (QString("\\[(\\w+)"));
+    QStringList defs = definition.split(DEF_ORIG_SEP);
+    foreach (const QString& def, defs) {
+        if ((posRegex.indexIn(def, 0) > 0) &&
+            (posRegex.cap(1) == pos))
+        {
+            QString str = def.left(def.indexOf("[")).simplified();
+            if (!str.isEmpty())
+                return str;
+        }
+    }
+
+    return QString();
+}
+
 //---------------------------------------------------------------------------
 //  getConditionPhase
 //
@@ -2029,6 +4269,7 @@ WordEngine::getConditionPhase(const SearchCondition& condition) const
         case SearchCondition::AnagramMatch:
         case SearchCondition::SubanagramMatch:
         case SearchCondition::ConsistOf:
+        case SearchCondition::DrawProbability:
         return WordGraphPhase;
 
         case SearchCondition::Length:
@@ -25,15 +25,27 @@
 #ifndef ZYZZYVA_WORD_ENGINE_H
 #define ZYZZYVA_WORD_ENGINE_H
 
+#include "Alphabet.h"
+#include "CompletionIndex.h"
+#include "FixedWord.h"
+#include "SampleWeight.h"
 #include "WordGraph.h"
+#include <QHash>
 #include <QMap>
 #include <QMultiMap>
+#include <QMutex>
 #include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QSqlDatabase>
+#include <QVector>
 #include <stdint.h>
 
+class LetterBag;
+class LexiconBundle;
+class SharedWordGraph;
+class Rand;
+
 class WordEngine : public QObject
 {
     Q_OBJECT
@@ -41,6 +53,45 @@ class WordEngine : public QObject
     static const QString DEF_ORIG_SEP;
     static const QString DEF_DISPLAY_SEP;
 
+    enum AggregateAttribute {
+        NoAttribute = 0,
+        LengthAttribute,
+        NumVowelsAttribute,
+        NumUniqueLettersAttribute,
+        PointValueAttribute,
+        NumAnagramsAttribute,
+        FirstLetterAttribute,
+        LastLetterAttribute,
+        ProbabilityOrderAttribute,
+        PlayabilityOrderAttribute
+    };
+
+    class AggregateSpec {
+        public:
+        AggregateSpec() : firstGroup(NoAttribute), secondGroup(NoAttribute),
+            valueAttribute(NoAttribute), bandSize(1), numBlanks(0) { }
+
+        public:
+        AggregateAttribute firstGroup;
+        AggregateAttribute secondGroup;
+        AggregateAttribute valueAttribute;
+        int bandSize;
+        int numBlanks;
+    };
+
+    class AggregateRow {
+        public:
+        AggregateRow() : firstKey(0), secondKey(0), count(0), minValue(0),
+            maxValue(0) { }
+
+        public:
+        qint64 firstKey;
+        qint64 secondKey;
+        int count;
+        qint64 minValue;
+        qint64 maxValue;
+    };
+
     class ValueOrder {
         public:
         ValueOrder() : valueOrder(0), minValueOrder(0), maxValueOrder(0) { }
@@ -53,7 +104,7 @@ class WordEngine : public QObject
     class WordInfo {
         public:
         WordInfo() : numVowels(0), numUniqueLetters(0), numAnagrams(0),
-            pointValue(0) { }
+            pointValue(0), definitionLinksReplaced(false) { }
         ~WordInfo() { }
 
         bool isValid() const { return !word.isEmpty(); }
@@ -70,38 +121,89 @@ class WordEngine : public QObject
         bool isBackHook;
         QString lexiconSymbols;
         QString definition;
+        QString replacedDefinition;
+        bool definitionLinksReplaced;
         qint64 playability;
         ValueOrder playabilityOrder;
         QMap<int, ValueOrder> blankProbabilityOrder;
     };
 
+    class WordProfile {
+        public:
+        WordProfile() : acceptable(false) { }
+        ~WordProfile() { }
+
+        public:
+        QString word;
+        bool acceptable;
+        QString definition;
+        QStringList anagrams;
+        QString frontHooks;
+        QString backHooks;
+        QStringList frontExtensions;
+        QStringList backExtensions;
+        QStringList doubleExtensions;
+        QMap<QString, QString> lexiconSymbols;
+    };
+
+    class AnagramHooks {
+        public:
+        AnagramHooks() : letterMask(0), numWords(0) { }
+
+        bool operator<(const AnagramHooks& rhs) const {
+            return alphagram < rhs.alphagram;
+        }
+
+        public:
+        FixedWord alphagram;
+        quint32 letterMask;
+        quint32 numWords;
+    };
+
     class LexiconData {
         public:
-        LexiconData() : graph(0), db(0) { }
+        LexiconData() : anagramHooksBuilt(false), anagramHooksUsable(false),
+                        anagramHooksGeneration(0), graphGeneration(0),
+                        graph(0), sharedGraph(0), bundle(0), db(0) { }
 
         public:
         QString name;
         QString lexiconFile;
+        QString lexiconHash;
+        QString baseLexicon;
         QMap<QString, QMultiMap<QString, QString> > definitions;
         QMap<int, QStringList> stems;
         QMap<QString, int> numAnagramsMap;
         QMap<QString, qint64> playabilityMap;
         QMap<int, QSet<QString> > stemAlphagrams;
-        mutable QMap<QString, WordInfo> wordCache;
+        mutable QHash<FixedWord, WordInfo> wordCache;
+        mutable QVector<AnagramHooks> anagramHooks;
+        mutable bool anagramHooksBuilt;
+        mutable bool anagramHooksUsable;
+        mutable quint32 anagramHooksGeneration;
+        mutable QMutex anagramHooksMutex;
+        mutable QMap<int, CompletionIndex> completionIndexes;
+        Alphabet alphabet;
+        quint32 graphGeneration;
         WordGraph* graph;
+        SharedWordGraph* sharedGraph;
+        LexiconBundle* bundle;
         QSqlDatabase* db;
         QString dbConnectionName;
     };
 
     public:
     WordEngine(QObject* parent = 0)
-        : QObject(parent) { }
+        : QObject(parent), lastGraphGeneration(0) { }
     ~WordEngine() { }
 
     bool connectToDatabase(const QString& lexicon, const QString& filename,
                            QString* errString = 0);
     bool disconnectFromDatabase(const QString& lexicon);
     bool databaseIsConnected(const QString& lexicon) const;
+    QString getDatabaseFilename(const QString& lexicon) const;
+    bool getDatabaseCondition(const QString& lexicon, const SearchSpec& spec,
+                              QString* condition) const;
     int importTextFile(const QString& lexicon, const QString& filename, bool
                        loadDefinitions = true, QString* errString = 0);
     bool importDawgFile(const QString& lexicon, const QString& filename, bool
@@ -109,16 +211,55 @@ class WordEngine : public QObject
                         expectedChecksum = 0);
     int importStems(const QString& lexicon, const QString& filename,
                     QString* errString = 0);
+    bool importLexiconBundle(const QString& lexicon, const QString& filename,
+                             QString* errString = 0);
+    bool importCompiledTextFile(const QString& lexicon, const QString&
+                                filename, QString* errString = 0);
+    bool importOverlayFile(const QString& lexicon, const QString&
+                           baseLexicon, const QString& filename, QString*
+                           errString = 0);
+    static QString readOverlayBase(const QString& filename);
+    bool shareLexiconGraphs(const QStringList& lexicons, QString* errString
+                            = 0);
+    QMap<QString, bool> getSharedMembership(const QString& lexicon, const
+                                            QString& word) const;
     bool lexiconIsLoaded(const QString& lexicon) const;
     bool isAcceptable(const QString& lexicon, const QString& word) const;
+    WordGraph::Cursor getWordCursor(const QString& lexicon) const;
+    const Alphabet& getAlphabet(const QString& lexicon) const;
+    QStringList getCompletions(const QString& lexicon, const QString& prefix,
+                               int maxCompletions, SampleWeight ranking =
+                               PlayabilityWeight) const;
     QStringList search(const QString& lexicon, const SearchSpec& spec,
                        bool allCaps) const;
+    int countSearch(const QString& lexicon, const SearchSpec& spec) const;
+    QList<AggregateRow> aggregateSearch(const QString& lexicon, const
+                                        SearchSpec& spec, const
+                                        AggregateSpec& aggregate) const;
+    static QString attributeKeyToString(AggregateAttribute attribute,
+                                        qint64 key, int bandSize = 1);
+    QStringList sampleSearch(const QString& lexicon, const SearchSpec& spec,
+                             int sampleSize, SampleWeight weight,
+                             int numBlanks, bool groupAnagrams, Rand* rng)
+                             const;
+    QStringList refineSearch(const QString& lexicon, const SearchSpec&
+                             baseSpec, const QStringList& baseResults,
+                             const SearchSpec& spec, bool allCaps) const;
     QStringList wordGraphSearch(const QString& lexicon, const SearchSpec&
                                 spec) const;
+    QMap<QString, double> getDrawProbabilities(const QString& lexicon,
+        const LetterBag& bag, const SearchSpec& spec = SearchSpec()) const;
     QStringList alphagrams(const QStringList& strList) const;
+    QString getAnagramHookLetters(const QString& lexicon, const QString&
+                                  word, bool* indexed = 0) const;
+    int getNumAnagramHooks(const QString& lexicon, const QString& word,
+                           bool* indexed = 0) const;
     int getNumWords(const QString& lexicon) const;
     QString getLexiconFile(const QString& lexicon) const;
+    QString getLexiconHash(const QString& lexicon) const;
     WordInfo getWordInfo(const QString& lexicon, const QString& word) const;
+    WordProfile getWordProfile(const QString& lexicon, const QString& word,
+                               bool allInfo = true) const;
     QString getDefinition(const QString& lexicon, const QString& word,
                           bool replaceLinks = true) const;
     QString getFrontHookLetters(const QString& lexicon, const QString& word)
@@ -150,6 +291,9 @@ class WordEngine : public QObject
 
     void addToCache(const QString& lexicon, const QStringList& words) const;
 
+    signals:
+    void lexiconUnloaded(const QString& lexicon, const QString& reason);
+
     private:
     enum ConditionPhase {
         UnknownPhase = 0,
@@ -160,15 +304,51 @@ class WordEngine : public QObject
 
     private:
     void clearCache(const QString& lexicon) const;
+    void clearCompletionIndexes(const QString& lexicon) const;
+    void buildAlphabet(const QString& lexicon);
+    const CompletionIndex& getCompletionIndex(const QString& lexicon,
+                                              SampleWeight ranking) const;
+    void unshareLexiconGraph(const QString& lexicon);
+    void releaseSharedGraph(SharedWordGraph* shared);
+    void rebaseOverlays(const QString& baseLexicon);
+    void unloadLexicon(const QString& lexicon);
+    void graphChanged(const QString& lexicon);
+    void buildAnagramHookIndex(const QString& lexicon) const;
+    bool findAnagramHooks(const QString& lexicon, const QString& word,
+                          AnagramHooks* hooks) const;
     bool matchesPostConditions(const QString& lexicon, const QString& word,
                                const QList<SearchCondition>& conditions) const;
     bool isSetMember(const QString& lexicon, const QString& word,
                      SearchSet ss) const;
     int getNumAnagrams(const QString& lexicon, const QString& word) const;
+    QStringList getMatchingWords(const QString& lexicon,
+                                 const SearchSpec& spec) const;
     QStringList nonGraphSearch(const QString& lexicon,
                                const SearchSpec& spec) const;
     void addDefinition(const QString& lexicon, const QString& word,
                        const QString& definition);
+    QString replaceDefinitionLinks(const QString& lexicon, const QString&
+                                   word, const QString& definition) const;
+    QString replaceDefinitionLinks(const QString& lexicon, const QString&
+                                   definition, int maxDepth, QSet<QString>*
+                                   alreadyReplaced, bool useFollow = false)
+                                   const;
+    QString getSubDefinition(const QString& lexicon, const QString& word,
+                             const QString& pos) const;
+    int databaseCount(const QString& lexicon, const SearchSpec&
+                      optimizedSpec) const;
+    QList<AggregateRow> databaseAggregate(const QString& lexicon, const
+                                          SearchSpec& optimizedSpec, const
+                                          AggregateSpec& aggregate) const;
+    qint64 getAttributeValue(const QString& lexicon, const QString& word,
+                             AggregateAttribute attribute, int numBlanks)
+                             const;
+    QList<qint64> getAttributeValues(const QString& lexicon, const
+                                     QStringList& words, AggregateAttribute
+                                     attribute, int numBlanks) const;
+    static QString getAttributeColumn(AggregateAttribute attribute, int
+                                      numBlanks);
+    static bool isBandedAttribute(AggregateAttribute attribute);
     QStringList databaseSearch(const QString& lexicon, const SearchSpec&
                                optimizedSpec, const QStringList* wordList = 0)
                                const;
@@ -176,9 +356,20 @@ class WordEngine : public QObject
                                     optimizedSpec, const QStringList&
                                     wordList) const;
     ConditionPhase getConditionPhase(const SearchCondition& condition) const;
+    QString getDatabaseConditionString(const QString& lexicon, const
+                                       SearchSpec& optimizedSpec) const;
+    QString getDefinitionMatchQuery(const QString& lexicon, const QString&
+                                    text, int tableNum) const;
+    static bool readWordListFile(const QString& filename, QStringList*
+                                 words, QStringList* definitions, QString*
+                                 errString);
+    QHash<QString, qint64> getDatabaseValues(const QString& lexicon, const
+                                             QStringList& words, const
+                                             QString& column) const;
 
     private:
     QMap<QString, LexiconData*> lexiconData;
+    quint32 lastGraphGeneration;
 };
 
 #endif // ZYZZYVA_WORD_ENGINE_H
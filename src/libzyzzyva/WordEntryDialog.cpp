@@ -24,6 +24,7 @@
 
 #include "WordEntryDialog.h"
 #include "LexiconSelectWidget.h"
+#include "WordLineEdit.h"
 #include "WordValidator.h"
 #include "ZPushButton.h"
 #include "Defs.h"
@@ -40,13 +41,15 @@ using namespace Defs;
 //
 //! Constructor.
 //
+//! @param e the word engine
 //! @param parent the parent widget
 //! @param name the name of this widget
 //! @param modal whether the dialog is modal
 //! @param f widget flags
 //---------------------------------------------------------------------------
-WordEntryDialog::WordEntryDialog(QWidget* parent, Qt::WFlags f)
-    : QDialog(parent, f),
+WordEntryDialog::WordEntryDialog(WordEngine* e, QWidget* parent,
+                                 Qt::WFlags f)
+    : QDialog(parent, f), wordEngine(e),
     wordValidator(new WordValidator(this))
 {
     QVBoxLayout* mainVlay = new QVBoxLayout(this);
@@ -54,6 +57,8 @@ WordEntryDialog::WordEntryDialog(QWidget* parent, Qt::WFlags f)
     mainVlay->setSpacing(SPACING);
 
     lexiconWidget = new LexiconSelectWidget;
+    connect(lexiconWidget->getComboBox(), SIGNAL(activated(const QString&)),
+        SLOT(lexiconActivated(const QString&)));
     mainVlay->addWidget(lexiconWidget);
 
     QHBoxLayout* lineHlay = new QHBoxLayout;
@@ -63,8 +68,9 @@ WordEntryDialog::WordEntryDialog(QWidget* parent, Qt::WFlags f)
     QLabel* label = new QLabel("Word:");
     lineHlay->addWidget(label);
 
-    wordLine = new QLineEdit;
+    wordLine = new WordLineEdit;
     wordLine->setValidator(wordValidator);
+    wordLine->setWordCompletion(true);
     lineHlay->addWidget(wordLine);
 
     // OK/Cancel buttons
@@ -86,6 +92,7 @@ WordEntryDialog::WordEntryDialog(QWidget* parent, Qt::WFlags f)
     buttonHlay->addWidget(cancelButton);
 
     setWindowTitle(DIALOG_CAPTION);
+    lexiconActivated(lexiconWidget->getCurrentLexicon());
     wordLine->setFocus();
 }
 
@@ -99,6 +106,19 @@ WordEntryDialog::~WordEntryDialog()
     delete wordValidator;
 }
 
+//---------------------------------------------------------------------------
+//  getWord
+//
+//! Return the entered word.
+//
+//! @return the entered word
+//---------------------------------------------------------------------------
+QString
+WordEntryDialog::getWord() const
+{
+    return wordLine->text();
+}
+
 //---------------------------------------------------------------------------
 //  getLexicon
 //
@@ -111,3 +131,16 @@ WordEntryDialog::getLexicon() const
 {
     return lexiconWidget->getCurrentLexicon();
 }
+
+//---------------------------------------------------------------------------
+//  lexiconActivated
+//
+//! Called when the lexicon combo box is activated.
+//
+//! @param lexicon the activated lexicon
+//---------------------------------------------------------------------------
+void
+WordEntryDialog::lexiconActivated(const QString& lexicon)
+{
+    wordLine->setWordHints(wordEngine, lexicon);
+}
@@ -26,24 +26,29 @@
 #define ZYZZYVA_WORD_ENTRY_DIALOG_H
 
 #include <QDialog>
-#include <QLineEdit>
 
 class LexiconSelectWidget;
+class WordEngine;
+class WordLineEdit;
 class WordValidator;
 
 class WordEntryDialog : public QDialog
 {
     Q_OBJECT
     public:
-    WordEntryDialog(QWidget* parent = 0, Qt::WFlags f = 0);
+    WordEntryDialog(WordEngine* e, QWidget* parent = 0, Qt::WFlags f = 0);
     ~WordEntryDialog();
 
-    QString getWord() const { return wordLine->text(); }
+    QString getWord() const;
     QString getLexicon() const;
 
+    private slots:
+    void lexiconActivated(const QString& lexicon);
+
     private:
+    WordEngine*    wordEngine;
     LexiconSelectWidget* lexiconWidget;
-    QLineEdit*     wordLine;
+    WordLineEdit*  wordLine;
     WordValidator* wordValidator;
 };
 
@@ -23,10 +23,16 @@
 //---------------------------------------------------------------------------
 
 #include "WordGraph.h"
+#include "LetterBag.h"
+#include "SharedWordGraph.h"
 #include "Defs.h"
 #include <QFile>
 #include <QList>
 #include <QRegExp>
+#include <QSet>
+#include <QThread>
+#include <QtAlgorithms>
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <stack>
@@ -46,13 +52,79 @@ const qint32 M_NODE_POINTER = 0x1FFFFFL;
 using namespace std;
 using namespace Defs;
 
+const int NUM_DRAW_LETTERS = 256;
+
+//---------------------------------------------------------------------------
+//  DrawState
+//
+//! The state of a traversal looking for words that can be drawn from a pool
+//! of tiles.  Each traversal thread has its own copy.
+//---------------------------------------------------------------------------
+class WordGraph::DrawState {
+    public:
+    DrawState() : spec(0), poolBlanks(0), poolSize(0), minLength(1),
+                  maxLength(MAX_WORD_LEN), length(0), blanksUsed(0)
+    {
+        memset(poolCounts, 0, sizeof(poolCounts));
+        memset(wordCounts, 0, sizeof(wordCounts));
+        combos[0] = 1.0;
+    }
+
+    const SearchSpec* spec;
+    int poolCounts[NUM_DRAW_LETTERS];
+    int poolBlanks;
+    int poolSize;
+    int minLength;
+    int maxLength;
+
+    // Reciprocal of (poolSize choose n) for each word length n
+    double drawInverse[MAX_WORD_LEN + 1];
+
+    int wordCounts[NUM_DRAW_LETTERS];
+    char word[MAX_WORD_LEN + 1];
+    int length;
+    int blanksUsed;
+
+    // Ways of drawing the current prefix without blanks, at each depth
+    double combos[MAX_WORD_LEN + 1];
+
+    QMap<QString, double> results;
+};
+
+//---------------------------------------------------------------------------
+//  DrawThread
+//
+//! A thread that traverses part of the word graph, starting from a subset
+//! of the edges leaving the root node.
+//---------------------------------------------------------------------------
+class WordGraph::DrawThread : public QThread {
+    public:
+    DrawThread(const WordGraph* g, const DrawState& s)
+        : graph(g), state(s) { }
+
+    const WordGraph* graph;
+    DrawState state;
+    QList<qint32> rootEdges;
+    QList<const Node*> rootNodes;
+
+    protected:
+    void run() {
+        foreach (qint32 edge, rootEdges)
+            graph->drawEdge(&state, edge);
+        foreach (const Node* node, rootNodes)
+            graph->drawNodeOld(&state, node);
+    }
+};
+
 //---------------------------------------------------------------------------
 //  WordGraph
 //
 //! Constructor.
 //---------------------------------------------------------------------------
 WordGraph::WordGraph()
-    : dawg(0), rdawg(0), top(0), rtop(0), numWords(0)
+    : dawg(0), rdawg(0), dawgOwned(true), rdawgOwned(true), dawgMasks(0),
+      rdawgMasks(0), lexiconMask(0), addedWords(0), top(0), rtop(0),
+      numWords(0)
 {
     // Test for endianness
     char endianTest[2] = { 1, 0 };
@@ -67,6 +139,7 @@ WordGraph::WordGraph()
 WordGraph::~WordGraph()
 {
     clear();
+    delete addedWords;
 }
 
 //---------------------------------------------------------------------------
@@ -77,12 +150,19 @@ WordGraph::~WordGraph()
 void
 WordGraph::clear()
 {
-    if (dawg)
+    if (dawg && dawgOwned)
         delete[] dawg;
-    if (rdawg)
+    if (rdawg && rdawgOwned)
         delete[] rdawg;
     dawg = 0;
     rdawg = 0;
+    dawgOwned = true;
+    rdawgOwned = true;
+    dawgMasks = 0;
+    rdawgMasks = 0;
+    lexiconMask = 0;
+    countOffsets.clear();
+    suffixCounts.clear();
 }
 
 //---------------------------------------------------------------------------
@@ -118,6 +198,7 @@ WordGraph::importDawgFile(const QString& filename, bool reverse, QString*
 
     if (reverse) {
         rdawg = new qint32[numEdges + 1];
+        rdawgMasks = 0;
         rdawg[0] = 0;
         p = &rdawg[1];
         cp = (char*) p;
@@ -125,6 +206,7 @@ WordGraph::importDawgFile(const QString& filename, bool reverse, QString*
     }
     else {
         dawg = new qint32[numEdges + 1];
+        dawgMasks = 0;
         dawg[0] = 0;
         p = &dawg[1];
         cp = (char*) p;
@@ -146,9 +228,203 @@ WordGraph::importDawgFile(const QString& filename, bool reverse, QString*
     if (bigEndian)
         convertEndian(p, numEdges);
 
+    if (!reverse)
+        buildWordCounts(numEdges);
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  importDawgData
+//
+//! Use an edge array already in memory, such as one mapped from a lexicon
+//! bundle.  The array is stored little-endian and begins with the terminal
+//! entry.  On little-endian machines the array is used in place and must
+//! remain valid for the lifetime of the graph; otherwise a converted copy is
+//! made.
+//
+//! @param data the edge array
+//! @param numEdges the number of edges, not counting the terminal entry
+//! @param reverse whether the DAWG contains reversed words
+//---------------------------------------------------------------------------
+void
+WordGraph::importDawgData(const qint32* data, qint32 numEdges, bool reverse)
+{
+    qint32* edges = const_cast<qint32*>(data);
+    bool owned = false;
+    if (bigEndian) {
+        edges = new qint32[numEdges + 1];
+        memcpy(edges, data, (numEdges + 1) * sizeof(qint32));
+        convertEndian(edges, numEdges + 1);
+        owned = true;
+    }
+
+    if (reverse) {
+        if (rdawg && rdawgOwned)
+            delete[] rdawg;
+        rdawg = edges;
+        rdawgOwned = owned;
+        rdawgMasks = 0;
+    }
+    else {
+        if (dawg && dawgOwned)
+            delete[] dawg;
+        dawg = edges;
+        dawgOwned = owned;
+        dawgMasks = 0;
+        buildWordCounts(numEdges);
+    }
+}
+
+//---------------------------------------------------------------------------
+//  importSharedGraph
+//
+//! Use the edges of a graph shared with other lexicons, ignoring the edges
+//! that lead to no words of this lexicon.  The shared graph must remain
+//! valid for the lifetime of this graph or until another graph is imported.
+//
+//! @param shared the shared graph
+//! @param lexicon the name of this lexicon in the shared graph
+//! @return true if successful, false if the shared graph does not contain
+//! the lexicon
+//---------------------------------------------------------------------------
+bool
+WordGraph::importSharedGraph(const SharedWordGraph* shared, const QString&
+                             lexicon)
+{
+    int index = shared ? shared->getLexiconIndex(lexicon) : -1;
+    if (index < 0)
+        return false;
+
+    qint32 numEdges = 0;
+    qint32 numReverseEdges = 0;
+    const qint32* edges = shared->getEdges(false, &numEdges);
+    const qint32* reverseEdges = shared->getEdges(true, &numReverseEdges);
+    if (!edges || !reverseEdges)
+        return false;
+
+    clear();
+    dawg = const_cast<qint32*>(edges);
+    rdawg = const_cast<qint32*>(reverseEdges);
+    dawgOwned = false;
+    rdawgOwned = false;
+    dawgMasks = shared->getMasks(false);
+    rdawgMasks = shared->getMasks(true);
+    lexiconMask = (1 << index);
+    buildWordCounts(numEdges);
     return true;
 }
 
+//---------------------------------------------------------------------------
+//  importBaseGraph
+//
+//! Use the edges of another graph without copying them, so that an overlay
+//! can be laid over the words of the other graph.  The other graph must
+//! remain valid for the lifetime of this graph or until another graph is
+//! imported.  Any overlay of this graph is kept.
+//
+//! @param base the base graph
+//! @return true if successful, false if the base graph has no DAWG
+//---------------------------------------------------------------------------
+bool
+WordGraph::importBaseGraph(const WordGraph* base)
+{
+    if (!base || !base->dawg || !base->rdawg || (base == this))
+        return false;
+
+    clear();
+    dawg = base->dawg;
+    rdawg = base->rdawg;
+    dawgOwned = false;
+    rdawgOwned = false;
+    dawgMasks = base->dawgMasks;
+    rdawgMasks = base->rdawgMasks;
+    lexiconMask = base->lexiconMask;
+    countOffsets = base->countOffsets;
+    suffixCounts = base->suffixCounts;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  setOverlay
+//
+//! Add words to the graph and remove words from it without rebuilding it.
+//! Additions take precedence over deletions.  Any earlier overlay is
+//! replaced.
+//
+//! @param additions the words to add
+//! @param deletions the words to remove
+//---------------------------------------------------------------------------
+void
+WordGraph::setOverlay(const QStringList& additions, const QStringList&
+                      deletions)
+{
+    delete addedWords;
+    addedWords = 0;
+    deletedWords.clear();
+
+    if (!additions.isEmpty()) {
+        addedWords = new WordGraph;
+        foreach (const QString& word, additions)
+            addedWords->addWord(word.toUpper());
+    }
+
+    foreach (const QString& word, deletions) {
+        QString upper = word.toUpper();
+        if (FixedWord::canHold(upper))
+            deletedWords.append(FixedWord(upper));
+    }
+    qSort(deletedWords);
+}
+
+//---------------------------------------------------------------------------
+//  isDeleted
+//
+//! Determine whether the overlay removes a word.
+//
+//! @param word the word, in upper case
+//! @return true if the word is deleted, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::isDeleted(const QString& word) const
+{
+    if (deletedWords.isEmpty() || !FixedWord::canHold(word))
+        return false;
+
+    return (qBinaryFind(deletedWords, FixedWord(word)) !=
+            deletedWords.constEnd());
+}
+
+//---------------------------------------------------------------------------
+//  edgeAt
+//
+//! Return an edge of the forward or reverse graph as seen by this lexicon.
+//! In a shared graph, the end of word flag and the child pointer are
+//! cleared where they do not apply to this lexicon, and an edge that leads
+//! to no words of this lexicon has its letter cleared as well.
+//
+//! @param graph the forward or reverse edge array
+//! @param edge the index of the edge
+//! @return the edge value
+//---------------------------------------------------------------------------
+inline qint32
+WordGraph::edgeAt(const qint32* graph, qint32 edge) const
+{
+    qint32 value = graph[edge];
+    const quint16* masks = (graph == rdawg) ? rdawgMasks : dawgMasks;
+    if (!masks)
+        return value;
+
+    quint16 mask = masks[edge];
+    if (!(mask & lexiconMask))
+        value &= ~M_NODE_POINTER;
+    if (!((mask >> 8) & lexiconMask))
+        value &= ~M_END_OF_WORD;
+    if (!(value & (M_NODE_POINTER | M_END_OF_WORD)))
+        value &= M_END_OF_NODE;
+    return value;
+}
+
 //---------------------------------------------------------------------------
 //  addWord
 //
@@ -171,12 +447,31 @@ WordGraph::addWord(const QString& w)
 //---------------------------------------------------------------------------
 //  containsWord
 //
-//! Determine whether the graph contains a word.
+//! Determine whether the graph contains a word, taking the overlay into
+//! account.
 //
 //! @param w the word to search for
 //---------------------------------------------------------------------------
 bool
 WordGraph::containsWord(const QString& w) const
+{
+    if (addedWords && addedWords->containsWord(w))
+        return true;
+    if (isDeleted(w))
+        return false;
+
+    return containsGraphWord(w);
+}
+
+//---------------------------------------------------------------------------
+//  containsGraphWord
+//
+//! Determine whether the graph itself contains a word, ignoring the overlay.
+//
+//! @param w the word to search for
+//---------------------------------------------------------------------------
+bool
+WordGraph::containsGraphWord(const QString& w) const
 {
     if (w.isEmpty())
         return false;
@@ -192,19 +487,20 @@ WordGraph::containsWord(const QString& w) const
             return false;
 
         QChar letter = w.at(i);
-        for (qint32* edge = &dawg[node]; ; ++edge) {
-            qint32 lc = *edge;
+        for (qint32 edge = node; ; ++edge) {
+            qint32 value = edgeAt(dawg, edge);
+            qint32 lc = value;
             lc = lc >> V_LETTER;
             lc = lc & M_LETTER;
             char c = (char) lc;
 
             if (letter == c) {
-                node = (*edge & M_NODE_POINTER);
-                eow = (*edge & M_END_OF_WORD);
+                node = (value & M_NODE_POINTER);
+                eow = (value & M_END_OF_WORD);
                 break;
             }
 
-            if (*edge & M_END_OF_NODE)
+            if (value & M_END_OF_NODE)
                 return false;
         }
     }
@@ -215,21 +511,319 @@ WordGraph::containsWord(const QString& w) const
 //---------------------------------------------------------------------------
 //  search
 //
-//! Search for acceptable words matching a search specification.
+//! Search for acceptable words matching a search specification, taking the
+//! overlay into account.
 //
 //! @param spec the search specification
 //! @return a list of acceptable words
 //---------------------------------------------------------------------------
 QStringList
 WordGraph::search(const SearchSpec& spec) const
+{
+    QStringList wordList = searchGraph(spec);
+    if (!hasOverlay())
+        return wordList;
+
+    // Keep the words sorted by their upper case forms, as the graph search
+    // does
+    QMap<QString, QString> words;
+    foreach (const QString& word, wordList) {
+        QString upper = word.toUpper();
+        if (!isDeleted(upper))
+            words.insert(upper, word);
+    }
+    if (addedWords) {
+        foreach (const QString& word, addedWords->search(spec))
+            words.insert(word.toUpper(), word);
+    }
+    return words.values();
+}
+
+//---------------------------------------------------------------------------
+//  searchGraph
+//
+//! Search the graph itself for words matching a search specification,
+//! ignoring the overlay.
+//
+//! @param spec the search specification
+//! @return a list of acceptable words
+//---------------------------------------------------------------------------
+QStringList
+WordGraph::searchGraph(const SearchSpec& spec) const
 {
     QStringList wordList;
     if (spec.conditions.empty())
         return wordList;
 
+    QListIterator<SearchCondition> dit (spec.conditions);
+    while (dit.hasNext()) {
+        if (dit.next().type == SearchCondition::DrawProbability)
+            return searchDraws(spec);
+    }
+
     if (!dawg)
         return searchOld(spec);
 
+    // Only replace wildcard matches with lower case letters if there is
+    // exactly one pattern using wildcards
+    // XXX: Commented out because it may be a reasonable default to use the
+    // lower case lettering as matched by the first such condition
+    //bool wildcardLower =(numWildcardConditions == 1);
+    bool wildcardLower = true;
+
+    map<FixedWord, FixedWord> finalWordSet;
+    map<FixedWord, FixedWord>::iterator sit;
+    collectWords(spec, &finalWordSet);
+
+    // Transform word set into word list and return it
+    for (sit = finalWordSet.begin(); sit != finalWordSet.end(); ++sit) {
+        wordList << (wildcardLower ? sit->second.toString()
+                                   : sit->first.toString());
+    }
+
+    return wordList;
+}
+
+//---------------------------------------------------------------------------
+//  countWords
+//
+//! Count the words matching a search specification.  Simple patterns are
+//! counted from the word counts stored for each node without building any
+//! words.  Specifications with a single match condition that matches each
+//! word in only one way are counted during the traversal, and others are
+//! counted from the full search.
+//
+//! @param spec the search specification
+//! @return the number of matching words
+//---------------------------------------------------------------------------
+int
+WordGraph::countWords(const SearchSpec& spec) const
+{
+    if (spec.conditions.empty())
+        return 0;
+
+    if (hasOverlay())
+        return search(spec).count();
+
+    int count = 0;
+    if (dawg && countSimplePattern(spec, &count))
+        return count;
+
+    QListIterator<SearchCondition> dit (spec.conditions);
+    while (dit.hasNext()) {
+        if (dit.next().type == SearchCondition::DrawProbability)
+            return searchDraws(spec).count();
+    }
+
+    if (!dawg)
+        return searchOld(spec).count();
+
+    int numMatchConditions = 0;
+    bool countable = true;
+    QListIterator<SearchCondition> mit (spec.conditions);
+    while (mit.hasNext()) {
+        const SearchCondition& condition = mit.next();
+        if ((condition.type != SearchCondition::PatternMatch) &&
+            (condition.type != SearchCondition::AnagramMatch) &&
+            (condition.type != SearchCondition::SubanagramMatch))
+        {
+            continue;
+        }
+        ++numMatchConditions;
+        if (condition.negated || !matchesOnce(condition))
+            countable = false;
+    }
+
+    if (countable && (numMatchConditions <= 1)) {
+        collectWords(spec, 0, &count);
+        return count;
+    }
+
+    map<FixedWord, FixedWord> finalWordSet;
+    collectWords(spec, &finalWordSet);
+    return finalWordSet.size();
+}
+
+//---------------------------------------------------------------------------
+//  matchesOnce
+//
+//! Determine whether the traversal in collectWords can reach each word
+//! matching a condition in only one way, so matching words can be counted
+//! without checking for duplicates.  This holds for patterns with at most
+//! one wildcard string, and for anagrams and subanagrams without character
+//! classes.
+//
+//! @param condition the Pattern, Anagram or Subanagram match condition
+//! @return true if each word is matched only once, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::matchesOnce(const SearchCondition& condition)
+{
+    QString match = condition.stringValue;
+    if (condition.type == SearchCondition::PatternMatch) {
+        match.replace(QRegExp("\\*+"), "*");
+        return (match.count('*') <= 1);
+    }
+    return !match.contains('[');
+}
+
+//---------------------------------------------------------------------------
+//  countSimplePattern
+//
+//! Count the words matching a specification made only of Length conditions
+//! and at most one Pattern match anchored at the start of the word, with
+//! wildcards allowed only at the end.  Such a pattern matches each word in
+//! exactly one way, so the matching paths can be counted directly.
+//
+//! @param spec the search specification
+//! @param count return the number of matching words
+//! @return true if the specification could be counted, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::countSimplePattern(const SearchSpec& spec, int* count) const
+{
+    if (countOffsets.isEmpty() || !count)
+        return false;
+
+    int minLength = 0;
+    int maxLength = MAX_WORD_LEN;
+    QString pattern;
+    bool havePattern = false;
+
+    QListIterator<SearchCondition> it (spec.conditions);
+    while (it.hasNext()) {
+        const SearchCondition& condition = it.next();
+        switch (condition.type) {
+            case SearchCondition::Length:
+            minLength = qMax(minLength, condition.minValue);
+            maxLength = qMin(maxLength, condition.maxValue);
+            break;
+
+            case SearchCondition::PatternMatch:
+            if (condition.negated || havePattern)
+                return false;
+            pattern = condition.stringValue;
+            havePattern = true;
+            break;
+
+            default:
+            return false;
+        }
+    }
+
+    pattern.replace(QRegExp("\\*+"), "*");
+    if (pattern.isEmpty())
+        pattern = "*";
+
+    bool tailWildcard = pattern.endsWith("*");
+    if (tailWildcard)
+        pattern.chop(1);
+    if (pattern.contains("*"))
+        return false;
+
+    // Split the pattern into one match string per letter position
+    QStringList letters;
+    for (int i = 0; i < pattern.length(); ++i) {
+        if (pattern.at(i) == '[') {
+            int closeIndex = pattern.indexOf(']', i);
+            if (closeIndex < 0)
+                return false;
+            letters.append(pattern.mid(i, closeIndex - i + 1));
+            i = closeIndex;
+        }
+        else
+            letters.append(pattern.at(i));
+    }
+
+    if (letters.isEmpty()) {
+        *count = tailWildcard ? countSuffixes(ROOT_NODE, minLength, maxLength)
+                              : 0;
+    }
+    else {
+        *count = countPatternPaths(ROOT_NODE, 0, letters, tailWildcard,
+                                   minLength, maxLength);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  countPatternPaths
+//
+//! Count the words below a node matching the remainder of a simple pattern.
+//
+//! @param node the node
+//! @param depth the number of letters already matched
+//! @param letters the match string for each letter position
+//! @param tailWildcard whether the pattern ends with a wildcard
+//! @param minLength the minimum word length
+//! @param maxLength the maximum word length
+//! @return the number of matching words
+//---------------------------------------------------------------------------
+int
+WordGraph::countPatternPaths(qint32 node, int depth, const QStringList&
+                             letters, bool tailWildcard, int minLength, int
+                             maxLength) const
+{
+    const QString& match = letters.at(depth);
+    bool matchClass = match.startsWith("[");
+    bool matchNegated = matchClass && match.contains("^");
+    bool lastLetter = (depth == letters.size() - 1);
+    int length = depth + 1;
+    int count = 0;
+
+    for (qint32 edge = node; ; ++edge) {
+        qint32 value = edgeAt(dawg, edge);
+        QChar letter = (char) ((value >> V_LETTER) & M_LETTER);
+
+        bool matched = (match == "?") ||
+            (matchClass ? (match.contains(letter) ^ matchNegated)
+                        : (match.at(0) == letter));
+
+        if (matched) {
+            qint32 child = value & M_NODE_POINTER;
+            if (lastLetter) {
+                if ((value & M_END_OF_WORD) && (length >= minLength) &&
+                    (length <= maxLength))
+                    ++count;
+                if (tailWildcard && child) {
+                    count += countSuffixes(child, minLength - length,
+                                           maxLength - length);
+                }
+            }
+            else if (child && (length < maxLength)) {
+                count += countPatternPaths(child, depth + 1, letters,
+                                           tailWildcard, minLength,
+                                           maxLength);
+            }
+        }
+
+        if (value & M_END_OF_NODE)
+            break;
+    }
+    return count;
+}
+
+//---------------------------------------------------------------------------
+//  collectWords
+//
+//! Find the words matching the pattern, anagram and subanagram conditions of
+//! a search specification by traversing the word graph.  Each word is keyed
+//! by its uppercase form and mapped to its form with wildcard matches in
+//! lower case.  If a count is requested instead, the matching words are
+//! counted as they are found without being stored; this is only possible if
+//! the spec has at most one match condition, and matchesOnce is true for it.
+//
+//! @param spec the search specification
+//! @param words return the matching words, or null if counting
+//! @param count return the number of matching words, or null if collecting
+//---------------------------------------------------------------------------
+void
+WordGraph::collectWords(const SearchSpec& spec, map<FixedWord, FixedWord>*
+                        words, int* count) const
+{
+    if (count)
+        *count = 0;
+
     QList<SearchCondition> posMatchConditions;
     QList<SearchCondition> negMatchConditions;
     int maxLength = MAX_WORD_LEN;
@@ -267,13 +861,6 @@ WordGraph::search(const SearchSpec& spec) const
         }
     }
 
-    // Only replace wildcard matches with lower case letters if there is
-    // exactly one pattern using wildcards
-    // XXX: Commented out because it may be a reasonable default to use the
-    // lower case lettering as matched by the first such condition
-    //bool wildcardLower =(numWildcardConditions == 1);
-    bool wildcardLower = true;
-
     // If no match condition was specified, search for all words matching the
     // other conditions
     if (posMatchConditions.empty()) {
@@ -283,8 +870,9 @@ WordGraph::search(const SearchSpec& spec) const
         posMatchConditions.append(condition);
     }
 
-    map<QString, QString> finalWordSet;
-    map<QString, QString>::iterator sit;
+    map<FixedWord, FixedWord> noWords;
+    map<FixedWord, FixedWord>& finalWordSet = words ? *words : noWords;
+    map<FixedWord, FixedWord>::iterator sit;
     int conditionNum = 0;
 
     // Search for each condition separately, and take the conjunction or
@@ -299,9 +887,9 @@ WordGraph::search(const SearchSpec& spec) const
 
         // Use set to eliminate duplicates since patterns with wildcards may
         // match the same word in more than one way
-        map<QString, QString> wordSet;
+        map<FixedWord, FixedWord> wordSet;
         stack <TraversalState> states;
-        QString word;
+        FixedWord word;
 
         bool wildcard = false;
         bool reversePattern = false;
@@ -349,7 +937,7 @@ WordGraph::search(const SearchSpec& spec) const
 
             // Stop if word is at max length
             if (int(word.length()) < maxLength) {
-                QString origWord = word;
+                FixedWord origWord = word;
                 QString origUnmatched = unmatched;
 
                 QString match;
@@ -371,18 +959,19 @@ WordGraph::search(const SearchSpec& spec) const
                     }
                 }
 
-                qint32* edge = reversePattern ? &rdawg[node] : &dawg[node];
+                const qint32* graph = reversePattern ? rdawg : dawg;
 
                 // Traverse next nodes, looking for matches
-                for (; ; ++edge) {
-                    qint32 longLetter = *edge;
+                for (qint32 edge = node; ; ++edge) {
+                    qint32 value = edgeAt(graph, edge);
+                    qint32 longLetter = value;
                     longLetter = longLetter >> V_LETTER;
                     longLetter = longLetter & M_LETTER;
 
                     QChar letter = (char) longLetter;
 
                     if (excludeLetters.contains(letter)) {
-                        if (*edge & M_END_OF_NODE)
+                        if (value & M_END_OF_NODE)
                             break;
                         else
                             continue;
@@ -404,15 +993,15 @@ WordGraph::search(const SearchSpec& spec) const
 
                         if ((match == "*") || (match == "?") ||
                             (matchLetter ^ matchNegated))
-                            word += c;
+                            word += c.toLatin1();
                         else {
-                            if (*edge & M_END_OF_NODE)
+                            if (value & M_END_OF_NODE)
                                 break;
                             else
                                 continue;
                         }
 
-                        qint32 child = *edge & M_NODE_POINTER;
+                        qint32 child = value & M_NODE_POINTER;
 
                         // If this node matches, push its child on the stack
                         // to be traversed later
@@ -432,20 +1021,26 @@ WordGraph::search(const SearchSpec& spec) const
                         // If end of word and end of pattern, put the word in
                         // the list.  If we are searching the reverse list,
                         // reverse the word first.
-                        QString wordUpper = word.toUpper();
-                        if (reversePattern)
-                            wordUpper = reverseString(wordUpper);
-
-                        if ((*edge & M_END_OF_WORD) &&
+                        if ((value & M_END_OF_WORD) &&
                             ((int(unmatched.length()) == closeIndex + 1) ||
                             ((int(unmatched.length()) == closeIndex + 2) &&
-                             (QChar(unmatched.at(closeIndex + 1)) == '*'))) &&
-                            matchesSpec(wordUpper, spec) &&
-                            !wordSet.count(wordUpper))
+                             (QChar(unmatched.at(closeIndex + 1)) == '*'))))
                         {
-                            wordSet.insert(make_pair(wordUpper,
-                                reversePattern ? reverseString(word)
-                                               : word));
+                            FixedWord wordUpper = word.toUpper();
+                            if (reversePattern)
+                                wordUpper = wordUpper.reversed();
+
+                            if (count) {
+                                if (matchesSpec(wordUpper.toString(), spec))
+                                    ++*count;
+                            }
+                            else if (!wordSet.count(wordUpper) &&
+                                     matchesSpec(wordUpper.toString(), spec))
+                            {
+                                wordSet.insert(make_pair(wordUpper,
+                                    reversePattern ? word.reversed()
+                                                   : word));
+                            }
                         }
                     }
 
@@ -486,7 +1081,7 @@ WordGraph::search(const SearchSpec& spec) const
 
                                 else if (c == ']') {
                                     if (found ^ negated) {
-                                        qint32 child = *edge & M_NODE_POINTER;
+                                        qint32 child = value & M_NODE_POINTER;
 
                                         if (matchEnd < 0) {
                                             matchStart = groupStart;
@@ -496,7 +1091,7 @@ WordGraph::search(const SearchSpec& spec) const
 
                                         else if (child) {
                                             states.push(TraversalState(child,
-                                                word + letter,
+                                                word + letter.toLatin1(),
                                                 unmatched.left(groupStart) +
                                                 unmatched.right(
                                                 unmatched.length() - i - 1)));
@@ -535,15 +1130,16 @@ WordGraph::search(const SearchSpec& spec) const
                         // keep traversing after possibly adding the current
                         // word.
                         if (found || wildcard) {
-                            word += (found && !wildcardMatch) ? QChar(letter)
-                                : QChar(letter).toLower();
+                            word += (found && !wildcardMatch)
+                                ? letter.toLatin1()
+                                : letter.toLower().toLatin1();
 
                             if (found)
                                 unmatched.replace(matchStart,
                                                   matchEnd - matchStart + 1,
                                                   QString());
 
-                            qint32 child = *edge & M_NODE_POINTER;
+                            qint32 child = value & M_NODE_POINTER;
                             if (child &&
                                 (wildcard || !unmatched.isEmpty()))
                             {
@@ -551,20 +1147,31 @@ WordGraph::search(const SearchSpec& spec) const
                                                            unmatched));
                             }
 
-                            QString wordUpper = word.toUpper();
-                            if ((*edge & M_END_OF_WORD) &&
+                            if ((value & M_END_OF_WORD) &&
                                 ((condition.type ==
                                   SearchCondition::SubanagramMatch) ||
-                                  unmatched.isEmpty()) &&
-                                  matchesSpec(wordUpper, spec) &&
-                                  !wordSet.count(wordUpper))
+                                  unmatched.isEmpty()))
                             {
-                                wordSet.insert(make_pair(wordUpper, word));
+                                FixedWord wordUpper = word.toUpper();
+                                if (count) {
+                                    if (matchesSpec(wordUpper.toString(),
+                                                    spec))
+                                    {
+                                        ++*count;
+                                    }
+                                }
+                                else if (!wordSet.count(wordUpper) &&
+                                         matchesSpec(wordUpper.toString(),
+                                                     spec))
+                                {
+                                    wordSet.insert(make_pair(wordUpper,
+                                                             word));
+                                }
                             }
                         }
                     }
 
-                    if (*edge & M_END_OF_NODE)
+                    if (value & M_END_OF_NODE)
                         break;
                 }
             }
@@ -580,15 +1187,18 @@ WordGraph::search(const SearchSpec& spec) const
             }
         }
 
+        if (count)
+            return;
+
         // Take conjunction or disjunction with final result set
         if (!conditionNum) {
             finalWordSet = wordSet;
         }
 
         else if (spec.conjunction) {
-            map<QString, QString> conjunctionSet;
+            map<FixedWord, FixedWord> conjunctionSet;
             for (sit = wordSet.begin(); sit != wordSet.end(); ++sit) {
-                map<QString, QString>::iterator found =
+                map<FixedWord, FixedWord>::iterator found =
                     finalWordSet.find(sit->first);
                 if (found != finalWordSet.end()) {
                     if (negated)
@@ -598,105 +1208,747 @@ WordGraph::search(const SearchSpec& spec) const
                 }
             }
             if (!negated) {
-                if (conjunctionSet.empty())
-                    return wordList;
+                if (conjunctionSet.empty()) {
+                    finalWordSet.clear();
+                    return;
+                }
                 finalWordSet = conjunctionSet;
             }
         }
 
-        else {
-            // FIXME: disjunction is broken for negated conditions! Fix this
-            // when disjunction is enabled in the UI.
-            for (sit = wordSet.begin(); sit != wordSet.end(); ++sit) {
-                finalWordSet.insert(*sit);
-            }
+        else {
+            // FIXME: disjunction is broken for negated conditions! Fix this
+            // when disjunction is enabled in the UI.
+            for (sit = wordSet.begin(); sit != wordSet.end(); ++sit) {
+                finalWordSet.insert(*sit);
+            }
+        }
+
+        ++conditionNum;
+    }
+}
+
+//---------------------------------------------------------------------------
+//  getNumWords
+//
+//! Return the number of words in the graph.
+//
+//! @return the number of words
+//---------------------------------------------------------------------------
+int
+WordGraph::getNumWords() const
+{
+    int count = 0;
+    if (!dawg)
+        count = numWords;
+    else if (countOffsets.isEmpty())
+        count = getNumWords(ROOT_NODE);
+    else {
+        count = countSuffixes(ROOT_NODE, 0, suffixCounts.at(countOffsets.at(
+                                                           ROOT_NODE)));
+    }
+
+    if (!hasOverlay())
+        return count;
+
+    foreach (const FixedWord& word, deletedWords) {
+        if (containsGraphWord(word.toString()))
+            --count;
+    }
+    if (addedWords) {
+        SearchCondition condition;
+        condition.type = SearchCondition::Length;
+        condition.minValue = 1;
+        condition.maxValue = MAX_WORD_LEN;
+        SearchSpec spec;
+        spec.conditions.append(condition);
+        foreach (const QString& word, addedWords->search(spec)) {
+            if (!containsGraphWord(word) || isDeleted(word))
+                ++count;
+        }
+    }
+    return count;
+}
+
+//---------------------------------------------------------------------------
+//  getLetters
+//
+//! Return the letters used by the words of the graph, including words added
+//! by an overlay.  The edges are walked once each, without forming words.
+//
+//! @return the letters, in character order
+//---------------------------------------------------------------------------
+QString
+WordGraph::getLetters() const
+{
+    bool used[256];
+    memset(used, 0, sizeof(used));
+
+    if (dawg) {
+        // Nodes of a DAWG are shared by many prefixes, so visit each once
+        QSet<qint32> visited;
+        QVector<qint32> pending;
+        pending.append(ROOT_NODE);
+        visited.insert(ROOT_NODE);
+        while (!pending.isEmpty()) {
+            qint32 node = pending.last();
+            pending.pop_back();
+            for (qint32 edge = node; ; ++edge) {
+                qint32 value = edgeAt(dawg, edge);
+                if (value & (M_NODE_POINTER | M_END_OF_WORD))
+                    used[(value >> V_LETTER) & M_LETTER] = true;
+                qint32 child = value & M_NODE_POINTER;
+                if (child && !visited.contains(child)) {
+                    visited.insert(child);
+                    pending.append(child);
+                }
+                if (value & M_END_OF_NODE)
+                    break;
+            }
+        }
+    }
+    else
+        collectLetters(top, used);
+
+    if (addedWords) {
+        foreach (const QChar& c, addedWords->getLetters())
+            used[c.unicode()] = true;
+    }
+
+    QString letters;
+    for (int i = 1; i < 256; ++i) {
+        if (used[i])
+            letters += QChar(ushort(i));
+    }
+    return letters;
+}
+
+//---------------------------------------------------------------------------
+//  matchesSpec
+//
+//! Determine whether a word matches a search specification.  Only the
+//! following attributes are checked: Include Letters, Consist Letters/Pct,
+//! Min Length, Min Anagrams, Max Anagrams, Min Probability, Max Probability.
+//! All other attributes are assumed to have been checked in the course of
+//! finding the word to be checked.
+//---------------------------------------------------------------------------
+bool
+WordGraph::matchesSpec(QString word, const SearchSpec& spec) const
+{
+    // Letter counts of the word, filled in when first needed.  Words in the
+    // graph are Latin-1, so every letter has a slot.
+    int letterCounts[256];
+    bool countsFilled = false;
+    int wordLen = word.length();
+
+    QListIterator<SearchCondition> it (spec.conditions);
+    while (it.hasNext()) {
+        const SearchCondition& condition = it.next();
+
+        switch (condition.type) {
+            case SearchCondition::Length:
+            if ((wordLen < condition.minValue) ||
+                (wordLen > condition.maxValue))
+                return false;
+            break;
+
+            case SearchCondition::IncludeLetters: {
+                if (!countsFilled) {
+                    memset(letterCounts, 0, sizeof(letterCounts));
+                    for (int i = 0; i < wordLen; ++i)
+                        ++letterCounts[uchar(word.at(i).toLatin1())];
+                    countsFilled = true;
+                }
+
+                // Take each included letter out of a copy of the counts
+                int counts[256];
+                memcpy(counts, letterCounts, sizeof(counts));
+                int includeLen = condition.stringValue.length();
+                for (int i = 0; i < includeLen; ++i) {
+                    QChar c = condition.stringValue.at(i);
+                    int& count = counts[uchar(c.toLatin1())];
+                    bool found = (c.unicode() <= 0xff) && (count > 0);
+                    if (!found ^ condition.negated)
+                        return false;
+                    if (found)
+                        --count;
+                }
+            }
+            break;
+
+            case SearchCondition::ConsistOf:
+            if (!matchesCondition(word, condition))
+                return false;
+            break;
+
+            // XXX: Implement these!
+            //case SearchCondition::NumAnagrams:
+            //case SearchCondition::Probability:
+
+            default: break;
+        }
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  matchesCondition
+//
+//! Determine whether a word matches a Pattern, Anagram, Subanagram or Consist
+//! Of condition, by examining the word alone rather than searching the
+//! graph.  The negation of the condition is not applied.  Conditions of
+//! other types are always matched.
+//
+//! @param word the word, in upper case
+//! @param condition the condition
+//! @return true if the word matches the condition, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::matchesCondition(const QString& word, const SearchCondition&
+                            condition)
+{
+    switch (condition.type) {
+        case SearchCondition::PatternMatch: {
+            QString pattern = condition.stringValue.toUpper();
+            if (pattern.isEmpty())
+                return true;
+            pattern.replace(QRegExp("\\*+"), "*");
+            return matchesPattern(word, 0, pattern, 0);
+        }
+
+        case SearchCondition::AnagramMatch:
+        case SearchCondition::SubanagramMatch: {
+            bool anagram = (condition.type == SearchCondition::AnagramMatch);
+            QString pattern = condition.stringValue.toUpper();
+            QString exact;
+            QStringList sets;
+            int blanks = 0;
+            bool wildcard = false;
+            int patternLen = pattern.length();
+            for (int i = 0; i < patternLen; ++i) {
+                QChar c = pattern.at(i);
+                if (c == '*')
+                    wildcard = true;
+                else if (c == '?')
+                    ++blanks;
+                else if (c == '[') {
+                    int close = pattern.indexOf(']', i);
+                    if (close < 0)
+                        close = patternLen;
+                    sets.append(pattern.mid(i + 1, close - i - 1));
+                    i = close;
+                }
+                else
+                    exact += c;
+            }
+
+            int wordLen = word.length();
+            int numElements = exact.length() + sets.count() + blanks;
+            if ((anagram && (wordLen < numElements)) ||
+                (!wildcard && (wordLen > numElements)))
+            {
+                return false;
+            }
+
+            // A letter is always best matched by itself, so only the
+            // letters left over need to be fitted to the other elements
+            QString leftover;
+            foreach (const QChar& c, word) {
+                int index = exact.indexOf(c);
+                if (index >= 0)
+                    exact.remove(index, 1);
+                else
+                    leftover += c;
+            }
+            if (anagram && !exact.isEmpty())
+                return false;
+            return matchesLetterSets(leftover, 0, &sets, blanks, wildcard,
+                                     anagram);
+        }
+
+        case SearchCondition::ConsistOf: {
+            if ((condition.minValue <= 0) && (condition.maxValue >= 100))
+                return true;
+
+            bool consistLetters[256];
+            memset(consistLetters, 0, sizeof(consistLetters));
+            foreach (const QChar& c, condition.stringValue) {
+                if (c.unicode() <= 0xff)
+                    consistLetters[c.unicode()] = true;
+            }
+
+            int wordLen = word.length();
+            if (!wordLen)
+                return false;
+            int consist = 0;
+            for (int i = 0; i < wordLen; ++i)
+                consist += consistLetters[uchar(word.at(i).toLatin1())];
+            int consistPct = (consist * 100) / wordLen;
+            return ((consistPct >= condition.minValue) &&
+                    (consistPct <= condition.maxValue));
+        }
+
+        default:
+        return true;
+    }
+}
+
+//---------------------------------------------------------------------------
+//  matchesPattern
+//
+//! Determine whether the rest of a word matches the rest of a pattern.
+//
+//! @param word the word
+//! @param wordPos the position in the word to match from
+//! @param pattern the pattern, with runs of '*' collapsed
+//! @param patternPos the position in the pattern to match from
+//! @return true if the word matches, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::matchesPattern(const QString& word, int wordPos, const QString&
+                          pattern, int patternPos)
+{
+    int wordLen = word.length();
+    int patternLen = pattern.length();
+    while (patternPos < patternLen) {
+        QChar p = pattern.at(patternPos);
+        if (p == '*') {
+            for (int i = wordPos; i <= wordLen; ++i) {
+                if (matchesPattern(word, i, pattern, patternPos + 1))
+                    return true;
+            }
+            return false;
+        }
+
+        if (wordPos >= wordLen)
+            return false;
+
+        QChar c = word.at(wordPos);
+        bool match = false;
+        if (p == '?')
+            match = true;
+        else if (p == '[') {
+            int close = pattern.indexOf(']', patternPos);
+            if (close < 0)
+                close = patternLen;
+            bool negated = ((patternPos + 1 < patternLen) &&
+                            (pattern.at(patternPos + 1) == '^'));
+            int start = patternPos + (negated ? 2 : 1);
+            match = (pattern.mid(start, close - start).contains(c) ^
+                     negated);
+            patternPos = close;
+        }
+        else
+            match = (p == c);
+
+        if (!match)
+            return false;
+        ++wordPos;
+        ++patternPos;
+    }
+
+    return (wordPos == wordLen);
+}
+
+//---------------------------------------------------------------------------
+//  matchesLetterSets
+//
+//! Determine whether letters left over from an anagram match can be fitted
+//! to the character classes, blanks and wildcard of the pattern.
+//
+//! @param letters the leftover letters
+//! @param index the first letter still to be fitted
+//! @param sets the character classes not yet used, each without brackets
+//! @param blanks the number of blanks not yet used
+//! @param wildcard whether the pattern has a wildcard
+//! @param anagram whether every class and blank must be used, as in an
+//! Anagram match, rather than only some of them, as in a Subanagram match
+//! @return true if the letters fit, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::matchesLetterSets(const QString& letters, int index, QStringList*
+                             sets, int blanks, bool wildcard, bool anagram)
+{
+    if (index == letters.length())
+        return !anagram || (sets->isEmpty() && !blanks);
+
+    QChar c = letters.at(index);
+    for (int i = 0; i < sets->count(); ++i) {
+        const QString& set = sets->at(i);
+        bool negated = set.startsWith("^");
+        if (!((set.indexOf(c, negated ? 1 : 0) >= 0) ^ negated))
+            continue;
+        QString taken = sets->takeAt(i);
+        bool match = matchesLetterSets(letters, index + 1, sets, blanks,
+                                       wildcard, anagram);
+        sets->insert(i, taken);
+        if (match)
+            return true;
+    }
+
+    if (blanks &&
+        matchesLetterSets(letters, index + 1, sets, blanks - 1, wildcard,
+                          anagram))
+    {
+        return true;
+    }
+
+    return (wildcard &&
+            matchesLetterSets(letters, index + 1, sets, blanks, wildcard,
+                              anagram));
+}
+
+//---------------------------------------------------------------------------
+//  getDrawProbabilities
+//
+//! Find all words that can be formed by drawing tiles from a pool, along
+//! with the probability of drawing each word when drawing as many tiles as
+//! there are letters in the word, taking the overlay into account.
+//
+//! @param pool the tiles in the pool, with ? or _ for blanks
+//! @param spec a search spec whose Length, Include Letters and Consist of
+//! conditions are also checked
+//! @return a map of words to their draw probabilities, between 0 and 1
+//---------------------------------------------------------------------------
+QMap<QString, double>
+WordGraph::getDrawProbabilities(const QString& pool, const SearchSpec& spec)
+    const
+{
+    QMap<QString, double> probabilities =
+        getGraphDrawProbabilities(pool, spec);
+    if (!hasOverlay())
+        return probabilities;
+
+    QMutableMapIterator<QString, double> it (probabilities);
+    while (it.hasNext()) {
+        it.next();
+        if (isDeleted(it.key()))
+            it.remove();
+    }
+    if (addedWords) {
+        QMap<QString, double> added =
+            addedWords->getDrawProbabilities(pool, spec);
+        QMapIterator<QString, double> ait (added);
+        while (ait.hasNext()) {
+            ait.next();
+            probabilities.insert(ait.key(), ait.value());
+        }
+    }
+    return probabilities;
+}
+
+//---------------------------------------------------------------------------
+//  getGraphDrawProbabilities
+//
+//! Find the draw probabilities of the words in the graph itself, ignoring
+//! the overlay.  The traversal only follows letters that remain in the
+//! pool, and is split across threads by the first letter.
+//
+//! @param pool the tiles in the pool, with ? or _ for blanks
+//! @param spec a search spec whose Length, Include Letters and Consist of
+//! conditions are also checked
+//! @return a map of words to their draw probabilities, between 0 and 1
+//---------------------------------------------------------------------------
+QMap<QString, double>
+WordGraph::getGraphDrawProbabilities(const QString& pool, const SearchSpec&
+                                     spec) const
+{
+    DrawState state;
+    state.spec = &spec;
+    foreach (const QChar& c, pool) {
+        if ((c == '?') || (c == LetterBag::BLANK_CHAR))
+            ++state.poolBlanks;
+        else if (c.isLetter())
+            ++state.poolCounts[uchar(c.toUpper().toLatin1())];
+        else
+            continue;
+        ++state.poolSize;
+    }
+
+    QListIterator<SearchCondition> it (spec.conditions);
+    while (it.hasNext()) {
+        const SearchCondition& condition = it.next();
+        if (condition.type != SearchCondition::Length)
+            continue;
+        if (condition.minValue > state.minLength)
+            state.minLength = condition.minValue;
+        if (condition.maxValue < state.maxLength)
+            state.maxLength = condition.maxValue;
+    }
+    if (state.poolSize < state.maxLength)
+        state.maxLength = state.poolSize;
+    if (state.minLength > state.maxLength)
+        return QMap<QString, double>();
+
+    double inverse = 1.0;
+    state.drawInverse[0] = inverse;
+    for (int i = 0; i < state.maxLength; ++i) {
+        inverse *= double(i + 1) / double(state.poolSize - i);
+        state.drawInverse[i + 1] = inverse;
+    }
+
+    QList<qint32> rootEdges;
+    QList<const Node*> rootNodes;
+    if (dawg) {
+        for (qint32 edge = ROOT_NODE; ; ++edge) {
+            rootEdges.append(edge);
+            if (dawg[edge] & M_END_OF_NODE)
+                break;
+        }
+    }
+    else {
+        for (const Node* node = top; node; node = node->next)
+            rootNodes.append(node);
+    }
+
+    int numRoots = rootEdges.count() + rootNodes.count();
+    int numThreads = qMin(qMax(QThread::idealThreadCount(), 1), numRoots);
+    if (numThreads <= 1) {
+        foreach (qint32 edge, rootEdges)
+            drawEdge(&state, edge);
+        foreach (const Node* node, rootNodes)
+            drawNodeOld(&state, node);
+        return state.results;
+    }
+
+    // Deal the root edges out to the threads in turn, so that each thread
+    // gets a mix of common and uncommon first letters
+    QList<DrawThread*> threads;
+    for (int i = 0; i < numThreads; ++i)
+        threads.append(new DrawThread(this, state));
+    for (int i = 0; i < rootEdges.count(); ++i)
+        threads[i % numThreads]->rootEdges.append(rootEdges[i]);
+    for (int i = 0; i < rootNodes.count(); ++i)
+        threads[i % numThreads]->rootNodes.append(rootNodes[i]);
+
+    foreach (DrawThread* thread, threads)
+        thread->start();
+
+    QMap<QString, double> results;
+    foreach (DrawThread* thread, threads) {
+        thread->wait();
+        QMapIterator<QString, double> rit (thread->state.results);
+        while (rit.hasNext()) {
+            rit.next();
+            results.insert(rit.key(), rit.value());
+        }
+        delete thread;
+    }
+
+    return results;
+}
+
+//---------------------------------------------------------------------------
+//  searchDraws
+//
+//! Search for acceptable words matching a search specification that
+//! contains Draw Probability conditions.  The words that can be drawn are
+//! found first, and the other conditions are then matched against them.
+//
+//! @param spec the search specification
+//! @return a list of acceptable words
+//---------------------------------------------------------------------------
+QStringList
+WordGraph::searchDraws(const SearchSpec& spec) const
+{
+    SearchSpec otherSpec = spec;
+    otherSpec.conditions.clear();
+    QList<SearchCondition> drawConditions;
+    bool matchCondition = false;
+
+    QListIterator<SearchCondition> it (spec.conditions);
+    while (it.hasNext()) {
+        const SearchCondition& condition = it.next();
+        switch (condition.type) {
+            case SearchCondition::DrawProbability:
+            drawConditions.append(condition);
+            break;
+
+            case SearchCondition::PatternMatch:
+            case SearchCondition::AnagramMatch:
+            case SearchCondition::SubanagramMatch:
+            matchCondition = true;
+            otherSpec.conditions.append(condition);
+            break;
+
+            default:
+            otherSpec.conditions.append(condition);
+            break;
+        }
+    }
+
+    QMap<QString, double> drawable;
+    for (int i = 0; i < drawConditions.count(); ++i) {
+        const SearchCondition& condition = drawConditions[i];
+        QMap<QString, double> probabilities =
+            getDrawProbabilities(condition.stringValue, otherSpec);
+
+        QMap<QString, double> matching;
+        QMapIterator<QString, double> pit (probabilities);
+        while (pit.hasNext()) {
+            pit.next();
+            double value = pit.value() * DRAW_PROBABILITY_SCALE;
+            if ((value < condition.minValue) || (value > condition.maxValue))
+                continue;
+            if (!i || drawable.contains(pit.key()))
+                matching.insert(pit.key(), pit.value());
         }
 
-        ++conditionNum;
+        drawable = matching;
+        if (drawable.isEmpty())
+            return QStringList();
     }
 
-    // Transform word set into word list and return it
-    for (sit = finalWordSet.begin(); sit != finalWordSet.end(); ++sit) {
-        wordList << (wildcardLower ? sit->second : sit->first);
-    }
+    if (!matchCondition)
+        return drawable.keys();
 
+    QStringList wordList;
+    foreach (const QString& word, search(otherSpec)) {
+        if (drawable.contains(word.toUpper()))
+            wordList.append(word);
+    }
     return wordList;
 }
 
 //---------------------------------------------------------------------------
-//  getNumWords
+//  drawEdge
 //
-//! Return the number of words in the graph.
+//! Traverse an edge of the word graph and everything below it, looking for
+//! words that can be drawn from a pool of tiles.
 //
-//! @return the number of words
+//! @param state the traversal state
+//! @param edge the index of the edge
 //---------------------------------------------------------------------------
-int
-WordGraph::getNumWords() const
+void
+WordGraph::drawEdge(DrawState* state, qint32 edge) const
 {
-    return (dawg ? getNumWords(ROOT_NODE) : numWords);
+    qint32 value = edgeAt(dawg, edge);
+    if (!(value & (M_NODE_POINTER | M_END_OF_WORD)))
+        return;
+
+    char letter = char((value >> V_LETTER) & M_LETTER);
+    if (!beginDrawLetter(state, letter, value & M_END_OF_WORD))
+        return;
+
+    qint32 child = value & M_NODE_POINTER;
+    if (child && (state->length < state->maxLength)) {
+        for (qint32 e = child; ; ++e) {
+            drawEdge(state, e);
+            if (dawg[e] & M_END_OF_NODE)
+                break;
+        }
+    }
+
+    endDrawLetter(state, letter);
 }
 
 //---------------------------------------------------------------------------
-//  matchesSpec
+//  drawNodeOld
 //
-//! Determine whether a word matches a search specification.  Only the
-//! following attributes are checked: Include Letters, Consist Letters/Pct,
-//! Min Length, Min Anagrams, Max Anagrams, Min Probability, Max Probability.
-//! All other attributes are assumed to have been checked in the course of
-//! finding the word to be checked.
+//! Traverse a node of the old word graph and everything below it, looking
+//! for words that can be drawn from a pool of tiles.
+//
+//! @param state the traversal state
+//! @param node the node
 //---------------------------------------------------------------------------
-bool
-WordGraph::matchesSpec(QString word, const SearchSpec& spec) const
+void
+WordGraph::drawNodeOld(DrawState* state, const Node* node) const
 {
-    QListIterator<SearchCondition> it (spec.conditions);
-    while (it.hasNext()) {
-        const SearchCondition& condition = it.next();
-
-        switch (condition.type) {
-            case SearchCondition::Length:
-            if ((int(word.length()) < condition.minValue) ||
-                (int(word.length()) > condition.maxValue))
-                return false;
-            break;
+    char letter = node->letter.toLatin1();
+    if (!beginDrawLetter(state, letter, node->eow))
+        return;
 
-            case SearchCondition::IncludeLetters: {
-                QString tmpWord = word;
-                int includeLen = condition.stringValue.length();
-                for (int i = 0; i < includeLen; ++i) {
-                    int index = tmpWord.indexOf(condition.stringValue.at(i));
-                    if ((index < 0) ^ condition.negated)
-                        return false;
-                    tmpWord.replace(index, 1, QString());
-                }
-            }
-            break;
+    if (state->length < state->maxLength) {
+        for (const Node* child = node->child; child; child = child->next)
+            drawNodeOld(state, child);
+    }
 
-            case SearchCondition::ConsistOf:
-            if ((condition.minValue > 0) || (condition.maxValue < 100)) {
-                int wordLen = word.length();
-                int consist = 0;
-                for (int i = 0; i < wordLen; ++i) {
-                    if (condition.stringValue.contains(word.at(i)))
-                        ++consist;
-                }
-                int consistPct = (consist * 100) / wordLen;
-                if ((consistPct < condition.minValue) ||
-                    (consistPct > condition.maxValue))
-                    return false;
-            }
-            break;
+    endDrawLetter(state, letter);
+}
 
-            // XXX: Implement these!
-            //case SearchCondition::NumAnagrams:
-            //case SearchCondition::Probability:
+//---------------------------------------------------------------------------
+//  beginDrawLetter
+//
+//! Add a letter to the word being traversed, if a tile for it remains in
+//! the pool.  If the letter ends a word, record the word along with its
+//! draw probability.
+//
+//! @param state the traversal state
+//! @param letter the letter
+//! @param eow whether the letter ends a word
+//! @return true if the letter was added, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::beginDrawLetter(DrawState* state, char letter, bool eow) const
+{
+    int index = uchar(letter);
+    int count = state->wordCounts[index] + 1;
+    int poolCount = state->poolCounts[index];
+    bool blank = (count > poolCount);
+    if (blank && (state->blanksUsed == state->poolBlanks))
+        return false;
 
-            default: break;
+    state->wordCounts[index] = count;
+    if (blank)
+        ++state->blanksUsed;
+
+    // Update the ways of drawing the prefix without blanks: the count of
+    // this letter goes from (poolCount choose count - 1) to (poolCount
+    // choose count)
+    int length = state->length;
+    state->word[length] = letter;
+    state->combos[length + 1] = blank ? 0.0 :
+        state->combos[length] * (poolCount - count + 1) / count;
+    state->length = ++length;
+
+    if (!eow || (length < state->minLength))
+        return true;
+
+    double combos = state->combos[length];
+    if (state->poolBlanks) {
+        int numLetters = 0;
+        int wordCounts[MAX_WORD_LEN];
+        int poolCounts[MAX_WORD_LEN];
+        char letters[MAX_WORD_LEN];
+        for (int i = 0; i < length; ++i) {
+            char c = state->word[i];
+            if (memchr(letters, c, numLetters))
+                continue;
+            letters[numLetters] = c;
+            wordCounts[numLetters] = state->wordCounts[uchar(c)];
+            poolCounts[numLetters] = state->poolCounts[uchar(c)];
+            ++numLetters;
         }
+        combos = LetterBag::getNumDrawCombinations(numLetters, wordCounts,
+            poolCounts, state->poolBlanks);
     }
 
+    QString word = QString::fromLatin1(state->word, length);
+    if (matchesSpec(word, *state->spec))
+        state->results.insert(word, combos * state->drawInverse[length]);
     return true;
 }
 
+//---------------------------------------------------------------------------
+//  endDrawLetter
+//
+//! Remove the last letter from the word being traversed, returning its tile
+//! to the pool.
+//
+//! @param state the traversal state
+//! @param letter the letter
+//---------------------------------------------------------------------------
+void
+WordGraph::endDrawLetter(DrawState* state, char letter) const
+{
+    int index = uchar(letter);
+    if (state->wordCounts[index] > state->poolCounts[index])
+        --state->blanksUsed;
+    --state->wordCounts[index];
+    --state->length;
+}
+
 //---------------------------------------------------------------------------
 //  convertEndian
 //
@@ -1222,15 +2474,123 @@ int
 WordGraph::getNumWords(qint32 node) const
 {
     int count = 0;
-    for (qint32* edge = &dawg[node]; ; ++edge) {
-        if ((*edge & M_END_OF_WORD) != 0)
+    for (qint32 edge = node; ; ++edge) {
+        qint32 value = edgeAt(dawg, edge);
+        if ((value & M_END_OF_WORD) != 0)
             ++count;
-        node = *edge & M_NODE_POINTER;
+        node = value & M_NODE_POINTER;
         if (node)
             count += getNumWords(node);
-        if (*edge & M_END_OF_NODE)
+        if (value & M_END_OF_NODE)
+            break;
+    }
+    return count;
+}
+
+//---------------------------------------------------------------------------
+//  collectLetters
+//
+//! Mark the letters used below a node of the old-style graph.
+//
+//! @param node the first of a list of sibling nodes
+//! @param used the table of used letters, indexed by Latin-1 value
+//---------------------------------------------------------------------------
+void
+WordGraph::collectLetters(const Node* node, bool* used) const
+{
+    for (; node; node = node->next) {
+        ushort u = node->letter.unicode();
+        if (u <= 0xff)
+            used[u] = true;
+        collectLetters(node->child, used);
+    }
+}
+
+//---------------------------------------------------------------------------
+//  buildWordCounts
+//
+//! Record, for every node of the forward DAWG, the number of words completed
+//! below the node by suffixes of each length.  Nodes shared by many prefixes
+//! are counted only once.
+//
+//! @param numEdges the number of edges, not counting the terminal entry
+//---------------------------------------------------------------------------
+void
+WordGraph::buildWordCounts(qint32 numEdges)
+{
+    countOffsets.fill(-1, numEdges + 1);
+    suffixCounts.clear();
+    if (numEdges > 0)
+        buildNodeCounts(ROOT_NODE);
+}
+
+//---------------------------------------------------------------------------
+//  buildNodeCounts
+//
+//! Compute the suffix counts for a node and its descendants, unless they
+//! have already been computed.
+//
+//! @param node the node
+//! @return the offset of the node's counts in the suffix count pool
+//---------------------------------------------------------------------------
+qint32
+WordGraph::buildNodeCounts(qint32 node)
+{
+    qint32 offset = countOffsets.at(node);
+    if (offset >= 0)
+        return offset;
+
+    // counts[i] holds the number of words completed by suffixes of length
+    // i + 1
+    QVector<quint32> counts (1, 0);
+    for (qint32 edge = node; ; ++edge) {
+        qint32 value = edgeAt(dawg, edge);
+        if (value & M_END_OF_WORD)
+            ++counts[0];
+
+        qint32 child = value & M_NODE_POINTER;
+        if (child) {
+            qint32 childOffset = buildNodeCounts(child);
+            int childLength = suffixCounts.at(childOffset);
+            if (counts.size() < childLength + 1)
+                counts.resize(childLength + 1);
+            for (int i = 1; i <= childLength; ++i)
+                counts[i] += suffixCounts.at(childOffset + i);
+        }
+
+        if (value & M_END_OF_NODE)
             break;
     }
+
+    offset = suffixCounts.size();
+    suffixCounts.append(counts.size());
+    suffixCounts += counts;
+    countOffsets[node] = offset;
+    return offset;
+}
+
+//---------------------------------------------------------------------------
+//  countSuffixes
+//
+//! Return the number of words completed below a node by suffixes within a
+//! range of lengths.
+//
+//! @param node the node
+//! @param minLength the minimum suffix length
+//! @param maxLength the maximum suffix length
+//! @return the number of words
+//---------------------------------------------------------------------------
+int
+WordGraph::countSuffixes(qint32 node, int minLength, int maxLength) const
+{
+    qint32 offset = countOffsets.at(node);
+    if (offset < 0)
+        return 0;
+
+    int longest = suffixCounts.at(offset);
+    int count = 0;
+    for (int i = qMax(minLength, 1); i <= qMin(maxLength, longest); ++i)
+        count += suffixCounts.at(offset + i);
     return count;
 }
 
@@ -1271,3 +2631,288 @@ WordGraph::Node::operator==(const Node& rhs)
     return ((letter == rhs.letter) && (eow == rhs.eow)
             && (next == rhs.next) && (child == rhs.child));
 }
+
+//---------------------------------------------------------------------------
+//  Cursor
+//
+//! Constructor.  Create a cursor positioned at the empty prefix.
+//
+//! @param g the graph to traverse
+//! @param gen the generation of the graph, which changes whenever the graph
+//! is replaced or reloaded
+//---------------------------------------------------------------------------
+WordGraph::Cursor::Cursor(const WordGraph* g, quint32 gen)
+    : graph(g), generation(gen)
+{
+    reset();
+}
+
+//---------------------------------------------------------------------------
+//  reset
+//
+//! Move the cursor back to the empty prefix.
+//---------------------------------------------------------------------------
+void
+WordGraph::Cursor::reset()
+{
+    prefix.clear();
+    resetStates(graph, &states);
+    resetStates(graph ? graph->addedWords : 0, &addedStates);
+}
+
+//---------------------------------------------------------------------------
+//  advance
+//
+//! Extend the current prefix by one letter.  The state of every prefix is
+//! kept, so advancing and retreating take constant time.  If no word begins
+//! with the extended prefix, the letter is still recorded so that retreating
+//! past it restores the previous state.  Words added by an overlay are
+//! followed alongside the words of the graph itself.
+//
+//! @param letter the letter to add
+//! @return true if some word begins with the extended prefix
+//---------------------------------------------------------------------------
+bool
+WordGraph::Cursor::advance(const QChar& letter)
+{
+    int length = prefix.length();
+    prefix.append(letter);
+    char c = letter.toUpper().toAscii();
+
+    bool inGraph = advanceStates(graph, &states, length, c);
+    bool inAdded = advanceStates(graph ? graph->addedWords : 0,
+                                 &addedStates, length, c);
+    return inGraph || inAdded;
+}
+
+//---------------------------------------------------------------------------
+//  retreat
+//
+//! Remove the last letter from the current prefix.
+//
+//! @return true if a letter was removed, false if the prefix was empty
+//---------------------------------------------------------------------------
+bool
+WordGraph::Cursor::retreat()
+{
+    if (prefix.isEmpty())
+        return false;
+
+    if (states.count() > prefix.length())
+        states.pop_back();
+    if (addedStates.count() > prefix.length())
+        addedStates.pop_back();
+    prefix.chop(1);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  setPrefix
+//
+//! Move the cursor to a new prefix, retreating only as far as the common
+//! prefix of the old and new strings and advancing from there.  This makes
+//! following the contents of an input line as it is edited cheap.
+//
+//! @param str the new prefix
+//! @return true if some word begins with the new prefix
+//---------------------------------------------------------------------------
+bool
+WordGraph::Cursor::setPrefix(const QString& str)
+{
+    int common = 0;
+    int maxCommon = qMin(prefix.length(), str.length());
+    while ((common < maxCommon) && (prefix.at(common) == str.at(common)))
+        ++common;
+
+    while (prefix.length() > common)
+        retreat();
+    for (int i = common; i < str.length(); ++i)
+        advance(str.at(i));
+
+    return isValidPrefix();
+}
+
+//---------------------------------------------------------------------------
+//  isValidPrefix
+//
+//! Determine whether any word begins with the current prefix.  A prefix
+//! whose only words are deleted by an overlay is still reported as valid.
+//
+//! @return true if the prefix is valid, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::Cursor::isValidPrefix() const
+{
+    return statesValid(states) || statesValid(addedStates);
+}
+
+//---------------------------------------------------------------------------
+//  isWord
+//
+//! Determine whether the current prefix is itself a word, taking the
+//! overlay of the graph into account.
+//
+//! @return true if the prefix is a word, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::Cursor::isWord() const
+{
+    if (prefix.isEmpty())
+        return false;
+    if (statesValid(addedStates) && addedStates.last().eow)
+        return true;
+    return statesValid(states) && states.last().eow &&
+        !graph->isDeleted(prefix.toUpper());
+}
+
+//---------------------------------------------------------------------------
+//  hasExtensions
+//
+//! Determine whether any longer word begins with the current prefix.
+//
+//! @return true if the prefix can be extended, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::Cursor::hasExtensions() const
+{
+    return (statesValid(states) && hasChildren(graph, states.last())) ||
+        (statesValid(addedStates) &&
+         hasChildren(graph->addedWords, addedStates.last()));
+}
+
+//---------------------------------------------------------------------------
+//  getNextLetters
+//
+//! Return the letters that can follow the current prefix in some word.
+//
+//! @return a string of valid next letters
+//---------------------------------------------------------------------------
+QString
+WordGraph::Cursor::getNextLetters() const
+{
+    QString letters;
+    if (statesValid(states))
+        letters = getChildLetters(graph, states.last());
+    if (statesValid(addedStates)) {
+        QString added = getChildLetters(graph->addedWords,
+                                        addedStates.last());
+        foreach (const QChar& c, added) {
+            if (!letters.contains(c))
+                letters += c;
+        }
+    }
+    return letters;
+}
+
+//---------------------------------------------------------------------------
+//  resetStates
+//
+//! Position a list of prefix states at the empty prefix of a graph.
+//
+//! @param g the graph, or 0 if there is none
+//! @param s the states to reset
+//---------------------------------------------------------------------------
+void
+WordGraph::Cursor::resetStates(const WordGraph* g, QVector<State>* s)
+{
+    s->clear();
+    if (!g)
+        return;
+
+    if (g->dawg)
+        s->append(State(ROOT_NODE));
+    else
+        s->append(State(TERMINAL_NODE, g->top));
+}
+
+//---------------------------------------------------------------------------
+//  advanceStates
+//
+//! Extend a list of prefix states by one letter.  Nothing is added if the
+//! states no longer follow the prefix.
+//
+//! @param g the graph, or 0 if there is none
+//! @param s the states to extend
+//! @param length the length of the prefix before the letter was added
+//! @param c the letter, in upper case
+//! @return true if some word of the graph begins with the extended prefix
+//---------------------------------------------------------------------------
+bool
+WordGraph::Cursor::advanceStates(const WordGraph* g, QVector<State>* s,
+                                 int length, char c)
+{
+    if (!g || (s->count() != length + 1))
+        return false;
+
+    State state = s->last();
+    if (g->dawg) {
+        if (state.node == TERMINAL_NODE)
+            return false;
+        for (qint32 edge = state.node; ; ++edge) {
+            qint32 value = g->edgeAt(g->dawg, edge);
+            char lc = char((value >> V_LETTER) & M_LETTER);
+            if (lc == c) {
+                s->append(State(value & M_NODE_POINTER, 0,
+                                value & M_END_OF_WORD));
+                return true;
+            }
+            if (value & M_END_OF_NODE)
+                return false;
+        }
+    }
+
+    for (Node* node = state.child; node; node = node->next) {
+        if (node->letter == c) {
+            s->append(State(TERMINAL_NODE, node->child, node->eow));
+            return true;
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------
+//  hasChildren
+//
+//! Determine whether a prefix state of a graph has any longer words.
+//
+//! @param g the graph
+//! @param state the prefix state
+//! @return true if the state has children, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordGraph::Cursor::hasChildren(const WordGraph* g, const State& state)
+{
+    return g->dawg ? (state.node != TERMINAL_NODE) : (state.child != 0);
+}
+
+//---------------------------------------------------------------------------
+//  getChildLetters
+//
+//! Return the letters that can follow a prefix state of a graph.
+//
+//! @param g the graph
+//! @param state the prefix state
+//! @return a string of valid next letters
+//---------------------------------------------------------------------------
+QString
+WordGraph::Cursor::getChildLetters(const WordGraph* g, const State& state)
+{
+    QString letters;
+    if (!hasChildren(g, state))
+        return letters;
+
+    if (g->dawg) {
+        for (qint32 edge = state.node; ; ++edge) {
+            qint32 value = g->edgeAt(g->dawg, edge);
+            if (value & (M_NODE_POINTER | M_END_OF_WORD))
+                letters += QChar(char((value >> V_LETTER) & M_LETTER));
+            if (value & M_END_OF_NODE)
+                break;
+        }
+    }
+    else {
+        for (Node* node = state.child; node; node = node->next)
+            letters += node->letter;
+    }
+    return letters;
+}
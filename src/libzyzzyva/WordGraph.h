@@ -25,13 +25,68 @@
 #ifndef ZYZZYVA_WORD_GRAPH_H
 #define ZYZZYVA_WORD_GRAPH_H
 
+#include "FixedWord.h"
 #include "SearchSpec.h"
 #include <QFile>
+#include <QMap>
 #include <QString>
 #include <QStringList>
+#include <QVector>
+#include <map>
+
+class SharedWordGraph;
 
 class WordGraph
 {
+    private:
+    class Node;
+
+    public:
+    class Cursor {
+        public:
+        Cursor(const WordGraph* g = 0, quint32 gen = 0);
+
+        void reset();
+        bool advance(const QChar& letter);
+        bool retreat();
+        bool setPrefix(const QString& str);
+        QString getPrefix() const { return prefix; }
+        bool isValidPrefix() const;
+        bool isWord() const;
+        bool hasExtensions() const;
+        QString getNextLetters() const;
+        const WordGraph* getGraph() const { return graph; }
+        quint32 getGeneration() const { return generation; }
+
+        private:
+        class State {
+            public:
+            State(qint32 n = 0, Node* c = 0, bool e = false)
+                : node(n), child(c), eow(e) { }
+            qint32 node;
+            Node* child;
+            bool eow;
+        };
+
+        static void resetStates(const WordGraph* g, QVector<State>* s);
+        static bool advanceStates(const WordGraph* g, QVector<State>* s,
+                                  int length, char c);
+        static bool hasChildren(const WordGraph* g, const State& state);
+        static QString getChildLetters(const WordGraph* g, const State&
+                                       state);
+        bool statesValid(const QVector<State>& s) const {
+            return !s.isEmpty() && (s.count() == prefix.length() + 1); }
+
+        // States of the prefix in the graph itself and in the graph of
+        // words added by its overlay
+        const WordGraph* graph;
+        quint32 generation;
+        QString prefix;
+        QVector<State> states;
+        QVector<State> addedStates;
+    };
+    friend class Cursor;
+
     public:
     WordGraph();
     ~WordGraph();
@@ -39,10 +94,25 @@ class WordGraph
     void clear();
     bool importDawgFile(const QString& filename, bool reverse, QString*
                         errString, quint16* expectedChecksum);
+    void importDawgData(const qint32* data, qint32 numEdges, bool reverse);
+    bool importSharedGraph(const SharedWordGraph* shared, const QString&
+                           lexicon);
+    bool importBaseGraph(const WordGraph* base);
+    void setOverlay(const QStringList& additions, const QStringList&
+                    deletions);
+    bool hasOverlay() const {
+        return (addedWords || !deletedWords.isEmpty()); }
     void addWord(const QString& w);
     bool containsWord(const QString& w) const;
     QStringList search(const SearchSpec& spec) const;
+    int countWords(const SearchSpec& spec) const;
+    QMap<QString, double> getDrawProbabilities(const QString& pool, const
+                                               SearchSpec& spec =
+                                               SearchSpec()) const;
     int getNumWords() const;
+    QString getLetters() const;
+    static bool matchesCondition(const QString& word, const SearchCondition&
+                                 condition);
 
     private:
     class Node {
@@ -58,10 +128,10 @@ class WordGraph
 
     class TraversalState {
       public:
-        TraversalState(qint32 n, const QString& w, const QString& u)
+        TraversalState(qint32 n, const FixedWord& w, const QString& u)
             : node(n), word(w), unmatched(u) { }
         qint32 node;
-        QString word;
+        FixedWord word;
         QString unmatched;
     };
 
@@ -74,8 +144,38 @@ class WordGraph
         QString unmatched;
     };
 
+    class DrawState;
+    class DrawThread;
+    friend class DrawThread;
+
     private:
+    qint32 edgeAt(const qint32* graph, qint32 edge) const;
+    bool isDeleted(const QString& word) const;
+    bool containsGraphWord(const QString& w) const;
+    QStringList searchGraph(const SearchSpec& spec) const;
+    QMap<QString, double> getGraphDrawProbabilities(const QString& pool, const
+                                                    SearchSpec& spec) const;
     bool matchesSpec(QString word, const SearchSpec& spec) const;
+    void collectWords(const SearchSpec& spec, std::map<FixedWord, FixedWord>*
+                      words, int* count = 0) const;
+    static bool matchesOnce(const SearchCondition& condition);
+    static bool matchesPattern(const QString& word, int wordPos, const
+                               QString& pattern, int patternPos);
+    static bool matchesLetterSets(const QString& letters, int index,
+                                  QStringList* sets, int blanks, bool
+                                  wildcard, bool anagram);
+    bool countSimplePattern(const SearchSpec& spec, int* count) const;
+    int countPatternPaths(qint32 node, int depth, const QStringList& letters,
+                          bool tailWildcard, int minLength, int maxLength)
+                          const;
+    void buildWordCounts(qint32 numEdges);
+    qint32 buildNodeCounts(qint32 node);
+    int countSuffixes(qint32 node, int minLength, int maxLength) const;
+    QStringList searchDraws(const SearchSpec& spec) const;
+    void drawEdge(DrawState* state, qint32 edge) const;
+    void drawNodeOld(DrawState* state, const Node* node) const;
+    bool beginDrawLetter(DrawState* state, char letter, bool eow) const;
+    void endDrawLetter(DrawState* state, char letter) const;
     QString reverseString(const QString& s) const;
     qint32 convertEndian(qint32* data, qint32 count);
 
@@ -83,12 +183,34 @@ class WordGraph
     bool containsWordOld(const QString& w) const;
     QStringList searchOld(const SearchSpec& spec) const;
     int getNumWords(qint32 node) const;
+    void collectLetters(const Node* node, bool* used) const;
 
     qint32* dawg;
     qint32* rdawg;
+    bool dawgOwned;
+    bool rdawgOwned;
+
+    // Edge masks of a graph shared with other lexicons, and the bit that
+    // stands for this lexicon in them.  The masks are null unless the edges
+    // come from a SharedWordGraph.
+    const quint16* dawgMasks;
+    const quint16* rdawgMasks;
+    quint16 lexiconMask;
 
     bool bigEndian;
 
+    // Word counts for the forward DAWG.  countOffsets maps the index of the
+    // first edge of each node to an entry in suffixCounts, which holds the
+    // longest suffix length L below the node followed by the number of words
+    // completed by suffixes of each length 1 through L.
+    QVector<qint32> countOffsets;
+    QVector<quint32> suffixCounts;
+
+    // Overlay of words added to and deleted from the graph.  Added words are
+    // kept in a small old-style graph, and deleted words in sorted order.
+    WordGraph* addedWords;
+    QVector<FixedWord> deletedWords;
+
     // OLD dawg structures - only used where new DAWG is unavailable
     Node* top;
     Node* rtop;
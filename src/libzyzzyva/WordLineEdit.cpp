@@ -0,0 +1,158 @@
+//---------------------------------------------------------------------------
+// WordLineEdit.cpp
+//
+// A class derived from QLineEdit, used to input words.  Objects of this class
+// can be distinguished from other QLineEdit objects when applying font
+// settings, and can optionally give as-you-type hints about whether the
+// input is a valid word.
+//
+// Copyright 2005-2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "WordLineEdit.h"
+#include "WordEngine.h"
+#include <QAbstractItemView>
+#include <QCompleter>
+#include <QPalette>
+#include <QStringListModel>
+
+const QColor INVALID_PREFIX_COLOR = Qt::red;
+const int MAX_COMPLETIONS = 10;
+
+//---------------------------------------------------------------------------
+//  setWordHints
+//
+//! Enable as-you-type word hints.  While the input is edited, a cursor
+//! follows it through the word graph of the lexicon, the text is colored
+//! when no word begins with it, and the letters that may come next are
+//! shown as a tool tip.
+//
+//! @param e the word engine
+//! @param lex the lexicon to check against
+//---------------------------------------------------------------------------
+void
+WordLineEdit::setWordHints(WordEngine* e, const QString& lex)
+{
+    if (!wordEngine) {
+        normalTextColor = palette().color(QPalette::Text);
+        connect(this, SIGNAL(textChanged(const QString&)),
+                SLOT(updateWordHint(const QString&)));
+    }
+
+    wordEngine = e;
+    lexicon = lex;
+    cursor = wordEngine->getWordCursor(lexicon);
+    updateWordHint(text());
+}
+
+//---------------------------------------------------------------------------
+//  updateWordHint
+//
+//! Move the word cursor to the current input and update the hints.
+//
+//! @param text the current input
+//---------------------------------------------------------------------------
+void
+WordLineEdit::updateWordHint(const QString& text)
+{
+    if (!wordEngine)
+        return;
+
+    // Pick up a new graph if the lexicon has been reloaded
+    WordGraph::Cursor fresh = wordEngine->getWordCursor(lexicon);
+    if (fresh.getGeneration() != cursor.getGeneration())
+        cursor = fresh;
+
+    bool isPrefix = cursor.setPrefix(text.toUpper());
+    bool isWord = cursor.isWord();
+
+    QPalette pal = palette();
+    pal.setColor(QPalette::Text, (isPrefix || text.isEmpty()) ?
+                 normalTextColor : INVALID_PREFIX_COLOR);
+    setPalette(pal);
+
+    QString nextLetters = cursor.getNextLetters();
+    setToolTip(nextLetters.isEmpty() ? QString() :
+               "Next letters: " + nextLetters);
+
+    emit wordHintChanged(isWord, isPrefix);
+}
+
+//---------------------------------------------------------------------------
+//  setWordCompletion
+//
+//! Enable or disable completion of words as they are typed.  The most
+//! playable words beginning with the input are offered in a popup list.
+//! Completion uses the lexicon given to setWordHints.
+//
+//! @param enable whether to enable completion
+//---------------------------------------------------------------------------
+void
+WordLineEdit::setWordCompletion(bool enable)
+{
+    if (enable == (completer != 0))
+        return;
+
+    if (!enable) {
+        disconnect(this, SIGNAL(textEdited(const QString&)),
+                   this, SLOT(updateCompletions(const QString&)));
+        setCompleter(0);
+        delete completer;
+        delete completionModel;
+        completer = 0;
+        completionModel = 0;
+        return;
+    }
+
+    completionModel = new QStringListModel(this);
+    completer = new QCompleter(completionModel, this);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    setCompleter(completer);
+    connect(this, SIGNAL(textEdited(const QString&)),
+            SLOT(updateCompletions(const QString&)));
+}
+
+//---------------------------------------------------------------------------
+//  updateCompletions
+//
+//! Look up the completions of the current input and show them.
+//
+//! @param text the current input
+//---------------------------------------------------------------------------
+void
+WordLineEdit::updateCompletions(const QString& text)
+{
+    if (!completer)
+        return;
+
+    QStringList completions;
+    if (wordEngine && !text.isEmpty()) {
+        completions = wordEngine->getCompletions(lexicon, text,
+                                                 MAX_COMPLETIONS + 1);
+        completions.removeAll(text.toUpper());
+        completions = completions.mid(0, MAX_COMPLETIONS);
+    }
+
+    completionModel->setStringList(completions);
+    if (completions.isEmpty())
+        completer->popup()->hide();
+    else
+        completer->complete();
+}
@@ -1,9 +1,10 @@
 //---------------------------------------------------------------------------
 // WordLineEdit.h
 //
-// A class derived from QLineEdit, used to input words.  This class currently
-// does nothing special.  It only exists so objects of this class can be
-// distinguished from other QLineEdit objects when applying font settings.
+// A class derived from QLineEdit, used to input words.  Objects of this class
+// can be distinguished from other QLineEdit objects when applying font
+// settings, and can optionally give as-you-type hints about whether the
+// input is a valid word.
 //
 // Copyright 2005-2012 Boshvark Software, LLC.
 //
@@ -27,18 +28,44 @@
 #ifndef ZYZZYVA_WORD_LINE_EDIT_H
 #define ZYZZYVA_WORD_LINE_EDIT_H
 
+#include "WordGraph.h"
+#include <QColor>
 #include <QLineEdit>
 
+class QCompleter;
+class QStringListModel;
+class WordEngine;
+
 class WordLineEdit : public QLineEdit
 {
     Q_OBJECT
     public:
     WordLineEdit(QWidget* parent = 0)
-        : QLineEdit(parent) { }
+        : QLineEdit(parent), wordEngine(0), completer(0),
+          completionModel(0) { }
     WordLineEdit(const QString& contents, QWidget* parent = 0)
-        : QLineEdit(contents, parent) { }
+        : QLineEdit(contents, parent), wordEngine(0), completer(0),
+          completionModel(0) { }
 
     virtual ~WordLineEdit() { }
+
+    void setWordHints(WordEngine* e, const QString& lex);
+    void setWordCompletion(bool enable);
+
+    signals:
+    void wordHintChanged(bool isWord, bool isPrefix);
+
+    private slots:
+    void updateWordHint(const QString& text);
+    void updateCompletions(const QString& text);
+
+    private:
+    WordEngine* wordEngine;
+    QString lexicon;
+    WordGraph::Cursor cursor;
+    QColor normalTextColor;
+    QCompleter* completer;
+    QStringListModel* completionModel;
 };
 
 #endif // ZYZZYVA_WORD_LINE_EDIT_H
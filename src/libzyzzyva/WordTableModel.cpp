@@ -35,6 +35,8 @@ const QChar PARENT_HOOK_HYPHEN_CHAR = '-';
 const QString WILDCARD_MATCH_HEADER = "?";
 const QString PROBABILITY_ORDER_HEADER = "Prob-%1";
 const QString PLAYABILITY_ORDER_HEADER = "Play";
+const QString DRAW_PROBABILITY_HEADER = "Draw %";
+const int DRAW_PROBABILITY_DIGITS = 4;
 const QString FRONT_HOOK_HEADER = "<";
 const QString WORD_HEADER = "Word";
 const QString BACK_HOOK_HEADER = ">";
@@ -129,7 +131,7 @@ lessThan(const WordTableModel::WordItem& a,
 //---------------------------------------------------------------------------
 WordTableModel::WordTableModel(WordEngine* e, QObject* parent)
     : QAbstractTableModel(parent), wordEngine(e), probNumBlanks(0),
-      lastAddedIndex(-1)
+      showDrawProbability(false), lastAddedIndex(-1)
 {
     probNumBlanks = MainSettings::getProbabilityNumBlanks();
 }
@@ -376,6 +378,7 @@ WordTableModel::data(const QModelIndex& index, int role) const
                 case WordTableModel::FRONT_HOOK_COLUMN:
                 case WordTableModel::PROBABILITY_ORDER_COLUMN:
                 case WordTableModel::PLAYABILITY_ORDER_COLUMN:
+                case WordTableModel::DRAW_PROBABILITY_COLUMN:
                 flags |= Qt::AlignRight;
                 break;
 
@@ -433,6 +436,12 @@ WordTableModel::data(const QModelIndex& index, int role) const
                     return (playOrder ? QString::number(playOrder) : QString());
                 }
 
+                case DRAW_PROBABILITY_COLUMN:
+                if (!wordItem.drawProbabilityIsValid())
+                    return QString();
+                return QString::number(wordItem.getDrawProbability() * 100,
+                                       'g', DRAW_PROBABILITY_DIGITS) + "%";
+
                 case FRONT_HOOK_COLUMN:
                 if (!MainSettings::getWordListShowHooks()) {
                     return QString();
@@ -540,6 +549,9 @@ WordTableModel::headerData(int section, Qt::Orientation orientation, int
             return MainSettings::getWordListShowPlayabilityOrder() ?
                 PLAYABILITY_ORDER_HEADER : QString();
 
+            case DRAW_PROBABILITY_COLUMN:
+            return showDrawProbability ? DRAW_PROBABILITY_HEADER : QString();
+
             case FRONT_HOOK_COLUMN:
             return MainSettings::getWordListShowHooks() ?
                 FRONT_HOOK_HEADER : QString();
@@ -658,6 +670,9 @@ WordTableModel::setData(const QModelIndex& index, const QVariant& value, int
         else if (index.column() == PLAYABILITY_ORDER_COLUMN) {
             wordList[index.row()].setPlayabilityOrder(value.toInt());
         }
+        else if (index.column() == DRAW_PROBABILITY_COLUMN) {
+            wordList[index.row()].setDrawProbability(value.toDouble());
+        }
         else {
             return false;
         }
@@ -758,6 +773,10 @@ WordTableModel::addWordPrivate(const WordItem& word, int row)
         setData(index(row, PLAYABILITY_ORDER_COLUMN),
                 word.getPlayabilityOrder(), Qt::EditRole);
     }
+    if (word.drawProbabilityIsValid()) {
+        setData(index(row, DRAW_PROBABILITY_COLUMN),
+                word.getDrawProbability(), Qt::EditRole);
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -856,12 +875,14 @@ WordTableModel::WordItem::init()
     parentHooksValid = false;
     probabilityOrderValid = false;
     playabilityOrderValid = false;
+    drawProbabilityValid = false;
     lexiconSymbolsValid = false;
     frontParentHook = false;
     backParentHook = false;
     probabilityOrder = 0;
     playabilityValue = 0;
     playabilityOrder = 0;
+    drawProbability = 0;
 }
 
 //---------------------------------------------------------------------------
@@ -905,6 +926,20 @@ WordTableModel::WordItem::setPlayabilityOrder(int p)
     playabilityOrderValid = true;
 }
 
+//---------------------------------------------------------------------------
+//  setDrawProbability
+//
+//! Set the draw probability of a word item.
+//
+//! @param p the probability of drawing the word, from 0 to 1
+//---------------------------------------------------------------------------
+void
+WordTableModel::WordItem::setDrawProbability(double p)
+{
+    drawProbability = p;
+    drawProbabilityValid = true;
+}
+
 //---------------------------------------------------------------------------
 //  setLexiconSymbols
 //
@@ -65,6 +65,7 @@ class WordTableModel : public QAbstractTableModel
         int getProbabilityOrder() const { return probabilityOrder; }
         qint64 getPlayabilityValue() const { return playabilityValue; }
         int getPlayabilityOrder() const { return playabilityOrder; }
+        double getDrawProbability() const { return drawProbability; }
         QString getLexiconSymbols() const { return lexiconSymbols; }
         void setWord(const QString& w) { word = w; }
         void setType(WordType t) { type = t; }
@@ -72,6 +73,7 @@ class WordTableModel : public QAbstractTableModel
         void setProbabilityOrder(int p);
         void setPlayabilityValue(qint64 p);
         void setPlayabilityOrder(int p);
+        void setDrawProbability(double p);
         void setLexiconSymbols(const QString& s);
 
         void setHooks(const QString& front, const QString& back);
@@ -80,6 +82,7 @@ class WordTableModel : public QAbstractTableModel
         bool parentHooksAreValid() const { return parentHooksValid; }
         bool probabilityOrderIsValid() const { return probabilityOrderValid; }
         bool playabilityOrderIsValid() const { return playabilityOrderValid; }
+        bool drawProbabilityIsValid() const { return drawProbabilityValid; }
         bool lexiconSymbolsAreValid() const { return lexiconSymbolsValid; }
 
         bool operator==(const WordItem& other) const {
@@ -94,12 +97,14 @@ class WordTableModel : public QAbstractTableModel
         bool parentHooksValid;
         bool probabilityOrderValid;
         bool playabilityOrderValid;
+        bool drawProbabilityValid;
         bool lexiconSymbolsValid;
         QString word;
         WordType type;
         int probabilityOrder;
         qint64 playabilityValue;
         int playabilityOrder;
+        double drawProbability;
         QString wildcard;
         QString frontHooks;
         QString backHooks;
@@ -136,6 +141,7 @@ class WordTableModel : public QAbstractTableModel
     int getLastAddedIndex() const { return lastAddedIndex; }
     void setProbabilityNumBlanks(int numBlanks) { probNumBlanks = numBlanks; }
     int getProbabilityNumBlanks() const { return probNumBlanks; }
+    void setShowDrawProbability(bool show) { showDrawProbability = show; }
     void clearLastAddedIndex();
 
     signals:
@@ -150,6 +156,7 @@ class WordTableModel : public QAbstractTableModel
     QString lexicon;
     mutable QList<WordItem> wordList;
     int probNumBlanks;
+    bool showDrawProbability;
     int lastAddedIndex;
 
     public:
@@ -157,11 +164,12 @@ class WordTableModel : public QAbstractTableModel
         WILDCARD_MATCH_COLUMN = 0,
         PROBABILITY_ORDER_COLUMN = 1,
         PLAYABILITY_ORDER_COLUMN = 2,
-        FRONT_HOOK_COLUMN = 3,
-        WORD_COLUMN = 4,
-        BACK_HOOK_COLUMN = 5,
-        DEFINITION_COLUMN = 6,
-        NUM_COLUMNS = 7
+        DRAW_PROBABILITY_COLUMN = 3,
+        FRONT_HOOK_COLUMN = 4,
+        WORD_COLUMN = 5,
+        BACK_HOOK_COLUMN = 6,
+        DEFINITION_COLUMN = 7,
+        NUM_COLUMNS = 8
     };
 
     static const QChar PARENT_HOOK_CHAR;
@@ -43,9 +43,12 @@
 #include <QFileDialog>
 #include <QHeaderView>
 #include <QMessageBox>
+#include <QMap>
 #include <QMenu>
 #include <QPushButton>
+#include <QSet>
 #include <QSignalMapper>
+#include <QStyle>
 #include <QTextStream>
 #include <QToolTip>
 
@@ -54,6 +57,10 @@ using namespace std;
 const int WordTableModel::ITEM_XPADDING = 5;
 const int WordTableModel::ITEM_YPADDING = 0;
 const int TWO_COLUMN_ANAGRAM_PADDING = 3;
+const int SIZE_HINT_HEAD_ROWS = 100;
+const int SIZE_HINT_SPREAD_ROWS = 100;
+const int SIZE_HINT_LONGEST_ROWS = 20;
+const int MAX_TEXT_WIDTH_CACHE_SIZE = 20000;
 
 //---------------------------------------------------------------------------
 //  WordTableView
@@ -63,7 +70,7 @@ const int TWO_COLUMN_ANAGRAM_PADDING = 3;
 //! @param parent the parent object
 //---------------------------------------------------------------------------
 WordTableView::WordTableView(WordEngine* e, QWidget* parent)
-    : QTreeView(parent), wordEngine(e)
+    : QTreeView(parent), wordEngine(e), sizeHintRowsValid(false)
 {
     setFocusPolicy(Qt::NoFocus);
     setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -88,6 +95,36 @@ WordTableView::WordTableView(WordEngine* e, QWidget* parent)
         SLOT(headerSectionClicked(int)));
 }
 
+//---------------------------------------------------------------------------
+//  setModel
+//
+//! Reimplementation of QAbstractItemView::setModel.  Discard the cached
+//! column widths whenever the rows or their contents change.
+//
+//! @param model the model
+//---------------------------------------------------------------------------
+void
+WordTableView::setModel(QAbstractItemModel* model)
+{
+    if (this->model())
+        this->model()->disconnect(this, SLOT(clearSizeHintCache()));
+
+    QTreeView::setModel(model);
+    clearSizeHintCache();
+    if (!model)
+        return;
+
+    connect(model, SIGNAL(modelReset()), SLOT(clearSizeHintCache()));
+    connect(model, SIGNAL(layoutChanged()), SLOT(clearSizeHintCache()));
+    connect(model, SIGNAL(rowsInserted(const QModelIndex&, int, int)),
+            SLOT(clearSizeHintCache()));
+    connect(model, SIGNAL(rowsRemoved(const QModelIndex&, int, int)),
+            SLOT(clearSizeHintCache()));
+    connect(model, SIGNAL(dataChanged(const QModelIndex&,
+                                      const QModelIndex&)),
+            SLOT(clearSizeHintCache()));
+}
+
 //---------------------------------------------------------------------------
 //  resizeItemsToContents
 //
@@ -955,13 +992,34 @@ WordTableView::viewportEvent(QEvent* e)
     return QTreeView::viewportEvent(e);
 }
 
+//---------------------------------------------------------------------------
+//  changeEvent
+//
+//! Reimplementation of QWidget::changeEvent.  Discard cached text and
+//! column widths and resize the columns when the font changes.
+//
+//! @param e the change event
+//---------------------------------------------------------------------------
+void
+WordTableView::changeEvent(QEvent* e)
+{
+    if (e->type() == QEvent::FontChange) {
+        textWidthCache.clear();
+        columnWidthCache.clear();
+        if (model())
+            resizeItemsToContents();
+    }
+    QTreeView::changeEvent(e);
+}
+
 //---------------------------------------------------------------------------
 //  sizeHintForColumn
 //
-//! Return the width size hint for a column.  Directly call the equivalent
-//! function from QAbstractItemView instead of allowing the QTableView version
-//! to take precedence, because we want the content of all rows to be
-//! considered, not just the visible ones.
+//! Return the width size hint for a column.  Rather than asking the delegate
+//! to measure every row, estimate the width from a bounded sample of rows:
+//! the first rows, rows spread evenly through the model, and the rows
+//! holding the longest words.  Measured text widths are cached per string,
+//! and column widths are cached until the model or the font changes.
 //
 //! @param column the column index
 //! @return the size hint for the column
@@ -969,24 +1027,149 @@ WordTableView::viewportEvent(QEvent* e)
 int
 WordTableView::sizeHintForColumn(int column) const
 {
-    return QAbstractItemView::sizeHintForColumn(column) +
-        (2 * WordTableModel::ITEM_XPADDING);
+    if (!model())
+        return -1;
+
+    QHash<int, int>::const_iterator cached =
+        columnWidthCache.constFind(column);
+    if (cached != columnWidthCache.constEnd())
+        return cached.value();
+
+    int width = 0;
+    const QList<int>& rows = getSizeHintRows();
+    QListIterator<int> it (rows);
+    while (it.hasNext()) {
+        QModelIndex index = model()->index(it.next(), column);
+        QString text = model()->data(index, Qt::DisplayRole).toString();
+        if (text.isEmpty())
+            continue;
+        int textWidth = getTextWidth(text);
+        if (textWidth > width)
+            width = textWidth;
+    }
+
+    // Match the text margins used by QItemDelegate
+    int textMargin = style()->pixelMetric(QStyle::PM_FocusFrameHMargin, 0,
+                                          this) + 1;
+    width += (2 * textMargin) + (2 * WordTableModel::ITEM_XPADDING);
+    columnWidthCache.insert(column, width);
+    return width;
 }
 
 //---------------------------------------------------------------------------
 //  sizeHintForRow
 //
-//! Return the height size hint for a row.  Directly call the equivalent
-//! function from QAbstractItemView instead of allowing the QTableView version
-//! to take precedence, because we want the content of all columns to be
-//! considered, not just the visible ones.
+//! Return the height size hint for a row.  All rows hold a single line of
+//! text in the same font, so the height is taken from the font metrics
+//! instead of measuring the contents of each column.
 //
-//! @param column the column index
-//! @return the size hint for the column
+//! @param row the row index
+//! @return the size hint for the row
 //---------------------------------------------------------------------------
 int
-WordTableView::sizeHintForRow(int row) const
+WordTableView::sizeHintForRow(int) const
 {
-    return QAbstractItemView::sizeHintForRow(row) +
-        (2 * WordTableModel::ITEM_YPADDING);
+    return fontMetrics().height() + (2 * WordTableModel::ITEM_YPADDING);
+}
+
+//---------------------------------------------------------------------------
+//  getSizeHintRows
+//
+//! Return the rows to be measured when estimating column widths.  Only word
+//! lengths are examined to find the longest words, so no other column data
+//! is computed for rows outside the sample.  The rows are chosen once and
+//! kept until the model changes.
+//
+//! @return the list of sampled row indexes
+//---------------------------------------------------------------------------
+const QList<int>&
+WordTableView::getSizeHintRows() const
+{
+    if (sizeHintRowsValid)
+        return sizeHintRows;
+
+    QList<int>& rows = sizeHintRows;
+    rows.clear();
+    sizeHintRowsValid = true;
+    int numRows = model()->rowCount();
+    if (numRows <= SIZE_HINT_HEAD_ROWS + SIZE_HINT_SPREAD_ROWS) {
+        for (int i = 0; i < numRows; ++i)
+            rows.append(i);
+        return rows;
+    }
+
+    QSet<int> rowSet;
+    for (int i = 0; i < SIZE_HINT_HEAD_ROWS; ++i)
+        rowSet.insert(i);
+
+    int stride = numRows / SIZE_HINT_SPREAD_ROWS;
+    for (int i = SIZE_HINT_HEAD_ROWS; i < numRows; i += stride)
+        rowSet.insert(i);
+
+    // Find the rows holding the longest words
+    QMap<int, QList<int> > rowsByLength;
+    for (int i = 0; i < numRows; ++i) {
+        QModelIndex index = model()->index(i, WordTableModel::WORD_COLUMN);
+        int len = model()->data(index, Qt::EditRole).toString().length();
+        if (rowsByLength.contains(len) &&
+            (rowsByLength[len].count() >= SIZE_HINT_LONGEST_ROWS))
+        {
+            continue;
+        }
+        rowsByLength[len].append(i);
+    }
+
+    int numLongest = 0;
+    QMapIterator<int, QList<int> > lit (rowsByLength);
+    lit.toBack();
+    while (lit.hasPrevious() && (numLongest < SIZE_HINT_LONGEST_ROWS)) {
+        lit.previous();
+        QListIterator<int> rit (lit.value());
+        while (rit.hasNext() && (numLongest < SIZE_HINT_LONGEST_ROWS)) {
+            rowSet.insert(rit.next());
+            ++numLongest;
+        }
+    }
+
+    rows = rowSet.toList();
+    qSort(rows);
+    return rows;
+}
+
+//---------------------------------------------------------------------------
+//  clearSizeHintCache
+//
+//! Discard the sampled rows and the cached column widths, so they are
+//! found again the next time a column width is needed.
+//---------------------------------------------------------------------------
+void
+WordTableView::clearSizeHintCache()
+{
+    sizeHintRows.clear();
+    sizeHintRowsValid = false;
+    columnWidthCache.clear();
+}
+
+//---------------------------------------------------------------------------
+//  getTextWidth
+//
+//! Return the width of a string in the current font, measuring it only if
+//! it has not already been measured.
+//
+//! @param text the text to measure
+//! @return the width of the text in pixels
+//---------------------------------------------------------------------------
+int
+WordTableView::getTextWidth(const QString& text) const
+{
+    QHash<QString, int>::const_iterator it = textWidthCache.find(text);
+    if (it != textWidthCache.end())
+        return it.value();
+
+    if (textWidthCache.count() >= MAX_TEXT_WIDTH_CACHE_SIZE)
+        textWidthCache.clear();
+
+    int width = fontMetrics().width(text);
+    textWidthCache.insert(text, width);
+    return width;
 }
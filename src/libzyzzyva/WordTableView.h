@@ -27,6 +27,8 @@
 
 #include "WordAttribute.h"
 #include "WordListFormat.h"
+#include <QHash>
+#include <QList>
 #include <QString>
 #include <QTreeView>
 
@@ -39,6 +41,8 @@ class WordTableView : public QTreeView
     WordTableView(WordEngine* e, QWidget* parent = 0);
     virtual ~WordTableView() { }
 
+    virtual void setModel(QAbstractItemModel* model);
+
     public slots:
     virtual void resizeItemsToContents();
     void exportRequested();
@@ -49,6 +53,7 @@ class WordTableView : public QTreeView
     protected:
     virtual void contextMenuEvent(QContextMenuEvent* e);
     virtual bool viewportEvent(QEvent* e);
+    virtual void changeEvent(QEvent* e);
     virtual int sizeHintForColumn(int column) const;
     virtual int sizeHintForRow(int row) const;
 
@@ -56,6 +61,7 @@ class WordTableView : public QTreeView
     void viewDefinition();
     void viewVariation(int variation);
     void headerSectionClicked(int section);
+    void clearSizeHintCache();
 
     private:
     // XXX: Hmm, these methods probably don't belong in WordTableView
@@ -74,8 +80,15 @@ class WordTableView : public QTreeView
     QString hookToolTipText(const QString& word, const QString& hooks,
                             bool front) const;
 
+    const QList<int>& getSizeHintRows() const;
+    int getTextWidth(const QString& text) const;
+
     private:
     WordEngine* wordEngine;
+    mutable QHash<QString, int> textWidthCache;
+    mutable QHash<int, int> columnWidthCache;
+    mutable QList<int> sizeHintRows;
+    mutable bool sizeHintRowsValid;
 
 };
 
@@ -42,6 +42,7 @@ win32 {
 # Source files
 SOURCES = \
     AboutDialog.cpp \
+    Alphabet.cpp \
     AnalyzeQuizDialog.cpp \
     Auxil.cpp \
     CardboxAddDialog.cpp \
@@ -49,17 +50,24 @@ SOURCES = \
     CardboxRemoveDialog.cpp \
     CardboxRescheduleDaysSpinBox.cpp \
     CardboxRescheduleDialog.cpp \
+    CompletionIndex.cpp \
     CreateDatabaseThread.cpp \
+    DatabaseBuildDialog.cpp \
+    DatabaseBuildScheduler.cpp \
     DatabaseRebuildDialog.cpp \
+    DawgBuilder.cpp \
     DefineForm.cpp \
     DefinitionBox.cpp \
     DefinitionDialog.cpp \
+    FixedWord.cpp \
     IntroForm.cpp \
     IscConnectionThread.cpp \
     IscConverter.cpp \
+    IscFrameCodec.cpp \
     JudgeDialog.cpp \
     JudgeSelectDialog.cpp \
     LetterBag.cpp \
+    LexiconBundle.cpp \
     LexiconSelectDialog.cpp \
     LexiconSelectWidget.cpp \
     LexiconStyleDialog.cpp \
@@ -72,6 +80,7 @@ SOURCES = \
     QuizForm.cpp \
     QuizProgress.cpp \
     QuizQuestion.cpp \
+    QuizSessionRecorder.cpp \
     QuizSpec.cpp \
     QuizStatsDatabase.cpp \
     QuizTimerSpec.cpp \
@@ -82,9 +91,11 @@ SOURCES = \
     SearchSpec.cpp \
     SearchSpecForm.cpp \
     SettingsDialog.cpp \
+    SharedWordGraph.cpp \
     WordEngine.cpp \
     WordEntryDialog.cpp \
     WordGraph.cpp \
+    WordLineEdit.cpp \
     WordListDialog.cpp \
     WordListSaveDialog.cpp \
     WordTableModel.cpp \
@@ -105,6 +116,8 @@ HEADERS = \
     CardboxRescheduleDaysSpinBox.h \
     CardboxRescheduleDialog.h \
     CreateDatabaseThread.h \
+    DatabaseBuildDialog.h \
+    DatabaseBuildScheduler.h \
     DatabaseRebuildDialog.h \
     DefineForm.h \
     DefinitionBox.h \
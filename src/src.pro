@@ -23,4 +23,4 @@
 #---------------------------------------------------------------------------
 
 TEMPLATE = subdirs
-SUBDIRS = libzyzzyva zyzzyva tests
+SUBDIRS = libzyzzyva zyzzyva tests tests/scale tests/iscreplay tests/quizreplay tests/searchload lexc
@@ -25,30 +25,103 @@
 #include <QtTest/QtTest>
 
 #include "WordEngine.h"
+#include "CreateDatabaseThread.h"
 #include "MainSettings.h"
+#include "QuizEngine.h"
+#include "QuizSpec.h"
 #include "Auxil.h"
 #include "Defs.h"
+#include <QTemporaryFile>
 
 class WordEngineTest : public QObject
 {
     Q_OBJECT
     public:
-    WordEngineTest() : prepared(false) { }
+    WordEngineTest() : prepared(false), customPrepared(false) { }
 
     private slots:
     void testSearch_data();
     void testSearch();
+    void testDefinitionSearch_data();
+    void testDefinitionSearch();
+    void testRefineSearch();
+    void testCountSearch();
+    void testAggregateSearch();
+    void testHookSignatures();
+    void testOverlay();
 
     private:
     void tryImport();
+    bool tryImportCustom();
+    void compareAggregate(const QString& lexicon, const SearchSpec& spec);
 
     private:
     WordEngine engine;
     bool prepared;
+    bool customPrepared;
+    QTemporaryFile customDatabaseFile;
 
 };
 
 QString TEST_LEXICON = Defs::LEXICON_OWL2;
+QString CUSTOM_LEXICON = Defs::LEXICON_CUSTOM;
+QString OVERLAY_BASE_LEXICON = "OverlayBase";
+QString OVERLAY_LEXICON = "Overlay";
+
+//---------------------------------------------------------------------------
+//  getTestFilename
+//
+//! Return the full path of a test data file.
+//
+//! @param name the name of the file
+//! @return the path of the file
+//---------------------------------------------------------------------------
+QString
+getTestFilename(const QString& name)
+{
+    return Auxil::getRootDir() + "/src/tests/data/" + name;
+}
+
+//---------------------------------------------------------------------------
+//  makeCondition
+//
+//! Create a search condition.
+//
+//! @param type the type of the condition
+//! @param stringValue the string value
+//! @param minValue the minimum value
+//! @param maxValue the maximum value
+//! @param negated whether the condition is negated
+//! @return the search condition
+//---------------------------------------------------------------------------
+SearchCondition
+makeCondition(SearchCondition::SearchType type, const QString& stringValue,
+              int minValue = 0, int maxValue = 0, bool negated = false)
+{
+    SearchCondition condition;
+    condition.type = type;
+    condition.stringValue = stringValue;
+    condition.minValue = minValue;
+    condition.maxValue = maxValue;
+    condition.negated = negated;
+    return condition;
+}
+
+//---------------------------------------------------------------------------
+//  makeSpec
+//
+//! Create a search spec from a list of conditions.
+//
+//! @param conditions the conditions
+//! @return the search spec
+//---------------------------------------------------------------------------
+SearchSpec
+makeSpec(const QList<SearchCondition>& conditions)
+{
+    SearchSpec spec;
+    spec.conditions = conditions;
+    return spec;
+}
 
 //---------------------------------------------------------------------------
 //  tryImport
@@ -61,22 +134,20 @@ WordEngineTest::tryImport()
     if (prepared)
         return;
 
-    bool ok = engine.importDawgFile(Auxil::getWordsDir() +
-                                    "/north-american/owl2.dwg",
-                                    Defs::LEXICON_CUSTOM, false);
+    bool ok = engine.importDawgFile(TEST_LEXICON, Auxil::getWordsDir() +
+                                    "/North-American/OWL2.dwg", false);
     if (!ok)
         return;
 
-    ok = engine.importDawgFile(Auxil::getWordsDir() +
-                               "/north-american/owl2-r.dwg",
-                               Defs::LEXICON_CUSTOM, true);
+    ok = engine.importDawgFile(TEST_LEXICON, Auxil::getWordsDir() +
+                               "/North-American/OWL2-R.dwg", true);
     if (!ok)
         return;
 
     engine.importStems(TEST_LEXICON, Auxil::getWordsDir() +
-                       "/north-american/6-letter-stems.txt");
+                       "/North-American/6-letter-stems.txt");
     engine.importStems(TEST_LEXICON, Auxil::getWordsDir() +
-                       "/north-american/7-letter-stems.txt");
+                       "/North-American/7-letter-stems.txt");
 
     MainSettings::setLetterDistribution("A:9 B:2 C:2 D:4 E:12 F:2 G:3 H:2 "
                                         "I:9 J:1 K:1 L:4 M:2 N:6 O:8 P:2 "
@@ -86,6 +157,45 @@ WordEngineTest::tryImport()
     prepared = true;
 }
 
+//---------------------------------------------------------------------------
+//  tryImportCustom
+//
+//! Try to import the small custom test lexicon into the WordEngine, and
+//! build and connect a database for it.
+//
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordEngineTest::tryImportCustom()
+{
+    if (customPrepared)
+        return true;
+
+    QString filename = getTestFilename("custom-lexicon.txt");
+    if (!engine.importTextFile(CUSTOM_LEXICON, filename))
+        return false;
+
+    if (!customDatabaseFile.open())
+        return false;
+    customDatabaseFile.close();
+
+    CreateDatabaseThread thread (&engine, CUSTOM_LEXICON,
+                                 customDatabaseFile.fileName(), filename);
+    thread.start();
+    thread.wait();
+    if (!thread.getError().isEmpty())
+        return false;
+
+    if (!engine.connectToDatabase(CUSTOM_LEXICON,
+                                  customDatabaseFile.fileName()))
+    {
+        return false;
+    }
+
+    customPrepared = true;
+    return true;
+}
+
 //---------------------------------------------------------------------------
 //  testSearch_data
 //
@@ -110,6 +220,8 @@ WordEngineTest::testSearch_data()
     QTest::newRow("8s-prob-1001-2000") << "8s-prob-1001-2000";
     QTest::newRow("anagram-Z-vowel-vowel") << "anagram-Z-vowel-vowel";
     QTest::newRow("pattern-vowel-D-vowel") << "pattern-vowel-D-vowel";
+    QTest::newRow("draw-AEINRSTT-over-5-percent")
+        << "draw-AEINRSTT-over-5-percent";
 
 }
 
@@ -166,6 +278,322 @@ WordEngineTest::testSearch()
     QCOMPARE(foundResults, expectedResults);
 }
 
+//---------------------------------------------------------------------------
+//  testDefinitionSearch_data
+//
+//! Set up Definition search tests.  Some words match only through the
+//! definitions they link to, and BAH links to a part of speech that BAA
+//! does not have, so it does not match.
+//---------------------------------------------------------------------------
+void
+WordEngineTest::testDefinitionSearch_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("replace link") << "sleeveless" << "ABA ABAS";
+    QTest::newRow("follow link") << "public notice"
+        << "AD ADS ADVERTISEMENT";
+    QTest::newRow("follow two links") << "amazement" << "AAH AAHS AH AHS";
+    QTest::newRow("missing part of speech") << "bleat" << "BAA BAAS";
+    QTest::newRow("no match") << "zebra" << "";
+}
+
+//---------------------------------------------------------------------------
+//  testDefinitionSearch
+//
+//! Test Definition search results, including text found in linked
+//! definitions.
+//---------------------------------------------------------------------------
+void
+WordEngineTest::testDefinitionSearch()
+{
+    if (!tryImportCustom())
+        QFAIL("Cannot import custom lexicon");
+
+    QFETCH(QString, text);
+    QFETCH(QString, expected);
+
+    QList<SearchCondition> conditions;
+    conditions << makeCondition(SearchCondition::Definition, text);
+    QStringList foundResults =
+        engine.search(CUSTOM_LEXICON, makeSpec(conditions), true);
+    qSort(foundResults);
+
+    QStringList expectedResults =
+        expected.split(" ", QString::SkipEmptyParts);
+    QCOMPARE(foundResults, expectedResults);
+}
+
+//---------------------------------------------------------------------------
+//  testRefineSearch
+//
+//! Test that refining the results of a search by adding a condition finds
+//! the same words as searching with all the conditions.
+//---------------------------------------------------------------------------
+void
+WordEngineTest::testRefineSearch()
+{
+    tryImport();
+
+    QList<SearchCondition> baseConditions;
+    baseConditions << makeCondition(SearchCondition::SubanagramMatch,
+                                    "AEINRSTT");
+    SearchSpec baseSpec = makeSpec(baseConditions);
+    QStringList baseResults = engine.search(TEST_LEXICON, baseSpec, true);
+    QVERIFY(!baseResults.isEmpty());
+
+    QList<SearchCondition> added;
+    added << makeCondition(SearchCondition::PatternMatch, "*T?")
+          << makeCondition(SearchCondition::PatternMatch, "S*", 0, 0, true)
+          << makeCondition(SearchCondition::AnagramMatch, "?AEINST")
+          << makeCondition(SearchCondition::AnagramMatch, "AEIN*")
+          << makeCondition(SearchCondition::SubanagramMatch, "[AE]RST??")
+          << makeCondition(SearchCondition::ConsistOf, "AEI", 40, 100)
+          << makeCondition(SearchCondition::DrawProbability, "AEINRSTT",
+                           50000000, 1000000000)
+          << makeCondition(SearchCondition::Length, QString(), 7, 7);
+
+    foreach (const SearchCondition& condition, added) {
+        SearchSpec spec = baseSpec;
+        spec.conditions.append(condition);
+
+        QStringList refinedResults = engine.refineSearch(TEST_LEXICON,
+            baseSpec, baseResults, spec, true);
+        qSort(refinedResults);
+        QStringList expectedResults = engine.search(TEST_LEXICON, spec,
+                                                    true);
+        qSort(expectedResults);
+        QCOMPARE(refinedResults, expectedResults);
+    }
+}
+
+//---------------------------------------------------------------------------
+//  testCountSearch
+//
+//! Test that counting the words matching a search finds as many words as
+//! the search itself.
+//---------------------------------------------------------------------------
+void
+WordEngineTest::testCountSearch()
+{
+    tryImport();
+
+    QList<QList<SearchCondition> > specs;
+    QList<SearchCondition> conditions;
+
+    conditions << makeCondition(SearchCondition::PatternMatch, "*");
+    specs << conditions;
+    conditions.clear();
+
+    conditions << makeCondition(SearchCondition::PatternMatch, "Q*");
+    specs << conditions;
+    conditions.clear();
+
+    conditions << makeCondition(SearchCondition::PatternMatch, "?*ING");
+    specs << conditions;
+    conditions.clear();
+
+    conditions << makeCondition(SearchCondition::PatternMatch, "Z??",
+                                0, 0, true)
+               << makeCondition(SearchCondition::Length, QString(), 3, 3);
+    specs << conditions;
+    conditions.clear();
+
+    conditions << makeCondition(SearchCondition::AnagramMatch, "?AEINST");
+    specs << conditions;
+    conditions.clear();
+
+    conditions << makeCondition(SearchCondition::AnagramMatch, "?QZ");
+    specs << conditions;
+    conditions.clear();
+
+    conditions << makeCondition(SearchCondition::AnagramMatch, "AERST??");
+    specs << conditions;
+    conditions.clear();
+
+    conditions << makeCondition(SearchCondition::SubanagramMatch,
+                                "AEINRSTT");
+    specs << conditions;
+    conditions.clear();
+
+    conditions << makeCondition(SearchCondition::SubanagramMatch,
+                                "AEINRST")
+               << makeCondition(SearchCondition::PatternMatch, "*S");
+    specs << conditions;
+    conditions.clear();
+
+    foreach (const QList<SearchCondition>& specConditions, specs) {
+        SearchSpec spec = makeSpec(specConditions);
+        QCOMPARE(engine.countSearch(TEST_LEXICON, spec),
+                 engine.search(TEST_LEXICON, spec, true).count());
+    }
+}
+
+//---------------------------------------------------------------------------
+//  compareAggregate
+//
+//! Compare the summary of a search, grouped by word length, with the words
+//! found by the search.
+//
+//! @param lexicon the name of the lexicon
+//! @param spec the search spec
+//---------------------------------------------------------------------------
+void
+WordEngineTest::compareAggregate(const QString& lexicon, const SearchSpec&
+                                 spec)
+{
+    WordEngine::AggregateSpec aggregate;
+    aggregate.firstGroup = WordEngine::LengthAttribute;
+    aggregate.valueAttribute = WordEngine::NumVowelsAttribute;
+
+    QMap<qint64, WordEngine::AggregateRow> expectedRows;
+    foreach (const QString& word, engine.search(lexicon, spec, true)) {
+        int numVowels = Auxil::getNumVowels(word);
+        WordEngine::AggregateRow& row = expectedRows[word.length()];
+        if (!row.count || (numVowels < row.minValue))
+            row.minValue = numVowels;
+        if (!row.count || (numVowels > row.maxValue))
+            row.maxValue = numVowels;
+        row.firstKey = word.length();
+        ++row.count;
+    }
+
+    QList<WordEngine::AggregateRow> rows =
+        engine.aggregateSearch(lexicon, spec, aggregate);
+    QCOMPARE(rows.count(), expectedRows.count());
+    foreach (const WordEngine::AggregateRow& row, rows) {
+        QVERIFY(expectedRows.contains(row.firstKey));
+        const WordEngine::AggregateRow& expectedRow =
+            expectedRows[row.firstKey];
+        QCOMPARE(row.count, expectedRow.count);
+        QCOMPARE(row.minValue, expectedRow.minValue);
+        QCOMPARE(row.maxValue, expectedRow.maxValue);
+    }
+}
+
+//---------------------------------------------------------------------------
+//  testAggregateSearch
+//
+//! Test search summaries, both summarized by the database and by scanning
+//! the matching words.
+//---------------------------------------------------------------------------
+void
+WordEngineTest::testAggregateSearch()
+{
+    tryImport();
+    if (!tryImportCustom())
+        QFAIL("Cannot import custom lexicon");
+
+    QList<SearchCondition> conditions;
+    conditions << makeCondition(SearchCondition::Length, QString(), 2, 15);
+    compareAggregate(CUSTOM_LEXICON, makeSpec(conditions));
+    if (QTest::currentTestFailed())
+        return;
+
+    conditions.clear();
+    conditions << makeCondition(SearchCondition::SubanagramMatch,
+                                "AEINRSTT");
+    compareAggregate(TEST_LEXICON, makeSpec(conditions));
+}
+
+//---------------------------------------------------------------------------
+//  testHookSignatures
+//
+//! Test checking responses to an Anagrams with Hooks quiz.
+//---------------------------------------------------------------------------
+void
+WordEngineTest::testHookSignatures()
+{
+    if (!tryImportCustom())
+        QFAIL("Cannot import custom lexicon");
+
+    QList<SearchCondition> conditions;
+    conditions << makeCondition(SearchCondition::AnagramMatch, "AB");
+
+    QuizSpec quizSpec;
+    quizSpec.setLexicon(CUSTOM_LEXICON);
+    quizSpec.setType(QuizSpec::QuizAnagramsWithHooks);
+    quizSpec.setQuestionOrder(QuizSpec::AlphabeticalOrder);
+    quizSpec.setSearchSpec(makeSpec(conditions));
+
+    QuizEngine quizEngine (&engine);
+    QVERIFY(quizEngine.newQuiz(quizSpec));
+    QCOMPARE(quizEngine.getQuestion(), QString("AB"));
+    QCOMPARE(quizEngine.getQuestionTotal(), 2);
+
+    // Hooks may be given in any order, but must all be given exactly once
+    QCOMPARE(quizEngine.respond("D:AB:A"), QuizEngine::Incorrect);
+    QCOMPARE(quizEngine.respond("D:AB:ASS"), QuizEngine::Incorrect);
+    QCOMPARE(quizEngine.respond("DA:AB:AS"), QuizEngine::Incorrect);
+    QCOMPARE(quizEngine.respond("Q:AB:AS"), QuizEngine::Incorrect);
+    QCOMPARE(quizEngine.respond("D:AB:SA"), QuizEngine::Correct);
+    QCOMPARE(quizEngine.respond("D:AB:AS"), QuizEngine::Duplicate);
+    QCOMPARE(quizEngine.respond("A:BA:SHDA"), QuizEngine::Correct);
+    QCOMPARE(quizEngine.getQuestionCorrect(), 2);
+
+    QCOMPARE(quizEngine.respond(quizEngine.getAnswerResponse("BA")),
+             QuizEngine::Duplicate);
+}
+
+//---------------------------------------------------------------------------
+//  testOverlay
+//
+//! Test a lexicon overlaid on a base lexicon, before and after the base
+//! lexicon is reloaded.
+//---------------------------------------------------------------------------
+void
+WordEngineTest::testOverlay()
+{
+    QVERIFY(engine.importTextFile(OVERLAY_BASE_LEXICON,
+                                  getTestFilename("custom-lexicon.txt"),
+                                  false));
+    QVERIFY(engine.importOverlayFile(OVERLAY_LEXICON, OVERLAY_BASE_LEXICON,
+        getTestFilename("custom-overlay.txt")));
+
+    QVERIFY(engine.isAcceptable(OVERLAY_LEXICON, "AB"));
+    QVERIFY(engine.isAcceptable(OVERLAY_LEXICON, "HAH"));
+    QVERIFY(!engine.isAcceptable(OVERLAY_LEXICON, "BADS"));
+    QVERIFY(!engine.isAcceptable(OVERLAY_BASE_LEXICON, "HAH"));
+    QVERIFY(engine.isAcceptable(OVERLAY_BASE_LEXICON, "BADS"));
+
+    QList<SearchCondition> conditions;
+    conditions << makeCondition(SearchCondition::PatternMatch, "?A*");
+    SearchSpec spec = makeSpec(conditions);
+    QStringList foundResults = engine.search(OVERLAY_LEXICON, spec, true);
+    qSort(foundResults);
+    QStringList expectedResults;
+    expectedResults << "AA" << "AAH" << "AAHS" << "AAS" << "BA" << "BAA"
+                    << "BAAS" << "BAD" << "BAH" << "BAS" << "DAB" << "DABS"
+                    << "HA" << "HAH" << "HAS";
+    QCOMPARE(foundResults, expectedResults);
+    QCOMPARE(engine.countSearch(OVERLAY_LEXICON, spec),
+             expectedResults.count());
+
+    // A failed reload leaves the base lexicon and the overlay as they were
+    QVERIFY(!engine.importTextFile(OVERLAY_BASE_LEXICON,
+                                   getTestFilename("no-such-file.txt"),
+                                   false));
+    QVERIFY(engine.isAcceptable(OVERLAY_BASE_LEXICON, "AB"));
+    QVERIFY(engine.isAcceptable(OVERLAY_LEXICON, "AB"));
+    QVERIFY(engine.isAcceptable(OVERLAY_LEXICON, "HAH"));
+
+    // Reloading the base lexicon applies the overlay to its new words
+    QVERIFY(engine.importTextFile(OVERLAY_BASE_LEXICON,
+        getTestFilename("custom-lexicon-rebase.txt"), false));
+    QVERIFY(engine.lexiconIsLoaded(OVERLAY_LEXICON));
+    QVERIFY(engine.isAcceptable(OVERLAY_LEXICON, "ZA"));
+    QVERIFY(engine.isAcceptable(OVERLAY_LEXICON, "HAH"));
+    QVERIFY(!engine.isAcceptable(OVERLAY_LEXICON, "AB"));
+    QVERIFY(!engine.isAcceptable(OVERLAY_LEXICON, "BADS"));
+
+    foundResults = engine.search(OVERLAY_LEXICON, spec, true);
+    qSort(foundResults);
+    expectedResults.clear();
+    expectedResults << "HA" << "HAH" << "ZA";
+    QCOMPARE(foundResults, expectedResults);
+}
+
 // Create a main function for a standalone executable
 QTEST_MAIN(WordEngineTest);
 #include "WordEngineTest.moc"
@@ -0,0 +1,66 @@
+//---------------------------------------------------------------------------
+// IscReplayClient.cpp
+//
+// A client that measures messages received from a replayed ISC session.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "IscReplayClient.h"
+
+//---------------------------------------------------------------------------
+//  IscReplayClient
+//
+//! Constructor.
+//
+//! @param e the messages expected, in order
+//! @param c the clock used to time stamp received messages
+//! @param parent the parent object
+//---------------------------------------------------------------------------
+IscReplayClient::IscReplayClient(const QStringList& e, const QElapsedTimer* c,
+                                 QObject* parent)
+    : QObject(parent), expected(e), clock(c), receiveTimes(e.count(), -1),
+      numReceived(0), numMismatches(0), numBytes(0)
+{
+}
+
+//---------------------------------------------------------------------------
+//  messageReceived
+//
+//! Called when the connection delivers a message.  Record when it arrived
+//! and whether it matches the message sent.
+//
+//! @param message the message
+//---------------------------------------------------------------------------
+void
+IscReplayClient::messageReceived(const QString& message)
+{
+    if (isDone()) {
+        ++numMismatches;
+        return;
+    }
+
+    receiveTimes[numReceived] = clock->nsecsElapsed();
+    if (message != expected[numReceived])
+        ++numMismatches;
+    numBytes += message.length();
+
+    if (++numReceived == expected.count())
+        emit finished();
+}
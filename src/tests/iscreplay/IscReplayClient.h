@@ -0,0 +1,62 @@
+//---------------------------------------------------------------------------
+// IscReplayClient.h
+//
+// A client that measures messages received from a replayed ISC session.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#ifndef ZYZZYVA_ISC_REPLAY_CLIENT_H
+#define ZYZZYVA_ISC_REPLAY_CLIENT_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+
+class IscReplayClient : public QObject
+{
+    Q_OBJECT
+    public:
+    IscReplayClient(const QStringList& e, const QElapsedTimer* c,
+                    QObject* parent = 0);
+    ~IscReplayClient() { }
+
+    int getNumReceived() const { return numReceived; }
+    int getNumMismatches() const { return numMismatches; }
+    qint64 getNumBytes() const { return numBytes; }
+    QVector<qint64> getReceiveTimes() const { return receiveTimes; }
+    bool isDone() const { return numReceived >= expected.count(); }
+
+    public slots:
+    void messageReceived(const QString& message);
+
+    signals:
+    void finished();
+
+    private:
+    QStringList expected;
+    const QElapsedTimer* clock;
+    QVector<qint64> receiveTimes;
+    int numReceived;
+    int numMismatches;
+    qint64 numBytes;
+};
+
+#endif // ZYZZYVA_ISC_REPLAY_CLIENT_H
@@ -0,0 +1,262 @@
+//---------------------------------------------------------------------------
+// IscReplayServer.cpp
+//
+// A local stand-in ISC server that replays recorded sessions.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "IscReplayServer.h"
+#include "IscFrameCodec.h"
+#include "Defs.h"
+#include <QFile>
+#include <QRegExp>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+using namespace Defs;
+
+const int MAX_BATCH_SIZE = 16384;
+const int WRITE_TIMEOUT = 10000;
+const int DISCONNECT_TIMEOUT = 1000;
+
+//---------------------------------------------------------------------------
+//  IscReplayServer
+//
+//! Constructor.
+//
+//! @param e the session entries to replay
+//! @param c the clock used to time stamp sent messages
+//! @param parent the parent object
+//---------------------------------------------------------------------------
+IscReplayServer::IscReplayServer(const QList<Entry>& e, const QElapsedTimer*
+                                 c, QObject* parent)
+    : QThread(parent), entries(e), clock(c), requestedPort(0), rate(1.0),
+      messagesPerSecond(0), fragmentSize(0), serveForever(false),
+      boundPort(0), sendTimes(e.count(), -1)
+{
+}
+
+//---------------------------------------------------------------------------
+//  readSession
+//
+//! Read a recorded session.  Each non-empty line that does not begin with
+//! '#' holds the time in milliseconds since the connection was established,
+//! followed by a space and the message as the server sent it.
+//
+//! @param filename the session file
+//! @param entries return the session entries
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+IscReplayServer::readSession(const QString& filename, QList<Entry>* entries,
+                             QString* errString)
+{
+    QFile file (filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errString) {
+            *errString = "Can't open file '" + filename + "': " +
+                file.errorString();
+        }
+        return false;
+    }
+
+    char* buffer = new char[MAX_INPUT_LINE_LEN];
+    int lineNum = 0;
+    while (file.readLine(buffer, MAX_INPUT_LINE_LEN) > 0) {
+        ++lineNum;
+        QString line = QString::fromUtf8(buffer);
+        line.remove(QRegExp("[\\r\\n]+$"));
+        if (line.trimmed().isEmpty() || line.startsWith("#"))
+            continue;
+
+        bool ok = false;
+        qint64 offset = line.section(' ', 0, 0).toLongLong(&ok);
+        if (!ok || (offset < 0)) {
+            if (errString) {
+                *errString = "Invalid time at line " +
+                    QString::number(lineNum) + " of '" + filename + "'.";
+            }
+            delete[] buffer;
+            return false;
+        }
+        entries->append(Entry(offset, line.section(' ', 1)));
+    }
+    delete[] buffer;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  waitForListening
+//
+//! Wait until the server is listening for connections.  Must be called after
+//! the thread is started.
+//
+//! @param port return the port the server is listening on
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+IscReplayServer::waitForListening(quint16* port, QString* errString)
+{
+    listening.acquire();
+    if (!listenError.isEmpty()) {
+        if (errString)
+            *errString = listenError;
+        return false;
+    }
+
+    if (port)
+        *port = boundPort;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  run
+//
+//! Listen for connections and replay the session to each client.
+//---------------------------------------------------------------------------
+void
+IscReplayServer::run()
+{
+    QTcpServer server;
+    if (!server.listen(QHostAddress::LocalHost, requestedPort)) {
+        listenError = server.errorString();
+        listening.release();
+        return;
+    }
+
+    boundPort = server.serverPort();
+    listening.release();
+
+    do {
+        if (!server.waitForNewConnection(-1))
+            break;
+
+        QTcpSocket* socket = server.nextPendingConnection();
+        if (!socket)
+            continue;
+
+        replay(socket);
+        socket->disconnectFromHost();
+        if (socket->state() != QAbstractSocket::UnconnectedState)
+            socket->waitForDisconnected(DISCONNECT_TIMEOUT);
+        delete socket;
+    } while (serveForever);
+}
+
+//---------------------------------------------------------------------------
+//  getDueTime
+//
+//! Determine when a message is due, relative to the start of the replay.
+//
+//! @param index the index of the session entry
+//! @return the due time in nanoseconds
+//---------------------------------------------------------------------------
+qint64
+IscReplayServer::getDueTime(int index) const
+{
+    if (messagesPerSecond > 0)
+        return qint64(index) * 1000000000LL / messagesPerSecond;
+    if (rate > 0)
+        return qint64(entries[index].offset * 1000000.0 / rate);
+    return 0;
+}
+
+//---------------------------------------------------------------------------
+//  replay
+//
+//! Replay the session to a connected client.  Messages that are due at the
+//! same time are sent together, so bursts of traffic arrive the way they do
+//! from the real server.
+//
+//! @param socket the client socket
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+IscReplayServer::replay(QTcpSocket* socket)
+{
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+    qint64 start = clock->nsecsElapsed();
+    QByteArray pending;
+    QList<int> pendingIndexes;
+    for (int i = 0; i < entries.count(); ++i) {
+        qint64 due = start + getDueTime(i);
+        if (due > clock->nsecsElapsed()) {
+            if (!flush(socket, pending, pendingIndexes))
+                return false;
+            qint64 wait = due - clock->nsecsElapsed();
+            if (wait > 0)
+                usleep((unsigned long)(wait / 1000));
+        }
+
+        pending.append(IscFrameCodec::encode(entries[i].message));
+        pendingIndexes.append(i);
+        if ((pending.size() >= MAX_BATCH_SIZE) &&
+            !flush(socket, pending, pendingIndexes))
+        {
+            return false;
+        }
+    }
+
+    return flush(socket, pending, pendingIndexes);
+}
+
+//---------------------------------------------------------------------------
+//  flush
+//
+//! Write pending frames to the client, split into fragments if a fragment
+//! size is set, and record when each message was sent.  Input from the
+//! client is discarded.
+//
+//! @param socket the client socket
+//! @param pending the pending bytes, cleared when written
+//! @param pendingIndexes the indexes of pending session entries, cleared
+//! when written
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+IscReplayServer::flush(QTcpSocket* socket, QByteArray& pending, QList<int>&
+                       pendingIndexes)
+{
+    if (pending.isEmpty())
+        return true;
+
+    int chunkSize = (fragmentSize > 0) ? fragmentSize : pending.size();
+    for (int pos = 0; pos < pending.size(); pos += chunkSize) {
+        int size = qMin(chunkSize, pending.size() - pos);
+        if (socket->write(pending.constData() + pos, size) != size)
+            return false;
+        while (socket->bytesToWrite()) {
+            if (!socket->waitForBytesWritten(WRITE_TIMEOUT))
+                return false;
+        }
+    }
+
+    qint64 now = clock->nsecsElapsed();
+    foreach (int index, pendingIndexes)
+        sendTimes[index] = now;
+
+    pending.clear();
+    pendingIndexes.clear();
+    socket->readAll();
+    return true;
+}
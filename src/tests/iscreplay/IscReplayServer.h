@@ -0,0 +1,89 @@
+//---------------------------------------------------------------------------
+// IscReplayServer.h
+//
+// A local stand-in ISC server that replays recorded sessions.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#ifndef ZYZZYVA_ISC_REPLAY_SERVER_H
+#define ZYZZYVA_ISC_REPLAY_SERVER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QSemaphore>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+class QTcpSocket;
+
+class IscReplayServer : public QThread
+{
+    public:
+    class Entry {
+        public:
+        Entry() : offset(0) { }
+        Entry(qint64 o, const QString& m) : offset(o), message(m) { }
+        qint64 offset;
+        QString message;
+    };
+
+    public:
+    IscReplayServer(const QList<Entry>& e, const QElapsedTimer* c,
+                    QObject* parent = 0);
+    ~IscReplayServer() { }
+
+    static bool readSession(const QString& filename, QList<Entry>* entries,
+                            QString* errString = 0);
+
+    void setPort(quint16 p) { requestedPort = p; }
+    void setRate(double r) { rate = r; }
+    void setMessagesPerSecond(int mps) { messagesPerSecond = mps; }
+    void setFragmentSize(int size) { fragmentSize = size; }
+    void setServeForever(bool forever) { serveForever = forever; }
+
+    bool waitForListening(quint16* port, QString* errString = 0);
+    QVector<qint64> getSendTimes() const { return sendTimes; }
+
+    protected:
+    void run();
+
+    private:
+    qint64 getDueTime(int index) const;
+    bool replay(QTcpSocket* socket);
+    bool flush(QTcpSocket* socket, QByteArray& pending, QList<int>&
+               pendingIndexes);
+
+    private:
+    QList<Entry> entries;
+    const QElapsedTimer* clock;
+    quint16 requestedPort;
+    double rate;
+    int messagesPerSecond;
+    int fragmentSize;
+    bool serveForever;
+
+    QSemaphore listening;
+    quint16 boundPort;
+    QString listenError;
+    QVector<qint64> sendTimes;
+};
+
+#endif // ZYZZYVA_ISC_REPLAY_SERVER_H
@@ -0,0 +1,276 @@
+//---------------------------------------------------------------------------
+// IscReplayTool.cpp
+//
+// A tool for benchmarking the ISC client pipeline against replayed sessions.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "IscReplayClient.h"
+#include "IscReplayServer.h"
+#include "IscConnectionThread.h"
+#include "Rand.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <QtAlgorithms>
+#include <iostream>
+
+using namespace std;
+
+const QString PING_MESSAGE = "PING REPLY";
+const int DEFAULT_TIMEOUT = 60;
+const int MIN_GENERATED_LENGTH = 8;
+const int MAX_GENERATED_LENGTH = 400;
+
+//---------------------------------------------------------------------------
+//  usage
+//
+//! Print a usage message.
+//---------------------------------------------------------------------------
+void
+usage()
+{
+    cerr << "Usage: iscreplay [options] [<session-file>]" << endl
+         << endl
+         << "Replay a recorded ISC session from a local server and measure"
+         << endl
+         << "the throughput and latency of the client connection pipeline."
+         << endl
+         << "Each line of the session file holds the time in milliseconds"
+         << endl
+         << "since login, a space, and the message sent by the server."
+         << endl
+         << endl
+         << "Options:" << endl
+         << "  -g <count>      replay <count> generated messages instead"
+         << endl
+         << "  -r <factor>     replay speed relative to the recording, or 0"
+         << endl
+         << "                  for no delays (default 1)" << endl
+         << "  -m <rate>       send <rate> messages per second, ignoring"
+         << endl
+         << "                  recorded times" << endl
+         << "  -f <bytes>      split writes into fragments of <bytes>" << endl
+         << "  -p <port>       listen on <port> (default any free port)"
+         << endl
+         << "  -s              only serve the session to other clients" << endl
+         << "  -t <seconds>    give up after <seconds> (default "
+         << DEFAULT_TIMEOUT << ")" << endl;
+}
+
+//---------------------------------------------------------------------------
+//  generateSession
+//
+//! Generate a session of messages of varying length, all sent at once.
+//
+//! @param count the number of messages
+//! @param entries return the session entries
+//---------------------------------------------------------------------------
+void
+generateSession(int count, QList<IscReplayServer::Entry>* entries)
+{
+    Rand rng;
+    rng.srand(count, ~count);
+    for (int i = 0; i < count; ++i) {
+        int length = MIN_GENERATED_LENGTH +
+            int(rng.rand(MAX_GENERATED_LENGTH - MIN_GENERATED_LENGTH));
+        QString text (length, QChar('A' + (i % 26)));
+        entries->append(IscReplayServer::Entry(
+            0, QString("TELL REPLAY %1 %2").arg(i).arg(text)));
+    }
+}
+
+//---------------------------------------------------------------------------
+//  percentile
+//
+//! Return a percentile of a sorted list of values.
+//
+//! @param values the sorted values
+//! @param pct the percentile
+//! @return the value
+//---------------------------------------------------------------------------
+qint64
+percentile(const QVector<qint64>& values, int pct)
+{
+    if (values.isEmpty())
+        return 0;
+    return values[(values.count() - 1) * pct / 100];
+}
+
+//---------------------------------------------------------------------------
+//  main
+//
+//! Run the replay server, and unless serving only, benchmark a client
+//! connection against it.
+//---------------------------------------------------------------------------
+int
+main(int argc, char** argv)
+{
+    QCoreApplication app (argc, argv);
+
+    int generateCount = 0;
+    double rate = 1.0;
+    int messagesPerSecond = 0;
+    int fragmentSize = 0;
+    quint16 port = 0;
+    bool serveOnly = false;
+    int timeout = DEFAULT_TIMEOUT;
+    QString sessionFile;
+
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.count(); ++i) {
+        const QString& arg = args[i];
+        if (arg == "-s") {
+            serveOnly = true;
+            continue;
+        }
+        if (!arg.startsWith("-")) {
+            sessionFile = arg;
+            continue;
+        }
+        if (i + 1 >= args.count()) {
+            usage();
+            return 1;
+        }
+        QString value = args[++i];
+        if (arg == "-g")
+            generateCount = value.toInt();
+        else if (arg == "-r")
+            rate = value.toDouble();
+        else if (arg == "-m")
+            messagesPerSecond = value.toInt();
+        else if (arg == "-f")
+            fragmentSize = value.toInt();
+        else if (arg == "-p")
+            port = value.toUShort();
+        else if (arg == "-t")
+            timeout = value.toInt();
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    if ((generateCount <= 0) == sessionFile.isEmpty()) {
+        usage();
+        return 1;
+    }
+
+    QList<IscReplayServer::Entry> entries;
+    QString errString;
+    if (generateCount > 0)
+        generateSession(generateCount, &entries);
+    else if (!IscReplayServer::readSession(sessionFile, &entries,
+                                           &errString))
+    {
+        cerr << errString.toLocal8Bit().constData() << endl;
+        return 1;
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+
+    IscReplayServer server (entries, &clock);
+    server.setPort(port);
+    server.setRate(rate);
+    server.setMessagesPerSecond(messagesPerSecond);
+    server.setFragmentSize(fragmentSize);
+    server.setServeForever(serveOnly);
+    server.start();
+    if (!server.waitForListening(&port, &errString)) {
+        cerr << errString.toLocal8Bit().constData() << endl;
+        server.wait();
+        return 1;
+    }
+
+    if (serveOnly) {
+        cout << "Listening on port " << port << "." << endl;
+        server.wait();
+        return 0;
+    }
+
+    // The connection answers pings itself instead of passing them on
+    QStringList expected;
+    QVector<int> entryIndexes;
+    for (int i = 0; i < entries.count(); ++i) {
+        if (entries[i].message == PING_MESSAGE)
+            continue;
+        expected.append(entries[i].message);
+        entryIndexes.append(i);
+    }
+
+    IscReplayClient client (expected, &clock);
+    IscConnectionThread connection;
+    connection.setServer("127.0.0.1", port);
+    QObject::connect(&connection, SIGNAL(messageReceived(const QString&)),
+                     &client, SLOT(messageReceived(const QString&)));
+    QObject::connect(&client, SIGNAL(finished()), &app, SLOT(quit()));
+    QTimer::singleShot(timeout * 1000, &app, SLOT(quit()));
+
+    QAbstractSocket::SocketError socketError;
+    if (!connection.connectToServer("replay replay", &socketError)) {
+        cerr << "Can't connect to replay server (error "
+             << int(socketError) << ")." << endl;
+        return 1;
+    }
+
+    if (!client.isDone())
+        app.exec();
+    connection.disconnectFromServer();
+    server.wait();
+
+    QVector<qint64> sendTimes = server.getSendTimes();
+    QVector<qint64> receiveTimes = client.getReceiveTimes();
+    QVector<qint64> latencies;
+    qint64 firstSend = -1;
+    qint64 lastReceive = -1;
+    for (int i = 0; i < client.getNumReceived(); ++i) {
+        qint64 sent = sendTimes[entryIndexes[i]];
+        qint64 received = receiveTimes[i];
+        if ((sent < 0) || (received < 0))
+            continue;
+        if ((firstSend < 0) || (sent < firstSend))
+            firstSend = sent;
+        lastReceive = qMax(lastReceive, received);
+        latencies.append(qMax(received - sent, qint64(0)));
+    }
+    qSort(latencies);
+
+    double seconds = (firstSend >= 0) && (lastReceive > firstSend) ?
+        (lastReceive - firstSend) / 1e9 : 0;
+
+    cout << "messages_expected," << expected.count() << endl
+         << "messages_received," << client.getNumReceived() << endl
+         << "messages_mismatched," << client.getNumMismatches() << endl
+         << "bytes_received," << client.getNumBytes() << endl
+         << "seconds," << seconds << endl
+         << "messages_per_second,"
+         << (seconds > 0 ? client.getNumReceived() / seconds : 0) << endl
+         << "latency_p50_us," << percentile(latencies, 50) / 1000 << endl
+         << "latency_p95_us," << percentile(latencies, 95) / 1000 << endl
+         << "latency_p99_us," << percentile(latencies, 99) / 1000 << endl
+         << "latency_max_us," << percentile(latencies, 100) / 1000 << endl;
+
+    bool ok = (client.getNumReceived() == expected.count()) &&
+        !client.getNumMismatches();
+    return ok ? 0 : 1;
+}
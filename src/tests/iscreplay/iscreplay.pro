@@ -0,0 +1,52 @@
+#---------------------------------------------------------------------------
+# iscreplay.pro
+#
+# Build configuration file for the Zyzzyva ISC replay tool using qmake.
+#
+# Copyright 2012 Boshvark Software, LLC.
+#
+# This file is part of Zyzzyva.
+#
+# Zyzzyva is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# Zyzzyva is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#---------------------------------------------------------------------------
+
+TEMPLATE = app
+TARGET = iscreplay
+CONFIG += qt thread warn_on console
+CONFIG -= app_bundle
+QT += network sql xml
+
+ROOT = ../../..
+DESTDIR = $$ROOT/bin
+INCLUDEPATH += $$ROOT/src/libzyzzyva
+
+include($$ROOT/zyzzyva.pri)
+
+unix {
+    LIBS = -lzyzzyva -L$$ROOT/bin
+}
+win32 {
+    LIBS = -lzyzzyva2 -L$$ROOT/bin
+}
+
+# Source files
+SOURCES = \
+    IscReplayClient.cpp \
+    IscReplayServer.cpp \
+    IscReplayTool.cpp
+
+# Header files that must be run through moc
+HEADERS = \
+    IscReplayClient.h
@@ -0,0 +1,420 @@
+//---------------------------------------------------------------------------
+// QuizReplayTool.cpp
+//
+// A tool for benchmarking the quiz engine against recorded quiz sessions.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "MainSettings.h"
+#include "QuizEngine.h"
+#include "QuizSessionRecorder.h"
+#include "QuizSpec.h"
+#include "QuizStatsDatabase.h"
+#include "WordEngine.h"
+#include "Auxil.h"
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <QtAlgorithms>
+#include <iostream>
+
+using namespace std;
+
+const QString DEFAULT_LETTER_DISTRIBUTION = "A:9 B:2 C:2 D:4 E:12 F:2 G:3 "
+    "H:2 I:9 J:1 K:1 L:4 M:2 N:6 O:8 P:2 Q:1 R:6 S:4 T:6 U:4 V:2 W:2 X:1 "
+    "Y:2 Z:1 _:2";
+
+//---------------------------------------------------------------------------
+//  Sleeper
+//
+//! Expose the protected QThread sleep functions to the main thread.
+//---------------------------------------------------------------------------
+class Sleeper : public QThread
+{
+    public:
+    static void sleepNsecs(qint64 nsecs) {
+        QThread::usleep((unsigned long)(nsecs / 1000)); }
+};
+
+//---------------------------------------------------------------------------
+//  QuizReplayer
+//
+//! Apply recorded quiz session events to a quiz engine and a quiz stats
+//! database, performing the same engine and database work QuizForm
+//! performs for each event.
+//---------------------------------------------------------------------------
+class QuizReplayer
+{
+    public:
+    QuizReplayer(WordEngine* e) : quizEngine(e), statsDatabase(0) { }
+    ~QuizReplayer() { delete statsDatabase; }
+
+    bool replay(const QuizSessionRecorder::Event& event, QString* errString);
+
+    private:
+    void readQuestionData();
+
+    QuizEngine quizEngine;
+    QuizStatsDatabase* statsDatabase;
+};
+
+//---------------------------------------------------------------------------
+//  replay
+//
+//! Replay a single event.
+//
+//! @param event the event
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+QuizReplayer::replay(const QuizSessionRecorder::Event& event,
+                     QString* errString)
+{
+    const QString& arg = event.argument;
+    QString question = quizEngine.getQuestion();
+
+    switch (event.type) {
+        case QuizSessionRecorder::QuizSpecEvent: {
+            QuizSpec spec;
+            if (!QuizSessionRecorder::parseQuizSpec(arg, &spec, errString))
+                return false;
+            delete statsDatabase;
+            statsDatabase = 0;
+            if (!quizEngine.newQuiz(spec)) {
+                if (errString)
+                    *errString = "No questions found for recorded quiz.";
+                return false;
+            }
+            statsDatabase = new QuizStatsDatabase(spec.getLexicon(),
+                Auxil::quizTypeToString(spec.getType()));
+            if (!statsDatabase->isValid()) {
+                delete statsDatabase;
+                statsDatabase = 0;
+            }
+            readQuestionData();
+        }
+        break;
+
+        case QuizSessionRecorder::RespondEvent:
+        quizEngine.respond(arg.section(' ', 1), arg.section(' ', 0, 0) == "1");
+        break;
+
+        case QuizSessionRecorder::CheckEvent: {
+            quizEngine.completeQuestion();
+            bool correct = (arg.section(' ', 0, 0) == "1");
+            bool recordStats = (arg.section(' ', 1, 1) == "1");
+            bool updateStatus = (arg.section(' ', 2, 2) == "1");
+            if (statsDatabase && recordStats) {
+                bool updateCardbox = (quizEngine.getQuizSpec().getMethod() ==
+                                      QuizSpec::CardboxQuizMethod);
+                statsDatabase->recordResponse(question, correct,
+                                              updateCardbox);
+            }
+            if (updateStatus)
+                readQuestionData();
+        }
+        break;
+
+        case QuizSessionRecorder::NextEvent:
+        quizEngine.nextQuestion();
+        readQuestionData();
+        break;
+
+        case QuizSessionRecorder::MarkMissedEvent:
+        quizEngine.markQuestionAsMissed();
+        break;
+
+        case QuizSessionRecorder::MarkCorrectEvent:
+        quizEngine.markQuestionAsCorrect();
+        break;
+
+        case QuizSessionRecorder::UndoResponseEvent:
+        if (statsDatabase)
+            statsDatabase->undoLastResponse(question);
+        break;
+
+        case QuizSessionRecorder::CardboxEvent:
+        if (statsDatabase)
+            statsDatabase->setCardbox(question, arg.toInt());
+        readQuestionData();
+        break;
+
+        default:
+        if (errString)
+            *errString = "Unknown event type.";
+        return false;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  readQuestionData
+//
+//! Read the stats of the current question, as QuizForm does when it
+//! displays the question status.
+//---------------------------------------------------------------------------
+void
+QuizReplayer::readQuestionData()
+{
+    if (statsDatabase)
+        statsDatabase->getQuestionData(quizEngine.getQuestion());
+}
+
+//---------------------------------------------------------------------------
+//  percentile
+//
+//! Return a percentile of a sorted list of values.
+//
+//! @param values the sorted values
+//! @param pct the percentile
+//! @return the value
+//---------------------------------------------------------------------------
+qint64
+percentile(const QVector<qint64>& values, int pct)
+{
+    if (values.isEmpty())
+        return 0;
+    return values[(values.count() - 1) * pct / 100];
+}
+
+//---------------------------------------------------------------------------
+//  reportLatencies
+//
+//! Print the latency percentiles of one event type as a CSV line.
+//
+//! @param name the event type name
+//! @param latencies the latencies in nanoseconds
+//---------------------------------------------------------------------------
+void
+reportLatencies(const QString& name, QVector<qint64> latencies)
+{
+    qSort(latencies);
+    cout << name.toUtf8().constData() << "," << latencies.count() << ","
+         << percentile(latencies, 50) / 1000 << ","
+         << percentile(latencies, 95) / 1000 << ","
+         << percentile(latencies, 99) / 1000 << ","
+         << percentile(latencies, 100) / 1000 << endl;
+}
+
+//---------------------------------------------------------------------------
+//  loadLexicon
+//
+//! Load a lexicon from a word list or a compiled lexicon bundle, and
+//! optionally connect it to a lexicon database.
+//
+//! @param engine the word engine
+//! @param lexicon the lexicon name
+//! @param filename the word list or bundle file
+//! @param dbFilename the database file, or empty
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+loadLexicon(WordEngine* engine, const QString& lexicon,
+            const QString& filename, const QString& dbFilename,
+            QString* errString)
+{
+    if (filename.endsWith(".zlx")) {
+        if (!engine->importLexiconBundle(lexicon, filename, errString))
+            return false;
+    }
+    else if (engine->importTextFile(lexicon, filename, true,
+                                    errString) <= 0)
+    {
+        return false;
+    }
+
+    if (!dbFilename.isEmpty() &&
+        !engine->connectToDatabase(lexicon, dbFilename, errString))
+    {
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  usage
+//
+//! Print a usage message.
+//---------------------------------------------------------------------------
+void
+usage()
+{
+    cerr << "Usage: quizreplay [options] -l <lexicon-file> <session-file>"
+         << endl
+         << endl
+         << "Replay a recorded quiz session against the quiz engine and the"
+         << endl
+         << "quiz stats database without any widgets, and report latency"
+         << endl
+         << "percentiles for each event type as CSV:" << endl
+         << "event,count,p50_us,p95_us,p99_us,max_us" << endl
+         << endl
+         << "Options:" << endl
+         << "  -l <file>       word list or .zlx bundle to load as the"
+         << endl
+         << "                  lexicon of each recorded quiz" << endl
+         << "  -d <file>       lexicon database to connect" << endl
+         << "  -u <dir>        user data directory for quiz stats (default"
+         << endl
+         << "                  a temporary directory)" << endl
+         << "  -r <factor>     replay speed relative to the recording, or 0"
+         << endl
+         << "                  for no delays (default 0)" << endl;
+}
+
+//---------------------------------------------------------------------------
+//  main
+//
+//! Replay a quiz session and report event latencies.
+//---------------------------------------------------------------------------
+int
+main(int argc, char** argv)
+{
+    QApplication app (argc, argv, false);
+
+    QString lexiconFile;
+    QString dbFile;
+    QString userDir = QDir::tempPath() + "/zyzzyva-quizreplay";
+    double rate = 0;
+    QString sessionFile;
+
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.count(); ++i) {
+        const QString& arg = args[i];
+        if (!arg.startsWith("-")) {
+            sessionFile = arg;
+            continue;
+        }
+        if (i + 1 >= args.count()) {
+            usage();
+            return 1;
+        }
+        QString value = args[++i];
+        if (arg == "-l")
+            lexiconFile = value;
+        else if (arg == "-d")
+            dbFile = value;
+        else if (arg == "-u")
+            userDir = value;
+        else if (arg == "-r")
+            rate = value.toDouble();
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (sessionFile.isEmpty() || lexiconFile.isEmpty() || (rate < 0)) {
+        usage();
+        return 1;
+    }
+
+    QList<QuizSessionRecorder::Event> events;
+    QString errString;
+    if (!QuizSessionRecorder::readSession(sessionFile, &events, &errString)) {
+        cerr << errString.toLocal8Bit().constData() << endl;
+        return 1;
+    }
+
+    QDir dir;
+    if (!dir.mkpath(userDir)) {
+        cerr << "Cannot create directory '"
+             << userDir.toLocal8Bit().constData() << "'." << endl;
+        return 1;
+    }
+
+    // Keep quiz stats out of the real user data directory unless asked
+    MainSettings::setUserDataDir(userDir);
+    MainSettings::setLetterDistribution(DEFAULT_LETTER_DISTRIBUTION);
+
+    // Load every lexicon named by the session before timing anything
+    WordEngine engine;
+    QSet<QString> lexicons;
+    foreach (const QuizSessionRecorder::Event& event, events) {
+        if (event.type != QuizSessionRecorder::QuizSpecEvent)
+            continue;
+        QuizSpec spec;
+        if (!QuizSessionRecorder::parseQuizSpec(event.argument, &spec,
+                                                &errString))
+        {
+            cerr << errString.toLocal8Bit().constData() << endl;
+            return 1;
+        }
+        QString lexicon = spec.getLexicon();
+        if (lexicons.contains(lexicon))
+            continue;
+        if (!loadLexicon(&engine, lexicon, lexiconFile, dbFile, &errString))
+        {
+            cerr << "Cannot load lexicon '"
+                 << lexiconFile.toLocal8Bit().constData() << "': "
+                 << errString.toLocal8Bit().constData() << endl;
+            return 1;
+        }
+        lexicons.insert(lexicon);
+    }
+
+    QuizReplayer replayer (&engine);
+    QMap<int, QVector<qint64> > latencies;
+    QVector<qint64> allLatencies;
+    int numErrors = 0;
+
+    QElapsedTimer clock;
+    clock.start();
+    qint64 firstTime = events.isEmpty() ? 0 : events.first().time;
+    foreach (const QuizSessionRecorder::Event& event, events) {
+        if (rate > 0) {
+            qint64 due = qint64((event.time - firstTime) * 1e6 / rate);
+            qint64 wait = due - clock.nsecsElapsed();
+            if (wait > 0)
+                Sleeper::sleepNsecs(wait);
+        }
+
+        qint64 start = clock.nsecsElapsed();
+        if (!replayer.replay(event, &errString)) {
+            cerr << errString.toLocal8Bit().constData() << endl;
+            ++numErrors;
+        }
+        qint64 elapsed = clock.nsecsElapsed() - start;
+        latencies[event.type].append(elapsed);
+        allLatencies.append(elapsed);
+    }
+    double seconds = clock.nsecsElapsed() / 1e9;
+
+    cout << "event,count,p50_us,p95_us,p99_us,max_us" << endl;
+    QMapIterator<int, QVector<qint64> > it (latencies);
+    while (it.hasNext()) {
+        it.next();
+        reportLatencies(QuizSessionRecorder::eventTypeToString(
+            QuizSessionRecorder::EventType(it.key())), it.value());
+    }
+    reportLatencies("all", allLatencies);
+    cout << "seconds," << seconds << endl
+         << "errors," << numErrors << endl;
+
+    return numErrors ? 1 : 0;
+}
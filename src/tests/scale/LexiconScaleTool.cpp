@@ -0,0 +1,563 @@
+//---------------------------------------------------------------------------
+// LexiconScaleTool.cpp
+//
+// A tool for measuring how Zyzzyva scales with synthetic lexicons.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "CreateDatabaseThread.h"
+#include "DawgBuilder.h"
+#include "LexiconBundle.h"
+#include "MainSettings.h"
+#include "QuizEngine.h"
+#include "QuizSpec.h"
+#include "QuizStatsDatabase.h"
+#include "Rand.h"
+#include "SearchSpec.h"
+#include "WordEngine.h"
+#include "WordTableModel.h"
+#include "Auxil.h"
+#include "Defs.h"
+#include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <QTextStream>
+#include <QTime>
+#include <QVector>
+#include <iostream>
+
+using namespace std;
+using namespace Defs;
+
+const QString DEFAULT_LETTER_DISTRIBUTION = "A:9 B:2 C:2 D:4 E:12 F:2 G:3 "
+    "H:2 I:9 J:1 K:1 L:4 M:2 N:6 O:8 P:2 Q:1 R:6 S:4 T:6 U:4 V:2 W:2 X:1 "
+    "Y:2 Z:1";
+
+// Relative number of words of each length, roughly following the shape of
+// the shipped tournament lexicons
+const QString DEFAULT_LENGTH_DISTRIBUTION = "2:1 3:6 4:25 5:55 6:100 7:145 "
+    "8:170 9:165 10:140 11:110 12:80 13:55 14:35 15:22";
+
+const QString DEFAULT_SIZES = "10000,50000,200000";
+const int DEFAULT_MIN_DEFINITION_WORDS = 3;
+const int DEFAULT_MAX_DEFINITION_WORDS = 12;
+const int DEFINITION_LINK_PERCENT = 5;
+const int MAX_ATTEMPTS_PER_WORD = 50;
+const qint32 MAX_DAWG_EDGES = 0x1FFFFF;
+
+//---------------------------------------------------------------------------
+//  randomIndex
+//
+//! Return a random number from zero up to but not including a limit.
+//! Rand::rand treats a maximum of zero as unbounded, so handle that case
+//! here.
+//
+//! @param rng the random number generator
+//! @param limit the limit
+//! @return the random number
+//---------------------------------------------------------------------------
+int
+randomIndex(Rand& rng, int limit)
+{
+    return (limit > 1) ? int(rng.rand(limit - 1)) : 0;
+}
+
+//---------------------------------------------------------------------------
+//  WeightedChooser
+//
+//! Choose keys at random in proportion to their weights.
+//---------------------------------------------------------------------------
+class WeightedChooser
+{
+    public:
+    bool parse(const QString& str);
+    QString choose(Rand& rng) const;
+
+    private:
+    QStringList keys;
+    QVector<unsigned int> cumulative;
+};
+
+//---------------------------------------------------------------------------
+//  parse
+//
+//! Parse a distribution string of the form "KEY:WEIGHT KEY:WEIGHT ...".
+//
+//! @param str the distribution string
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+WeightedChooser::parse(const QString& str)
+{
+    keys.clear();
+    cumulative.clear();
+    unsigned int total = 0;
+    foreach (const QString& item, str.simplified().split(" ")) {
+        bool ok = false;
+        QString key = item.section(':', 0, 0);
+        unsigned int weight = item.section(':', 1, 1).toUInt(&ok);
+        if (key.isEmpty() || !ok)
+            return false;
+        if (!weight)
+            continue;
+        total += weight;
+        keys.append(key);
+        cumulative.append(total);
+    }
+    return !keys.isEmpty();
+}
+
+//---------------------------------------------------------------------------
+//  choose
+//
+//! Choose a key at random.
+//
+//! @param rng the random number generator
+//! @return the chosen key
+//---------------------------------------------------------------------------
+QString
+WeightedChooser::choose(Rand& rng) const
+{
+    unsigned int r = randomIndex(rng, cumulative.last());
+    for (int i = 0; i < cumulative.count(); ++i) {
+        if (r < cumulative[i])
+            return keys[i];
+    }
+    return keys.last();
+}
+
+//---------------------------------------------------------------------------
+//  readProcStatus
+//
+//! Read a memory value from /proc/self/status.  Only available on Linux.
+//
+//! @param field the field name, such as VmHWM or VmRSS
+//! @return the value in kilobytes, or -1 if not available
+//---------------------------------------------------------------------------
+qint64
+readProcStatus(const QString& field)
+{
+#if defined Z_LINUX
+    QFile file ("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return -1;
+    QTextStream stream (&file);
+    QString line;
+    while (!(line = stream.readLine()).isNull()) {
+        if (line.startsWith(field + ":"))
+            return line.section(':', 1).simplified().section(' ', 0, 0)
+                .toLongLong();
+    }
+#else
+    Q_UNUSED(field);
+#endif
+    return -1;
+}
+
+//---------------------------------------------------------------------------
+//  resetPeakMemory
+//
+//! Reset the peak resident set size so the next stage reports its own peak.
+//! Only available on Linux.
+//---------------------------------------------------------------------------
+void
+resetPeakMemory()
+{
+#if defined Z_LINUX
+    QFile file ("/proc/self/clear_refs");
+    if (file.open(QIODevice::WriteOnly))
+        file.write("5");
+#endif
+}
+
+//---------------------------------------------------------------------------
+//  StageTimer
+//
+//! Time a stage and report its duration and peak memory.
+//---------------------------------------------------------------------------
+class StageTimer
+{
+    public:
+    StageTimer(int n, const QString& s) : numWords(n), stage(s) {
+        resetPeakMemory();
+        time.start();
+    }
+    void report(const QString& detail = QString()) {
+        double seconds = time.elapsed() / 1000.0;
+        cout << numWords << "," << stage.toUtf8().constData() << ","
+             << seconds << "," << readProcStatus("VmHWM") << ","
+             << detail.toUtf8().constData() << endl;
+    }
+
+    private:
+    int numWords;
+    QString stage;
+    QTime time;
+};
+
+//---------------------------------------------------------------------------
+//  generateLexicon
+//
+//! Generate a synthetic lexicon and write it to a text file, one word per
+//! line followed by a definition.
+//
+//! @param numWords the number of words to generate
+//! @param letters the letter distribution
+//! @param lengths the word length distribution
+//! @param minDefWords the minimum number of words in a definition
+//! @param maxDefWords the maximum number of words in a definition
+//! @param rng the random number generator
+//! @param filename the file to write
+//! @return the generated words in sorted order
+//---------------------------------------------------------------------------
+QStringList
+generateLexicon(int numWords, const WeightedChooser& letters,
+                const WeightedChooser& lengths, int minDefWords,
+                int maxDefWords, Rand& rng, const QString& filename)
+{
+    QSet<QString> wordSet;
+    int maxAttempts = numWords * MAX_ATTEMPTS_PER_WORD;
+    for (int i = 0; (wordSet.count() < numWords) && (i < maxAttempts); ++i) {
+        int length = lengths.choose(rng).toInt();
+        QString word;
+        for (int j = 0; j < length; ++j)
+            word += letters.choose(rng);
+        wordSet.insert(word);
+    }
+
+    QStringList words = wordSet.toList();
+    qSort(words);
+
+    QFile file (filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return QStringList();
+
+    QTextStream stream (&file);
+    foreach (const QString& word, words) {
+        stream << word;
+        int defWords = minDefWords +
+            randomIndex(rng, maxDefWords - minDefWords + 1);
+        for (int i = 0; i < defWords; ++i) {
+            QString defWord = words[randomIndex(rng, words.count())];
+            if (!i && (randomIndex(rng, 100) < DEFINITION_LINK_PERCENT))
+                stream << " {" << defWord.toLower() << "=v}";
+            else
+                stream << " " << defWord.toLower();
+        }
+        stream << "\n";
+    }
+
+    return words;
+}
+
+//---------------------------------------------------------------------------
+//  makeCondition
+//
+//! Create a search condition.
+//
+//! @param type the condition type
+//! @param str the string value
+//! @param minValue the minimum value
+//! @param maxValue the maximum value
+//! @return the search condition
+//---------------------------------------------------------------------------
+SearchCondition
+makeCondition(SearchCondition::SearchType type, const QString& str,
+              int minValue = 0, int maxValue = 0)
+{
+    SearchCondition condition;
+    condition.type = type;
+    condition.stringValue = str;
+    condition.minValue = minValue;
+    condition.maxValue = maxValue;
+    return condition;
+}
+
+//---------------------------------------------------------------------------
+//  runSize
+//
+//! Drive a synthetic lexicon of one size through every stage.
+//
+//! @param numWords the number of words to generate
+//! @param stages the stages to run
+//! @param letters the letter distribution
+//! @param lengths the word length distribution
+//! @param minDefWords the minimum number of words in a definition
+//! @param maxDefWords the maximum number of words in a definition
+//! @param rng the random number generator
+//! @param workDir the directory for generated files
+//---------------------------------------------------------------------------
+void
+runSize(int numWords, const QSet<QString>& stages,
+        const WeightedChooser& letters, const WeightedChooser& lengths,
+        int minDefWords, int maxDefWords, Rand& rng, const QString& workDir)
+{
+    QString prefix = workDir + "/synthetic-" + QString::number(numWords);
+    QString wordFile = prefix + ".txt";
+    QString lexicon = LEXICON_CUSTOM;
+
+    StageTimer genTimer (numWords, "generate");
+    QStringList words = generateLexicon(numWords, letters, lengths,
+                                        minDefWords, maxDefWords, rng,
+                                        wordFile);
+    genTimer.report(QString("words=%1").arg(words.count()));
+    if (words.isEmpty())
+        return;
+
+    WordEngine engine;
+    StageTimer importTimer (numWords, "import");
+    int imported = engine.importTextFile(lexicon, wordFile, true);
+    importTimer.report(QString("imported=%1").arg(imported));
+
+    if (stages.contains("dawg")) {
+        DawgBuilder builder;
+        QVector<qint32> edges;
+        QString err;
+        StageTimer dawgTimer (numWords, "dawg");
+        bool ok = builder.build(words, false, &edges, &err);
+        dawgTimer.report(ok ? QString("edges=%1 cap=%2").arg(edges.count() - 1)
+                         .arg(MAX_DAWG_EDGES) : "error=" + err);
+
+        QString bundleFile = prefix + ".zlx";
+        StageTimer writeTimer (numWords, "bundle-write");
+        ok = LexiconBundle::write(bundleFile, words, QMap<QString, QString>(),
+                                  QMap<QString, qint64>(),
+                                  QMap<int, QStringList>(), &err);
+        writeTimer.report(ok ? QString() : "error=" + err);
+
+        if (ok) {
+            WordEngine bundleEngine;
+            StageTimer loadTimer (numWords, "bundle-load");
+            ok = bundleEngine.importLexiconBundle(lexicon, bundleFile, &err);
+            loadTimer.report(ok ? QString() : "error=" + err);
+        }
+    }
+
+    if (stages.contains("db")) {
+        QString dbFile = prefix + ".db";
+        QFile::remove(dbFile);
+        CreateDatabaseThread thread (&engine, lexicon, dbFile, wordFile);
+        StageTimer dbTimer (numWords, "db");
+        thread.start();
+        thread.wait();
+        QString err = thread.getError();
+        dbTimer.report(err.isEmpty() ? QString("size=%1")
+                       .arg(QFile(dbFile).size()) : "error=" + err);
+        if (err.isEmpty())
+            engine.connectToDatabase(lexicon, dbFile, &err);
+    }
+
+    if (stages.contains("search")) {
+        QString sample = words[randomIndex(rng, words.count())];
+        QMap<QString, SearchCondition> searches;
+        searches["length-7"] =
+            makeCondition(SearchCondition::Length, QString(), 7, 7);
+        searches["pattern-prefix"] =
+            makeCondition(SearchCondition::PatternMatch, sample.left(1) + "*");
+        searches["anagram-blank"] =
+            makeCondition(SearchCondition::AnagramMatch,
+                          sample.left(sample.length() - 1) + "?");
+        searches["subanagram"] =
+            makeCondition(SearchCondition::SubanagramMatch, sample);
+        if (engine.databaseIsConnected(lexicon)) {
+            searches["num-anagrams"] =
+                makeCondition(SearchCondition::NumAnagrams, QString(), 2, 3);
+            searches["definition"] =
+                makeCondition(SearchCondition::Definition,
+                              words.first().toLower());
+        }
+
+        QMapIterator<QString, SearchCondition> it (searches);
+        while (it.hasNext()) {
+            it.next();
+            SearchSpec spec;
+            spec.conditions.append(it.value());
+            StageTimer searchTimer (numWords, "search:" + it.key());
+            QStringList results = engine.search(lexicon, spec, false);
+            searchTimer.report(QString("results=%1").arg(results.count()));
+        }
+    }
+
+    if (stages.contains("model")) {
+        qint64 rssBefore = readProcStatus("VmRSS");
+        WordTableModel model (&engine);
+        model.setLexicon(lexicon);
+        QList<WordTableModel::WordItem> items;
+        foreach (const QString& word, words)
+            items.append(WordTableModel::WordItem(word));
+        StageTimer modelTimer (numWords, "model");
+        model.addWords(items);
+        qint64 rssAfter = readProcStatus("VmRSS");
+        modelTimer.report(QString("rss_delta_kb=%1")
+                          .arg((rssBefore < 0) ? -1 : rssAfter - rssBefore));
+    }
+
+    if (stages.contains("quiz")) {
+        SearchSpec spec;
+        spec.conditions.append(makeCondition(SearchCondition::Length,
+                                             QString(), 7, 8));
+        QuizSpec quizSpec;
+        quizSpec.setLexicon(lexicon);
+        quizSpec.setType(QuizSpec::QuizAnagrams);
+        quizSpec.setQuizSourceType(QuizSpec::SearchSource);
+        quizSpec.setSearchSpec(spec);
+
+        QuizEngine quizEngine (&engine);
+        StageTimer quizTimer (numWords, "quiz");
+        bool ok = quizEngine.newQuiz(quizSpec);
+        quizTimer.report(QString("questions=%1")
+                         .arg(ok ? quizEngine.numQuestions() : 0));
+    }
+
+    if (stages.contains("cardbox")) {
+        QString quizType = Auxil::quizTypeToString(QuizSpec::QuizAnagrams);
+        QFile::remove(Auxil::getQuizDir() + "/data/" + lexicon + "/" +
+                      quizType + ".db");
+        QStringList questions = engine.alphagrams(words);
+        QuizStatsDatabase db (lexicon, quizType);
+        if (!db.isValid())
+            return;
+
+        StageTimer addTimer (numWords, "cardbox-add");
+        db.addToCardbox(questions, false);
+        addTimer.report(QString("questions=%1").arg(questions.count()));
+
+        StageTimer readyTimer (numWords, "cardbox-ready");
+        QStringList ready = db.getReadyQuestions(QStringList(), false);
+        readyTimer.report(QString("ready=%1").arg(ready.count()));
+    }
+}
+
+//---------------------------------------------------------------------------
+//  usage
+//
+//! Print a usage message.
+//---------------------------------------------------------------------------
+void
+usage()
+{
+    cerr << "Usage: lexscale [options]" << endl
+         << endl
+         << "Generate synthetic lexicons and report time and peak memory for"
+         << endl
+         << "each stage as CSV: words,stage,seconds,peak_kb,detail" << endl
+         << endl
+         << "Options:" << endl
+         << "  -n <sizes>      comma-separated lexicon sizes (default "
+         << DEFAULT_SIZES.toUtf8().constData() << ")" << endl
+         << "  -a <dist>       letter distribution, e.g. \"A:9 B:2 ...\""
+         << endl
+         << "  -l <dist>       word length distribution, e.g. \"2:1 3:6 ...\""
+         << endl
+         << "  -d <min>-<max>  number of words per definition" << endl
+         << "  -k <stages>     comma-separated stages to run: dawg, db,"
+         << endl
+         << "                  search, model, quiz, cardbox (default all)"
+         << endl
+         << "  -s <seed>       random seed" << endl
+         << "  -o <dir>        directory for generated files" << endl;
+}
+
+//---------------------------------------------------------------------------
+//  main
+//
+//! Run the scale tests.
+//---------------------------------------------------------------------------
+int
+main(int argc, char** argv)
+{
+    QApplication app (argc, argv, false);
+
+    QString sizesStr = DEFAULT_SIZES;
+    QString letterStr = DEFAULT_LETTER_DISTRIBUTION;
+    QString lengthStr = DEFAULT_LENGTH_DISTRIBUTION;
+    int minDefWords = DEFAULT_MIN_DEFINITION_WORDS;
+    int maxDefWords = DEFAULT_MAX_DEFINITION_WORDS;
+    QString stagesStr = "dawg,db,search,model,quiz,cardbox";
+    unsigned int seed = 1;
+    QString workDir = QDir::tempPath() + "/zyzzyva-scale";
+
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.count(); ++i) {
+        const QString& arg = args[i];
+        if (!arg.startsWith("-") || (i + 1 >= args.count())) {
+            usage();
+            return 1;
+        }
+        QString value = args[++i];
+        if (arg == "-n")
+            sizesStr = value;
+        else if (arg == "-a")
+            letterStr = value;
+        else if (arg == "-l")
+            lengthStr = value;
+        else if (arg == "-d") {
+            minDefWords = value.section('-', 0, 0).toInt();
+            maxDefWords = value.section('-', 1, 1).toInt();
+        }
+        else if (arg == "-k")
+            stagesStr = value;
+        else if (arg == "-s")
+            seed = value.toUInt();
+        else if (arg == "-o")
+            workDir = value;
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    WeightedChooser letters;
+    WeightedChooser lengths;
+    if (!letters.parse(letterStr) || !lengths.parse(lengthStr)) {
+        cerr << "Invalid letter or length distribution." << endl;
+        return 1;
+    }
+
+    QDir dir;
+    if (!dir.mkpath(workDir)) {
+        cerr << "Cannot create directory '"
+             << workDir.toLocal8Bit().constData() << "'." << endl;
+        return 1;
+    }
+
+    // Keep databases and cardbox data out of the real user data directory
+    MainSettings::setUserDataDir(workDir);
+    MainSettings::setLetterDistribution(DEFAULT_LETTER_DISTRIBUTION +
+                                        " _:2");
+
+    QSet<QString> stages = QSet<QString>::fromList(stagesStr.split(","));
+    Rand rng;
+    rng.srand(seed, ~seed);
+
+    cout << "words,stage,seconds,peak_kb,detail" << endl;
+    foreach (const QString& sizeStr, sizesStr.split(",")) {
+        int numWords = sizeStr.toInt();
+        if (numWords <= 0)
+            continue;
+        runSize(numWords, stages, letters, lengths, minDefWords,
+                maxDefWords, rng, workDir);
+    }
+
+    return 0;
+}
@@ -0,0 +1,1222 @@
+//---------------------------------------------------------------------------
+// SearchLoadTool.cpp
+//
+// A tool for timing random search workloads and checking their results
+// against a brute-force scan of the word list.
+//
+// Copyright 2012 Boshvark Software, LLC.
+//
+// This file is part of Zyzzyva.
+//
+// Zyzzyva is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Zyzzyva is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//---------------------------------------------------------------------------
+
+#include "CreateDatabaseThread.h"
+#include "MainSettings.h"
+#include "Rand.h"
+#include "SearchSpec.h"
+#include "WordEngine.h"
+#include "Auxil.h"
+#include "Defs.h"
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QRegExp>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+#include <QtAlgorithms>
+#include <iostream>
+
+using namespace std;
+using namespace Defs;
+
+const QString LEXICON_NAME = LEXICON_CUSTOM;
+const QString POOL_LETTERS = "AAAAAAAAABBCCDDDDEEEEEEEEEEEEFFGGGHHIIIIIIIII"
+    "JKLLLLMMNNNNNNOOOOOOOOPPQRRRRRRSSSSTTTTTTUUUUVVWWXYYZ";
+const QString VOWELS = "AEIOU";
+const int LETTER_VALUES[26] = { 1, 3, 3, 2, 1, 4, 2, 4, 1, 8, 5, 1, 3, 1,
+                                1, 3, 10, 1, 1, 1, 1, 4, 4, 8, 4, 10 };
+const int DEFAULT_NUM_SPECS = 1000;
+const int DEFAULT_MAX_CONDITIONS = 3;
+const int NEGATED_PERCENT = 20;
+const int MAX_REPORTED_WORDS = 5;
+
+//---------------------------------------------------------------------------
+//  randomIndex
+//
+//! Return a random number from zero up to but not including a limit.
+//
+//! @param rng the random number generator
+//! @param limit the limit
+//! @return the random number
+//---------------------------------------------------------------------------
+int
+randomIndex(Rand& rng, int limit)
+{
+    return (limit > 1) ? int(rng.rand(limit - 1)) : 0;
+}
+
+//---------------------------------------------------------------------------
+//  randomLetter
+//
+//! Return a random letter, drawn according to the standard tile
+//! distribution.
+//
+//! @param rng the random number generator
+//! @return the letter
+//---------------------------------------------------------------------------
+QChar
+randomLetter(Rand& rng)
+{
+    return POOL_LETTERS.at(randomIndex(rng, POOL_LETTERS.length()));
+}
+
+//---------------------------------------------------------------------------
+//  WordListOracle
+//
+//! Evaluate search specs by scanning a plain word list and testing every
+//! word against every condition independently of WordGraph, the lexicon
+//! database and the word engine caches.  Conditions that depend on data
+//! not derivable from the word list, such as probability, playability and
+//! definitions, cannot be evaluated; specs containing them are only checked
+//! for results that fail the conditions that can be evaluated.
+//---------------------------------------------------------------------------
+class WordListOracle
+{
+    public:
+    bool readWordList(const QString& filename, QString* errString);
+    QSet<QString> search(const SearchSpec& spec, bool* complete) const;
+    bool canEvaluate(const SearchCondition& condition) const;
+
+    const QStringList& getWords() const { return wordList; }
+    const QString& getLexicon() const { return lexicon; }
+    void setLexicon(const QString& lex) { lexicon = lex; }
+
+    private:
+    class LetterPattern {
+        public:
+        LetterPattern() : blanks(0), wildcard(false) { }
+        QMap<QChar, int> letters;
+        QStringList classes;
+        int blanks;
+        bool wildcard;
+    };
+
+    private:
+    bool matches(const QString& word, const SearchCondition& condition) const;
+    bool matchesPattern(const QString& word, const QString& pattern) const;
+    bool matchesLetters(const QString& word, const QString& pattern,
+                        bool anagram) const;
+    LetterPattern parseLetterPattern(const QString& pattern) const;
+    int matchClasses(const QList<QChar>& letters,
+                     const QStringList& classes) const;
+    bool augmentClassMatch(int letter, const QList<QChar>& letters,
+                           const QStringList& classes, QVector<int>& owner,
+                           QVector<bool>& visited) const;
+    bool classContains(const QString& charClass, QChar letter) const;
+    bool inRange(int value, const SearchCondition& condition) const {
+        return (value >= condition.minValue) &&
+            (value <= condition.maxValue); }
+
+    QString lexicon;
+    QStringList wordList;
+    QSet<QString> wordSet;
+    QHash<QString, int> numAnagrams;
+};
+
+//---------------------------------------------------------------------------
+//  readWordList
+//
+//! Read the first word of each non-empty, non-comment line of a word list.
+//
+//! @param filename the name of the word list file
+//! @param errString returns the error string in case of error
+//! @return true if successful, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordListOracle::readWordList(const QString& filename, QString* errString)
+{
+    QFile file (filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errString) {
+            *errString = "Can't open file '" + filename + "': " +
+                file.errorString();
+        }
+        return false;
+    }
+
+    char* buffer = new char[MAX_INPUT_LINE_LEN];
+    while (file.readLine(buffer, MAX_INPUT_LINE_LEN) > 0) {
+        QString line = QString::fromUtf8(buffer).simplified();
+        if (!line.length() || (line.at(0) == '#'))
+            continue;
+        QString word = line.section(' ', 0, 0).toUpper();
+        if (wordSet.contains(word))
+            continue;
+        wordSet.insert(word);
+        wordList.append(word);
+        ++numAnagrams[Auxil::getAlphagram(word)];
+    }
+    delete[] buffer;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//  search
+//
+//! Find all words in the word list matching a search spec.
+//
+//! @param spec the search spec
+//! @param complete return whether every condition could be evaluated
+//! @return the set of matching words, in upper case
+//---------------------------------------------------------------------------
+QSet<QString>
+WordListOracle::search(const SearchSpec& spec, bool* complete) const
+{
+    QList<SearchCondition> conditions;
+    bool allEvaluated = true;
+    foreach (const SearchCondition& condition, spec.conditions) {
+        if (canEvaluate(condition))
+            conditions.append(condition);
+        else
+            allEvaluated = false;
+    }
+    if (complete)
+        *complete = allEvaluated;
+
+    QSet<QString> results;
+    if (spec.conditions.isEmpty())
+        return results;
+
+    foreach (const QString& word, wordList) {
+        bool keep = spec.conjunction;
+        foreach (const SearchCondition& condition, conditions) {
+            bool match = matches(word, condition);
+            if (spec.conjunction && !match) {
+                keep = false;
+                break;
+            }
+            if (!spec.conjunction && match) {
+                keep = true;
+                break;
+            }
+        }
+        if (keep)
+            results.insert(word);
+    }
+    return results;
+}
+
+//---------------------------------------------------------------------------
+//  canEvaluate
+//
+//! Determine whether a condition can be evaluated from the word list alone.
+//
+//! @param condition the search condition
+//! @return true if the condition can be evaluated, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordListOracle::canEvaluate(const SearchCondition& condition) const
+{
+    switch (condition.type) {
+        case SearchCondition::PatternMatch:
+        case SearchCondition::AnagramMatch:
+        case SearchCondition::SubanagramMatch:
+        case SearchCondition::Length:
+        case SearchCondition::Prefix:
+        case SearchCondition::Suffix:
+        case SearchCondition::IncludeLetters:
+        case SearchCondition::ConsistOf:
+        case SearchCondition::InLexicon:
+        case SearchCondition::InWordList:
+        case SearchCondition::NumAnagrams:
+        case SearchCondition::NumVowels:
+        case SearchCondition::NumUniqueLetters:
+        case SearchCondition::PointValue:
+        return true;
+
+        case SearchCondition::BelongToGroup: {
+            SearchSet searchSet =
+                Auxil::stringToSearchSet(condition.stringValue);
+            return (searchSet == SetHookWords) ||
+                (searchSet == SetFrontHooks) || (searchSet == SetBackHooks);
+        }
+
+        // Only whether the word can be drawn is checked, not its probability
+        case SearchCondition::DrawProbability:
+        return (condition.minValue <= 0) && (condition.maxValue >= 100);
+
+        default:
+        return false;
+    }
+}
+
+//---------------------------------------------------------------------------
+//  matches
+//
+//! Determine whether a word matches a search condition.
+//
+//! @param word the word, in upper case
+//! @param condition the search condition
+//! @return true if the word matches, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordListOracle::matches(const QString& word, const SearchCondition& condition)
+    const
+{
+    bool match = false;
+    const QString& str = condition.stringValue;
+    switch (condition.type) {
+        case SearchCondition::PatternMatch:
+        match = matchesPattern(word, str);
+        break;
+
+        case SearchCondition::AnagramMatch:
+        match = matchesLetters(word, str, true);
+        break;
+
+        case SearchCondition::SubanagramMatch:
+        match = matchesLetters(word, str, false);
+        break;
+
+        case SearchCondition::Length:
+        return inRange(word.length(), condition);
+
+        case SearchCondition::Prefix:
+        match = wordSet.contains(str + word);
+        break;
+
+        case SearchCondition::Suffix:
+        match = wordSet.contains(word + str);
+        break;
+
+        case SearchCondition::IncludeLetters: {
+            if (condition.negated) {
+                for (int i = 0; i < str.length(); ++i) {
+                    if (word.contains(str.at(i)))
+                        return false;
+                }
+                return true;
+            }
+            QString remaining = word;
+            for (int i = 0; i < str.length(); ++i) {
+                int index = remaining.indexOf(str.at(i));
+                if (index < 0)
+                    return false;
+                remaining.remove(index, 1);
+            }
+            return true;
+        }
+
+        case SearchCondition::ConsistOf: {
+            int consist = 0;
+            for (int i = 0; i < word.length(); ++i) {
+                if (str.contains(word.at(i)))
+                    ++consist;
+            }
+            return inRange((consist * 100) / word.length(), condition);
+        }
+
+        case SearchCondition::BelongToGroup: {
+            bool front = wordSet.contains(word.mid(1));
+            bool back = wordSet.contains(word.left(word.length() - 1));
+            switch (Auxil::stringToSearchSet(str)) {
+                case SetHookWords: match = front || back; break;
+                case SetFrontHooks: match = front; break;
+                case SetBackHooks: match = back; break;
+                default: break;
+            }
+        }
+        break;
+
+        case SearchCondition::InLexicon:
+        match = (str == lexicon);
+        break;
+
+        case SearchCondition::InWordList:
+        match = str.split(QChar(' ')).contains(word);
+        break;
+
+        case SearchCondition::NumAnagrams:
+        return inRange(numAnagrams.value(Auxil::getAlphagram(word)),
+                       condition);
+
+        case SearchCondition::NumVowels: {
+            int numVowels = 0;
+            for (int i = 0; i < word.length(); ++i) {
+                if (VOWELS.contains(word.at(i)))
+                    ++numVowels;
+            }
+            return inRange(numVowels, condition);
+        }
+
+        case SearchCondition::NumUniqueLetters: {
+            QSet<QChar> letters;
+            for (int i = 0; i < word.length(); ++i)
+                letters.insert(word.at(i));
+            return inRange(letters.count(), condition);
+        }
+
+        case SearchCondition::PointValue: {
+            int pointValue = 0;
+            for (int i = 0; i < word.length(); ++i) {
+                int index = word.at(i).unicode() - 'A';
+                if ((index >= 0) && (index < 26))
+                    pointValue += LETTER_VALUES[index];
+            }
+            return inRange(pointValue, condition);
+        }
+
+        case SearchCondition::DrawProbability: {
+            QString pool = str;
+            for (int i = 0; i < word.length(); ++i) {
+                int index = pool.indexOf(word.at(i));
+                if (index < 0)
+                    index = pool.indexOf(QChar('?'));
+                if (index < 0)
+                    return false;
+                pool.remove(index, 1);
+            }
+            return true;
+        }
+
+        default:
+        return true;
+    }
+
+    return match ^ condition.negated;
+}
+
+//---------------------------------------------------------------------------
+//  matchesPattern
+//
+//! Determine whether a word matches a pattern, where ? matches any letter,
+//! * matches any sequence of letters, and [...] or [^...] matches a letter
+//! in or not in a class.
+//
+//! @param word the word
+//! @param pattern the pattern
+//! @return true if the word matches, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordListOracle::matchesPattern(const QString& word, const QString& pattern)
+    const
+{
+    QString regex;
+    QString str = Auxil::getCanonicalSearchString(pattern);
+    for (int i = 0; i < str.length(); ++i) {
+        QChar c = str.at(i);
+        if (c == '?')
+            regex += ".";
+        else if (c == '*')
+            regex += ".*";
+        else if (c == '[') {
+            int close = str.indexOf(']', i);
+            if (close < 0)
+                return false;
+            regex += str.mid(i, close - i + 1);
+            i = close;
+        }
+        else
+            regex += QRegExp::escape(QString(c));
+    }
+    return QRegExp(regex).exactMatch(word);
+}
+
+//---------------------------------------------------------------------------
+//  matchesLetters
+//
+//! Determine whether a word is an anagram or subanagram of a letter
+//! pattern.  Every letter of the word must be matched to a distinct
+//! element of the pattern: the same letter, a ? blank, or a character
+//! class containing the letter.  A * allows any letters to be left
+//! unmatched.  For an anagram, every element of the pattern must also be
+//! matched.
+//
+//! @param word the word
+//! @param pattern the letter pattern
+//! @param anagram true for an anagram, false for a subanagram
+//! @return true if the word matches, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordListOracle::matchesLetters(const QString& word, const QString& pattern,
+                               bool anagram) const
+{
+    LetterPattern parsed =
+        parseLetterPattern(Auxil::getCanonicalSearchString(pattern));
+    if (!anagram && parsed.wildcard)
+        return true;
+
+    // Matching a letter to itself never prevents matching the rest, since
+    // a letter element can match nothing else
+    QList<QChar> leftover;
+    for (int i = 0; i < word.length(); ++i) {
+        QChar c = word.at(i);
+        QMap<QChar, int>::iterator it = parsed.letters.find(c);
+        if ((it != parsed.letters.end()) && (it.value() > 0))
+            --it.value();
+        else
+            leftover.append(c);
+    }
+
+    int numClassMatches = matchClasses(leftover, parsed.classes);
+    int numUnmatched = leftover.count() - numClassMatches;
+
+    if (!anagram)
+        return (numUnmatched <= parsed.blanks);
+
+    QMapIterator<QChar, int> it (parsed.letters);
+    while (it.hasNext()) {
+        if (it.next().value() > 0)
+            return false;
+    }
+    if (numClassMatches < parsed.classes.count())
+        return false;
+    return parsed.wildcard ? (numUnmatched >= parsed.blanks)
+                           : (numUnmatched == parsed.blanks);
+}
+
+//---------------------------------------------------------------------------
+//  parseLetterPattern
+//
+//! Split a letter pattern into letters, blanks, character classes and a
+//! wildcard flag.
+//
+//! @param pattern the letter pattern
+//! @return the parsed pattern
+//---------------------------------------------------------------------------
+WordListOracle::LetterPattern
+WordListOracle::parseLetterPattern(const QString& pattern) const
+{
+    LetterPattern parsed;
+    for (int i = 0; i < pattern.length(); ++i) {
+        QChar c = pattern.at(i);
+        if (c == '?')
+            ++parsed.blanks;
+        else if (c == '*')
+            parsed.wildcard = true;
+        else if (c == '[') {
+            int close = pattern.indexOf(']', i);
+            if (close < 0)
+                break;
+            parsed.classes.append(pattern.mid(i + 1, close - i - 1));
+            i = close;
+        }
+        else
+            ++parsed.letters[c];
+    }
+    return parsed;
+}
+
+//---------------------------------------------------------------------------
+//  matchClasses
+//
+//! Find the largest number of letters that can each be matched to a
+//! distinct character class.
+//
+//! @param letters the letters
+//! @param classes the character classes
+//! @return the number of matched letters
+//---------------------------------------------------------------------------
+int
+WordListOracle::matchClasses(const QList<QChar>& letters,
+                             const QStringList& classes) const
+{
+    if (classes.isEmpty())
+        return 0;
+
+    QVector<int> owner (classes.count(), -1);
+    int numMatched = 0;
+    for (int i = 0; i < letters.count(); ++i) {
+        QVector<bool> visited (classes.count(), false);
+        if (augmentClassMatch(i, letters, classes, owner, visited))
+            ++numMatched;
+    }
+    return numMatched;
+}
+
+//---------------------------------------------------------------------------
+//  augmentClassMatch
+//
+//! Try to match a letter to a character class, moving previously matched
+//! letters to other classes if necessary.
+//
+//! @param letter the index of the letter
+//! @param letters the letters
+//! @param classes the character classes
+//! @param owner the index of the letter matched to each class, or -1
+//! @param visited whether each class has been tried for this letter
+//! @return true if the letter was matched, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordListOracle::augmentClassMatch(int letter, const QList<QChar>& letters,
+                                  const QStringList& classes,
+                                  QVector<int>& owner,
+                                  QVector<bool>& visited) const
+{
+    for (int i = 0; i < classes.count(); ++i) {
+        if (visited[i] || !classContains(classes[i], letters[letter]))
+            continue;
+        visited[i] = true;
+        if ((owner[i] < 0) ||
+            augmentClassMatch(owner[i], letters, classes, owner, visited))
+        {
+            owner[i] = letter;
+            return true;
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------
+//  classContains
+//
+//! Determine whether a character class matches a letter.
+//
+//! @param charClass the contents of the class, without brackets
+//! @param letter the letter
+//! @return true if the class matches the letter, false otherwise
+//---------------------------------------------------------------------------
+bool
+WordListOracle::classContains(const QString& charClass, QChar letter) const
+{
+    if (charClass.startsWith("^"))
+        return !charClass.mid(1).contains(letter);
+    return charClass.contains(letter);
+}
+
+//---------------------------------------------------------------------------
+//  SpecGenerator
+//
+//! Generate random but realistic search specs.  String values are derived
+//! from words in the lexicon so that most conditions have results.
+//---------------------------------------------------------------------------
+class SpecGenerator
+{
+    public:
+    SpecGenerator(const QStringList& w, const QString& lex)
+        : words(w), lexicon(lex) { }
+
+    SearchSpec generate(Rand& rng, int maxConditions,
+                        const QList<SearchCondition::SearchType>& types) const;
+
+    private:
+    SearchCondition generateCondition(Rand& rng,
+                                      SearchCondition::SearchType type) const;
+    QString randomWord(Rand& rng) const {
+        return words[randomIndex(rng, words.count())]; }
+    QString shuffle(Rand& rng, const QString& str) const;
+    QString randomClass(Rand& rng, QChar letter) const;
+
+    QStringList words;
+    QString lexicon;
+};
+
+//---------------------------------------------------------------------------
+//  generate
+//
+//! Generate a search spec with between one and a maximum number of
+//! conditions.
+//
+//! @param rng the random number generator
+//! @param maxConditions the maximum number of conditions
+//! @param types the condition types to choose from
+//! @return the search spec
+//---------------------------------------------------------------------------
+SearchSpec
+SpecGenerator::generate(Rand& rng, int maxConditions,
+                        const QList<SearchCondition::SearchType>& types) const
+{
+    SearchSpec spec;
+    int numConditions = 1 + randomIndex(rng, maxConditions);
+    for (int i = 0; i < numConditions; ++i) {
+        SearchCondition::SearchType type =
+            types[randomIndex(rng, types.count())];
+        spec.conditions.append(generateCondition(rng, type));
+    }
+    return spec;
+}
+
+//---------------------------------------------------------------------------
+//  generateCondition
+//
+//! Generate a search condition of a certain type.
+//
+//! @param rng the random number generator
+//! @param type the condition type
+//! @return the search condition
+//---------------------------------------------------------------------------
+SearchCondition
+SpecGenerator::generateCondition(Rand& rng, SearchCondition::SearchType type)
+    const
+{
+    SearchCondition condition;
+    condition.type = type;
+    bool negatable = true;
+    QString word = randomWord(rng);
+
+    switch (type) {
+        case SearchCondition::PatternMatch:
+        switch (randomIndex(rng, 4)) {
+            case 0:
+            for (int i = 0; i < word.length(); ++i) {
+                if (randomIndex(rng, 100) < 30)
+                    word[i] = '?';
+            }
+            condition.stringValue = word;
+            break;
+
+            case 1:
+            condition.stringValue =
+                word.left(1 + randomIndex(rng, qMin(word.length(), 3))) + "*";
+            break;
+
+            case 2:
+            condition.stringValue =
+                "*" + word.right(1 + randomIndex(rng, qMin(word.length(), 3)));
+            break;
+
+            default:
+            if (word.length() > 2) {
+                int pos = randomIndex(rng, word.length() - 1);
+                condition.stringValue = "*" + word.mid(pos, 2) + "*";
+            }
+            else {
+                int pos = randomIndex(rng, word.length());
+                condition.stringValue = word.left(pos) +
+                    randomClass(rng, word.at(pos)) + word.mid(pos + 1);
+            }
+            break;
+        }
+        break;
+
+        case SearchCondition::AnagramMatch:
+        case SearchCondition::SubanagramMatch: {
+            QString letters = shuffle(rng, word.left(MAX_WORD_LEN / 2));
+            int numBlanks = randomIndex(rng, 3);
+            for (int i = 0; (i < numBlanks) && (i < letters.length()); ++i)
+                letters[i] = '?';
+            if (type == SearchCondition::SubanagramMatch) {
+                int numExtra = randomIndex(rng, 3);
+                for (int i = 0; i < numExtra; ++i)
+                    letters += randomLetter(rng);
+            }
+            QString classes;
+            if ((letters.length() > 2) && (randomIndex(rng, 100) < 20)) {
+                QChar last = letters.at(letters.length() - 1);
+                if (last != '?') {
+                    letters.chop(1);
+                    classes = randomClass(rng, last);
+                }
+            }
+            if ((type == SearchCondition::AnagramMatch) &&
+                (letters.length() > 2) && (randomIndex(rng, 100) < 20))
+            {
+                letters = letters.mid(1) + "*";
+            }
+            condition.stringValue = letters + classes;
+        }
+        break;
+
+        case SearchCondition::Length:
+        condition.minValue = 2 + randomIndex(rng, 7);
+        condition.maxValue = condition.minValue + randomIndex(rng, 3);
+        negatable = false;
+        break;
+
+        case SearchCondition::Prefix:
+        case SearchCondition::Suffix:
+        condition.stringValue = QString(randomLetter(rng));
+        break;
+
+        case SearchCondition::IncludeLetters:
+        condition.stringValue = QString(randomLetter(rng));
+        if (randomIndex(rng, 2))
+            condition.stringValue += word.at(randomIndex(rng, word.length()));
+        break;
+
+        case SearchCondition::ConsistOf:
+        for (int i = 0; i < 6; ++i)
+            condition.stringValue += randomLetter(rng);
+        condition.minValue = 50 + randomIndex(rng, 51);
+        condition.maxValue = 100;
+        negatable = false;
+        break;
+
+        case SearchCondition::BelongToGroup: {
+            SearchSet sets[] = { SetHookWords, SetFrontHooks, SetBackHooks,
+                                 SetHighFives, SetTypeOneSevens,
+                                 SetTypeThreeSevens };
+            condition.stringValue = Auxil::searchSetToString(
+                sets[randomIndex(rng, sizeof(sets) / sizeof(sets[0]))]);
+        }
+        break;
+
+        case SearchCondition::InLexicon:
+        condition.stringValue = lexicon;
+        break;
+
+        case SearchCondition::InWordList: {
+            QStringList list;
+            for (int i = 0; i < 20; ++i)
+                list.append(randomWord(rng));
+            for (int i = 0; i < 5; ++i)
+                list.append(shuffle(rng, randomWord(rng)));
+            condition.stringValue = list.join(" ");
+        }
+        break;
+
+        case SearchCondition::NumAnagrams:
+        condition.minValue = 1 + randomIndex(rng, 3);
+        condition.maxValue = condition.minValue + randomIndex(rng, 3);
+        negatable = false;
+        break;
+
+        case SearchCondition::NumVowels:
+        condition.minValue = randomIndex(rng, 4);
+        condition.maxValue = condition.minValue + randomIndex(rng, 3);
+        negatable = false;
+        break;
+
+        case SearchCondition::NumUniqueLetters:
+        condition.minValue = 2 + randomIndex(rng, 6);
+        condition.maxValue = condition.minValue + randomIndex(rng, 3);
+        negatable = false;
+        break;
+
+        case SearchCondition::PointValue:
+        condition.minValue = 5 + randomIndex(rng, 16);
+        condition.maxValue = condition.minValue + randomIndex(rng, 11);
+        negatable = false;
+        break;
+
+        case SearchCondition::ProbabilityOrder:
+        case SearchCondition::LimitByProbabilityOrder:
+        case SearchCondition::PlayabilityOrder:
+        case SearchCondition::LimitByPlayabilityOrder:
+        condition.minValue = 1 + randomIndex(rng, 500);
+        condition.maxValue = condition.minValue + randomIndex(rng, 100);
+        condition.intValue = randomIndex(rng, 3);
+        condition.boolValue = randomIndex(rng, 2);
+        negatable = false;
+        break;
+
+        case SearchCondition::PartOfSpeech: {
+            QString pos[] = { "n", "v", "adj", "adv" };
+            condition.stringValue = pos[randomIndex(rng, 4)];
+        }
+        break;
+
+        case SearchCondition::Definition:
+        condition.stringValue = randomWord(rng).toLower();
+        break;
+
+        case SearchCondition::DrawProbability: {
+            QString pool;
+            for (int i = 0; i < 7; ++i)
+                pool += randomLetter(rng);
+            if (randomIndex(rng, 2))
+                pool += "?";
+            condition.stringValue = pool;
+            condition.minValue = 0;
+            condition.maxValue = 100;
+            negatable = false;
+        }
+        break;
+
+        default:
+        negatable = false;
+        break;
+    }
+
+    if (negatable)
+        condition.negated = (randomIndex(rng, 100) < NEGATED_PERCENT);
+    return condition;
+}
+
+//---------------------------------------------------------------------------
+//  shuffle
+//
+//! Return the letters of a string in random order.
+//
+//! @param rng the random number generator
+//! @param str the string
+//! @return the shuffled string
+//---------------------------------------------------------------------------
+QString
+SpecGenerator::shuffle(Rand& rng, const QString& str) const
+{
+    QString shuffled = str;
+    for (int i = shuffled.length() - 1; i > 0; --i) {
+        int j = randomIndex(rng, i + 1);
+        QChar c = shuffled[i];
+        shuffled[i] = shuffled[j];
+        shuffled[j] = c;
+    }
+    return shuffled;
+}
+
+//---------------------------------------------------------------------------
+//  randomClass
+//
+//! Return a character class that matches a letter, and sometimes other
+//! letters.
+//
+//! @param rng the random number generator
+//! @param letter the letter
+//! @return the character class
+//---------------------------------------------------------------------------
+QString
+SpecGenerator::randomClass(Rand& rng, QChar letter) const
+{
+    QString charClass = "[";
+    charClass += letter;
+    int numExtra = randomIndex(rng, 3);
+    for (int i = 0; i < numExtra; ++i)
+        charClass += randomLetter(rng);
+    return charClass + "]";
+}
+
+//---------------------------------------------------------------------------
+//  getMixName
+//
+//! Return the name of a condition mix: the sorted condition types, with
+//! negated conditions marked.
+//
+//! @param spec the search spec
+//! @return the mix name
+//---------------------------------------------------------------------------
+QString
+getMixName(const SearchSpec& spec)
+{
+    QStringList names;
+    foreach (const SearchCondition& condition, spec.conditions) {
+        QString name = Auxil::searchTypeToString(condition.type);
+        if (condition.negated)
+            name = "Not " + name;
+        names.append(name);
+    }
+    qSort(names);
+    return names.join("+");
+}
+
+//---------------------------------------------------------------------------
+//  percentile
+//
+//! Return a percentile of a sorted list of values.
+//
+//! @param values the sorted values
+//! @param pct the percentile
+//! @return the value
+//---------------------------------------------------------------------------
+qint64
+percentile(const QVector<qint64>& values, int pct)
+{
+    if (values.isEmpty())
+        return 0;
+    return values[(values.count() - 1) * pct / 100];
+}
+
+//---------------------------------------------------------------------------
+//  MixStats
+//
+//! Latencies and check results for one condition mix.
+//---------------------------------------------------------------------------
+class MixStats
+{
+    public:
+    MixStats() : numMismatches(0), numPartial(0) { }
+    QVector<qint64> latencies;
+    int numMismatches;
+    int numPartial;
+};
+
+//---------------------------------------------------------------------------
+//  reportMix
+//
+//! Print the latency percentiles and check results of a condition mix as a
+//! CSV line.
+//
+//! @param name the mix name
+//! @param stats the mix statistics
+//---------------------------------------------------------------------------
+void
+reportMix(const QString& name, MixStats stats)
+{
+    qSort(stats.latencies);
+    cout << "\"" << name.toUtf8().constData() << "\","
+         << stats.latencies.count() << ","
+         << percentile(stats.latencies, 50) / 1000 << ","
+         << percentile(stats.latencies, 95) / 1000 << ","
+         << percentile(stats.latencies, 99) / 1000 << ","
+         << percentile(stats.latencies, 100) / 1000 << ","
+         << stats.numMismatches << "," << stats.numPartial << endl;
+}
+
+//---------------------------------------------------------------------------
+//  reportMismatch
+//
+//! Describe a search whose results differ from the oracle.
+//
+//! @param spec the search spec
+//! @param missing words found by the oracle but not the search
+//! @param extra words found by the search but not the oracle
+//---------------------------------------------------------------------------
+void
+reportMismatch(const SearchSpec& spec, const QSet<QString>& missing,
+               const QSet<QString>& extra)
+{
+    QStringList missingList = missing.toList();
+    QStringList extraList = extra.toList();
+    qSort(missingList);
+    qSort(extraList);
+    cerr << "Mismatch: " << spec.asString().toUtf8().constData() << endl
+         << "  missing " << missingList.count() << ": "
+         << QStringList(missingList.mid(0, MAX_REPORTED_WORDS)).join(" ")
+            .toUtf8().constData() << endl
+         << "  extra " << extraList.count() << ": "
+         << QStringList(extraList.mid(0, MAX_REPORTED_WORDS)).join(" ")
+            .toUtf8().constData() << endl;
+}
+
+//---------------------------------------------------------------------------
+//  usage
+//
+//! Print a usage message.
+//---------------------------------------------------------------------------
+void
+usage()
+{
+    cerr << "Usage: searchload [options] <word-file>" << endl
+         << endl
+         << "Run random search specs over every search condition type"
+         << endl
+         << "through WordEngine::search, check each result against a"
+         << endl
+         << "brute-force scan of the word file, and report latency for each"
+         << endl
+         << "condition mix as CSV:" << endl
+         << "mix,count,p50_us,p95_us,p99_us,max_us,mismatches,partial" << endl
+         << endl
+         << "Specs with conditions that cannot be evaluated from the word"
+         << endl
+         << "list, such as probability, playability and definitions, are"
+         << endl
+         << "only checked for results that fail the other conditions, and"
+         << endl
+         << "are counted as partial.  Each spec is also counted with"
+         << endl
+         << "WordEngine::countSearch, and a count that differs from the"
+         << endl
+         << "search results is reported as a mismatch." << endl
+         << endl
+         << "Options:" << endl
+         << "  -n <count>      number of specs (default "
+         << DEFAULT_NUM_SPECS << ")" << endl
+         << "  -c <count>      maximum conditions per spec (default "
+         << DEFAULT_MAX_CONDITIONS << ")" << endl
+         << "  -t <types>      comma-separated condition types to use"
+         << endl
+         << "                  (default all)" << endl
+         << "  -d <file>       existing lexicon database for the word file"
+         << endl
+         << "  -s <seed>       random seed" << endl
+         << "  -o <dir>        directory for generated files" << endl;
+}
+
+//---------------------------------------------------------------------------
+//  main
+//
+//! Run the search workload.
+//---------------------------------------------------------------------------
+int
+main(int argc, char** argv)
+{
+    QApplication app (argc, argv, false);
+
+    int numSpecs = DEFAULT_NUM_SPECS;
+    int maxConditions = DEFAULT_MAX_CONDITIONS;
+    QString typesStr;
+    QString dbFile;
+    unsigned int seed = 1;
+    QString workDir = QDir::tempPath() + "/zyzzyva-searchload";
+    QString wordFile;
+
+    QStringList args = app.arguments();
+    for (int i = 1; i < args.count(); ++i) {
+        const QString& arg = args[i];
+        if (!arg.startsWith("-")) {
+            wordFile = arg;
+            continue;
+        }
+        if (i + 1 >= args.count()) {
+            usage();
+            return 1;
+        }
+        QString value = args[++i];
+        if (arg == "-n")
+            numSpecs = value.toInt();
+        else if (arg == "-c")
+            maxConditions = value.toInt();
+        else if (arg == "-t")
+            typesStr = value;
+        else if (arg == "-d")
+            dbFile = value;
+        else if (arg == "-s")
+            seed = value.toUInt();
+        else if (arg == "-o")
+            workDir = value;
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (wordFile.isEmpty() || (numSpecs <= 0) || (maxConditions <= 0)) {
+        usage();
+        return 1;
+    }
+
+    QList<SearchCondition::SearchType> types;
+    if (typesStr.isEmpty()) {
+        for (int i = SearchCondition::PatternMatch;
+             i <= SearchCondition::DrawProbability; ++i)
+        {
+            // Probability conditions are not evaluated by WordEngine
+            if (i != SearchCondition::Probability)
+                types.append(SearchCondition::SearchType(i));
+        }
+    }
+    else {
+        foreach (const QString& str, typesStr.split(",")) {
+            SearchCondition::SearchType type =
+                Auxil::stringToSearchType(str.trimmed());
+            if (type == SearchCondition::UnknownSearchType) {
+                cerr << "Unknown condition type '"
+                     << str.toUtf8().constData() << "'." << endl;
+                return 1;
+            }
+            types.append(type);
+        }
+    }
+
+    QString errString;
+    WordListOracle oracle;
+    oracle.setLexicon(LEXICON_NAME);
+    if (!oracle.readWordList(wordFile, &errString)) {
+        cerr << errString.toLocal8Bit().constData() << endl;
+        return 1;
+    }
+    if (oracle.getWords().isEmpty()) {
+        cerr << "No words in '" << wordFile.toLocal8Bit().constData()
+             << "'." << endl;
+        return 1;
+    }
+
+    QDir dir;
+    if (!dir.mkpath(workDir)) {
+        cerr << "Cannot create directory '"
+             << workDir.toLocal8Bit().constData() << "'." << endl;
+        return 1;
+    }
+    MainSettings::setUserDataDir(workDir);
+
+    WordEngine engine;
+    if (engine.importTextFile(LEXICON_NAME, wordFile, true, &errString) <= 0)
+    {
+        cerr << errString.toLocal8Bit().constData() << endl;
+        return 1;
+    }
+
+    // Most conditions are evaluated by the lexicon database
+    if (dbFile.isEmpty()) {
+        dbFile = workDir + "/searchload.db";
+        QFile::remove(dbFile);
+        CreateDatabaseThread thread (&engine, LEXICON_NAME, dbFile, wordFile);
+        thread.start();
+        thread.wait();
+        if (!thread.getError().isEmpty()) {
+            cerr << thread.getError().toLocal8Bit().constData() << endl;
+            return 1;
+        }
+    }
+    if (!engine.connectToDatabase(LEXICON_NAME, dbFile, &errString)) {
+        cerr << errString.toLocal8Bit().constData() << endl;
+        return 1;
+    }
+
+    Rand rng;
+    rng.srand(seed, ~seed);
+    SpecGenerator generator (oracle.getWords(), LEXICON_NAME);
+    QMap<QString, MixStats> mixStats;
+    MixStats allStats;
+
+    QElapsedTimer clock;
+    clock.start();
+    for (int i = 0; i < numSpecs; ++i) {
+        SearchSpec spec = generator.generate(rng, maxConditions, types);
+
+        qint64 start = clock.nsecsElapsed();
+        QStringList results = engine.search(LEXICON_NAME, spec, true);
+        qint64 elapsed = clock.nsecsElapsed() - start;
+
+        bool complete = false;
+        QSet<QString> expected = oracle.search(spec, &complete);
+        QSet<QString> found = results.toSet();
+        QSet<QString> extra = found - expected;
+        QSet<QString> missing;
+        if (complete)
+            missing = expected - found;
+
+        MixStats& stats = mixStats[getMixName(spec)];
+        stats.latencies.append(elapsed);
+        allStats.latencies.append(elapsed);
+        if (!complete) {
+            ++stats.numPartial;
+            ++allStats.numPartial;
+        }
+        if (!extra.isEmpty() || !missing.isEmpty()) {
+            ++stats.numMismatches;
+            ++allStats.numMismatches;
+            reportMismatch(spec, missing, extra);
+        }
+
+        // The count-only search must agree with the full search
+        int count = engine.countSearch(LEXICON_NAME, spec);
+        if (count != results.count()) {
+            ++stats.numMismatches;
+            ++allStats.numMismatches;
+            cerr << "Count mismatch: "
+                 << spec.asString().toUtf8().constData() << endl
+                 << "  counted " << count << ", found " << results.count()
+                 << endl;
+        }
+    }
+
+    cout << "mix,count,p50_us,p95_us,p99_us,max_us,mismatches,partial"
+         << endl;
+    QMapIterator<QString, MixStats> it (mixStats);
+    while (it.hasNext()) {
+        it.next();
+        reportMix(it.key(), it.value());
+    }
+    reportMix("all", allStats);
+
+    return allStats.numMismatches ? 1 : 0;
+}
@@ -50,34 +50,27 @@ int main(int argc, char** argv)
 
     MainWindow* window = new MainWindow(0, splash);
 
-    window->tryUpdateUserDataDir();
-    window->tryAutoImport();
-    window->tryConnectToDatabases();
-
     window->show();
     splash->finish(window);
     delete splash;
 
-    // Now that the splash screen is gone, process any database errors
-    window->processDatabaseErrors();
-
-    // Handle command-line arguments
-    if (argc > 1) {
-        QStringList args;
-        for (int i = 1; i < argc; ++i) {
-            args.append(QString(argv[i]));
-        }
-        window->processArguments(args);
+    // Collect command-line arguments and file open requests, to be opened
+    // once lexicons and databases have been loaded
+    QStringList files;
+    for (int i = 1; i < argc; ++i) {
+        files.append(QString(argv[i]));
     }
 
 #if not defined Z_LINUX
-    // Handle file open requests
-    QStringList files = app.getFileOpenRequests();
-    foreach (const QString& file, files) {
-        window->fileOpenRequested(file);
-    }
+    files += app.getFileOpenRequests();
     app.clearFileOpenRequests();
+#endif
+
+    // Load lexicons and connect to databases from the event loop, now that
+    // the main window is visible
+    window->runStartupSteps(files);
 
+#if not defined Z_LINUX
     QObject::connect(&app, SIGNAL(fileOpenRequested(const QString&)),
                      window, SLOT(fileOpenRequested(const QString&)));
 #endif